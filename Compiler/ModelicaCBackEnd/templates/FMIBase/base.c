@@ -133,6 +133,16 @@ $C_delay_sample$
     return 0;
 }
 
+static int model_ode_dependencies(jmi_t* jmi) {
+$C_ode_block_dependencies$
+    return 0;
+}
+
+static int model_init_dependent_dependencies(jmi_t* jmi) {
+$C_init_dependent_dependencies$
+    return 0;
+}
+
 static int jmi_z_offset_strings(jmi_z_strings_t* z) {
 $C_z_offsets_strings$
     return 0;
@@ -171,6 +181,10 @@ $C_dynamic_state_add_call$
                    *model_init_eval_independent,
                    *model_init_eval_dependent,
                    *model_ode_next_time_event);
+
+    /* Initialize the dependencies for incremental evaluation */
+    model_ode_dependencies(*jmi);
+    model_init_dependent_dependencies(*jmi);
     
     /* Initialize the delay interface */
     jmi_init_delay_if(*jmi, N_delays, N_spatialdists, *model_init_delay,
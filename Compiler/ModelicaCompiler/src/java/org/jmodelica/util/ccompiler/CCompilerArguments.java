@@ -79,8 +79,13 @@ public class CCompilerArguments {
         return externalIncludeDirectories;
     }
     
+    /**
+     * The maximum number of parallel compilation processes, values less than 1 
+     * means one per available processor.
+     */
     public int getMaxProc() {
-        return options.getIntegerOption("max_n_proc");
+        int n = options.getIntegerOption("max_n_proc");
+        return n < 1 ? Runtime.getRuntime().availableProcessors() : n;
     }
     
     public String getExtraCFlags() {
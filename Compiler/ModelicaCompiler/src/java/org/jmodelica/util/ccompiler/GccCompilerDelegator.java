@@ -20,11 +20,13 @@ import java.io.ByteArrayOutputStream;
 import java.io.File;
 import java.io.OutputStream;
 import java.util.ArrayList;
+import java.util.Collections;
 import java.util.LinkedHashMap;
 import java.util.LinkedHashSet;
 import java.util.Map;
 import java.util.Set;
 
+import org.jmodelica.common.options.AbstractOptionRegistry;
 import org.jmodelica.util.EnvironmentUtils;
 import org.jmodelica.util.exceptions.CcodeCompilationException;
 import org.jmodelica.util.logging.ModelicaLogger;
@@ -95,6 +97,83 @@ public class GccCompilerDelegator extends CCompilerDelegator {
         vars.put("MODULE_HOME", getEnv().get("MODULE_HOME"));
     }
     
+    /**
+     * Add make variables for profile-guided and link-time optimization and 
+     * for the BLAS/LAPACK implementation to link with.
+     */
+    protected void addOptimizationMakeVars(Map<String,String> vars, CCompilerArguments args) {
+        AbstractOptionRegistry options = args.getOptions();
+        String profileMode = options.getStringOption("cc_profile_mode");
+        if (!profileMode.equals("none")) {
+            String profileDir = options.getStringOption("cc_profile_dir");
+            if (profileDir.isEmpty()) {
+                profileDir = args.getFileName() + "_profile";
+            }
+            vars.put("PGO", profileMode);
+            vars.put("PGO_DIR", new File(profileDir).getAbsolutePath());
+        }
+        if (options.getBooleanOption("cc_lto")) {
+            vars.put("LTO", "1");
+        }
+        String blasLapack = options.getStringOption("cc_blas_lapack_libs");
+        if (!blasLapack.isEmpty()) {
+            vars.put("BLAS_LAPACK_LIBS", blasLapack);
+        }
+        String objCache = options.getStringOption("cc_object_cache_dir");
+        if (!objCache.isEmpty()) {
+            vars.put("OBJ_CACHE_DIR", new File(objCache).getAbsolutePath());
+        }
+    }
+    
+    /**
+     * Get the arguments controlling the number of parallel jobs. If we are run 
+     * from a make that provides a named jobserver, then make will pick that up 
+     * from the environment and share its job slots instead.
+     */
+    protected String[] getJobArgs(CCompilerArguments args) {
+        return jobArgs(getEnv().get("MAKEFLAGS"), args.getMaxProc());
+    }
+    
+    /**
+     * Get the arguments controlling the number of parallel jobs, given the 
+     * MAKEFLAGS that make is run with. Only a named (fifo) jobserver can be 
+     * shared, the file descriptors of the other forms are not inherited 
+     * through the JVM.
+     */
+    public static String[] jobArgs(String makeFlags, int maxProc) {
+        if (makeFlags != null && makeFlags.contains("--jobserver-auth=fifo:")) {
+            return new String[0];
+        }
+        return new String[] { "-j", Integer.toString(maxProc) };
+    }
+    
+    /**
+     * Get MAKEFLAGS without the jobserver options that refer to file 
+     * descriptors, i.e. <code>--jobserver-auth=R,W</code> and the older 
+     * <code>--jobserver-fds=R,W</code>. The descriptors are closed in the 
+     * processes that we start, and make warns about them.
+     */
+    public static String removeJobserverFds(String makeFlags) {
+        if (makeFlags == null) {
+            return null;
+        }
+        return makeFlags.replaceAll("(^|\\s)--jobserver-(auth|fds)=-?\\d+,-?\\d+(?=\\s|$)", "").trim();
+    }
+    
+    /**
+     * Get the environment to run make in.
+     */
+    protected Map<String, String> getMakeEnv() {
+        String makeFlags = getEnv().get("MAKEFLAGS");
+        String cleaned = removeJobserverFds(makeFlags);
+        if (makeFlags == null || makeFlags.equals(cleaned)) {
+            return getEnv();
+        }
+        Map<String, String> env = new LinkedHashMap<String, String>(getEnv());
+        env.put("MAKEFLAGS", cleaned);
+        return env;
+    }
+    
     /**
      * Add make variables specific to the build platform.
      */
@@ -158,6 +237,7 @@ public class GccCompilerDelegator extends CCompilerDelegator {
         addBuildPlatformMakeVars(vars, getBuildPlatform());
         
         vars.put("EXTRA_CFLAGS", args.getExtraCFlags());
+        addOptimizationMakeVars(vars, args);
         
         for (String platform : platforms) {
             Map<String, String> pVars = new LinkedHashMap<String, String>(vars);
@@ -165,22 +245,19 @@ public class GccCompilerDelegator extends CCompilerDelegator {
             
             File makefile = getMakefile();
             String makefileVar = "MAKEFILE=" + makefile.getPath();
-            String[] mArgs = new String[] { make, "-f", makefile.getPath(), "-j", Integer.toString(args.getMaxProc()), 
-                    args.getTarget().getMakeFileFlag(), makefileVar };
-            ArrayList<String> vArgs = new ArrayList<String>(pVars.size());
+            ArrayList<String> cmdList = new ArrayList<String>();
+            Collections.addAll(cmdList, make, "-f", makefile.getPath());
+            Collections.addAll(cmdList, getJobArgs(args));
+            Collections.addAll(cmdList, args.getTarget().getMakeFileFlag(), makefileVar);
             for (Map.Entry<String,String> var : pVars.entrySet())
                 if (var.getValue() != null)
-                    vArgs.add(var.getKey() + '=' + var.getValue());
-            String[] cmd = new String[mArgs.length + vArgs.size()];
-            System.arraycopy(mArgs, 0, cmd, 0, mArgs.length);
-            int i = mArgs.length;
-            for (String arg : vArgs)
-                cmd[i++] = arg;
+                    cmdList.add(var.getKey() + '=' + var.getValue());
+            String[] cmd = cmdList.toArray(new String[cmdList.size()]);
                 
             log.debug("C-code compilation command:");
             log.debug(printStringArrayObject(cmd));
 
-            if (ProcessExecutor.loggedProcess(log, cmd, getEnv(), workDir) != 0) {
+            if (ProcessExecutor.loggedProcess(log, cmd, getMakeEnv(), workDir) != 0) {
                 File sourceDir = new File(workDir, "sources");
                 File cfile = new File(sourceDir, args.getFileName()+".c");
                 throw new CcodeCompilationException("Compilation of generated C code failed.\n" +
@@ -0,0 +1,154 @@
+package org.jmodelica.test.common;
+
+import static org.junit.Assert.assertArrayEquals;
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertNull;
+import static org.junit.Assert.assertTrue;
+
+import java.io.File;
+import java.util.Collections;
+import java.util.LinkedHashMap;
+import java.util.Map;
+import java.util.Set;
+
+import org.jmodelica.common.options.AbstractOptionRegistry;
+import org.jmodelica.common.options.BooleanOption;
+import org.jmodelica.common.options.StringOption;
+import org.jmodelica.util.ccompiler.CCompilerArguments;
+import org.jmodelica.util.ccompiler.GccCompilerDelegator;
+import org.junit.Test;
+
+public class GccCompilerDelegatorTest {
+
+    @Test
+    public void defaultOptionsAddNoMakeVars() {
+        assertTrue(makeVars(new OptionsMock()).isEmpty());
+    }
+
+    @Test
+    public void profileGenerateDefaultDir() {
+        OptionsMock options = new OptionsMock();
+        options.setStringOption("cc_profile_mode", "generate");
+        Map<String, String> vars = makeVars(options);
+        assertEquals("generate", vars.get("PGO"));
+        assertEquals(new File("Model_profile").getAbsolutePath(), vars.get("PGO_DIR"));
+        assertEquals(2, vars.size());
+    }
+
+    @Test
+    public void profileUseGivenDir() {
+        OptionsMock options = new OptionsMock();
+        options.setStringOption("cc_profile_mode", "use");
+        options.setStringOption("cc_profile_dir", "profiles");
+        Map<String, String> vars = makeVars(options);
+        assertEquals("use", vars.get("PGO"));
+        assertEquals(new File("profiles").getAbsolutePath(), vars.get("PGO_DIR"));
+    }
+
+    @Test
+    public void linkTimeOptimization() {
+        OptionsMock options = new OptionsMock();
+        options.setBooleanOption("cc_lto", true);
+        Map<String, String> vars = makeVars(options);
+        assertEquals("1", vars.get("LTO"));
+        assertEquals(1, vars.size());
+    }
+
+    @Test
+    public void blasLapackLibs() {
+        OptionsMock options = new OptionsMock();
+        options.setStringOption("cc_blas_lapack_libs", "-lopenblas");
+        Map<String, String> vars = makeVars(options);
+        assertEquals("-lopenblas", vars.get("BLAS_LAPACK_LIBS"));
+        assertEquals(1, vars.size());
+    }
+
+    @Test
+    public void allOptimizations() {
+        OptionsMock options = new OptionsMock();
+        options.setStringOption("cc_profile_mode", "use");
+        options.setBooleanOption("cc_lto", true);
+        options.setStringOption("cc_blas_lapack_libs", "-lopenblas");
+        Map<String, String> vars = makeVars(options);
+        assertEquals("use", vars.get("PGO"));
+        assertEquals("1", vars.get("LTO"));
+        assertEquals("-lopenblas", vars.get("BLAS_LAPACK_LIBS"));
+    }
+
+    @Test
+    public void jobArgsWithoutJobserver() {
+        assertArrayEquals(new String[] { "-j", "4" }, GccCompilerDelegator.jobArgs(null, 4));
+        assertArrayEquals(new String[] { "-j", "4" }, GccCompilerDelegator.jobArgs("-k", 4));
+    }
+
+    @Test
+    public void jobArgsWithFifoJobserver() {
+        String makeFlags = "-j8 --jobserver-auth=fifo:/tmp/GMfifo123";
+        assertEquals(0, GccCompilerDelegator.jobArgs(makeFlags, 4).length);
+        assertEquals(makeFlags, GccCompilerDelegator.removeJobserverFds(makeFlags));
+    }
+
+    @Test
+    public void jobArgsWithFdJobserver() {
+        String makeFlags = "-j8 --jobserver-auth=3,4 -- X=1";
+        assertArrayEquals(new String[] { "-j", "4" }, GccCompilerDelegator.jobArgs(makeFlags, 4));
+        assertEquals("-j8 -- X=1", GccCompilerDelegator.removeJobserverFds(makeFlags));
+    }
+
+    @Test
+    public void jobArgsWithLegacyFdJobserver() {
+        String makeFlags = " --jobserver-fds=3,4 -j";
+        assertArrayEquals(new String[] { "-j", "4" }, GccCompilerDelegator.jobArgs(makeFlags, 4));
+        assertEquals("-j", GccCompilerDelegator.removeJobserverFds(makeFlags));
+    }
+
+    @Test
+    public void removeJobserverFdsWithoutMakeFlags() {
+        assertNull(GccCompilerDelegator.removeJobserverFds(null));
+    }
+
+    private static Map<String, String> makeVars(AbstractOptionRegistry options) {
+        return new CompilerMock().optimizationMakeVars(options);
+    }
+
+    /**
+     * The options that the make variables are computed from, with the defaults of module.options.
+     */
+    private static class OptionsMock extends AbstractOptionRegistry {
+
+        public OptionsMock() {
+            addStringOption("cc_profile_mode", "none");
+            addStringOption("cc_profile_dir", "");
+            addStringOption("cc_blas_lapack_libs", "");
+            addStringOption("cc_object_cache_dir", "");
+            optionsMap.put("cc_lto", new BooleanOption("cc_lto", OptionType.compiler, Category.uncommon, "",
+                    new DefaultValue<Boolean>(false)));
+        }
+
+        private void addStringOption(String key, String defaultValue) {
+            optionsMap.put(key, new StringOption(key, OptionType.compiler, Category.uncommon, "",
+                    new DefaultValue<String>(defaultValue), null));
+        }
+
+        @Override
+        public AbstractOptionRegistry copy() {
+            OptionsMock res = new OptionsMock();
+            res.copyAllOptions(this);
+            return res;
+        }
+    }
+
+    private static class CompilerMock extends GccCompilerDelegator {
+
+        public CompilerMock() {
+            super(new File("."), "linux64");
+        }
+
+        public Map<String, String> optimizationMakeVars(AbstractOptionRegistry options) {
+            Set<String> none = Collections.emptySet();
+            Map<String, String> vars = new LinkedHashMap<String, String>();
+            addOptimizationMakeVars(vars, new CCompilerArguments("Model", options, null, none, none, none));
+            return vars;
+        }
+    }
+}
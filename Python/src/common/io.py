@@ -21,7 +21,11 @@ from operator import itemgetter, attrgetter
 import array
 import codecs
 import re
+from collections import OrderedDict
 import sys
+import struct
+import logging
+import mmap
 
 import numpy as N
 import numpy as np
@@ -1098,13 +1102,17 @@ class ResultDymolaTextual(ResultDymola):
         self.data[1] = N.vstack((self.data[1],res.data[1]))
         self.data[1][n_points:,0] = self.data[1][n_points:,0] + time_shift 
 
+mat4_precision = {0: "f8", 1: "f4", 2: "i4", 3: "i2", 4: "u2", 5: "u1"}
+
 class ResultDymolaBinary(ResultDymola):
     """ 
     Class representing a simulation or optimization result loaded from a Dymola 
-    binary file.
+    binary file. The file is memory-mapped, only the header matrices
+    (name and dataInfo) are read when the file is opened and the
+    trajectories are read on demand.
     """
 
-    def __init__(self,fname):
+    def __init__(self, fname, max_cached_columns=256):
         """
         Load a result file written on Dymola binary format.
 
@@ -1112,22 +1120,106 @@ class ResultDymolaBinary(ResultDymola):
         
             fname --
                 Name of file.
+                
+            max_cached_columns --
+                The maximum number of trajectories kept in memory after
+                they have been read.
+                Default: 256
         """
         self._fname = fname
-        self.raw = scipy.io.loadmat(fname,chars_as_strings=False, variable_names=["name", "dataInfo", "data_1", "data_2"])
-        name = self.raw['name']
-        self.raw_name = name
-
-        self.name = fmi_util.convert_array_names_list_names_int(name.view(np.int32))
-        self.dataInfo = self.raw['dataInfo'].transpose()
+        self._max_cached_columns = max_cached_columns
+        self._columns = OrderedDict()
+        
+        with open(fname, "rb") as f:
+            self._mmap = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        self._matrices = self._read_matrix_headers()
+        
+        for required in ["name", "dataInfo", "data_1"]:
+            if required not in self._matrices:
+                raise JIOError("The result file %s does not contain the matrix %s."%(fname, required))
+        
+        #Dymola stores the matrices either transposed (binTrans) or not (binNormal)
+        self._transposed = True
+        if "Aclass" in self._matrices:
+            aclass = self._get_matrix("Aclass")
+            if aclass.shape[0] > 3 and aclass[3,:].tobytes().rstrip(b"\0 ").startswith(b"binNormal"):
+                self._transposed = False
+        
+        name = self._get_matrix("name", transposed=self._transposed)
+        self.name = fmi_util.convert_array_names_list_names_int(name.astype(np.int32))
         self.name_lookup = {key:ind for ind,key in enumerate(self.name)}
         
+        self._data_info = np.array(self._get_matrix("dataInfo", transposed=self._transposed), dtype=np.int32)
+        self.dataInfo = self._data_info.transpose()
+        self._data_1 = np.array(self._get_matrix("data_1", transposed=self._transposed), dtype=np.float64)
+        self._data_2 = self._get_matrix("data_2", transposed=self._transposed) if "data_2" in self._matrices else np.empty((0,0))
+        
         self._description = None
+    
+    def _read_matrix_headers(self):
+        """
+        Reads the headers of all the (MATLAB v4) matrices in the file 
+        without reading the data.
+        """
+        mm = self._mmap
+        size = len(mm)
+        header_size = struct.calcsize("<5i")
+        matrices = {}
+        pos = 0
+        
+        while pos + header_size <= size:
+            byte_order = "<"
+            mtype, mrows, ncols, imagf, namlen = struct.unpack_from(byte_order+"5i", mm, pos)
+            if mtype < 0 or mtype > 4052:
+                byte_order = ">"
+                mtype, mrows, ncols, imagf, namlen = struct.unpack_from(byte_order+"5i", mm, pos)
+            if mtype < 0 or mtype > 4052 or mrows < 0 or ncols < 0 or namlen < 1:
+                break #Not a valid header, the file is corrupt from here
+            
+            name = decode(mm[pos+header_size:pos+header_size+namlen-1]) if python3_flag else mm[pos+header_size:pos+header_size+namlen-1]
+            dtype = np.dtype(byte_order + mat4_precision[(mtype // 10) % 10])
+            offset = pos + header_size + namlen
+            nbytes = mrows*ncols*dtype.itemsize*(2 if imagf else 1)
+            
+            if offset + nbytes > size:
+                #Not finalized, use the number of columns that are available
+                ncols = (size - offset) // (mrows*dtype.itemsize) if mrows > 0 else 0
+                nbytes = mrows*ncols*dtype.itemsize
+            
+            matrices[name] = (offset, dtype, mrows, ncols)
+            pos = offset + nbytes
+        
+        return matrices
+    
+    def _get_matrix(self, name, transposed=True):
+        """
+        Returns a view (backed by the memory-mapped file) of a matrix.
+        """
+        offset, dtype, mrows, ncols = self._matrices[name]
+        matrix = np.ndarray(shape=(mrows, ncols), dtype=dtype, buffer=self._mmap, offset=offset, order="F")
+        
+        return matrix if transposed else matrix.transpose()
+    
+    def _get_trajectory(self, data_index):
+        """
+        Returns the trajectory in the given row of the data_2 matrix. The
+        trajectories are cached.
+        """
+        try:
+            column = self._columns.pop(data_index)
+        except KeyError:
+            column = np.array(self._data_2[data_index,:], dtype=np.float64)
+            if len(self._columns) >= self._max_cached_columns:
+                self._columns.popitem(last=False)
+        self._columns[data_index] = column
+        
+        return column
         
     def _get_description(self):
         if not self._description:
-            description = scipy.io.loadmat(self._fname,chars_as_strings=False, variable_names=["description"])["description"]
-            self._description = ["".join(description[:,i]).rstrip() for i in range(description[0,:].size)]
+            description = self._get_matrix("description", transposed=self._transposed)
+            self._description = [description[:,i].tobytes().rstrip(b"\0 ").decode("latin-1") if python3_flag else description[:,i].tobytes().rstrip("\0 ") 
+                                    for i in range(description.shape[1])]
         
         return self._description
 
@@ -1135,6 +1227,31 @@ class ResultDymolaBinary(ResultDymola):
     """
     Property for accessing the description vector.
     """)
+    
+    def _get_raw_name(self):
+        logging.warning("The attribute 'raw_name' is deprecated and will be removed. Please use 'name' instead.")
+        return self._name_char_matrix()
+    
+    raw_name = property(_get_raw_name, doc = 
+    """
+    Deprecated. The name matrix as a character array (as stored in the file).
+    """)
+    
+    def _get_raw(self):
+        logging.warning("The attribute 'raw' is deprecated and will be removed. Please use 'get_variable_data' or 'get_data_matrix' instead.")
+        return {"name": self._name_char_matrix(), "dataInfo": self._get_matrix("dataInfo", transposed=self._transposed), 
+                "data_1": self._get_matrix("data_1", transposed=self._transposed), "data_2": self._data_2}
+    
+    raw = property(_get_raw, doc = 
+    """
+    Deprecated. Dictionary with the matrices name, dataInfo, data_1 and 
+    data_2 (as stored in the file). Note that data_2 is backed by the
+    memory-mapped file.
+    """)
+    
+    def _name_char_matrix(self):
+        name = self._get_matrix("name", transposed=self._transposed)
+        return name.astype(np.uint32).view("U1") if python3_flag else name.astype(np.uint8).view("S1")
        
     def get_variable_data(self,name):
         """
@@ -1158,8 +1275,8 @@ class ResultDymolaBinary(ResultDymola):
         else:
             varInd  = self.get_variable_index(name)
             
-        dataInd = self.raw['dataInfo'][1][varInd]
-        dataMat = self.raw['dataInfo'][0][varInd]
+        dataInd = self._data_info[1][varInd]
+        dataMat = self._data_info[0][varInd]
         factor = 1
         if dataInd<0:
             factor = -1
@@ -1170,9 +1287,12 @@ class ResultDymolaBinary(ResultDymola):
         if dataMat == 0:
             # Take into account that the 'Time' variable has data matrix index 0
             # and that 'time' is called 'Time' in Dymola results
-            dataMat = 2 if len(self.raw['data_2'])> 0 else 1
-                
-        return Trajectory(self.raw['data_%d'%dataMat][0,:],factor*self.raw['data_%d'%dataMat][dataInd,:])
+            dataMat = 2 if len(self._data_2)> 0 else 1
+        
+        if dataMat == 1:
+            return Trajectory(self._data_1[0,:],factor*self._data_1[dataInd,:])
+        else:
+            return Trajectory(self._get_trajectory(0),factor*self._get_trajectory(dataInd))
 
     def is_variable(self, name):
         """
@@ -1190,7 +1310,7 @@ class ResultDymolaBinary(ResultDymola):
         if name == 'time' or name== 'Time':
             return True
         varInd  = self.get_variable_index(name)
-        dataMat = self.raw['dataInfo'][0][varInd]
+        dataMat = self._data_info[0][varInd]
         if dataMat<1:
             dataMat = 1
         
@@ -1213,7 +1333,7 @@ class ResultDymolaBinary(ResultDymola):
             True if the result should be negated
         """
         varInd  = self.get_variable_index(name)
-        dataInd = self.raw['dataInfo'][1][varInd]
+        dataInd = self._data_info[1][varInd]
         if dataInd<0:
             return True
         else:
@@ -1240,7 +1360,7 @@ class ResultDymolaBinary(ResultDymola):
             raise VariableNotTimeVarying("Variable " +
                                         name + " is not time-varying.")
         varInd  = self.get_variable_index(name)
-        dataInd = self.raw['dataInfo'][1][varInd]
+        dataInd = self._data_info[1][varInd]
         factor = 1
         if dataInd<0:
             factor = -1
@@ -1252,15 +1372,28 @@ class ResultDymolaBinary(ResultDymola):
     
     def get_data_matrix(self):
         """
-        Returns the result matrix.
+        Returns the result matrix. Note that the matrix is backed by the
+        memory-mapped file, i.e. it is not read into memory.
                 
         Returns::
         
             The result data matrix.
         """
-        return self.raw['data_%d'%2]
-        
-
+        return self._data_2
+    
+    def close(self):
+        """
+        Closes the memory-mapped file. Trajectories that have already
+        been returned are still valid.
+        """
+        if self._mmap is not None:
+            self._data_2 = None
+            self._columns.clear()
+            try:
+                self._mmap.close()
+            except BufferError:
+                return #There are still views of the file in use
+            self._mmap = None
 
 class ResultHandlerMemory(ResultHandler):
     def __init__(self, model):
@@ -147,6 +147,64 @@ def compile_fmu(class_name, file_name=[], compiler='auto', target='me', version=
                 platform, compiler_options, compile_to, compiler_log_level,
                 separate_process, jvm_args)       
 
+def compile_fmu_with_profile(class_name, training, file_name=[], profile_dir=None,
+                             lto=True, compiler_options={}, **kwargs):
+    """
+    Compile a Modelica model to an FMU whose C code is optimized for a 
+    training simulation (profile-guided optimization, Linux only).
+    
+    The model is first compiled to an instrumented FMU, which is passed to 
+    the training function. The profile data recorded while simulating it is 
+    then used when compiling the final FMU, which replaces the instrumented 
+    one.
+    
+    Parameters::
+    
+        class_name --
+            The name of the model class.
+            
+        training --
+            A function taking the name of the instrumented FMU as argument 
+            and simulating it the way the final FMU is expected to be used.
+            The profile data is written when the FMU binary is unloaded, so 
+            the loaded model should not be kept after the function returns.
+            
+        file_name --
+            A path (string) or paths (list of strings) to model files and/or 
+            libraries.
+            Default: Empty list.
+            
+        profile_dir --
+            Directory where the profile data is kept. 
+            Default: None, i.e. <class name>_profile in the current directory.
+            
+        lto --
+            Also enable link-time optimization.
+            Default: True
+            
+        compiler_options --
+            Options for the compiler.
+            Default: Empty dict.
+            
+        All other keyword arguments are passed on to compile_fmu.
+            
+    Returns::
+    
+        The compilation result of the final FMU, see compile_fmu.
+    """
+    options = dict(compiler_options)
+    if profile_dir is None:
+        profile_dir = class_name.replace('.', '_') + "_profile"
+    options["cc_profile_dir"] = os.path.abspath(profile_dir)
+    options["cc_lto"] = lto
+    
+    options["cc_profile_mode"] = "generate"
+    fmu = compile_fmu(class_name, file_name, compiler_options=options, **kwargs)
+    training(fmu)
+    
+    options["cc_profile_mode"] = "use"
+    return compile_fmu(class_name, file_name, compiler_options=options, **kwargs)
+
 def compile_fmux(class_name, file_name=[], compiler='auto', compiler_options={}, 
                  compile_to='.', compiler_log_level='warning', separate_process=True,
                  jvm_args=''):
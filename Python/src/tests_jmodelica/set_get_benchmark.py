@@ -0,0 +1,69 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# Copyright (C) 2017 Modelon AB
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, version 3 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+"""
+Benchmark of parameter set/get round-trips with and without the compiler
+option incremental_parameter_evaluation.
+
+Usage: python set_get_benchmark.py [round-trips]
+
+ParameterDependencies.Chain is compiled to an FMU with and without the
+option. Each round-trip sets one independent parameter and gets a few
+dependent parameters, which recomputes the dependent parameters. The time
+per round-trip is printed for both FMUs. The script is not a test, the
+values are checked by Test_Incremental_Parameters in test_fmi_2.py.
+"""
+
+import os
+import sys
+import timeit
+
+from tests_jmodelica import get_files_path
+from pymodelica.compiler import compile_fmu
+from pyfmi.fmi import load_fmu
+
+def compile_chain(incremental):
+    file_name = os.path.join(get_files_path(), 'Modelica', "ParameterDependencies.mo")
+    suffix = "incremental" if incremental else "complete"
+    return compile_fmu("ParameterDependencies.Chain", file_name, target="me", version="2.0",
+                       compile_to="ParameterDependencies_Chain_%s.fmu" % suffix,
+                       compiler_options={"incremental_parameter_evaluation":incremental})
+
+def set_get(model, n):
+    for i in range(n):
+        model.set("a[1]", float(i))
+        model.get(["b[1]", "c", "d", "x"])
+
+def run_benchmark(n=200):
+    """
+    Returns the time in seconds per set/get round-trip, for the FMU compiled
+    without and with incremental_parameter_evaluation.
+    """
+    times = []
+    for incremental in [False, True]:
+        model = load_fmu(compile_chain(incremental))
+        set_get(model, 1)
+        times.append(timeit.timeit(lambda: set_get(model, n), number=1) / n)
+    return times
+
+if __name__ == "__main__":
+    n = int(sys.argv[1]) if len(sys.argv) > 1 else 200
+    complete, incremental = run_benchmark(n)
+    print "%d set/get round-trips" % n
+    print "complete:    %g s per round-trip" % complete
+    print "incremental: %g s per round-trip" % incremental
+    print "speedup:     %.2f" % (complete / incremental)
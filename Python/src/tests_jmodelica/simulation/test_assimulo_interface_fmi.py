@@ -760,6 +760,63 @@ class Test_Events:
         nose.tools.assert_almost_equal(res["start"][0], 1.0)
         nose.tools.assert_almost_equal(res["T2"][0], 0.0)
 
+class Test_Incremental_Event_Iteration:
+    """
+    Compares models compiled with and without the block dependency tables
+    used for incremental event iteration.
+    """
+    models = ["EventStartIter", "EnhancedEventIteration1", "EnhancedEventIteration2", "EventIterDiscreteReals"]
+    
+    @classmethod
+    def setUpClass(cls):
+        """
+        Compile the test models.
+        """
+        file_name = os.path.join(get_files_path(), 'Modelica', 'EventIter.mo')
+        
+        for model in cls.models:
+            compile_fmu("EventIter."+model, file_name, compile_to=model+"_full.fmu")
+            compile_fmu("EventIter."+model, file_name, compile_to=model+"_incremental.fmu",
+                        compiler_options={"incremental_event_iteration":True})
+    
+    def compare_models(self, name, final_time):
+        model_full = load_fmu(name+"_full.fmu")
+        model_incr = load_fmu(name+"_incremental.fmu")
+        
+        #Derivatives and variables after the initial event iteration
+        model_full.initialize()
+        model_incr.initialize()
+        N.testing.assert_array_equal(model_full.get_derivatives(), model_incr.get_derivatives())
+        vrefs = [model_full.get_variable_valueref(var) for var in model_full.get_model_variables(type=0)]
+        N.testing.assert_array_equal(model_full.get_real(vrefs), model_incr.get_real(vrefs))
+        
+        model_full.reset()
+        model_incr.reset()
+        opts = model_full.simulate_options()
+        opts["CVode_options"]["rtol"] = 1e-8
+        res_full = model_full.simulate(final_time=final_time, options=opts)
+        res_incr = model_incr.simulate(final_time=final_time, options=opts)
+        
+        N.testing.assert_array_equal(res_full["time"], res_incr["time"])
+        for var in model_full.get_model_variables(type=0):
+            N.testing.assert_array_almost_equal(res_full[var], res_incr[var], decimal=10)
+    
+    @testattr(stddist_full = True)
+    def test_event_start_iteration(self):
+        self.compare_models("EventStartIter", 2.0)
+    
+    @testattr(stddist_full = True)
+    def test_enhanced_event_iteration_1(self):
+        self.compare_models("EnhancedEventIteration1", 1.0)
+    
+    @testattr(stddist_full = True)
+    def test_enhanced_event_iteration_2(self):
+        self.compare_models("EnhancedEventIteration2", 2.0)
+    
+    @testattr(stddist_full = True)
+    def test_discrete_real_event_iteration(self):
+        self.compare_models("EventIterDiscreteReals", 1.0)
+
 class Test_Relations:
     @classmethod
     def setUpClass(cls):
@@ -462,6 +462,35 @@ class Test_Compiler_functions:
         assert 'sources/' in includedFiles, 'Source files should be present when copy_source_files_to_fmu is set to true'
         assert 'sources/BouncingBall.c' in includedFiles, 'Source files should be present when copy_source_files_to_fmu is set to true'
 
+    @testattr(stddist_full = True)
+    def test_compile_fmu_with_profile(self):
+        """
+        Test that the training simulation of the instrumented FMU records a 
+        profile and that the FMU rebuilt with it is loadable.
+        """
+        profile_dir = os.path.abspath("BouncingBall_profile_test")
+        if os.path.exists(profile_dir):
+            shutil.rmtree(profile_dir)
+        trained = []
+        
+        def training(fmu):
+            model = load_fmu(fmu)
+            res = model.simulate(final_time=3.0)
+            trained.append(res.final("h"))
+        
+        fmuname = pym.compile_fmu_with_profile("BouncingBall", training,
+            [os.path.join(get_files_path(), 'Modelica', 'BouncingBall.mo')],
+            profile_dir=profile_dir, version="2.0")
+        
+        assert len(trained) == 1, "The training function was not called once"
+        profiles = [f for dirpath, dirnames, files in os.walk(profile_dir) for f in files if f.endswith(".gcda")]
+        assert len(profiles) > 0, "The training simulation did not record a profile"
+        
+        model = load_fmu(fmuname)
+        res = model.simulate(final_time=3.0)
+        nose.tools.assert_almost_equal(res.final("h"), trained[0])
+        shutil.rmtree(profile_dir)
+    
     def assert_compiler_option_missing(self, option_name, exception) :
         """
             Tests that an option is missing, deducing it from an exception message.
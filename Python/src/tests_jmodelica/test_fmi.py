@@ -211,6 +211,7 @@ class Test_FMUModelCS1:
         cls.simple_input = compile_fmu("Inputs.SimpleInput",os.path.join(path_to_mofiles,"InputTests.mo"),target="cs", version="1.0")
         cls.simple_input2 = compile_fmu("Inputs.SimpleInput2",os.path.join(path_to_mofiles,"InputTests.mo"),target="cs", version="1.0")
         cls.input_discontinuity = compile_fmu("Inputs.InputDiscontinuity",os.path.join(path_to_mofiles,"InputTests.mo"),target="cs", version="1.0")
+        cls.smooth_input = compile_fmu("Inputs.SmoothInput",os.path.join(path_to_mofiles,"InputTests.mo"),target="cs", version="1.0")
         cls.terminate = compile_fmu("Terminate",os.path.join(path_to_mofiles,"Terminate.mo"),target="cs", version="1.0")
         cls.assert_fail = compile_fmu("AssertFail",os.path.join(path_to_mofiles,"Terminate.mo"),target="cs", version="1.0")
         cls.initialize_solver = compile_fmu("Inputs.DiscChange",os.path.join(path_to_mofiles,"InputTests.mo"),target="cs", version="1.0")
@@ -382,6 +383,37 @@ class Test_FMUModelCS1:
         nose.tools.assert_almost_equal(model.get("u"),8.0)
 
 
+    def simulate_smooth_input(self, reinit_tol):
+        model = load_fmu(Test_FMUModelCS1.smooth_input, log_level=4)
+        model.set("_log_level", 4)
+        model.set("_cs_input_reinit_tol", reinit_tol)
+        
+        model.initialize()
+        h = 0.01
+        for i in range(100):
+            model.set("u", N.sin(i*h))
+            model.do_step(i*h, h)
+        x = model.get("x")
+        
+        #The solver statistics are logged when the solver is freed
+        model.reset()
+        log = parse_jmi_log(model.get_log_filename())
+        return x, log.find("CVodeStatistics")[-1]
+
+    @testattr(stddist_full = True)
+    def test_smooth_input_changes(self):
+        x_reinit, stats_reinit = self.simulate_smooth_input(0.0)
+        x_smooth, stats_smooth = self.simulate_smooth_input(0.1)
+        
+        #Every input change re-initializes the solver by default
+        assert stats_reinit.nreinits >= 99
+        #Changes below the tolerance keep the solver history
+        assert stats_smooth.nreinits <= 1
+        assert stats_smooth.nsteps < stats_reinit.nsteps
+        
+        #The inputs are extrapolated linearly between the communication points
+        nose.tools.assert_almost_equal(x_smooth, 1.0 - N.cos(1.0), places=3)
+
     @testattr(stddist_full = True)
     def test_zero_step_size(self):
         model = load_fmu(Test_FMUModelCS1.input_discontinuity)
@@ -462,10 +494,53 @@ class Test_FMUModelCS1:
 
         assert N.abs(resistor_v[-1] + 0.233534539103) < 1e-3
 
+    @testattr(stddist_full = True)
+    def test_simulation_using_ida(self):
+        """
+        Tests a simulation using IDA.
+        """
+        rlc_square = load_fmu(Test_FMUModelCS1.rlc_circuit_square)
+        rlc_square.set("_cs_solver",2)
+
+        res1 = rlc_square.simulate()
+        resistor_v = res1['resistor.v']
+
+        assert N.abs(resistor_v[-1] + 0.233534539103) < 1e-3
+
+    @testattr(stddist_full = True)
+    def test_simulation_using_rk(self):
+        """
+        Tests a simulation using the explicit Runge-Kutta methods.
+        """
+        for method in range(4):
+            rlc_square = load_fmu(Test_FMUModelCS1.rlc_circuit_square)
+            rlc_square.set("_cs_solver",3)
+            rlc_square.set("_cs_rk_method",method)
+
+            res1 = rlc_square.simulate()
+            resistor_v = res1['resistor.v']
+
+            assert N.abs(resistor_v[-1] + 0.233534539103) < 1e-3
+
+    @testattr(stddist_full = True)
+    def test_simulation_using_rosenbrock(self):
+        """
+        Tests a simulation using the linearly implicit methods.
+        """
+        for method in range(2):
+            rlc_square = load_fmu(Test_FMUModelCS1.rlc_circuit_square)
+            rlc_square.set("_cs_solver",4)
+            rlc_square.set("_cs_rosenbrock_method",method)
+
+            res1 = rlc_square.simulate()
+            resistor_v = res1['resistor.v']
+
+            assert N.abs(resistor_v[-1] + 0.233534539103) < 1e-3
+
     @testattr(stddist_full = True)
     def test_unknown_solver(self):
         rlc = load_fmu(Test_FMUModelCS1.rlc_circuit)
-        rlc.set("_cs_solver",2) #Does not exists
+        rlc.set("_cs_solver",5) #Does not exists
 
         nose.tools.assert_raises(FMUException, rlc.simulate)
 
@@ -21,6 +21,7 @@ Module containing the tests for the FMI interface.
 
 import nose
 import os
+import time
 import numpy as N
 import sys as S
 import scipy.sparse.csc
@@ -265,6 +266,8 @@ class Test_FMUModelCS2:
         cls.terminate = compile_fmu("Terminate",os.path.join(path_to_mofiles,"Terminate.mo"),target="cs", version="2.0")
         cls.assert_fail = compile_fmu("AssertFail",os.path.join(path_to_mofiles,"Terminate.mo"),target="cs", version="2.0")
         cls.initialize_solver = compile_fmu("Inputs.DiscChange",os.path.join(path_to_mofiles,"InputTests.mo"),target="cs", version="2.0")
+        cls.smooth_input = compile_fmu("Inputs.SmoothInput",os.path.join(path_to_mofiles,"InputTests.mo"),target="cs", version="2.0")
+        cls.blocked_step = compile_fmu("Inputs.BlockedStep",os.path.join(path_to_mofiles,"InputTests.mo"),target="cs", version="2.0")
     
     @testattr(stddist_full = True)
     def test_reinitialize_solver(self):
@@ -279,6 +282,124 @@ class Test_FMUModelCS2:
         flag = model.do_step(0.1, 0.1)
         assert flag == 0
         
+    def simulate_smooth_input(self, reinit_tol, input_derivatives=False):
+        model = load_fmu(Test_FMUModelCS2.smooth_input, log_level=4)
+        model.set("_log_level", 4)
+        model.set("_cs_input_reinit_tol", reinit_tol)
+        
+        model.initialize()
+        h = 0.01
+        for i in range(100):
+            model.set("u", N.sin(i*h))
+            if input_derivatives:
+                model.set_input_derivatives("u", N.cos(i*h), 1)
+            model.do_step(i*h, h)
+        x = model.get("x")
+        
+        #The solver statistics are logged when the solver is freed
+        model.reset()
+        log = parse_jmi_log(model.get_log_filename())
+        return x, log.find("CVodeStatistics")[-1]
+    
+    @testattr(stddist_full = True)
+    def test_smooth_input_changes(self):
+        x_reinit, stats_reinit = self.simulate_smooth_input(0.0)
+        x_smooth, stats_smooth = self.simulate_smooth_input(0.1)
+        
+        #Every input change re-initializes the solver by default
+        assert stats_reinit.nreinits >= 99
+        #Changes below the tolerance keep the solver history
+        assert stats_smooth.nreinits <= 1
+        assert stats_smooth.nsteps < stats_reinit.nsteps
+        
+        #The inputs are extrapolated linearly between the communication points
+        nose.tools.assert_almost_equal(x_smooth, 1.0 - N.cos(1.0), places=3)
+    
+    @testattr(stddist_full = True)
+    def test_smooth_input_changes_with_derivatives(self):
+        x_smooth, stats_smooth = self.simulate_smooth_input(0.1, input_derivatives=True)
+        
+        #The input derivatives are used instead of the extrapolation
+        assert stats_smooth.nreinits <= 1
+        nose.tools.assert_almost_equal(x_smooth, 1.0 - N.cos(1.0), places=4)
+    
+    #Created by the test to release the step of Inputs.BlockedStep
+    release_file = "BlockedStep.release"
+    
+    def teardown(self):
+        if os.path.exists(self.release_file):
+            os.remove(self.release_file)
+    
+    def start_async_step(self):
+        if os.path.exists(self.release_file):
+            os.remove(self.release_file)
+        model = load_fmu(Test_FMUModelCS2.blocked_step)
+        model.set("_cs_async_do_step", True)
+        model.set("_cs_solver", 1)
+        model.set("_cs_step_size", 0.01)
+        model.initialize()
+        
+        #The step blocks after t=0.5 until the test releases it, the fixed
+        #integrator steps make sure that it is cancelled before t=1
+        status = model.do_step(0.0, 1.0)
+        assert status == fmi.FMI_PENDING
+        return model
+    
+    def release_async_step(self):
+        open(self.release_file, "w").close()
+    
+    def wait_for_async_step(self, model):
+        while model.get_status(fmi.FMI2_DO_STEP_STATUS) == fmi.FMI_PENDING:
+            time.sleep(0.01)
+        return model.get_status(fmi.FMI2_DO_STEP_STATUS)
+    
+    @testattr(stddist_full = True)
+    def test_async_step_cancel(self):
+        model = self.start_async_step()
+        
+        #Only the status can be accessed while the step is pending
+        nose.tools.assert_raises(FMUException, model.get, "x")
+        nose.tools.assert_raises(FMUException, model.set, "u", 1.0)
+        assert model.do_step(0.0, 1.0) == fmi.FMI_ERROR
+        assert model.get_status(fmi.FMI2_DO_STEP_STATUS) == fmi.FMI_PENDING
+        assert model.get_real_status(fmi.FMI2_LAST_SUCCESSFUL_TIME) < 1.0
+        
+        #The cancelled step stops after the released integrator step
+        model.cancel_step()
+        self.release_async_step()
+        assert self.wait_for_async_step(model) == fmi.FMI_ERROR
+        
+        #The model is accessible again and the step stopped early
+        assert model.get_real_status(fmi.FMI2_LAST_SUCCESSFUL_TIME) < 1.0
+        model.set("u", 1.0)
+        assert N.isfinite(model.get("x"))
+    
+    @testattr(stddist_full = True)
+    def test_async_step_finished(self):
+        model = load_fmu(Test_FMUModelCS2.smooth_input)
+        model.set("_cs_async_do_step", True)
+        model.initialize()
+        
+        model.set("u", 2.0)
+        assert model.do_step(0.0, 1.0) == fmi.FMI_PENDING
+        assert self.wait_for_async_step(model) == fmi.FMI_OK
+        nose.tools.assert_almost_equal(model.get_real_status(fmi.FMI2_LAST_SUCCESSFUL_TIME), 1.0)
+        nose.tools.assert_almost_equal(model.get("x"), 2.0)
+    
+    @testattr(stddist_full = True)
+    def test_async_step_free_pending(self):
+        model = self.start_async_step()
+        
+        #Freeing the instance cancels the step and waits for the worker
+        self.release_async_step()
+        model.free_instance()
+        
+        model = self.start_async_step()
+        self.release_async_step()
+        model.reset()
+        model.initialize()
+        nose.tools.assert_almost_equal(model.get("x"), 0.0)
+    
     @testattr(stddist_full = True)
     def test_assert_fail(self):
         model = load_fmu(Test_FMUModelCS2.assert_fail)
@@ -1384,6 +1505,192 @@ class Test_FMUModelME2:
             bounce.reset()
 
 
+class Test_Incremental_Parameters:
+    """
+    Tests the compiler option incremental_parameter_evaluation.
+    """
+    @classmethod
+    def setUpClass(cls):
+        """
+        Sets up the test class.
+        """
+        file_name = os.path.join(path_to_mofiles, "ParameterDependencies.mo")
+        cls.complete_name = compile_fmu("ParameterDependencies.Chain", file_name, target="me", version="2.0",
+                                        compile_to="ParameterDependencies_Chain_complete.fmu")
+        cls.incremental_name = compile_fmu("ParameterDependencies.Chain", file_name, target="me", version="2.0",
+                                           compile_to="ParameterDependencies_Chain_incremental.fmu",
+                                           compiler_options={"incremental_parameter_evaluation":True})
+    
+    @testattr(stddist_full = True)
+    def test_set_get(self):
+        complete = load_fmu(self.complete_name)
+        incremental = load_fmu(self.incremental_name)
+        
+        for model in [complete, incremental]:
+            model.set("a[1]", 3.0)
+            model.set("a[1000]", 5.0)
+            nose.tools.assert_almost_equal(model.get("b[1]"), 6.0)
+            nose.tools.assert_almost_equal(model.get("b[2]"), 4.0)
+            nose.tools.assert_almost_equal(model.get("d"), 17.0)
+            nose.tools.assert_almost_equal(model.get("x"), 17.0)
+            model.set("a[2]", 7.0)
+            nose.tools.assert_almost_equal(model.get("b[2]"), 14.0)
+            nose.tools.assert_almost_equal(model.get("d"), 17.0)
+        
+        incremental.initialize()
+        complete.initialize()
+        nose.tools.assert_almost_equal(incremental.get("der(x)"), complete.get("der(x)"))
+    
+    @testattr(stddist_full = True)
+    def test_set_get_sequence(self):
+        """
+        Interleaves sets of independent parameters with gets of different
+        dependent parameters, so that gets only see part of the changes.
+        """
+        complete = load_fmu(self.complete_name)
+        incremental = load_fmu(self.incremental_name)
+        
+        a = N.arange(1.0, 1001.0)
+        for i in range(20):
+            k = (37 * i) % 1000
+            a[k] = 0.5 * i - 3.0
+            a[999] = a[999] + 1.0
+            for model in [complete, incremental]:
+                model.set("a[%d]" % (k + 1), a[k])
+                model.set("a[1000]", a[999])
+            nose.tools.assert_almost_equal(incremental.get("b[%d]" % (k + 1)), 2 * a[k])
+            if i % 2 == 0:
+                nose.tools.assert_almost_equal(incremental.get("d"), 2 * a[0] + 2 * a[999] + 1)
+            for name in ["b[1]", "b[%d]" % (k + 1), "b[1000]", "c", "d", "x"]:
+                nose.tools.assert_almost_equal(incremental.get(name), complete.get(name))
+        
+        nose.tools.assert_almost_equal(incremental.get("c"), 2 * a[0] + 2 * a[999])
+        nose.tools.assert_almost_equal(incremental.get("x"), 2 * a[0] + 2 * a[999] + 1)
+        N.testing.assert_array_almost_equal(incremental.get(["b[%d]" % (k + 1) for k in range(1000)]), 2 * a)
+
+class Test_Demand_Driven_Evaluation:
+    """
+    Tests that the compiler option demand_driven_evaluation gives the same
+    values as complete evaluations.
+    """
+    @classmethod
+    def setUpClass(cls):
+        """
+        Sets up the test class.
+        """
+        file_name = os.path.join(path_to_mofiles, "NonLinear.mo")
+        for target in ["me", "cs"]:
+            setattr(cls, "complete_%s" % target, compile_fmu("NonLinear.DemandDriven1", file_name, target=target, version="2.0",
+                                                            compile_to="NonLinear_DemandDriven1_complete_%s.fmu" % target))
+            setattr(cls, "partial_%s" % target, compile_fmu("NonLinear.DemandDriven1", file_name, target=target, version="2.0",
+                                                           compile_to="NonLinear_DemandDriven1_partial_%s.fmu" % target,
+                                                           compiler_options={"demand_driven_evaluation":True}))
+    
+    def assert_same_values(self, complete, partial, names):
+        for name in names:
+            nose.tools.assert_almost_equal(partial.get(name)[0], complete.get(name)[0], places=12)
+    
+    @testattr(stddist_full = True)
+    def test_set_get_me(self):
+        complete = load_fmu(self.complete_me)
+        partial = load_fmu(self.partial_me)
+        
+        for model in [complete, partial]:
+            model.initialize()
+            model.event_update()
+            model.enter_continuous_time_mode()
+        
+        for i in range(1, 6):
+            for model in [complete, partial]:
+                model.time = 0.1 * i
+                model.continuous_states = N.array([1.0 + 0.2 * i])
+            #Only the part that does not depend on the state first
+            self.assert_same_values(complete, partial, ["z"])
+            self.assert_same_values(complete, partial, ["w", "y"])
+            
+            for model in [complete, partial]:
+                model.set("u", 1.0 - 0.3 * i)
+            self.assert_same_values(complete, partial, ["y", "z"])
+            
+            for model in [complete, partial]:
+                model.continuous_states = N.array([2.0 - 0.1 * i])
+            N.testing.assert_array_almost_equal(partial.get_derivatives(), complete.get_derivatives(), decimal=12)
+            self.assert_same_values(complete, partial, ["w", "z", "y"])
+    
+    @testattr(stddist_full = True)
+    def test_set_get_cs_ida(self):
+        """
+        The IDA solver evaluates the block residuals with the iteration
+        variables of the integrator, the values seen after a step must not
+        be left over from those evaluations.
+        """
+        complete = load_fmu(self.complete_cs)
+        partial = load_fmu(self.partial_cs)
+        
+        for model in [complete, partial]:
+            model.set("_cs_solver", 2)
+            model.setup_experiment()
+            model.initialize()
+        
+        t = 0.0
+        for i in range(10):
+            for model in [complete, partial]:
+                model.set("u", 1.0 + 0.1 * i)
+                nose.tools.assert_equal(model.do_step(t, 0.1, True), 0)
+            t = t + 0.1
+            self.assert_same_values(complete, partial, ["z"])
+            self.assert_same_values(complete, partial, ["w", "y", "x"])
+
+class Test_CS_Right_Hand_Side:
+    """
+    Compares the right hand side of the co-simulation integrator, which sets
+    the states, time and inputs and gets the derivatives internally, with
+    the FMI setters and getters of model exchange.
+    """
+    
+    @classmethod
+    def setUpClass(cls):
+        """
+        Compile the test model.
+        """
+        file_name = os.path.join(path_to_mofiles, "InputTests.mo")
+        cls.me = compile_fmu("Inputs.NegatedAliasStates", file_name, target="me", version="2.0")
+        cls.cs = compile_fmu("Inputs.NegatedAliasStates", file_name, target="cs", version="2.0")
+    
+    @testattr(stddist_full = True)
+    def test_derivatives_negated_alias_states(self):
+        h = 0.1
+        cs = load_fmu(Test_CS_Right_Hand_Side.cs)
+        me = load_fmu(Test_CS_Right_Hand_Side.me)
+        
+        #One explicit Euler step per communication step
+        cs.set("_cs_solver", 1)
+        cs.set("_cs_step_size", h)
+        cs.initialize()
+        me.initialize()
+        me.event_update()
+        me.enter_continuous_time_mode()
+        
+        #One of x and y is the state, the other is its negated alias
+        names = list(me.get_states_list().keys())
+        assert len(names) == 2
+        
+        for i in range(5):
+            t = i*h
+            u = 1.0 + N.sin(t)
+            cs.set("u", u)
+            cs.set_input_derivatives("u", N.cos(t), 1)
+            me.set("u", u)
+            
+            states = N.array(cs.get(names)).ravel()
+            me.time = t
+            me.continuous_states = states
+            der = me.get_derivatives()
+            
+            cs.do_step(t, h)
+            N.testing.assert_array_almost_equal(N.array(cs.get(names)).ravel(), states + h*der, decimal=12)
+            nose.tools.assert_almost_equal(cs.get("y")[0], -cs.get("x")[0], places=14)
+
 class Test_Result_Writing:
     """
     This test the result writing functionality.
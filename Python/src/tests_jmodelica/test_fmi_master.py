@@ -0,0 +1,102 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# Copyright (C) 2017 Modelon AB
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, version 3 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+"""
+Module containing the tests for the Master algorithm on compiled FMUs.
+"""
+
+import nose
+import os
+import numpy as N
+
+from tests_jmodelica import testattr, get_files_path
+from pymodelica.compiler import compile_fmu
+from pyfmi import Master
+from pyfmi import load_fmu
+
+path_to_mofiles = os.path.join(get_files_path(), 'Modelica')
+
+
+class Test_Master_Connection_Exchange:
+    """
+    Compares the compiled connection exchange with the general exchange,
+    the Dummy models in the PyFMI tests never take the compiled path.
+    """
+
+    @classmethod
+    def setUpClass(cls):
+        """
+        Sets up the test class.
+        """
+        cls.qc_sub1 = compile_fmu("QuarterCar.QuarterCarWithoutFeedThrough1", os.path.join(path_to_mofiles,"CoupledME.mo"), target="cs", version="2.0")
+        cls.qc_sub2 = compile_fmu("QuarterCar.QuarterCarWithoutFeedThrough2", os.path.join(path_to_mofiles,"CoupledME.mo"), target="cs", version="2.0")
+
+    def simulate_quarter_car(self, fast_exchange, extrapolation_order, execution="serial", log_level=2):
+        model_chassi = load_fmu(Test_Master_Connection_Exchange.qc_sub1, log_level=log_level)
+        model_wheel  = load_fmu(Test_Master_Connection_Exchange.qc_sub2, log_level=log_level)
+
+        models = [model_chassi, model_wheel]
+        connections = [(model_chassi,"x_chassi",model_wheel,"x_chassi"),
+                       (model_chassi,"v_chassi",model_wheel,"v_chassi"),
+                       (model_wheel,"x_wheel",model_chassi,"x_wheel"),
+                       (model_wheel,"v_wheel",model_chassi,"v_wheel")]
+
+        master = Master(models, connections)
+
+        opts = master.simulate_options()
+        opts["step_size"] = 0.001
+        opts["extrapolation_order"] = extrapolation_order
+        opts["fast_connection_exchange"] = fast_exchange
+        opts["execution"] = execution
+        opts["result_handling"] = "memory"
+
+        assert master.check_support_connection_exchange(opts) == (1 if fast_exchange else 0)
+
+        res = master.simulate(final_time=0.5, options=opts)
+
+        return [res[model_chassi]["x_chassi"], res[model_chassi]["v_chassi"],
+                res[model_wheel]["x_wheel"], res[model_wheel]["v_wheel"]]
+
+    def assert_same_trajectories(self, res_fast, res_general):
+        for fast, general in zip(res_fast, res_general):
+            assert len(fast) == len(general)
+            N.testing.assert_array_almost_equal(fast, general, decimal=10)
+
+    @testattr(stddist_full = True)
+    def test_compiled_exchange_constant_extrapolation(self):
+        res_general = self.simulate_quarter_car(False, 0)
+        res_fast    = self.simulate_quarter_car(True, 0)
+
+        self.assert_same_trajectories(res_fast, res_general)
+
+    @testattr(stddist_full = True)
+    def test_compiled_exchange_linear_extrapolation(self):
+        res_general = self.simulate_quarter_car(False, 1)
+        res_fast    = self.simulate_quarter_car(True, 1)
+
+        self.assert_same_trajectories(res_fast, res_general)
+
+    @testattr(stddist_full = True)
+    def test_compiled_exchange_parallel_with_logging(self):
+        """
+        The FMU logger callback takes the GIL, with a high log level it is
+        called from the threads gathering and scattering the connection data.
+        """
+        res_general = self.simulate_quarter_car(False, 1)
+        res_fast    = self.simulate_quarter_car(True, 1, execution="parallel", log_level=7)
+
+        self.assert_same_trajectories(res_fast, res_general)
@@ -76,6 +76,12 @@ fmiStatus fmi1_cs_do_step(fmiComponent c, fmiReal currentCommunicationPoint,
     top_node = jmi_log_enter_fmt(ode_problem->log, logInfo, "DoStep", 
             "Starting a do step at internal <t:%E> with end <t:%E>", ode_problem->time, time_final);
     
+    /* Smooth input changes are not re-initializing the solver, extrapolate
+     * the inputs without input derivatives to keep the right hand side continuous */
+    if (((fmi1_me_t*)cs_data->fmix_me)->jmi.options.cs_input_reinit_tol > 0.0) {
+        jmi_cs_extrapolate_input_history(cs_data, &((fmi1_me_t*)cs_data->fmix_me)->jmi, ode_problem->time);
+    }
+    
     /* For the active real inputs, get the current value */
     real_inputs = cs_data->real_inputs;
     for (i = 0; i < cs_data->n_real_inputs; i++) {
@@ -230,6 +236,7 @@ fmiComponent fmi1_cs_instantiate_slave(fmiString instanceName, fmiString GUID, f
     ode_callbacks.event_update_func = fmi1_cs_event_update;
     ode_sizes.states = jmi->n_real_x;
     ode_sizes.event_indicators = jmi->n_relations;
+    ode_sizes.algebraics = 0;
     component->cs_data = jmi_new_cs_data(fmi1_me, jmi->n_real_u);
     component->ode_problem = jmi_new_ode_problem(&(fmi1_me->jmi.jmi_callbacks),
                                                  component->cs_data,
@@ -301,6 +308,12 @@ fmiStatus fmi1_cs_initialize_slave(fmiComponent c, fmiReal tStart,
     options.method                  = fmi1_me->jmi.options.cs_solver;
     options.euler_options.step_size = fmi1_me->jmi.options.cs_step_size;
     options.cvode_options.rel_tol   = fmi1_me->jmi.options.cs_rel_tol;
+    options.rk_options.method       = fmi1_me->jmi.options.cs_rk_method;
+    options.rosenbrock_options.method                   = fmi1_me->jmi.options.cs_rosenbrock_method;
+    options.rosenbrock_options.jacobian_update_interval = fmi1_me->jmi.options.cs_jacobian_update_interval;
+    options.cvode_options.linear_solver      = fmi1_me->jmi.options.cs_linear_solver;
+    options.cvode_options.precond_block_size = fmi1_me->jmi.options.cs_precond_block_size;
+    options.cvode_options.num_threads        = fmi1_me->jmi.options.cs_num_threads;
     options.experimental_mode       = fmi1_me->jmi.options.cs_experimental_mode;
     
     /* Create solver */
@@ -366,10 +379,13 @@ fmiStatus fmi1_cs_set_real(fmiComponent c, const fmiValueReference vr[], size_t
         jmi_ode_solver_external_event(fmi1_cs->ode_problem->ode_solver);
     }
     if (fmi1_cs->ode_problem->ode_solver != NULL &&
-        jmi_cs_check_input_change(jmi, vr, nvr, value))
+        jmi_cs_check_input_change(jmi, vr, nvr, value, jmi->options.cs_input_reinit_tol))
     {
         jmi_ode_solver_need_to_initialize(fmi1_cs->ode_problem->ode_solver);
     }
+    if (jmi->options.cs_input_reinit_tol > 0.0) {
+        jmi_cs_record_input_history(fmi1_cs->cs_data, jmi, vr, nvr, value, fmi1_cs->ode_problem->time);
+    }
     
         
     return fmi1_me_set_real(fmi1_cs->cs_data->fmix_me, vr, nvr, value);
@@ -499,30 +515,14 @@ fmiStatus fmi1_cs_get_string_status(fmiComponent c, const fmiStatusKind s, fmiSt
 }
 
 fmiStatus fmi1_cs_set_real_inputs(jmi_cs_data_t* cs_data, fmiReal time) {
-    jmi_cs_real_input_t* real_inputs;
-    fmiStatus retval;
-    fmiReal value;
-    size_t i,j;
+    size_t n;
     
-    real_inputs = cs_data->real_inputs;
-    for (i = 0; i < cs_data->n_real_inputs; i++) {
-        if (real_inputs[i].active == fmiFalse) {
-            continue;
-        }
-        value = real_inputs[i].value;
-        for (j = 0; j < JMI_CS_MAX_INPUT_DERIVATIVES; j++) {
-            value += pow((time - real_inputs[i].tn), j + 1.0) *
-                     real_inputs[i].input_derivatives[j] /
-                     real_inputs[i].input_derivatives_factor[j];
-        }
-        
-        retval = fmi1_me_set_real(cs_data->fmix_me, &(real_inputs[i].vr),
-                                  1, &value);
-        if (retval != fmiOK) {
-            return fmiError;
-        }
+    n = jmi_cs_extrapolate_real_inputs(cs_data, time);
+    if (n == 0) {
+        return fmiOK;
     }
-    return fmiOK;
+    
+    return fmi1_me_set_real(cs_data->fmix_me, cs_data->input_vrs, n, cs_data->input_values);
 }
 
 fmiStatus fmi1_cs_set_time(fmiComponent c, fmiReal time){
@@ -277,8 +277,17 @@ fmiStatus fmi1_me_initialize(fmiComponent c, fmiBoolean toleranceControlled, fmi
     return fmiOK;
 }
 
+/* fmiWarning if the time budget of the equation blocks was exhausted in a model evaluation of the call */
+static fmiStatus fmi1_me_time_budget_status(fmiComponent c, long int nbr_exhausted) {
+    if (((fmi1_me_t *)c)->jmi.block_solver_deadline.nbr_exhausted != nbr_exhausted) {
+        return fmiWarning;
+    }
+    return fmiOK;
+}
+
 fmiStatus fmi1_me_get_derivatives(fmiComponent c, fmiReal derivatives[] , size_t nx) {
     fmiInteger retval;
+    long int nbr_exhausted;
     fmi1_me_t* self = (fmi1_me_t*)c;
     jmi_t* jmi = &self->jmi;
     
@@ -286,16 +295,18 @@ fmiStatus fmi1_me_get_derivatives(fmiComponent c, fmiReal derivatives[] , size_t
         return fmiFatal;
     }
     
+    nbr_exhausted = jmi->block_solver_deadline.nbr_exhausted;
     retval = jmi_get_derivatives(jmi, derivatives, nx);
     if (retval != 0) {
         return fmiError;
     }
     
-    return fmiOK;
+    return fmi1_me_time_budget_status(c, nbr_exhausted);
 }
 
 fmiStatus fmi1_me_get_event_indicators(fmiComponent c, fmiReal eventIndicators[], size_t ni) {
     fmiInteger retval;
+    long int nbr_exhausted;
     fmi1_me_t* self = (fmi1_me_t*)c;
     jmi_t* jmi = &self->jmi;
     
@@ -303,16 +314,18 @@ fmiStatus fmi1_me_get_event_indicators(fmiComponent c, fmiReal eventIndicators[]
         return fmiFatal;
     }
     
+    nbr_exhausted = jmi->block_solver_deadline.nbr_exhausted;
     retval = jmi_get_event_indicators(jmi, eventIndicators, ni);
     if (retval != 0) {
         return fmiError;
     }
     
-    return fmiOK;
+    return fmi1_me_time_budget_status(c, nbr_exhausted);
 }
 
 fmiStatus fmi1_me_get_real(fmiComponent c, const fmiValueReference vr[], size_t nvr, fmiReal value[]) {
     fmiInteger retval;
+    long int nbr_exhausted;
     fmi1_me_t* self = (fmi1_me_t*)c;
     jmi_t* jmi = &self->jmi;
 
@@ -320,57 +333,64 @@ fmiStatus fmi1_me_get_real(fmiComponent c, const fmiValueReference vr[], size_t
         return fmiFatal;
     }
 
+    nbr_exhausted = jmi->block_solver_deadline.nbr_exhausted;
     retval = jmi_get_real(jmi, vr, nvr, value);
     if (retval != 0) {
         return fmiError;
     }
 
-    return fmiOK;
+    return fmi1_me_time_budget_status(c, nbr_exhausted);
 }
 
 fmiStatus fmi1_me_get_integer(fmiComponent c, const fmiValueReference vr[], size_t nvr, fmiInteger value[]) {
     fmiInteger retval;
+    long int nbr_exhausted;
     
     if (c == NULL) {
         return fmiFatal;
     }
 
+    nbr_exhausted = ((fmi1_me_t *)c)->jmi.block_solver_deadline.nbr_exhausted;
     retval = jmi_get_integer(&((fmi1_me_t *)c)->jmi, vr, nvr, value);
     if (retval != 0) {
         return fmiError;
     }
     
-    return fmiOK;
+    return fmi1_me_time_budget_status(c, nbr_exhausted);
 }
 
 fmiStatus fmi1_me_get_boolean(fmiComponent c, const fmiValueReference vr[], size_t nvr, fmiBoolean value[]) {
     fmiInteger retval;
+    long int nbr_exhausted;
     
     if (c == NULL) {
         return fmiFatal;
     }
 
+    nbr_exhausted = ((fmi1_me_t *)c)->jmi.block_solver_deadline.nbr_exhausted;
     retval = jmi_get_boolean(&((fmi1_me_t *)c)->jmi, vr, nvr, value);
     if (retval != 0) {
         return fmiError;
     }
     
-    return fmiOK;
+    return fmi1_me_time_budget_status(c, nbr_exhausted);
 }
 
 fmiStatus fmi1_me_get_string(fmiComponent c, const fmiValueReference vr[], size_t nvr, fmiString  value[]) {
     fmiInteger retval;
+    long int nbr_exhausted;
     
     if (c == NULL) {
         return fmiFatal;
     }
 
+    nbr_exhausted = ((fmi1_me_t *)c)->jmi.block_solver_deadline.nbr_exhausted;
     retval = jmi_get_string(&((fmi1_me_t *)c)->jmi, vr, nvr, value);
     if (retval != 0) {
         return fmiError;
     }
 
-    return fmiOK;
+    return fmi1_me_time_budget_status(c, nbr_exhausted);
 }
 
 jmi_t* fmi1_me_get_jmi_t(fmiComponent c) {
@@ -21,10 +21,14 @@
 #include "fmi2_me.h"
 #include "fmi2_cs.h"
 #include "fmi2FunctionTypes.h"
+#include "jmi_block_residual.h"
 
 /* Forward declarations: */
 int fmi2_cs_rhs_fcn(jmi_real_t t, jmi_real_t *y, jmi_real_t *rhs, jmi_ode_sizes_t sizes, void* problem_data);
 int fmi2_cs_root_fcn(jmi_real_t t, jmi_real_t *y, jmi_real_t *root, jmi_ode_sizes_t sizes, void* problem_data);
+int fmi2_cs_dir_der_fcn(jmi_real_t t, jmi_real_t *y, jmi_real_t *v, jmi_real_t *jv, jmi_ode_sizes_t sizes, void* problem_data);
+int fmi2_cs_dae_res_fcn(jmi_real_t t, jmi_real_t *y, jmi_real_t *yp, jmi_real_t *res, jmi_ode_sizes_t sizes, void* problem_data);
+int fmi2_cs_dae_alg_fcn(jmi_real_t *w, jmi_real_t *nominals, jmi_ode_sizes_t sizes, void* problem_data);
 int fmi2_cs_completed_integrator_step(char* step_event, char* terminate, void* problem_data);
 jmi_ode_status_t fmi2_cs_event_update(jmi_ode_problem_t *problem);
 
@@ -41,6 +45,10 @@ fmi2Status fmi2_set_real_input_derivatives(fmi2Component c,
         return fmi2Fatal;
     }
     
+    if (fmi2_cs_step_pending(c)) {
+        return fmi2Error;
+    }
+    
     retval = jmi_cs_set_real_input_derivatives(cs_data, log, vr, nvr, order, value);
     if (retval != 0) {
         return fmi2Error;
@@ -56,56 +64,46 @@ fmi2Status fmi2_get_real_output_derivatives(fmi2Component c,
     return fmi2Error;
 }
 
-fmi2Status fmi2_do_step(fmi2Component c, fmi2Real currentCommunicationPoint,
-                        fmi2Real    communicationStepSize,
-                        fmi2Boolean noSetFMUStatePriorToCurrentPoint) {
-    
-    fmi2_cs_t* fmi2_cs;
+/* Performs the integration of a step in the calling thread */
+static fmi2Status fmi2_cs_do_step_sync(fmi2_cs_t* fmi2_cs, fmi2Real time_final) {
     jmi_ode_problem_t* ode_problem;
     jmi_cs_data_t* cs_data;
     jmi_cs_real_input_t* real_inputs;
     int flag;
     size_t i;
     jmi_ode_status_t retval;
-    fmi2Real time_final = currentCommunicationPoint + communicationStepSize;
-
-    
-    if (c == NULL) {
-        return fmi2Fatal;
-    }
-
-    if (((fmi2_me_t*)c)->fmu_mode != continuousTimeMode) { /* slaveInitialized */
-        jmi_log_node(((fmi2_me_t *)c)->jmi.log, logError, "FMIState",
-            "Can only do a step if the model is an initialized slave.");
-        return fmi2Error;
-    }
-
-    if (((fmi2_me_t*)c)->stopTime < time_final-JMI_ALMOST_EPS*time_final) {
-        jmi_log_node(((fmi2_me_t *)c)->jmi.log, logError, "DoStep",
-            "Cannot take a step past the <stop_time: %g>. Asked <final_time: %g>.",
-            ((fmi2_me_t*)c)->stopTime, time_final);
-        return fmi2Error;
-    }
+    long int nbr_exhausted;
+    fmi2Component c = (fmi2Component)fmi2_cs;
 
-    fmi2_cs = (fmi2_cs_t*)c;
     ode_problem = fmi2_cs->ode_problem;
     cs_data = fmi2_cs->cs_data;
     
-    /* For the active real inputs, get the current input value */
+    /* Smooth input changes are not re-initializing the solver, extrapolate
+     * the inputs without input derivatives to keep the right hand side continuous */
+    if (((fmi2_me_t*)c)->jmi.options.cs_input_reinit_tol > 0.0) {
+        jmi_cs_extrapolate_input_history(cs_data, &((fmi2_me_t*)c)->jmi, ode_problem->time);
+    }
+    
+    /* For the active real inputs, get the current input value. This may run in the
+     * worker thread of an asynchronous step, so the FMI getter is not used. */
     real_inputs = cs_data->real_inputs;
     for (i = 0; i < cs_data->n_real_inputs; i++) {
         if (real_inputs[i].active == fmi2True) {
             real_inputs[i].tn = ode_problem->time;
-            flag = fmi2_get_real(cs_data->fmix_me, &(real_inputs[i].vr),
-                                 1, &(real_inputs[i].value));
-            if (flag != fmi2OK) {
+            flag = jmi_get_real(&((fmi2_me_t*)c)->jmi, &(real_inputs[i].vr),
+                                1, &(real_inputs[i].value));
+            if (flag != 0) {
                 jmi_log_node(ode_problem->log, logError, "CoSimulationInputs",
                     "Failed to get the current value of real inputs.");
                 return fmi2Error;
             }
+            if (jmi_value_ref_is_negated(real_inputs[i].vr)) {
+                real_inputs[i].value = -real_inputs[i].value;
+            }
         }
     }
 
+    nbr_exhausted = ((fmi2_me_t*)c)->jmi.block_solver_deadline.nbr_exhausted;
     retval = jmi_ode_solver_solve(ode_problem->ode_solver, time_final);
     if (retval == JMI_ODE_ERROR) {
         jmi_log_node(ode_problem->log, logError, "DoStep",
@@ -120,15 +118,353 @@ fmi2Status fmi2_do_step(fmi2Component c, fmi2Real currentCommunicationPoint,
         real_inputs[i].active = fmi2False;
     }
     
-    return fmi2OK;
+    return fmi2_me_time_budget_status(c, nbr_exhausted);
+}
+
+#ifndef NO_FILE_SYSTEM
+#define FMI2_CS_ASYNC
+#endif
+
+#ifdef FMI2_CS_ASYNC
+
+#ifdef _MSC_VER
+#include <windows.h>
+typedef HANDLE             fmi2_cs_thread_t;
+typedef CRITICAL_SECTION   fmi2_cs_mutex_t;
+typedef CONDITION_VARIABLE fmi2_cs_cond_t;
+#define fmi2_cs_mutex_init(m)      InitializeCriticalSection(m)
+#define fmi2_cs_mutex_destroy(m)   DeleteCriticalSection(m)
+#define fmi2_cs_mutex_lock(m)      EnterCriticalSection(m)
+#define fmi2_cs_mutex_unlock(m)    LeaveCriticalSection(m)
+#define fmi2_cs_cond_init(cv)      InitializeConditionVariable(cv)
+#define fmi2_cs_cond_destroy(cv)
+#define fmi2_cs_cond_wait(cv, m)   SleepConditionVariableCS(cv, m, INFINITE)
+#define fmi2_cs_cond_broadcast(cv) WakeAllConditionVariable(cv)
+#else
+/* Assume pthreads is available, as in jmi_global.c. */
+#define _MULTI_THREADED
+#ifdef _WIN32 /* MinGW only: define use static lib and specific include */
+#define PTW32_STATIC_LIB
+#endif
+#include <pthread.h>
+typedef pthread_t          fmi2_cs_thread_t;
+typedef pthread_mutex_t    fmi2_cs_mutex_t;
+typedef pthread_cond_t     fmi2_cs_cond_t;
+#define fmi2_cs_mutex_init(m)      pthread_mutex_init(m, NULL)
+#define fmi2_cs_mutex_destroy(m)   pthread_mutex_destroy(m)
+#define fmi2_cs_mutex_lock(m)      pthread_mutex_lock(m)
+#define fmi2_cs_mutex_unlock(m)    pthread_mutex_unlock(m)
+#define fmi2_cs_cond_init(cv)      pthread_cond_init(cv, NULL)
+#define fmi2_cs_cond_destroy(cv)   pthread_cond_destroy(cv)
+#define fmi2_cs_cond_wait(cv, m)   pthread_cond_wait(cv, m)
+#define fmi2_cs_cond_broadcast(cv) pthread_cond_broadcast(cv)
+#endif
+
+struct fmi2_cs_async_t {
+    fmi2_cs_thread_t thread;
+    fmi2_cs_mutex_t  mutex;             /**< \brief Protects all fields below. */
+    fmi2_cs_cond_t   cond;              /**< \brief Signals requested steps, finished steps and quit. */
+    int              pending;           /**< \brief A step is requested or running. */
+    int              cancel;            /**< \brief The running step should stop after the current integrator step. */
+    int              quit;              /**< \brief The worker thread should exit. */
+    fmi2Real         time_final;        /**< \brief End time of the requested step. */
+    fmi2Real         time;              /**< \brief Time reached by the running step. */
+    fmi2Status       status;            /**< \brief Result of the latest finished step. */
+    int              nbr_rejected;      /**< \brief Calls rejected while the step was pending, logged when it has finished. */
+    char             pending_status[128];
+};
+
+static void fmi2_cs_async_worker(fmi2_cs_t* fmi2_cs) {
+    fmi2_cs_async_t* async = fmi2_cs->async;
+    const fmi2CallbackFunctions* functions = fmi2_cs->fmi2_me.fmi_functions;
+    fmi2Status status;
+    fmi2Real time_final;
+    
+    fmi2_cs_mutex_lock(&async->mutex);
+    for (;;) {
+        while (!async->quit && !async->pending) {
+            fmi2_cs_cond_wait(&async->cond, &async->mutex);
+        }
+        if (async->quit) {
+            break;
+        }
+        time_final = async->time_final;
+        fmi2_cs_mutex_unlock(&async->mutex);
+        
+        status = fmi2_cs_do_step_sync(fmi2_cs, time_final);
+        
+        fmi2_cs_mutex_lock(&async->mutex);
+        if (async->cancel && status != fmi2OK) {
+            jmi_log_node(fmi2_cs->ode_problem->log, logWarning, "CancelStep",
+                "The step was cancelled at <t:%g>.", fmi2_cs->ode_problem->time);
+            status = fmi2Error;
+        }
+        async->status = status;
+        async->pending = FALSE;
+        async->cancel = FALSE;
+        fmi2_cs_cond_broadcast(&async->cond);
+        fmi2_cs_mutex_unlock(&async->mutex);
+        
+        if (functions->stepFinished) {
+            functions->stepFinished(functions->componentEnvironment, status);
+        }
+        fmi2_cs_mutex_lock(&async->mutex);
+    }
+    fmi2_cs_mutex_unlock(&async->mutex);
+}
+
+#ifdef _MSC_VER
+static DWORD WINAPI fmi2_cs_async_thread(LPVOID arg) {
+    fmi2_cs_async_worker((fmi2_cs_t*)arg);
+    return 0;
+}
+
+static int fmi2_cs_thread_create(fmi2_cs_thread_t* thread, fmi2_cs_t* fmi2_cs) {
+    *thread = CreateThread(NULL, 0, fmi2_cs_async_thread, fmi2_cs, 0, NULL);
+    return *thread == NULL;
+}
+
+static void fmi2_cs_thread_join(fmi2_cs_thread_t thread) {
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+#else
+static void* fmi2_cs_async_thread(void* arg) {
+    fmi2_cs_async_worker((fmi2_cs_t*)arg);
+    return NULL;
+}
+
+static int fmi2_cs_thread_create(fmi2_cs_thread_t* thread, fmi2_cs_t* fmi2_cs) {
+    return pthread_create(thread, NULL, fmi2_cs_async_thread, fmi2_cs);
+}
+
+static void fmi2_cs_thread_join(fmi2_cs_thread_t thread) {
+    pthread_join(thread, NULL);
+}
+#endif
+
+/* Starts the worker thread of the instance */
+static int fmi2_cs_async_new(fmi2_cs_t* fmi2_cs) {
+    fmi2_cs_async_t* async = (fmi2_cs_async_t*)calloc(1, sizeof(fmi2_cs_async_t));
+    
+    if (async == NULL) {
+        return -1;
+    }
+    fmi2_cs_mutex_init(&async->mutex);
+    fmi2_cs_cond_init(&async->cond);
+    async->status = fmi2OK;
+    fmi2_cs->async = async;
+    
+    if (fmi2_cs_thread_create(&async->thread, fmi2_cs) != 0) {
+        fmi2_cs_cond_destroy(&async->cond);
+        fmi2_cs_mutex_destroy(&async->mutex);
+        free(async);
+        fmi2_cs->async = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+/* Stops and joins the worker thread of the instance */
+static void fmi2_cs_async_delete(fmi2_cs_t* fmi2_cs) {
+    fmi2_cs_async_t* async = fmi2_cs->async;
+    
+    fmi2_cs_wait_for_step((fmi2Component)fmi2_cs, fmi2True);
+    fmi2_cs_mutex_lock(&async->mutex);
+    async->quit = TRUE;
+    fmi2_cs_cond_broadcast(&async->cond);
+    fmi2_cs_mutex_unlock(&async->mutex);
+    fmi2_cs_thread_join(async->thread);
+    
+    fmi2_cs_cond_destroy(&async->cond);
+    fmi2_cs_mutex_destroy(&async->mutex);
+    free(async);
+    fmi2_cs->async = NULL;
+}
+
+/*
+ * Logs the calls that were rejected during the latest step. The worker thread
+ * uses the log while a step is pending, so this is only done by the calling
+ * thread after the step has finished.
+ */
+static void fmi2_cs_async_log_rejected(fmi2_cs_t* fmi2_cs) {
+    fmi2_cs_async_t* async = fmi2_cs->async;
+    int nbr_rejected = 0;
+    
+    fmi2_cs_mutex_lock(&async->mutex);
+    if (!async->pending) {
+        nbr_rejected = async->nbr_rejected;
+        async->nbr_rejected = 0;
+    }
+    fmi2_cs_mutex_unlock(&async->mutex);
+    
+    if (nbr_rejected > 0) {
+        jmi_log_node(fmi2_cs->ode_problem->log, logError, "StepPending",
+            "<rejected_calls:%d> calls were rejected while an asynchronous step was pending, "
+            "only the status can be queried or the step cancelled.", nbr_rejected);
+    }
+}
+
+/* Rejects the call if a step is pending, without logging since the log is used by the worker thread */
+static int fmi2_cs_async_reject_if_pending(fmi2_cs_t* fmi2_cs) {
+    int pending;
+    
+    if (fmi2_cs->async == NULL) {
+        return FALSE;
+    }
+    fmi2_cs_mutex_lock(&fmi2_cs->async->mutex);
+    pending = fmi2_cs->async->pending;
+    if (pending) {
+        fmi2_cs->async->nbr_rejected++;
+    }
+    fmi2_cs_mutex_unlock(&fmi2_cs->async->mutex);
+    
+    if (!pending) {
+        fmi2_cs_async_log_rejected(fmi2_cs);
+    }
+    return pending;
+}
+
+/* Called after each integrator step, reports the progress and checks for cancellation */
+static void fmi2_cs_async_progress(fmi2_cs_t* fmi2_cs, char* terminate) {
+    fmi2_cs_async_t* async = fmi2_cs->async;
+    
+    fmi2_cs_mutex_lock(&async->mutex);
+    async->time = fmi2_cs->ode_problem->time;
+    if (async->cancel) {
+        terminate[0] = TRUE;
+    }
+    fmi2_cs_mutex_unlock(&async->mutex);
+}
+
+/* Hands the step to the worker thread */
+static fmi2Status fmi2_cs_do_step_async(fmi2_cs_t* fmi2_cs, fmi2Real time_final) {
+    fmi2_cs_async_t* async;
+    
+    if (fmi2_cs->async == NULL && fmi2_cs_async_new(fmi2_cs) != 0) {
+        jmi_log_node(fmi2_cs->ode_problem->log, logError, "DoStep",
+            "Failed to start the thread for asynchronous steps.");
+        return fmi2Error;
+    }
+    
+    async = fmi2_cs->async;
+    fmi2_cs_mutex_lock(&async->mutex);
+    async->time_final = time_final;
+    async->time = fmi2_cs->ode_problem->time;
+    async->cancel = FALSE;
+    async->pending = TRUE;
+    fmi2_cs_cond_broadcast(&async->cond);
+    fmi2_cs_mutex_unlock(&async->mutex);
+    
+    return fmi2Pending;
+}
+
+void fmi2_cs_wait_for_step(fmi2Component c, fmi2Boolean cancel) {
+    fmi2_cs_async_t* async = ((fmi2_cs_t*)c)->async;
+    
+    if (async == NULL) {
+        return;
+    }
+    fmi2_cs_mutex_lock(&async->mutex);
+    if (cancel && async->pending) {
+        async->cancel = TRUE;
+    }
+    while (async->pending) {
+        fmi2_cs_cond_wait(&async->cond, &async->mutex);
+    }
+    fmi2_cs_mutex_unlock(&async->mutex);
+    fmi2_cs_async_log_rejected((fmi2_cs_t*)c);
+}
+
+#else /* FMI2_CS_ASYNC */
+
+#define fmi2_cs_async_reject_if_pending(fmi2_cs) FALSE
+
+void fmi2_cs_wait_for_step(fmi2Component c, fmi2Boolean cancel) {
+}
+
+#endif /* FMI2_CS_ASYNC */
+
+int fmi2_cs_step_pending(fmi2Component c) {
+    if (((fmi2_me_t*)c)->fmu_type != fmi2CoSimulation) {
+        return FALSE;
+    }
+    return fmi2_cs_async_reject_if_pending((fmi2_cs_t*)c);
+}
+
+fmi2Status fmi2_do_step(fmi2Component c, fmi2Real currentCommunicationPoint,
+                        fmi2Real    communicationStepSize,
+                        fmi2Boolean noSetFMUStatePriorToCurrentPoint) {
+    
+    fmi2_cs_t* fmi2_cs;
+    fmi2Real time_final = currentCommunicationPoint + communicationStepSize;
+
+    
+    if (c == NULL) {
+        return fmi2Fatal;
+    }
+    
+    fmi2_cs = (fmi2_cs_t*)c;
+    if (fmi2_cs_step_pending(c)) {
+        return fmi2Error;
+    }
+
+    if (((fmi2_me_t*)c)->fmu_mode != continuousTimeMode) { /* slaveInitialized */
+        jmi_log_node(((fmi2_me_t *)c)->jmi.log, logError, "FMIState",
+            "Can only do a step if the model is an initialized slave.");
+        return fmi2Error;
+    }
+
+    if (((fmi2_me_t*)c)->stopTime < time_final-JMI_ALMOST_EPS*time_final) {
+        jmi_log_node(((fmi2_me_t *)c)->jmi.log, logError, "DoStep",
+            "Cannot take a step past the <stop_time: %g>. Asked <final_time: %g>.",
+            ((fmi2_me_t*)c)->stopTime, time_final);
+        return fmi2Error;
+    }
+
+#ifdef FMI2_CS_ASYNC
+    if (((fmi2_me_t*)c)->jmi.options.cs_async_do_step) {
+        return fmi2_cs_do_step_async(fmi2_cs, time_final);
+    }
+#endif
+    return fmi2_cs_do_step_sync(fmi2_cs, time_final);
 }
 
 fmi2Status fmi2_cancel_step(fmi2Component c) {
+    if (c == NULL) {
+        return fmi2Fatal;
+    }
+    
+#ifdef FMI2_CS_ASYNC
+    if (((fmi2_cs_t*)c)->async != NULL) {
+        fmi2_cs_async_t* async = ((fmi2_cs_t*)c)->async;
+        
+        /* The worker stops after the current integrator step */
+        fmi2_cs_mutex_lock(&async->mutex);
+        if (async->pending) {
+            async->cancel = TRUE;
+        }
+        fmi2_cs_mutex_unlock(&async->mutex);
+    }
+#endif
     return fmi2OK;
 }
 
 fmi2Status fmi2_get_status(fmi2Component c, const fmi2StatusKind s,
                            fmi2Status* value) {
+#ifdef FMI2_CS_ASYNC
+    fmi2_cs_async_t* async = ((fmi2_cs_t*)c)->async;
+    
+    if (s == fmi2DoStepStatus && async != NULL) {
+        fmi2_cs_mutex_lock(&async->mutex);
+        *value = async->pending ? fmi2Pending : async->status;
+        fmi2_cs_mutex_unlock(&async->mutex);
+        if (*value != fmi2Pending) {
+            fmi2_cs_async_log_rejected((fmi2_cs_t*)c);
+        }
+        return fmi2OK;
+    }
+#endif
     return fmi2Discard;
 }
 
@@ -138,6 +474,14 @@ fmi2Status fmi2_get_real_status(fmi2Component c, const fmi2StatusKind s,
     jmi_ode_problem_t* ode_problem = fmi2_cs -> ode_problem;
     
     if (s == fmi2LastSuccessfulTime) {
+#ifdef FMI2_CS_ASYNC
+        if (fmi2_cs->async != NULL) {
+            fmi2_cs_mutex_lock(&fmi2_cs->async->mutex);
+            *value = fmi2_cs->async->pending ? fmi2_cs->async->time : ode_problem->time;
+            fmi2_cs_mutex_unlock(&fmi2_cs->async->mutex);
+            return fmi2OK;
+        }
+#endif
         *value = ode_problem->time;
         return fmi2OK;
     }
@@ -157,6 +501,23 @@ fmi2Status fmi2_get_boolean_status(fmi2Component c, const fmi2StatusKind s,
 
 fmi2Status fmi2_get_string_status(fmi2Component c, const fmi2StatusKind s,
                                   fmi2String* value) {
+#ifdef FMI2_CS_ASYNC
+    fmi2_cs_async_t* async = ((fmi2_cs_t*)c)->async;
+    
+    if (s == fmi2PendingStatus && async != NULL) {
+        fmi2Status retval = fmi2Discard;
+        
+        fmi2_cs_mutex_lock(&async->mutex);
+        if (async->pending) {
+            sprintf(async->pending_status, "Integrating to t=%g, reached t=%g%s",
+                    async->time_final, async->time, async->cancel ? ", cancelling" : "");
+            *value = async->pending_status;
+            retval = fmi2OK;
+        }
+        fmi2_cs_mutex_unlock(&async->mutex);
+        return retval;
+    }
+#endif
     return fmi2Discard;
 }
 
@@ -190,8 +551,14 @@ fmi2Status fmi2_cs_instantiate(fmi2Component c,
     ode_callbacks.root_func = fmi2_cs_root_fcn;
     ode_callbacks.complete_step_func = fmi2_cs_completed_integrator_step;
     ode_callbacks.event_update_func = fmi2_cs_event_update;
+    ode_callbacks.dir_der_func = fmi2_cs_dir_der_fcn;
     ode_sizes.states = jmi->n_real_x;
     ode_sizes.event_indicators = jmi->n_relations;
+    ode_sizes.algebraics = jmi->n_dae_iteration;
+    if (ode_sizes.algebraics > 0) {
+        ode_callbacks.dae_res_func = fmi2_cs_dae_res_fcn;
+        ode_callbacks.dae_alg_func = fmi2_cs_dae_alg_fcn;
+    }
     fmi2_cs->cs_data = jmi_new_cs_data(c, jmi->n_real_u);
     fmi2_cs -> ode_problem = jmi_new_ode_problem(&jmi->jmi_callbacks,
         fmi2_cs->cs_data, ode_callbacks, ode_sizes, jmi->log);
@@ -202,6 +569,11 @@ fmi2Status fmi2_cs_instantiate(fmi2Component c,
 /* Helper method for fmi2_free_instance. */
 void fmi2_cs_free_instance(fmi2Component c) {
     if (c) {
+#ifdef FMI2_CS_ASYNC
+        if (((fmi2_cs_t*)c)->async != NULL) {
+            fmi2_cs_async_delete((fmi2_cs_t*)c);
+        }
+#endif
         jmi_free_ode_solver(((fmi2_cs_t *)c)->ode_problem->ode_solver);
         jmi_free_ode_problem(((fmi2_cs_t*)c)->ode_problem);
         jmi_free_cs_data(((fmi2_cs_t*)c)->cs_data);
@@ -209,84 +581,98 @@ void fmi2_cs_free_instance(fmi2Component c) {
     }
 }
 
-fmi2Status fmi2_cs_set_real_inputs(jmi_cs_data_t* cs_data, fmi2Real time) {
-    jmi_cs_real_input_t* real_inputs;
-    fmi2Status retval;
-    fmi2Real value;
-    fmi2Integer i,j;
+/* Set the time, states and extrapolated inputs directly for the integrator callbacks */
+static int fmi2_cs_set_ode_point(jmi_cs_data_t* cs_data, jmi_real_t t, jmi_real_t *y, size_t nx) {
+    fmi2_me_t* fmi2_me = (fmi2_me_t*)cs_data->fmix_me;
+    size_t n;
     
-    real_inputs = cs_data->real_inputs;
-    for (i = 0; i < cs_data->n_real_inputs; i++) {
-        if (real_inputs[i].active == fmi2False) {
-            continue;
-        }
-        value = real_inputs[i].value;
-        for (j = 0; j < JMI_CS_MAX_INPUT_DERIVATIVES; j++) {
-            value += pow((time - real_inputs[i].tn), j + 1.0) *
-                     real_inputs[i].input_derivatives[j] / 
-                     real_inputs[i].input_derivatives_factor[j];
-        }
-        
-        retval = fmi2_set_real(cs_data->fmix_me, &(real_inputs[i].vr),
-                               1, &value);
-        if (retval != fmi2OK) {
-            return fmi2Error;
-        }
+    if (fmi2_me->stopTime*(1+JMI_ALMOST_EPS) < t) {
+        jmi_log_node(fmi2_me->jmi.log, logError, "Error", "Cannot set a time past the <stop_time: %g>. Asked <time: %g>", fmi2_me->stopTime, t);
+        return -1;
     }
-    return fmi2OK;
+    
+    n = jmi_cs_extrapolate_real_inputs(cs_data, t);
+    return jmi_ode_set_point(&fmi2_me->jmi, t, y, nx, cs_data->input_vrs, cs_data->input_values, n);
 }
 
 int fmi2_cs_rhs_fcn(jmi_real_t t, jmi_real_t *y, jmi_real_t *rhs, jmi_ode_sizes_t sizes, void* problem_data){
-    fmi2Status retval;
     jmi_cs_data_t* cs_data = (jmi_cs_data_t*)problem_data;
+    jmi_t* jmi = &((fmi2_me_t*)cs_data->fmix_me)->jmi;
     
-    /* Set the states */
-    retval = fmi2_set_continuous_states(cs_data->fmix_me, y, sizes.states);
-    if (retval != fmi2OK) {
+    /* Set the states, time and inputs */
+    if (fmi2_cs_set_ode_point(cs_data, t, y, sizes.states) != 0) {
         return -1;
     }
     
-    /* Set the time */
-    retval = fmi2_set_time(cs_data->fmix_me, t);
-    if (retval != fmi2OK) {
-        return -1;
+    /* Evaluate the derivatives */
+    if (sizes.states > 0) {
+        if (jmi_ode_get_derivatives(jmi, rhs, sizes.states) != 0) {
+            return -1;
+        }
     }
     
-    /* Set the inputs */
-    retval = fmi2_cs_set_real_inputs(cs_data, t);
-    if (retval != fmi2OK) {
+    return 0;
+}
+
+int fmi2_cs_dir_der_fcn(jmi_real_t t, jmi_real_t *y, jmi_real_t *v, jmi_real_t *jv, jmi_ode_sizes_t sizes, void* problem_data){
+    jmi_cs_data_t* cs_data = (jmi_cs_data_t*)problem_data;
+    jmi_t* jmi = &((fmi2_me_t*)cs_data->fmix_me)->jmi;
+    
+    /* Set the states, time and inputs */
+    if (fmi2_cs_set_ode_point(cs_data, t, y, sizes.states) != 0) {
         return -1;
     }
     
-    /* Evaluate the derivatives */
-    if (sizes.states > 0) {
-        retval = fmi2_get_derivatives(cs_data->fmix_me, rhs, sizes.states);
-        if (retval != fmi2OK) {
+    /* The integrator usually asks for products at the point of the last right hand side,
+     * then the model variables are up to date and only the derivatives are evaluated */
+    if (jmi->recomputeVariables == 1 && sizes.states > 0) {
+        if (jmi_ode_get_derivatives(jmi, jv, sizes.states) != 0) {
             return -1;
         }
     }
     
-    return 0;
+    return jmi_get_state_directional_derivative(jmi, v, jv, sizes.states);
 }
 
-int fmi2_cs_root_fcn(jmi_real_t t, jmi_real_t *y, jmi_real_t *root, jmi_ode_sizes_t sizes, void* problem_data){
-    fmi2Status retval;
+int fmi2_cs_dae_res_fcn(jmi_real_t t, jmi_real_t *y, jmi_real_t *yp, jmi_real_t *res, jmi_ode_sizes_t sizes, void* problem_data){
     jmi_cs_data_t* cs_data = (jmi_cs_data_t*)problem_data;
+    jmi_t* jmi = &((fmi2_me_t*)cs_data->fmix_me)->jmi;
+    int retval;
+    size_t i;
     
-    retval = fmi2_set_continuous_states(cs_data->fmix_me, y, sizes.states);
-    if (retval != fmi2OK) {
+    /* Set the states, time and inputs */
+    if (fmi2_cs_set_ode_point(cs_data, t, y, sizes.states) != 0) {
         return -1;
     }
     
-    /* Set the time */
-    retval = fmi2_set_time(cs_data->fmix_me, t);
-    if (retval != fmi2OK) {
+    /* Evaluate the derivatives with the iteration variables given by the integrator */
+    jmi_dae_iteration_begin(jmi, y + sizes.states, res + sizes.states);
+    retval = jmi_ode_get_derivatives(jmi, res, sizes.states);
+    jmi_dae_iteration_end(jmi);
+    if (retval != 0) {
         return -1;
     }
     
-    /* Set the inputs */
-    retval = fmi2_cs_set_real_inputs(cs_data, t);
-    if (retval != fmi2OK) {
+    for (i = 0; i < sizes.states; i++) {
+        res[i] -= yp[i];
+    }
+    
+    return 0;
+}
+
+int fmi2_cs_dae_alg_fcn(jmi_real_t *w, jmi_real_t *nominals, jmi_ode_sizes_t sizes, void* problem_data){
+    jmi_cs_data_t* cs_data = (jmi_cs_data_t*)problem_data;
+    jmi_t* jmi = &((fmi2_me_t*)cs_data->fmix_me)->jmi;
+    
+    return jmi_dae_iteration_get(jmi, w, nominals);
+}
+
+int fmi2_cs_root_fcn(jmi_real_t t, jmi_real_t *y, jmi_real_t *root, jmi_ode_sizes_t sizes, void* problem_data){
+    fmi2Status retval;
+    jmi_cs_data_t* cs_data = (jmi_cs_data_t*)problem_data;
+    
+    /* Set the states, time and inputs */
+    if (fmi2_cs_set_ode_point(cs_data, t, y, sizes.states) != 0) {
         return -1;
     }
     
@@ -308,6 +694,12 @@ int fmi2_cs_completed_integrator_step(char* step_event, char* terminate, void* p
     step_event[0] = (char) tmp_step_event;
     terminate[0] = (char) tmp_terminate_simulation;
 
+#ifdef FMI2_CS_ASYNC
+    if (((fmi2_cs_t*)cs_data->fmix_me)->async != NULL) {
+        fmi2_cs_async_progress((fmi2_cs_t*)cs_data->fmix_me, terminate);
+    }
+#endif
+
     if (retval != fmi2OK) {
         return -1;
     }
@@ -32,11 +32,13 @@
 /* @{ */
 
 typedef struct fmi2_cs_t fmi2_cs_t;      /**< \brief Forward declaration of struct. */
+typedef struct fmi2_cs_async_t fmi2_cs_async_t; /**< \brief State of the asynchronous fmi2DoStep, defined in fmi2_cs.c. */
 
 struct fmi2_cs_t {
     fmi2_me_t          fmi2_me;                     /**< \brief Must be the first one in this struct so that a fmi2_cs_t pointer can be used in place of a fmi2_me_t pointer. */
     jmi_ode_problem_t* ode_problem;                 /**< \brief A jmi ode problem pointer. */
     jmi_cs_data_t*     cs_data;                     /**< \brief A jmi CS data pointer. */
+    fmi2_cs_async_t*   async;                       /**< \brief Worker thread for asynchronous steps, NULL until the first one. */
 };
 
 /**
@@ -181,6 +183,25 @@ fmi2Status fmi2_cs_instantiate(fmi2Component c,
                                fmi2Boolean                  visible,
                                fmi2Boolean                  loggingOn);
 
+/**
+ * \brief Waits for a pending asynchronous step to finish, helper function for
+ * fmi2_reset and fmi2_free_instance.
+ * 
+ * @param c The FMU struct.
+ * @param cancel If true, the step is cancelled before waiting.
+ */
+void fmi2_cs_wait_for_step(fmi2Component c, fmi2Boolean cancel);
+
+/**
+ * \brief Checks if an asynchronous step is pending, helper function for the
+ * getters and setters. The rejected calls are logged as an error once the step
+ * has finished, since the worker thread uses the log until then.
+ * 
+ * @param c The FMU struct.
+ * @return True if the instance is a CS instance with a pending step.
+ */
+int fmi2_cs_step_pending(fmi2Component c);
+
 /**
  * \brief Dispose of the CS model instance, helper function for fmi2_free_instance.
  * 
@@ -0,0 +1,281 @@
+/*
+    Copyright (C) 2017 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+/*
+ * fmi2_cs_rhs_bench.c measures the cost of one right hand side evaluation of
+ * the co-simulation integrator, comparing the path through the FMI setters
+ * and getters with the internal path used by fmi2_cs_rhs_fcn.
+ *
+ * Usage: fmi2_cs_rhs_bench <unzipped FMU dir> <model identifier> [calls]
+ *
+ * The FMU must be a co-simulation FMU compiled with this runtime, its binary
+ * is loaded from <unzipped FMU dir>/binaries/<platform>/. Each path is called
+ * the given number of times (default 100000), first with the same states and
+ * time so that only the per-call overhead is measured, and then with a
+ * perturbed state so that the model equations are evaluated in every call.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#include <dlfcn.h>
+#endif
+
+#include "fmi2_cs.h"
+
+#ifdef _WIN32
+#define BENCH_PLATFORM (sizeof(void*) == 8 ? "win64" : "win32")
+#define BENCH_LIB_EXT ".dll"
+typedef HMODULE bench_lib_t;
+#define BENCH_LOAD(path) LoadLibraryA(path)
+#define BENCH_SYM(lib, name) ((void*)GetProcAddress(lib, name))
+#elif defined(__APPLE__)
+#define BENCH_PLATFORM (sizeof(void*) == 8 ? "darwin64" : "darwin32")
+#define BENCH_LIB_EXT ".dylib"
+typedef void* bench_lib_t;
+#define BENCH_LOAD(path) dlopen(path, RTLD_NOW | RTLD_LOCAL)
+#define BENCH_SYM(lib, name) dlsym(lib, name)
+#else
+#define BENCH_PLATFORM (sizeof(void*) == 8 ? "linux64" : "linux32")
+#define BENCH_LIB_EXT ".so"
+typedef void* bench_lib_t;
+#define BENCH_LOAD(path) dlopen(path, RTLD_NOW | RTLD_LOCAL)
+#define BENCH_SYM(lib, name) dlsym(lib, name)
+#endif
+
+typedef fmi2Status (*set_states_ft)(fmi2Component c, const fmi2Real x[], size_t nx);
+typedef fmi2Status (*set_time_ft)(fmi2Component c, fmi2Real time);
+typedef fmi2Status (*get_derivatives_ft)(fmi2Component c, fmi2Real derivatives[], size_t nx);
+typedef size_t (*extrapolate_ft)(jmi_cs_data_t* cs_data, jmi_real_t time);
+typedef int (*set_real_ft)(jmi_t* jmi, const jmi_value_reference vr[], size_t nvr, const jmi_real_t value[]);
+typedef jmi_value_reference (*is_negated_ft)(jmi_value_reference vref);
+typedef jmi_real_t* (*get_real_x_ft)(jmi_t* jmi);
+
+/* Functions of the runtime resolved from the FMU binary */
+typedef struct {
+    set_states_ft set_states;
+    set_time_ft set_time;
+    get_derivatives_ft get_derivatives;
+    extrapolate_ft extrapolate;
+    set_real_ft set_real;
+    is_negated_ft is_negated;
+    get_real_x_ft get_real_x;
+    jmi_rhs_func_t rhs;
+} bench_functions_t;
+
+static double wall_time() {
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + 1e-6 * tv.tv_usec;
+#endif
+}
+
+static void bench_logger(fmi2ComponentEnvironment env, fmi2String name, fmi2Status status,
+                         fmi2String category, fmi2String message, ...) {
+    if (status != fmi2OK) {
+        printf("[%s] %s\n", category, message);
+    }
+}
+
+/* Looks up a function, fptr is the address of the function pointer to set */
+static void bench_sym(bench_lib_t lib, const char* name, void** fptr) {
+    *fptr = BENCH_SYM(lib, name);
+    if (*fptr == NULL) {
+        fprintf(stderr, "Could not find %s in the FMU binary\n", name);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* Reads the guid attribute from the model description, returns a static buffer */
+static const char* read_guid(const char* fmu_dir) {
+    static char guid[256];
+    char path[1024];
+    char buf[4096];
+    FILE* f;
+    size_t n;
+    char* start;
+    char* end;
+
+    sprintf(path, "%s/modelDescription.xml", fmu_dir);
+    f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "Could not open %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    n = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[n] = 0;
+
+    start = strstr(buf, "guid=\"");
+    end = start ? strchr(start + 6, '"') : NULL;
+    if (end == NULL || end - start - 6 >= (int)sizeof(guid)) {
+        fprintf(stderr, "Could not find the guid in %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    memcpy(guid, start + 6, end - start - 6);
+    guid[end - start - 6] = 0;
+    return guid;
+}
+
+/* The right hand side as evaluated through the FMI setters and getters */
+static int rhs_public(bench_functions_t* f, fmi2_cs_t* fmi2_cs, jmi_real_t t, jmi_real_t* y,
+                      jmi_real_t* rhs, jmi_ode_sizes_t sizes) {
+    jmi_cs_data_t* cs_data = fmi2_cs->cs_data;
+    size_t i, n;
+
+    if (f->set_states(fmi2_cs, y, sizes.states) != fmi2OK) return -1;
+    if (f->set_time(fmi2_cs, t) != fmi2OK) return -1;
+
+    n = f->extrapolate(cs_data, t);
+    if (n > 0) {
+        for (i = 0; i < n; i++) {
+            if (f->is_negated(cs_data->input_vrs[i])) {
+                cs_data->input_values[i] = -cs_data->input_values[i];
+            }
+        }
+        if (f->set_real(&fmi2_cs->fmi2_me.jmi, cs_data->input_vrs, n, cs_data->input_values) != 0) return -1;
+    }
+
+    if (sizes.states > 0 && f->get_derivatives(fmi2_cs, rhs, sizes.states) != fmi2OK) return -1;
+    return 0;
+}
+
+/* Calls one of the paths n_calls times and returns the time per call in ns */
+static double bench_path(bench_functions_t* f, fmi2_cs_t* fmi2_cs, int internal, int perturb,
+                         long n_calls, jmi_real_t* y, jmi_real_t* rhs) {
+    jmi_ode_sizes_t sizes = fmi2_cs->ode_problem->sizes;
+    jmi_real_t t = fmi2_cs->ode_problem->time;
+    jmi_real_t y0 = sizes.states > 0 ? y[0] : 0.0;
+    double start, stop;
+    long k;
+    int ret;
+
+    start = wall_time();
+    for (k = 0; k < n_calls; k++) {
+        if (perturb && sizes.states > 0) {
+            y[0] = (k & 1) ? y0 : y0 * (1.0 + 1e-10) + 1e-10;
+        }
+        if (internal) {
+            ret = f->rhs(t, y, rhs, sizes, fmi2_cs->cs_data);
+        } else {
+            ret = rhs_public(f, fmi2_cs, t, y, rhs, sizes);
+        }
+        if (ret != 0) {
+            fprintf(stderr, "Right hand side evaluation failed\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    stop = wall_time();
+
+    if (sizes.states > 0) {
+        y[0] = y0;
+    }
+    return 1e9 * (stop - start) / n_calls;
+}
+
+int main(int argc, char* argv[]) {
+    fmi2CallbackFunctions callbacks = {bench_logger, calloc, free, NULL, NULL};
+    bench_functions_t f;
+    bench_lib_t lib;
+    fmi2InstantiateTYPE* instantiate;
+    fmi2SetupExperimentTYPE* setup_experiment;
+    fmi2EnterInitializationModeTYPE* enter_initialization_mode;
+    fmi2ExitInitializationModeTYPE* exit_initialization_mode;
+    fmi2FreeInstanceTYPE* free_instance;
+    fmi2Component c;
+    fmi2_cs_t* fmi2_cs;
+    jmi_real_t* y;
+    jmi_real_t* rhs;
+    size_t nx;
+    long n_calls;
+    char path[1024];
+    char resources[1100];
+    double public_overhead, internal_overhead, public_eval, internal_eval;
+
+    if (argc < 3) {
+        printf("Usage: %s <unzipped FMU dir> <model identifier> [calls]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    n_calls = argc > 3 ? atol(argv[3]) : 100000;
+
+    sprintf(path, "%s/binaries/%s/%s%s", argv[1], BENCH_PLATFORM, argv[2], BENCH_LIB_EXT);
+    lib = BENCH_LOAD(path);
+    if (lib == NULL) {
+        fprintf(stderr, "Could not load %s\n", path);
+        return EXIT_FAILURE;
+    }
+
+    bench_sym(lib, "fmi2Instantiate", (void**)&instantiate);
+    bench_sym(lib, "fmi2SetupExperiment", (void**)&setup_experiment);
+    bench_sym(lib, "fmi2EnterInitializationMode", (void**)&enter_initialization_mode);
+    bench_sym(lib, "fmi2ExitInitializationMode", (void**)&exit_initialization_mode);
+    bench_sym(lib, "fmi2FreeInstance", (void**)&free_instance);
+    bench_sym(lib, "fmi2_set_continuous_states", (void**)&f.set_states);
+    bench_sym(lib, "fmi2_set_time", (void**)&f.set_time);
+    bench_sym(lib, "fmi2_get_derivatives", (void**)&f.get_derivatives);
+    bench_sym(lib, "jmi_cs_extrapolate_real_inputs", (void**)&f.extrapolate);
+    bench_sym(lib, "jmi_set_real", (void**)&f.set_real);
+    bench_sym(lib, "jmi_value_ref_is_negated", (void**)&f.is_negated);
+    bench_sym(lib, "jmi_get_real_x", (void**)&f.get_real_x);
+    bench_sym(lib, "fmi2_cs_rhs_fcn", (void**)&f.rhs);
+
+    sprintf(resources, "file:///%s/resources", argv[1]);
+    c = instantiate(argv[2], fmi2CoSimulation, read_guid(argv[1]), resources, &callbacks, fmi2False, fmi2False);
+    if (c == NULL
+        || setup_experiment(c, fmi2False, 0.0, 0.0, fmi2False, 0.0) != fmi2OK
+        || enter_initialization_mode(c) != fmi2OK
+        || exit_initialization_mode(c) != fmi2OK) {
+        fprintf(stderr, "Could not initialize the FMU\n");
+        return EXIT_FAILURE;
+    }
+
+    fmi2_cs = (fmi2_cs_t*)c;
+    nx = fmi2_cs->ode_problem->sizes.states;
+    y = (jmi_real_t*)calloc(nx + 1, sizeof(jmi_real_t));
+    rhs = (jmi_real_t*)calloc(nx + 1, sizeof(jmi_real_t));
+    memcpy(y, f.get_real_x(&fmi2_cs->fmi2_me.jmi), nx * sizeof(jmi_real_t));
+
+    public_overhead = bench_path(&f, fmi2_cs, 0, 0, n_calls, y, rhs);
+    internal_overhead = bench_path(&f, fmi2_cs, 1, 0, n_calls, y, rhs);
+    public_eval = bench_path(&f, fmi2_cs, 0, 1, n_calls, y, rhs);
+    internal_eval = bench_path(&f, fmi2_cs, 1, 1, n_calls, y, rhs);
+
+    printf("%lu states, %ld calls per path\n", (unsigned long)nx, n_calls);
+    printf("%-22s %14s %14s %10s\n", "", "FMI [ns/call]", "internal", "speedup");
+    printf("%-22s %14.1f %14.1f %10.2f\n", "unchanged point", public_overhead, internal_overhead,
+           public_overhead / internal_overhead);
+    printf("%-22s %14.1f %14.1f %10.2f\n", "perturbed state", public_eval, internal_eval,
+           public_eval / internal_eval);
+
+    free_instance(c);
+    free(y);
+    free(rhs);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,315 @@
+/*
+    Copyright (C) 2017 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+/*
+ * fmi2_cs_test.c tests the co-simulation runtime with the model of
+ * fmi2_test_model.c.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#ifndef _MSC_VER
+#include <pthread.h>
+#endif
+
+#include "fmi2_cs.h"
+#include "fmi2_test_model.h"
+
+#define ABS_MACRO(X) ((X) > 0 ? (X): -(X))
+
+static jmi_block_solver_deadline_t* test_deadline = NULL;
+static int nbr_logged_errors = 0;
+
+int fmi2_cs_rhs_fcn(jmi_real_t t, jmi_real_t *y, jmi_real_t *rhs, jmi_ode_sizes_t sizes, void* problem_data);
+
+static void assert_true(int should_be_true, char* message) {
+    if (!should_be_true) {
+        fprintf(stderr, "%s", message);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void test_logger(fmi2ComponentEnvironment env, fmi2String name, fmi2Status status,
+                        fmi2String category, fmi2String message, ...) {
+    if (status != fmi2OK) {
+        printf("[%s] %s\n", category, message);
+    }
+    if (status == fmi2Error) {
+        nbr_logged_errors++;
+    }
+}
+
+static const fmi2CallbackFunctions test_callbacks = {test_logger, calloc, free, NULL, NULL};
+
+/* Instantiates and initializes the model with the given input */
+static fmi2Component instantiate(fmi2Type type, fmi2Integer cs_solver, fmi2Real cs_step_size, fmi2Real u) {
+    fmi2ValueReference vr_solver = FMI2_TEST_MODEL_VR_CS_SOLVER;
+    fmi2ValueReference vr_step_size = FMI2_TEST_MODEL_VR_CS_STEP_SIZE;
+    fmi2ValueReference vr_u = FMI2_TEST_MODEL_VR_U;
+    fmi2Component c;
+
+    c = fmi2_instantiate("test_instance", type, C_GUID, "file:///tmp", &test_callbacks, fmi2False, fmi2False);
+    assert_true(c != NULL, "Instantiation failed\n");
+    assert_true(fmi2_set_integer(c, &vr_solver, 1, &cs_solver) == fmi2OK, "Setting the solver failed\n");
+    assert_true(fmi2_set_real(c, &vr_step_size, 1, &cs_step_size) == fmi2OK, "Setting the step size failed\n");
+    assert_true(fmi2_set_real(c, &vr_u, 1, &u) == fmi2OK, "Setting the input failed\n");
+    assert_true(fmi2_setup_experiment(c, fmi2False, 0.0, 0.0, fmi2False, 0.0) == fmi2OK, "Setup failed\n");
+    assert_true(fmi2_enter_initialization_mode(c) == fmi2OK, "Entering initialization failed\n");
+    assert_true(fmi2_exit_initialization_mode(c) == fmi2OK, "Initialization failed\n");
+    if (type == fmi2ModelExchange) {
+        assert_true(fmi2_enter_continuous_time_mode(c) == fmi2OK, "Entering continuous time mode failed\n");
+    }
+    return c;
+}
+
+/* Derivatives through the FMI setters and getters of a model exchange instance */
+static void me_derivatives(fmi2Real t, const fmi2Real* x, fmi2Real u, fmi2Real* der) {
+    fmi2ValueReference vr_u = FMI2_TEST_MODEL_VR_U;
+    fmi2ValueReference vr_der[2] = {FMI2_TEST_MODEL_VR_DER_X, FMI2_TEST_MODEL_VR_DER_Z};
+    fmi2Real der_get[2];
+    fmi2Component c = instantiate(fmi2ModelExchange, 0, 0.001, u);
+
+    assert_true(fmi2_set_time(c, t) == fmi2OK, "Setting the time failed\n");
+    assert_true(fmi2_set_real(c, &vr_u, 1, &u) == fmi2OK, "Setting the input failed\n");
+    assert_true(fmi2_set_continuous_states(c, x, 2) == fmi2OK, "Setting the states failed\n");
+    assert_true(fmi2_get_derivatives(c, der, 2) == fmi2OK, "Getting the derivatives failed\n");
+    assert_true(fmi2_get_real(c, vr_der, 2, der_get) == fmi2OK, "Getting the derivatives failed\n");
+    assert_true(der[0] == der_get[0] && der[1] == der_get[1],
+                "fmi2GetDerivatives and fmi2GetReal of the derivatives differ\n");
+    fmi2_free_instance(c);
+}
+
+/*
+ * The internal right hand side of the co-simulation integrator must give the
+ * derivatives of the FMI getters, also for a state with a negated alias, and
+ * leave the model in the same state as the FMI setters would.
+ */
+static void test_cs_rhs_matches_getters() {
+    fmi2ValueReference vr_xyz[3] = {FMI2_TEST_MODEL_VR_X, FMI2_TEST_MODEL_VR_Y, FMI2_TEST_MODEL_VR_Z};
+    fmi2Real u = 0.3;
+    fmi2Real x[2] = {0.7, 0.2};
+    fmi2Real der_me[2], rhs[2], xyz[3];
+    fmi2Component c = instantiate(fmi2CoSimulation, 0, 0.001, u);
+    fmi2_cs_t* fmi2_cs = (fmi2_cs_t*)c;
+    jmi_ode_sizes_t sizes = fmi2_cs->ode_problem->sizes;
+
+    assert_true(sizes.states == 2, "Expected 2 states\n");
+    me_derivatives(0.0, x, u, der_me);
+
+    assert_true(fmi2_cs_rhs_fcn(0.0, x, rhs, sizes, fmi2_cs->cs_data) == 0, "Right hand side failed\n");
+    assert_true(ABS_MACRO(rhs[0] - der_me[0]) < 1e-14 && ABS_MACRO(rhs[1] - der_me[1]) < 1e-14,
+                "The internal right hand side differs from fmi2GetDerivatives\n");
+    assert_true(ABS_MACRO(der_me[0] + (x[0]*x[1] + u)) < 1e-14, "Unexpected derivative of x\n");
+    assert_true(ABS_MACRO(der_me[1] - (sin(-x[0]) - u*x[1])) < 1e-14, "Unexpected derivative of z\n");
+
+    assert_true(fmi2_get_real(c, vr_xyz, 3, xyz) == fmi2OK, "Getting the states failed\n");
+    assert_true(xyz[0] == x[0] && xyz[1] == -x[0] && xyz[2] == x[1],
+                "The states or the negated alias were not set by the right hand side\n");
+
+    fmi2_free_instance(c);
+}
+
+/* One explicit Euler step of the co-simulation FMU from the initial point */
+static void test_cs_euler_step() {
+    fmi2ValueReference vr_xz[2] = {FMI2_TEST_MODEL_VR_X, FMI2_TEST_MODEL_VR_Z};
+    fmi2ValueReference vr_y = FMI2_TEST_MODEL_VR_Y;
+    fmi2Real h = 0.01;
+    fmi2Real u = -0.4;
+    fmi2Real x0[2], der[2], x1[2], y1;
+    fmi2Component c = instantiate(fmi2CoSimulation, 1, h, u);
+
+    assert_true(fmi2_get_real(c, vr_xz, 2, x0) == fmi2OK, "Getting the states failed\n");
+    assert_true(x0[0] == 1.0 && x0[1] == 0.5, "Unexpected initial states\n");
+    me_derivatives(0.0, x0, u, der);
+
+    assert_true(fmi2_do_step(c, 0.0, h, fmi2True) == fmi2OK, "The step failed\n");
+    assert_true(fmi2_get_real(c, vr_xz, 2, x1) == fmi2OK, "Getting the states failed\n");
+    assert_true(fmi2_get_real(c, &vr_y, 1, &y1) == fmi2OK, "Getting the alias failed\n");
+    assert_true(ABS_MACRO(x1[0] - (x0[0] + h*der[0])) < 1e-14, "Unexpected Euler step of x\n");
+    assert_true(ABS_MACRO(x1[1] - (x0[1] + h*der[1])) < 1e-14, "Unexpected Euler step of z\n");
+    assert_true(y1 == -x1[0], "The negated alias differs after the step\n");
+
+    fmi2_free_instance(c);
+}
+
+/* Model equations that take until the time budget is exhausted */
+static void exhaust_time_budget(void) {
+    while (!jmi_block_solver_deadline_exceeded(test_deadline)) {}
+}
+
+/* Value of one input from its Taylor polynomial, one input and one term at a time */
+static jmi_real_t extrapolate_input(jmi_cs_real_input_t* real_input, jmi_real_t time) {
+    jmi_real_t value = real_input->value;
+    int j;
+
+    for (j = 0; j < JMI_CS_MAX_INPUT_DERIVATIVES; j++) {
+        value += pow(time - real_input->tn, j + 1.0) * real_input->input_derivatives[j] /
+                 real_input->input_derivatives_factor[j];
+    }
+    return value;
+}
+
+/* The batched extrapolation gives the values of the per-input polynomials for the active inputs */
+static void test_extrapolate_real_inputs() {
+    jmi_value_reference vrs[6] = {11, 11, 12, 14, 14, 14};
+    int orders[6] = {1, 3, 1, 1, 2, 3};
+    jmi_real_t derivatives[6] = {0.5, -2.0, 3.0, 1.5, -0.25, 4.0};
+    jmi_cs_data_t* cs_data = jmi_new_cs_data(NULL, 4);
+    jmi_cs_real_input_t* real_inputs;
+    jmi_real_t times[3] = {0.0, 0.35, -1.2};
+    size_t i, k, n;
+
+    assert_true(cs_data != NULL, "Creating the co-simulation data failed\n");
+    assert_true(jmi_cs_set_real_input_derivatives(cs_data, NULL, vrs, 6, orders, derivatives) == 0,
+                "Setting the input derivatives failed\n");
+    real_inputs = cs_data->real_inputs;
+    for (i = 0; i < 3; i++) {
+        real_inputs[i].value = 1.0 + i;
+        real_inputs[i].tn = 0.1 * i;
+    }
+    assert_true(real_inputs[3].active == FALSE, "Expected an inactive input\n");
+
+    for (k = 0; k < 3; k++) {
+        n = jmi_cs_extrapolate_real_inputs(cs_data, times[k]);
+        assert_true(n == 3, "Expected three extrapolated inputs\n");
+        for (i = 0; i < n; i++) {
+            jmi_real_t expected = extrapolate_input(&real_inputs[i], times[k]);
+            assert_true(cs_data->input_vrs[i] == real_inputs[i].vr, "Unexpected value reference of an input\n");
+            assert_true(ABS_MACRO(cs_data->input_values[i] - expected) <= 1e-14 * (1.0 + ABS_MACRO(expected)),
+                        "The batched extrapolation differs from the per-input polynomial\n");
+        }
+    }
+
+    jmi_free_cs_data(cs_data);
+}
+
+/* Getters that evaluate the model for new states return a warning if the time budget of the evaluation is exhausted */
+static void test_time_budget_warning() {
+    fmi2ValueReference vr_der_x = FMI2_TEST_MODEL_VR_DER_X;
+    fmi2Real x[2] = {0.7, 0.2};
+    fmi2Real der[2];
+    fmi2Real event_indicator;
+    fmi2Component c = instantiate(fmi2ModelExchange, 0, 0.001, 0.3);
+    jmi_t* jmi = &((fmi2_me_t*)c)->jmi;
+
+    jmi->options.block_solver_options.time_budget = 1e-9;
+    test_deadline = &jmi->block_solver_deadline;
+    fmi2_test_model_derivatives_hook = exhaust_time_budget;
+
+    x[0] += 0.1;
+    assert_true(fmi2_set_continuous_states(c, x, 2) == fmi2OK, "Setting the states failed\n");
+    assert_true(fmi2_get_derivatives(c, der, 2) == fmi2Warning, "Expected a warning from fmi2GetDerivatives\n");
+    assert_true(fmi2_get_derivatives(c, der, 2) == fmi2OK, "The model was evaluated again\n");
+
+    x[0] += 0.1;
+    assert_true(fmi2_set_continuous_states(c, x, 2) == fmi2OK, "Setting the states failed\n");
+    assert_true(fmi2_get_real(c, &vr_der_x, 1, der) == fmi2Warning, "Expected a warning from fmi2GetReal\n");
+    x[0] += 0.1;
+    assert_true(fmi2_set_continuous_states(c, x, 2) == fmi2OK, "Setting the states failed\n");
+    assert_true(fmi2_get_event_indicators(c, &event_indicator, 0) == fmi2Warning,
+                "Expected a warning from fmi2GetEventIndicators\n");
+
+    fmi2_test_model_derivatives_hook = NULL;
+    x[0] += 0.1;
+    assert_true(fmi2_set_continuous_states(c, x, 2) == fmi2OK, "Setting the states failed\n");
+    assert_true(fmi2_get_derivatives(c, der, 2) == fmi2OK, "Unexpected warning within the time budget\n");
+    assert_true(jmi->block_solver_deadline.nbr_exhausted == 3, "Expected three exhausted evaluations\n");
+
+    fmi2_free_instance(c);
+}
+
+#ifndef _MSC_VER
+static pthread_mutex_t step_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t step_cond = PTHREAD_COND_INITIALIZER;
+static int step_entered = 0;
+static int step_released = 0;
+
+/* Model equations that block the worker thread until the test releases the step */
+static void block_step(void) {
+    pthread_mutex_lock(&step_mutex);
+    step_entered = 1;
+    pthread_cond_broadcast(&step_cond);
+    while (!step_released) {
+        pthread_cond_wait(&step_cond, &step_mutex);
+    }
+    pthread_mutex_unlock(&step_mutex);
+}
+
+/*
+ * Calls that access the model are rejected while an asynchronous step is
+ * pending, and are logged on the calling thread once the step has finished.
+ */
+static void test_async_step_rejects_calls() {
+    fmi2ValueReference vr_x = FMI2_TEST_MODEL_VR_X;
+    fmi2Real x, u = 0.3;
+    fmi2Status status;
+    fmi2Component c = instantiate(fmi2CoSimulation, 1, 0.001, u);
+
+    ((fmi2_me_t*)c)->jmi.options.cs_async_do_step = 1;
+    assert_true(fmi2_set_debug_logging(c, fmi2True, 0, NULL) == fmi2OK, "Setting the debug logging failed\n");
+    fmi2_test_model_derivatives_hook = block_step;
+    nbr_logged_errors = 0;
+
+    assert_true(fmi2_do_step(c, 0.0, 0.01, fmi2True) == fmi2Pending, "Expected a pending step\n");
+    pthread_mutex_lock(&step_mutex);
+    while (!step_entered) {
+        pthread_cond_wait(&step_cond, &step_mutex);
+    }
+    pthread_mutex_unlock(&step_mutex);
+
+    assert_true(fmi2_get_real(c, &vr_x, 1, &x) == fmi2Error, "fmi2GetReal was not rejected\n");
+    assert_true(fmi2_set_real(c, &vr_x, 1, &u) == fmi2Error, "fmi2SetReal was not rejected\n");
+    assert_true(fmi2_do_step(c, 0.0, 0.01, fmi2True) == fmi2Error, "fmi2DoStep was not rejected\n");
+    assert_true(fmi2_setup_experiment(c, fmi2False, 0.0, 0.0, fmi2False, 0.0) == fmi2Error,
+                "fmi2SetupExperiment was not rejected\n");
+    assert_true(fmi2_enter_initialization_mode(c) == fmi2Error, "fmi2EnterInitializationMode was not rejected\n");
+    assert_true(fmi2_exit_initialization_mode(c) == fmi2Error, "fmi2ExitInitializationMode was not rejected\n");
+    assert_true(fmi2_set_debug_logging(c, fmi2False, 0, NULL) == fmi2Error, "fmi2SetDebugLogging was not rejected\n");
+    assert_true(fmi2_get_status(c, fmi2DoStepStatus, &status) == fmi2OK && status == fmi2Pending,
+                "Expected the status of a pending step\n");
+    assert_true(nbr_logged_errors == 0, "A rejected call was logged while the step was pending\n");
+
+    pthread_mutex_lock(&step_mutex);
+    step_released = 1;
+    pthread_cond_broadcast(&step_cond);
+    pthread_mutex_unlock(&step_mutex);
+    fmi2_cs_wait_for_step(c, fmi2False);
+
+    assert_true(fmi2_get_status(c, fmi2DoStepStatus, &status) == fmi2OK && status == fmi2OK,
+                "Expected the status of a finished step\n");
+    assert_true(nbr_logged_errors == 1, "Expected one error for the rejected calls after the step\n");
+    assert_true(fmi2_get_real(c, &vr_x, 1, &x) == fmi2OK, "Getting the state after the step failed\n");
+
+    fmi2_test_model_derivatives_hook = NULL;
+    fmi2_free_instance(c);
+}
+#endif
+
+int main(int argc, char* argv[]) {
+    test_cs_rhs_matches_getters();
+    test_cs_euler_step();
+    test_extrapolate_real_inputs();
+    test_time_budget_warning();
+#ifndef _MSC_VER
+    test_async_step_rejects_calls();
+#endif
+
+    return EXIT_SUCCESS;
+}
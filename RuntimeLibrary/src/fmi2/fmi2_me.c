@@ -43,6 +43,10 @@ fmi2Status fmi2_set_debug_logging(fmi2Component    c,
         return fmi2Fatal;
     }
 
+    if (fmi2_cs_step_pending(c)) {
+        return fmi2Error;
+    }
+
     max_log_level = 0;
     for (i = 0; i < nCategories; i++) {
         if (strcmp(categories[i], "logLevel1")) {
@@ -216,6 +220,10 @@ fmi2Status fmi2_setup_experiment(fmi2Component c,
         return fmi2Fatal;
     }
 
+    if (fmi2_cs_step_pending(c)) {
+        return fmi2Error;
+    }
+
     fmi2_me = (fmi2_me_t*)c;
 
     if (fmi2_me->fmu_mode != instantiatedMode) {
@@ -249,6 +257,10 @@ fmi2Status fmi2_enter_initialization_mode(fmi2Component c) {
         return fmi2Fatal;
     }
     
+    if (fmi2_cs_step_pending(c)) {
+        return fmi2Error;
+    }
+    
     if (((fmi2_me_t *)c)->fmu_mode != instantiatedMode) {
         jmi_log_node(((fmi2_me_t *)c)->jmi.log, logError, "FMIState",
             "Can only enter initialization mode after instantiating the model.");
@@ -276,6 +288,12 @@ fmi2Status fmi2_enter_initialization_mode(fmi2Component c) {
         options.method                  = jmi->options.cs_solver;
         options.euler_options.step_size = jmi->options.cs_step_size;
         options.cvode_options.rel_tol   = jmi->options.cs_rel_tol;
+        options.rk_options.method       = jmi->options.cs_rk_method;
+        options.rosenbrock_options.method                   = jmi->options.cs_rosenbrock_method;
+        options.rosenbrock_options.jacobian_update_interval = jmi->options.cs_jacobian_update_interval;
+        options.cvode_options.linear_solver      = jmi->options.cs_linear_solver;
+        options.cvode_options.precond_block_size = jmi->options.cs_precond_block_size;
+        options.cvode_options.num_threads        = jmi->options.cs_num_threads;
         options.experimental_mode       = jmi->options.cs_experimental_mode;
         
         /* Create solver */
@@ -293,6 +311,10 @@ fmi2Status fmi2_exit_initialization_mode(fmi2Component c) {
         return fmi2Fatal;
     }
 
+    if (fmi2_cs_step_pending(c)) {
+        return fmi2Error;
+    }
+
     if (((fmi2_me_t *)c)->fmu_mode != initializationMode) {
         jmi_log_node(((fmi2_me_t *)c)->jmi.log, logError, "FMIState",
             "Can only exit initialization mode when being in initialization mode.");
@@ -318,6 +340,10 @@ fmi2Status fmi2_terminate(fmi2Component c) {
     if (c == NULL) {
         return fmi2Fatal;
     }
+
+    if (fmi2_cs_step_pending(c)) {
+        return fmi2Error;
+    }
     
     retval = jmi_update_and_terminate(&((fmi2_me_t*)c)->jmi);
     if (retval != 0) {
@@ -341,6 +367,7 @@ fmi2Status fmi2_reset(fmi2Component c) {
     
     /* Clear the ode_solver in case of CoSimulation */
     if (fmi2_me->fmu_type == fmi2CoSimulation) {
+        fmi2_cs_wait_for_step(c, fmi2True);
         jmi_free_ode_solver(((fmi2_cs_t *)c)->ode_problem->ode_solver);
         ((fmi2_cs_t *)c)->ode_problem->ode_solver = NULL;
     }
@@ -380,12 +407,18 @@ fmi2Status fmi2_reset(fmi2Component c) {
 fmi2Status fmi2_get_real(fmi2Component c, const fmi2ValueReference vr[],
                          size_t nvr, fmi2Real value[]) {
     fmi2Integer retval;
+    long int nbr_exhausted;
     size_t i;
     
     if (c == NULL) {
         return fmi2Fatal;
     }
 
+    if (fmi2_cs_step_pending(c)) {
+        return fmi2Error;
+    }
+
+    nbr_exhausted = ((fmi2_me_t *)c)->jmi.block_solver_deadline.nbr_exhausted;
     retval = jmi_get_real(&((fmi2_me_t *)c)->jmi, vr, nvr, value);
     if (retval != 0) {
         return fmi2Error;
@@ -398,18 +431,24 @@ fmi2Status fmi2_get_real(fmi2Component c, const fmi2ValueReference vr[],
         }
     }
 
-    return fmi2OK;
+    return fmi2_me_time_budget_status(c, nbr_exhausted);
 }
 
 fmi2Status fmi2_get_integer(fmi2Component c, const fmi2ValueReference vr[],
                             size_t nvr, fmi2Integer value[]) {
     fmi2Integer retval;
+    long int nbr_exhausted;
     size_t i;
     
     if (c == NULL) {
         return fmi2Fatal;
     }
 
+    if (fmi2_cs_step_pending(c)) {
+        return fmi2Error;
+    }
+
+    nbr_exhausted = ((fmi2_me_t *)c)->jmi.block_solver_deadline.nbr_exhausted;
     retval = jmi_get_integer(&((fmi2_me_t *)c)->jmi, vr, nvr, value);
     if (retval != 0) {
         return fmi2Error;
@@ -422,12 +461,13 @@ fmi2Status fmi2_get_integer(fmi2Component c, const fmi2ValueReference vr[],
         }
     }
 
-    return fmi2OK;
+    return fmi2_me_time_budget_status(c, nbr_exhausted);
 }
 
 fmi2Status fmi2_get_boolean(fmi2Component c, const fmi2ValueReference vr[],
                             size_t nvr, fmi2Boolean value[]) {
     fmi2Integer retval;
+    long int nbr_exhausted;
     jmi_boolean* jmi_boolean_values = (jmi_boolean*)calloc(nvr, sizeof(char));
     size_t i;
     
@@ -435,6 +475,11 @@ fmi2Status fmi2_get_boolean(fmi2Component c, const fmi2ValueReference vr[],
         return fmi2Fatal;
     }
 
+    if (fmi2_cs_step_pending(c)) {
+        return fmi2Error;
+    }
+
+    nbr_exhausted = ((fmi2_me_t *)c)->jmi.block_solver_deadline.nbr_exhausted;
     retval = jmi_get_boolean(&((fmi2_me_t *)c)->jmi, vr, nvr, jmi_boolean_values);
     if (retval != 0) {
         return fmi2Error;
@@ -445,23 +490,29 @@ fmi2Status fmi2_get_boolean(fmi2Component c, const fmi2ValueReference vr[],
     }
     free(jmi_boolean_values);
 
-    return fmi2OK;
+    return fmi2_me_time_budget_status(c, nbr_exhausted);
 }
 
 fmi2Status fmi2_get_string(fmi2Component c, const fmi2ValueReference vr[],
                            size_t nvr, fmi2String value[]) {
     fmi2Integer retval;
+    long int nbr_exhausted;
     
     if (c == NULL) {
         return fmi2Fatal;
     }
 
+    if (fmi2_cs_step_pending(c)) {
+        return fmi2Error;
+    }
+
+    nbr_exhausted = ((fmi2_me_t *)c)->jmi.block_solver_deadline.nbr_exhausted;
     retval = jmi_get_string(&((fmi2_me_t *)c)->jmi, vr, nvr, value);
     if (retval != 0) {
         return fmi2Error;
     }
 
-    return fmi2OK;
+    return fmi2_me_time_budget_status(c, nbr_exhausted);
 }
 
 fmi2Status fmi2_set_real(fmi2Component c, const fmi2ValueReference vr[],
@@ -473,6 +524,10 @@ fmi2Status fmi2_set_real(fmi2Component c, const fmi2ValueReference vr[],
     if (c == NULL) {
         return fmi2Fatal;
     }
+
+    if (fmi2_cs_step_pending(c)) {
+        return fmi2Error;
+    }
     
     for (i = 0; i < nvr; i++) {
         /* Negate the values before setting the "negate alias" variables. */
@@ -491,10 +546,17 @@ fmi2Status fmi2_set_real(fmi2Component c, const fmi2ValueReference vr[],
     }
     if (fmi2_me->fmu_type == fmi2CoSimulation &&
         ((fmi2_cs_t *)c)->ode_problem->ode_solver != NULL &&
-        jmi_cs_check_input_change(&fmi2_me->jmi, vr, nvr, fmi2_me->work_real_array))
+        jmi_cs_check_input_change(&fmi2_me->jmi, vr, nvr, fmi2_me->work_real_array,
+                                  fmi2_me->jmi.options.cs_input_reinit_tol))
     {
         jmi_ode_solver_need_to_initialize(((fmi2_cs_t *)c)->ode_problem->ode_solver);
     } 
+    if (fmi2_me->fmu_type == fmi2CoSimulation &&
+        fmi2_me->jmi.options.cs_input_reinit_tol > 0.0)
+    {
+        jmi_cs_record_input_history(((fmi2_cs_t *)c)->cs_data, &fmi2_me->jmi, vr, nvr,
+                                    fmi2_me->work_real_array, ((fmi2_cs_t *)c)->ode_problem->time);
+    }
     
     retval = jmi_set_real(&((fmi2_me_t *)c)->jmi, vr, nvr, fmi2_me->work_real_array);
     if (retval != 0) {
@@ -513,6 +575,10 @@ fmi2Status fmi2_set_integer(fmi2Component c, const fmi2ValueReference vr[],
     if (c == NULL) {
         return fmi2Fatal;
     }
+
+    if (fmi2_cs_step_pending(c)) {
+        return fmi2Error;
+    }
     
     /* Negate the values before setting the "negate alias" variables. */
     for (i = 0; i < nvr; i++) {
@@ -548,6 +614,10 @@ fmi2Status fmi2_set_boolean(fmi2Component c, const fmi2ValueReference vr[],
     if (c == NULL) {
         return fmi2Fatal;
     }
+
+    if (fmi2_cs_step_pending(c)) {
+        return fmi2Error;
+    }
     
     jmi_boolean_values = (jmi_boolean*)calloc(nvr, sizeof(jmi_boolean));
     for (i = 0; i < nvr; i++) {
@@ -578,6 +648,10 @@ fmi2Status fmi2_set_string(fmi2Component c, const fmi2ValueReference vr[],
     if (c == NULL) {
         return fmi2Fatal;
     }
+
+    if (fmi2_cs_step_pending(c)) {
+        return fmi2Error;
+    }
     
     retval = jmi_set_string(&((fmi2_me_t *)c)->jmi, vr, nvr, value);
     if (retval != 0) {
@@ -624,6 +698,10 @@ fmi2Status fmi2_get_directional_derivative(fmi2Component c,
     if (c == NULL) {
         return fmi2Fatal;
     }
+
+    if (fmi2_cs_step_pending(c)) {
+        return fmi2Error;
+    }
     
     retval = jmi_get_directional_derivative(&((fmi2_me_t *)c)->jmi, vUnknown_ref,
                     nUnknown, vKnown_ref, nKnown, dvKnown, dvUnknown);
@@ -768,33 +846,37 @@ fmi2Status fmi2_set_continuous_states(fmi2Component c, const fmi2Real x[],
 
 fmi2Status fmi2_get_derivatives(fmi2Component c, fmi2Real derivatives[], size_t nx) {
     fmi2Integer retval;
+    long int nbr_exhausted;
     
     if (c == NULL) {
         return fmi2Fatal;
     }
     
+    nbr_exhausted = ((fmi2_me_t *)c)->jmi.block_solver_deadline.nbr_exhausted;
     retval = jmi_get_derivatives(&((fmi2_me_t *)c)->jmi, derivatives, nx);
     if (retval != 0) {
         return fmi2Error;
     }
     
-    return fmi2OK;
+    return fmi2_me_time_budget_status(c, nbr_exhausted);
 }
 
 fmi2Status fmi2_get_event_indicators(fmi2Component c, 
                                      fmi2Real eventIndicators[], size_t ni) {
     fmi2Integer retval;
+    long int nbr_exhausted;
     
     if (c == NULL) {
         return fmi2Fatal;
     }
     
+    nbr_exhausted = ((fmi2_me_t *)c)->jmi.block_solver_deadline.nbr_exhausted;
     retval = jmi_get_event_indicators(&((fmi2_me_t *)c)->jmi, eventIndicators, ni);
     if (retval != 0) {
         return fmi2Error;
     }
     
-    return fmi2OK;
+    return fmi2_me_time_budget_status(c, nbr_exhausted);
 }
 
 fmi2Status fmi2_get_continuous_states(fmi2Component c, fmi2Real x[], size_t nx) {
@@ -933,6 +1015,13 @@ fmi2Status fmi2_me_instantiate(fmi2Component c,
 }
 
 /* Helper method for fmi2_free_instance. */
+fmi2Status fmi2_me_time_budget_status(fmi2Component c, long int nbr_exhausted) {
+    if (((fmi2_me_t *)c)->jmi.block_solver_deadline.nbr_exhausted != nbr_exhausted) {
+        return fmi2Warning;
+    }
+    return fmi2OK;
+}
+
 void fmi2_me_free_instance(fmi2Component c) {
     fmi2_me_t* fmi2_me = (fmi2_me_t*)c;
     fmi2CallbackFreeMemory fmi_free = fmi2_me->fmi_functions->freeMemory;
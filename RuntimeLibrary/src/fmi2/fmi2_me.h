@@ -501,4 +501,14 @@ fmi2Status fmi2_me_instantiate(fmi2Component c,
  */
 void fmi2_me_free_instance(fmi2Component c);
 
+/**
+ * \brief Status of a call that evaluated the model, fmi2Warning if the time budget
+ * of the equation blocks (nle_solver_time_budget) was exhausted during the call.
+ * 
+ * @param c The FMU struct.
+ * @param nbr_exhausted Number of exhausted time budgets before the call.
+ * @return fmi2Warning or fmi2OK.
+ */
+fmi2Status fmi2_me_time_budget_status(fmi2Component c, long int nbr_exhausted);
+
 #endif
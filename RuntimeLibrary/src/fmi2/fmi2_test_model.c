@@ -0,0 +1,302 @@
+/*
+    Copyright (C) 2017 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+/*
+ * fmi2_test_model.c is the model of fmi2_test_model.h, following the
+ * templates in Compiler/ModelicaCBackEnd/templates/FMIBase.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <jmi.h>
+#include <jmi_block_residual.h>
+
+#include "fmi2_test_model.h"
+
+int model_ode_derivatives(jmi_t* jmi);
+int model_ode_initialize(jmi_t* jmi);
+int model_ode_event_indicators(jmi_t* jmi, jmi_real_t** res);
+int model_init_R0(jmi_t* jmi, jmi_real_t** res);
+void model_add_blocks(jmi_t** jmi);
+void model_init_add_blocks(jmi_t** jmi);
+int model_init_eval_independent(jmi_t* jmi);
+int model_init_eval_dependent(jmi_t* jmi);
+int model_ode_guards(jmi_t* jmi);
+int model_ode_guards_init(jmi_t* jmi);
+
+#define __cs_rel_tol_0 ((*(jmi->z))[0])
+#define __cs_step_size_1 ((*(jmi->z))[1])
+#define __cs_solver_2 ((*(jmi->z))[2])
+#define __log_level_3 ((*(jmi->z))[3])
+#define _der_x_4 ((*(jmi->z))[4])
+#define _der_z_5 ((*(jmi->z))[5])
+#define _x_6 ((*(jmi->z))[6])
+#define _z_7 ((*(jmi->z))[7])
+#define _u_8 ((*(jmi->z))[8])
+#define _time ((*(jmi->z))[jmi->offs_t])
+
+typedef struct jmi_globals {
+    int dummy; /* Empty struct not allowed */
+} jmi_globals_t;
+
+static const int N_real_ci = 0;
+static const int N_real_cd = 0;
+static const int N_real_pi = 2;
+static const int N_real_pi_s = 0;
+static const int N_real_pi_f = 0;
+static const int N_real_pi_e = 0;
+static const int N_real_pd = 0;
+
+static const int N_integer_ci = 0;
+static const int N_integer_cd = 0;
+static const int N_integer_pi = 2;
+static const int N_integer_pi_s = 0;
+static const int N_integer_pi_f = 0;
+static const int N_integer_pi_e = 0;
+static const int N_integer_pd = 0;
+
+static const int N_boolean_ci = 0;
+static const int N_boolean_cd = 0;
+static const int N_boolean_pi = 0;
+static const int N_boolean_pi_s = 0;
+static const int N_boolean_pi_f = 0;
+static const int N_boolean_pi_e = 0;
+static const int N_boolean_pd = 0;
+
+static const int N_real_dx = 2;
+static const int N_real_x = 2;
+static const int N_real_u = 1;
+static const int N_real_w = 0;
+
+static const int N_real_d = 0;
+
+static const int N_integer_d = 0;
+static const int N_integer_u = 0;
+
+static const int N_boolean_d = 0;
+static const int N_boolean_u = 0;
+
+static const int N_ext_objs = 0;
+
+static const int N_sw = 0;
+static const int N_time_sw = 0;
+static const int N_state_sw = 0;
+static const int N_delay_sw = 0;
+
+static const int N_dae_blocks = 0;
+static const int N_dae_init_blocks = 0;
+static const int N_guards = 0;
+
+static const int N_dynamic_state_sets = 0;
+
+static const int N_sw_init = 0;
+static const int N_guards_init = 0;
+
+static const int N_delays = 0;
+static const int N_spatialdists = 0;
+
+static const int Scaling_method = JMI_SCALING_NONE;
+
+static const int Homotopy_block = -1;
+
+const char *C_GUID = "fmi2_test_model";
+
+static const int N_initial_relations = 0;
+static const int DAE_initial_relations[] = { -1 };
+
+static const int N_relations = 0;
+static const int DAE_relations[] = { -1 };
+
+static const jmi_real_t DAE_nominals[] = { 1.0, 1.0 };
+
+const char *fmi_runtime_options_map_names[] = {
+    "_cs_rel_tol",
+    "_cs_solver",
+    "_cs_step_size",
+    "_log_level",
+    NULL
+};
+
+const int fmi_runtime_options_map_vrefs[] = {
+    0, 268435458, 1, 268435459, 0
+};
+
+const int fmi_runtime_options_map_length = 4;
+
+void (*fmi2_test_model_derivatives_hook)(void) = NULL;
+
+int model_ode_guards(jmi_t* jmi) {
+    return 0;
+}
+
+static int model_ode_next_time_event(jmi_t* jmi, jmi_time_event_t* nextTimeEvent) {
+    return 0;
+}
+
+static int model_ode_derivatives_dir_der(jmi_t* jmi) {
+    int ef = 0;
+    return ef;
+}
+
+int model_ode_guards_init(jmi_t* jmi) {
+    return 0;
+}
+
+static int model_init_delay(jmi_t* jmi) {
+    return 0;
+}
+
+static int model_sample_delay(jmi_t* jmi) {
+    return 0;
+}
+
+static int jmi_z_offset_strings(jmi_z_strings_t* z) {
+    z->offs.ci = 0;
+    z->nums.ci = 0;
+    z->offs.cd = 0;
+    z->nums.cd = 0;
+    z->offs.pi = 0;
+    z->nums.pi = 0;
+    z->offs.ps = 0;
+    z->nums.ps = 0;
+    z->offs.pf = 0;
+    z->nums.pf = 0;
+    z->offs.pe = 0;
+    z->nums.pe = 0;
+    z->offs.pd = 0;
+    z->nums.pd = 0;
+    z->offs.w = 0;
+    z->nums.w = 0;
+    z->offs.wp = 0;
+    z->nums.wp = 0;
+    z->n = 0;
+    return 0;
+}
+
+int model_ode_derivatives_base(jmi_t* jmi) {
+    int ef = 0;
+    if (fmi2_test_model_derivatives_hook != NULL) {
+        fmi2_test_model_derivatives_hook();
+    }
+    _der_x_4 = - (_x_6 * _z_7 + _u_8);
+    _der_z_5 = sin(- _x_6) - _u_8 * _z_7;
+    return ef;
+}
+
+int model_ode_derivatives(jmi_t* jmi) {
+    return model_ode_derivatives_base(jmi);
+}
+
+int model_ode_event_indicators(jmi_t* jmi, jmi_real_t** res) {
+    return 0;
+}
+
+void model_add_blocks(jmi_t** jmi) {
+}
+
+int model_ode_initialize_base(jmi_t* jmi) {
+    int ef = 0;
+    _x_6 = 1;
+    _z_7 = 0.5;
+    _der_x_4 = - (_x_6 * _z_7 + _u_8);
+    _der_z_5 = sin(- _x_6) - _u_8 * _z_7;
+    return ef;
+}
+
+int model_ode_initialize(jmi_t* jmi) {
+    return model_ode_initialize_base(jmi);
+}
+
+int model_init_R0(jmi_t* jmi, jmi_real_t** res) {
+    return 0;
+}
+
+void model_init_add_blocks(jmi_t** jmi) {
+}
+
+int model_init_eval_independent_start(jmi_t* jmi) {
+    int ef = 0;
+    __cs_rel_tol_0 = (1.0E-6);
+    __cs_step_size_1 = (0.001);
+    __cs_solver_2 = (0);
+    __log_level_3 = (3);
+    _x_6 = (1);
+    _z_7 = (0.5);
+    return ef;
+}
+
+int model_init_eval_independent(jmi_t* jmi) {
+    model_init_eval_independent_start(jmi);
+    return 0;
+}
+
+int model_init_eval_dependent(jmi_t* jmi) {
+    return 0;
+}
+
+int jmi_new(jmi_t** jmi, jmi_callbacks_t* jmi_callbacks) {
+
+    jmi_z_offset_strings(&(*jmi)->z_t.strings);
+
+    jmi_init(jmi, N_real_ci,      N_real_cd,      N_real_pi,      N_real_pi_s,
+                  N_real_pi_f,    N_real_pi_e,    N_real_pd,      N_integer_ci,
+                  N_integer_cd,   N_integer_pi,   N_integer_pi_s, N_integer_pi_f,
+                  N_integer_pi_e, N_integer_pd,   N_boolean_ci,   N_boolean_cd,
+                  N_boolean_pi,   N_boolean_pi_s, N_boolean_pi_f, N_boolean_pi_e,
+                  N_boolean_pd,   N_real_dx,      N_real_x,       N_real_u,
+                  N_real_w,       N_real_d,       N_integer_d,    N_integer_u,
+                  N_boolean_d,    N_boolean_u,    N_sw,           N_sw_init,
+                  N_time_sw,      N_state_sw,     N_guards,       N_guards_init,
+                  N_dae_blocks,   N_dae_init_blocks, N_initial_relations,
+                  (int (*))DAE_initial_relations, N_relations,
+                  (int (*))DAE_relations, N_dynamic_state_sets,
+                  (jmi_real_t *) DAE_nominals, Scaling_method, N_ext_objs,
+                  Homotopy_block, jmi_callbacks);
+
+    model_add_blocks(jmi);
+    model_init_add_blocks(jmi);
+
+    /* Initialize the model equations interface */
+    jmi_model_init(*jmi,
+                   *model_ode_derivatives_dir_der,
+                   *model_ode_derivatives,
+                   *model_ode_event_indicators,
+                   *model_ode_initialize,
+                   *model_init_eval_independent,
+                   *model_init_eval_dependent,
+                   *model_ode_next_time_event);
+
+    /* Initialize the delay interface */
+    jmi_init_delay_if(*jmi, N_delays, N_spatialdists, *model_init_delay,
+                      *model_sample_delay, N_delay_sw);
+
+    /* Initialize globals struct */
+    (*jmi)->globals = calloc(1, sizeof(jmi_globals_t));
+
+    return 0;
+}
+
+int jmi_destruct_external_objs(jmi_t* jmi) {
+    return 0;
+}
+
+const char *jmi_get_model_identifier() {
+    return FMI2_TEST_MODEL_ID;
+}
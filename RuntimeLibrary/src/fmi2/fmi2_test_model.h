@@ -0,0 +1,62 @@
+/*
+    Copyright (C) 2017 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+/*
+ * fmi2_test_model.h declares the model of fmi2_test_model.c, written in the
+ * form the compiler generates so that the FMI 2.0 runtime can be tested
+ * without compiling a Modelica model:
+ *
+ *   model NegatedAliasStates
+ *       Real x(start=1);
+ *       Real y;
+ *       Real z(start=0.5);
+ *       input Real u;
+ *   equation
+ *       y = -x;
+ *       der(y) = x*z + u;
+ *       der(z) = sin(y) - u*z;
+ *   end NegatedAliasStates;
+ *
+ * The states are x and z, y is a negated alias of x.
+ */
+
+#ifndef _FMI2_TEST_MODEL_H
+#define _FMI2_TEST_MODEL_H
+
+#define FMI2_TEST_MODEL_ID "NegatedAliasStates"
+
+/* Value references */
+#define FMI2_TEST_MODEL_VR_CS_REL_TOL   0
+#define FMI2_TEST_MODEL_VR_CS_STEP_SIZE 1
+#define FMI2_TEST_MODEL_VR_CS_SOLVER    268435458
+#define FMI2_TEST_MODEL_VR_LOG_LEVEL    268435459
+#define FMI2_TEST_MODEL_VR_DER_X        4
+#define FMI2_TEST_MODEL_VR_DER_Z        5
+#define FMI2_TEST_MODEL_VR_X            6
+#define FMI2_TEST_MODEL_VR_Z            7
+#define FMI2_TEST_MODEL_VR_U            8
+#define FMI2_TEST_MODEL_VR_Y            134217734
+
+/**
+ * \brief Called at the start of every evaluation of the model derivatives
+ * when set, lets a test block or count evaluations.
+ */
+extern void (*fmi2_test_model_derivatives_hook)(void);
+
+#endif
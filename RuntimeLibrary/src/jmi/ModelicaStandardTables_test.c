@@ -0,0 +1,252 @@
+/*
+    Copyright (C) 2018 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+/*
+ * ModelicaStandardTables_test.c tests of the local changes to the MSL
+ * table functions. The source is included to check the table and spline
+ * shares, it has to be compiled with TABLE_SHARE.
+ */
+
+/* Included first since it sets the feature test macros */
+#include "ModelicaStandardTables.c"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#if defined(_WIN32)
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
+static int n_failures = 0;
+
+#define CHECK(cond) \
+    if (!(cond)) { \
+        printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        n_failures++; \
+    }
+
+/* The table functions report errors through the Modelica utilities */
+void ModelicaMessage(const char *string) {
+    printf("%s", string);
+}
+
+void ModelicaVFormatMessage(const char *string, va_list args) {
+    vprintf(string, args);
+}
+
+void ModelicaFormatMessage(const char *string, ...) {
+    va_list args;
+    va_start(args, string);
+    ModelicaVFormatMessage(string, args);
+    va_end(args);
+}
+
+void ModelicaError(const char *string) {
+    printf("Error: %s", string);
+    exit(EXIT_FAILURE);
+}
+
+void ModelicaVFormatError(const char *string, va_list args) {
+    printf("Error: ");
+    vprintf(string, args);
+    exit(EXIT_FAILURE);
+}
+
+void ModelicaFormatError(const char *string, ...) {
+    va_list args;
+    va_start(args, string);
+    ModelicaVFormatError(string, args);
+    va_end(args);
+}
+
+char* ModelicaAllocateString(size_t len) {
+    return (char*)malloc(len + 1);
+}
+
+char* ModelicaAllocateStringWithErrorReturn(size_t len) {
+    return (char*)malloc(len + 1);
+}
+
+#define N_ROW 6
+#define N_COLUMN 4
+#define N_COLS 3
+
+/* Abscissa with a non-uniform grid and three ordinate columns */
+static double table[N_ROW*N_COLUMN] = {
+    0.0,  1.0,  0.0, -2.0,
+    0.5,  2.0,  0.3, -1.0,
+    1.5,  2.5,  1.1,  4.0,
+    2.0,  0.5,  1.2,  4.5,
+    3.5, -1.0,  3.0,  4.5,
+    4.0,  0.0,  2.0,  7.0
+};
+
+/*
+ * Compares the batched interpolation of all columns with the per-column
+ * functions. The batched functions do the same arithmetic, so the results
+ * must be bitwise identical.
+ */
+static void test_batched_values(double* tab, size_t nRow, int smoothness) {
+    int columns[N_COLS] = {3, 2, 4};
+    double u[] = {-1.0, 0.0, 0.25, 0.5, 0.7, 1.5, 1.9999, 2.0, 3.0, 4.0, 5.5,
+                  1.0, -0.5, 3.9};
+    double y[N_COLS], der_y[N_COLS];
+    size_t i, j;
+    void* tableID = ModelicaStandardTables_CombiTable1D_init("NoName", "NoName",
+        tab, nRow, N_COLUMN, columns, N_COLS, smoothness);
+
+    for (i = 0; i < sizeof(u)/sizeof(u[0]); i++) {
+        ModelicaStandardTables_CombiTable1D_getValues(tableID, u[i], y, N_COLS);
+        ModelicaStandardTables_CombiTable1D_getDerValues(tableID, u[i], 0.7,
+            der_y, N_COLS);
+        for (j = 0; j < N_COLS; j++) {
+            CHECK(y[j] == ModelicaStandardTables_CombiTable1D_getValue(
+                tableID, (int)j + 1, u[i]));
+            CHECK(der_y[j] == ModelicaStandardTables_CombiTable1D_getDerValue(
+                tableID, (int)j + 1, u[i], 0.7));
+        }
+    }
+
+    /* Fewer outputs than interpolated columns */
+    ModelicaStandardTables_CombiTable1D_getValues(tableID, 1.2, y, 2);
+    for (j = 0; j < 2; j++) {
+        CHECK(y[j] == ModelicaStandardTables_CombiTable1D_getValue(
+            tableID, (int)j + 1, 1.2));
+    }
+
+    ModelicaStandardTables_CombiTable1D_close(tableID);
+}
+
+#define TABLE_FILE "ModelicaStandardTables_test.txt"
+
+static void write_table_file(double scale, time_t mtime) {
+    struct utimbuf times;
+    FILE* fp = fopen(TABLE_FILE, "w");
+    CHECK(fp != NULL);
+    if (fp == NULL) {
+        return;
+    }
+    fprintf(fp, "#1\ndouble tab1(4,3)\n");
+    fprintf(fp, "0 0 %g\n1 %g 1\n2 %g 0\n3 %g 2\n", scale, scale,
+        4*scale, 9*scale);
+    fclose(fp);
+    /* The share compares modification times in seconds */
+    times.actime = mtime;
+    times.modtime = mtime;
+    CHECK(utime(TABLE_FILE, &times) == 0);
+}
+
+static CombiTable1D* open_file_table(int smoothness) {
+    int columns[2] = {2, 3};
+    void* tableID = ModelicaStandardTables_CombiTable1D_init("tab1",
+        TABLE_FILE, NULL, 0, 0, columns, 2, smoothness);
+    CHECK(ModelicaStandardTables_CombiTable1D_read(tableID, 0, 0) == 1.);
+    return (CombiTable1D*)tableID;
+}
+
+static size_t table_share_ref_count(void) {
+    TableShare* iter;
+    HASH_FIND_STR(tableShare, "tab1|" TABLE_FILE, iter);
+    return iter == NULL ? 0 : iter->refCount;
+}
+
+static size_t spline_share_ref_count(void* spline) {
+    SplineShare* iter;
+    SplineShare* tmp;
+    HASH_ITER(hh, splineShare, iter, tmp) {
+        if (iter->spline == spline) {
+            return iter->refCount;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Tests sharing of file tables and spline coefficients between table
+ * objects, private copies after file changes and forced reads, and that
+ * closing the objects releases the shares.
+ */
+static void test_table_share(void) {
+    const time_t mtime = time(NULL) - 100;
+    CombiTable1D *t1, *t2, *t3, *t4;
+
+    write_table_file(1.0, mtime);
+    t1 = open_file_table(AKIMA_C1);
+    t2 = open_file_table(AKIMA_C1);
+    t3 = open_file_table(LINEAR_SEGMENTS);
+
+    /* One table and one set of coefficients for equal settings */
+    CHECK(t1->table == t2->table && t1->table == t3->table);
+    CHECK(t1->spline != NULL && t1->spline == t2->spline);
+    CHECK(t3->spline == NULL);
+    CHECK(table_share_ref_count() == 3);
+    CHECK(spline_share_ref_count(t1->spline) == 2);
+    CHECK(HASH_COUNT(splineShare) == 1);
+
+    /* Objects opened after the file changed get a private copy */
+    write_table_file(2.0, mtime + 10);
+    t4 = open_file_table(AKIMA_C1);
+    CHECK(t4->table != t1->table);
+    CHECK(t4->spline != t1->spline);
+    CHECK(ModelicaStandardTables_CombiTable1D_getValue(t4, 1, 2.) == 8.);
+    CHECK(ModelicaStandardTables_CombiTable1D_getValue(t1, 1, 2.) == 4.);
+    CHECK(table_share_ref_count() == 3);
+    CHECK(HASH_COUNT(splineShare) == 2);
+
+    /* A forced read while shared leaves the other objects alone */
+    CHECK(ModelicaStandardTables_CombiTable1D_read(t2, 1, 0) == 1.);
+    CHECK(t2->table != t1->table && t2->table != t4->table);
+    CHECK(ModelicaStandardTables_CombiTable1D_getValue(t2, 1, 3.) == 18.);
+    CHECK(ModelicaStandardTables_CombiTable1D_getValue(t1, 1, 3.) == 9.);
+    CHECK(table_share_ref_count() == 2);
+    CHECK(spline_share_ref_count(t1->spline) == 1);
+    CHECK(spline_share_ref_count(t2->spline) == 1);
+
+    /* Closing releases the references and frees the shares */
+    ModelicaStandardTables_CombiTable1D_close(t1);
+    CHECK(table_share_ref_count() == 1);
+    CHECK(HASH_COUNT(splineShare) == 2);
+    ModelicaStandardTables_CombiTable1D_close(t2);
+    ModelicaStandardTables_CombiTable1D_close(t4);
+    CHECK(HASH_COUNT(splineShare) == 0);
+    CHECK(table_share_ref_count() == 1);
+    ModelicaStandardTables_CombiTable1D_close(t3);
+    CHECK(HASH_COUNT(tableShare) == 0);
+
+    remove(TABLE_FILE);
+}
+
+int main(int argc, char* argv[]) {
+    int smoothness;
+
+    for (smoothness = 1; smoothness <= 5; smoothness++) {
+        test_batched_values(table, N_ROW, smoothness);
+        test_batched_values(table, 1, smoothness);
+    }
+    test_table_share();
+
+    if (n_failures > 0) {
+        printf("%d checks failed\n", n_failures);
+        return EXIT_FAILURE;
+    }
+    printf("All tests passed\n");
+    return EXIT_SUCCESS;
+}
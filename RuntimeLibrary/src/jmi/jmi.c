@@ -244,6 +244,11 @@ int jmi_init(jmi_t** jmi,
     jmi_->updated_states = FALSE;
     
     jmi_->chattering = jmi_chattering_create(n_sw);
+    jmi_->ode_deps = NULL;
+    jmi_->param_deps = NULL;
+    jmi_->n_dae_iteration = 0;
+    jmi_->dae_iteration_x = NULL;
+    jmi_->dae_iteration_res = NULL;
     
     /* Work arrays */
     jmi_->real_x_work = (jmi_real_t*)calloc(jmi_->n_real_x,sizeof(jmi_real_t));
@@ -299,6 +304,7 @@ int jmi_init(jmi_t** jmi,
 
     jmi_->nbr_event_iter = 0;
     jmi_->nbr_consec_time_events = 0;
+    memset(&jmi_->block_solver_deadline, 0, sizeof(jmi_block_solver_deadline_t));
 
     jmi_->dyn_fcn_mem = jmi_dynamic_function_pool_create(JMI_MEMORY_POOL_SIZE);
     jmi_->dyn_fcn_mem_globals = jmi_dynamic_function_pool_create(JMI_MEMORY_POOL_SIZE);
@@ -331,6 +337,8 @@ int jmi_delete(jmi_t* jmi){
     free(jmi->dynamic_state_sets);
     
     jmi_chattering_delete(jmi->chattering);
+    jmi_ode_deps_delete(jmi->ode_deps);
+    jmi_param_deps_delete(jmi->param_deps);
 
     free(*(jmi->z));
     free(jmi->z);
@@ -450,7 +458,13 @@ int jmi_ode_derivatives(jmi_t* jmi) {
     }
 
     jmi->block_level = 0; /* to recover from errors */
+    jmi_block_solver_deadline_start(&jmi->block_solver_deadline, jmi->options.block_solver_options.time_budget);
     return_status = jmi_generic_func(jmi, jmi->model->ode_derivatives);
+    if (jmi_block_solver_deadline_stop(&jmi->block_solver_deadline) && return_status == 0) {
+        jmi_log_node(jmi->log, logWarning, "TimeBudgetExhausted",
+                     "The time budget of the equation blocks was exhausted at <t:%E>, <exhausted_evaluations:%d> and <fallback_solves:%d> in total.",
+                     t[0], (int)jmi->block_solver_deadline.nbr_exhausted, (int)jmi->block_solver_deadline.nbr_fallbacks);
+    }
 
     if ((jmi->jmi_callbacks.log_options.log_level >= 5)) {
         jmi_log_reals(jmi->log, node, logInfo, "Derivatives", jmi_get_real_dx(jmi), jmi->n_real_x);
@@ -597,12 +611,26 @@ void jmi_init_eval_dependent_set_dirty(jmi_t* jmi) {
 }
 
 int jmi_init_eval_dependent(jmi_t* jmi) {
-    return jmi_init_eval_generic(jmi,
+    int retval;
+    int evaluate = jmi->recompute_init_dependent == 1 && jmi->is_initialized == 0;
+
+    if (jmi->recompute_init_independent == 1) {
+        /* All start values are reset, nothing can be reused */
+        jmi_param_deps_invalidate(jmi);
+    }
+    if (evaluate) {
+        jmi_param_deps_begin(jmi);
+    }
+    retval = jmi_init_eval_generic(jmi,
                             jmi_init_eval_independent,
                             &jmi->recompute_init_dependent, 
                             jmi->model->init_eval_dependent, 
                             "DependentParametersEvaluationFailed",
                             "Error evaluating dependent parameters and start values");
+    if (evaluate) {
+        jmi_param_deps_end(jmi, retval);
+    }
+    return retval;
 }
 
 int jmi_destruct_external_objects(jmi_t* jmi) {
@@ -29,6 +29,8 @@
 #include "jmi_global.h"
 #include "jmi_block_solver.h"
 #include "jmi_delay.h"
+#include "jmi_ode_deps.h"
+#include "jmi_param_deps.h"
 #include "jmi_work_array.h"
 
 
@@ -438,6 +440,7 @@ struct jmi_t {
 
     int nbr_event_iter;                  /**< Counter for the nummber of global event iterations performed. */
     int nbr_consec_time_events;          /**< Counter for the nummber of consecutive time events handled (max should always be 2). */ 
+    jmi_block_solver_deadline_t block_solver_deadline; /**< \brief Time budget of the realtime equation block solvers in one model evaluation. */
 
     jmi_log_t* log;                      /**< \brief Struct containing the structured logger. */
 
@@ -470,6 +473,12 @@ struct jmi_t {
 
     jmi_modules_t modules;               /**< \brief Interchangable modules struct */
     jmi_chattering_t* chattering;        /**< \brief Contains chattering information, used for logging */
+    jmi_ode_deps_t* ode_deps;            /**< \brief Block dependencies of the ODE evaluation, may be NULL */
+    jmi_param_deps_t* param_deps;        /**< \brief Dependencies of the dependent parameters, may be NULL */
+
+    jmi_int_t n_dae_iteration;           /**< \brief Number of real iteration variables that can be unknowns of a DAE integrator */
+    jmi_real_t* dae_iteration_x;         /**< \brief Iteration variables given by the DAE integrator, NULL when the blocks are solved */
+    jmi_real_t* dae_iteration_res;       /**< \brief Block residuals for dae_iteration_x */
 
     jmi_dynamic_function_memory_t* dyn_fcn_mem;
     jmi_dynamic_function_memory_t* dyn_fcn_mem_globals;
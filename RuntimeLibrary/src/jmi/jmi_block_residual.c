@@ -46,6 +46,10 @@ int jmi_dae_add_equation_block(jmi_t* jmi, jmi_block_residual_func_t F, jmi_bloc
                                     n, n_sr, n_dr, n_nr, n_dinr, n_nrt, n_str,
                                     n_sw, n_disw, jacobian_variability, index, label);
     jmi->dae_block_residuals[index] = b;
+    if (b != 0 && n > 0 && n_dr == 0 && n_nr == 0 && n_str == 0) {
+        b->dae_iteration_offs = jmi->n_dae_iteration;
+        jmi->n_dae_iteration += n;
+    }
 #ifdef JMI_PROFILE_RUNTIME
     if (b != 0) {
         b->parent_index = parent_index;
@@ -498,6 +502,7 @@ int jmi_new_block_residual(jmi_block_residual_t** block, jmi_t* jmi, jmi_block_s
     b->n_direct_sw = n_disw;
     b->n_direct_bool = 0; /* Calculated in initialization */
     b->index = index;
+    b->dae_iteration_offs = -1;
 #ifdef JMI_PROFILE_RUNTIME
     b->parent_index = -1;
     b->is_init_block = -1;
@@ -576,6 +581,7 @@ int jmi_new_block_residual(jmi_block_residual_t** block, jmi_t* jmi, jmi_block_s
         b);
         
     b->block_solver->n_sr = n_sr;
+    jmi_block_solver_set_deadline(b->block_solver, &jmi->block_solver_deadline);
 
     switch(solver) {
     case JMI_SIMPLE_NEWTON_SOLVER:
@@ -605,11 +611,48 @@ int jmi_new_block_residual(jmi_block_residual_t** block, jmi_t* jmi, jmi_block_s
     return flag;
 }
 
+int jmi_dae_iteration_get(jmi_t* jmi, jmi_real_t* x, jmi_real_t* nominals) {
+    int i, ef = 0;
+    for (i = 0; i < jmi->n_dae_blocks; i++) {
+        jmi_block_residual_t* block = jmi->dae_block_residuals[i];
+        if (block->dae_iteration_offs >= 0) {
+            ef |= jmi_block_residual(block, x + block->dae_iteration_offs, NULL, JMI_BLOCK_INITIALIZE);
+            ef |= jmi_block_residual(block, nominals + block->dae_iteration_offs, NULL, JMI_BLOCK_NOMINAL);
+        }
+    }
+    return ef;
+}
+
+void jmi_dae_iteration_begin(jmi_t* jmi, jmi_real_t* x, jmi_real_t* res) {
+    jmi->dae_iteration_x = x;
+    jmi->dae_iteration_res = res;
+    memset(res, 0, jmi->n_dae_iteration * sizeof(jmi_real_t));
+    jmi->recomputeVariables = 1;
+    jmi_ode_deps_invalidate(jmi);
+}
+
+void jmi_dae_iteration_end(jmi_t* jmi) {
+    jmi->dae_iteration_x = NULL;
+    jmi->dae_iteration_res = NULL;
+    /* Block values from the iteration are not solutions, evaluate all blocks again */
+    jmi->recomputeVariables = 1;
+    jmi_ode_deps_invalidate(jmi);
+}
+
 int jmi_solve_block_residual(jmi_block_residual_t * block) {
     int ef, i, j;
-    clock_t c0 = jmi_block_solver_start_clock(block->block_solver); /*timers*/
+    clock_t c0;
     jmi_t* jmi = block->jmi;
 
+    if (jmi->dae_iteration_x != NULL && block->dae_iteration_offs >= 0) {
+        /* The iteration variables are unknowns of the DAE integrator, only evaluate the residual */
+        block->nb_calls++;
+        return block->F(jmi, jmi->dae_iteration_x + block->dae_iteration_offs,
+                        jmi->dae_iteration_res + block->dae_iteration_offs, JMI_BLOCK_EVALUATE);
+    }
+
+    c0 = jmi_block_solver_start_clock(block->block_solver); /*timers*/
+
     jmi->block_level++;
     block->event_iter = 0;
 
@@ -203,6 +203,7 @@ struct jmi_block_residual_t {
     int init;              /**< \brief A flag for initialization */
     int at_event;          /**< \brief A flag indicating if we are at an event */
     
+    int dae_iteration_offs;               /**< \brief Offset in jmi->dae_iteration_x, -1 if the block is always solved */
     long int nb_calls;                    /**< \brief Nb of times the block has been solved */
     long int nb_iters;                     /**< \breif Total nb if iterations of non-linear solver */
     long int nb_jevals ;
@@ -294,6 +295,37 @@ int jmi_new_block_residual(jmi_block_residual_t** block, jmi_t* jmi, jmi_block_s
                            int n_sw, int n_disw, int jacobian_variability, int index, jmi_string_t label);
 int jmi_solve_block_residual(jmi_block_residual_t * block);
 
+/**
+ * \brief Get the current values and nominals of the real iteration variables that can
+ * be unknowns of a DAE integrator, jmi->n_dae_iteration entries each.
+ *
+ * These are the iteration variables of the ODE blocks without non-real, string or
+ * discrete real unknowns.
+ *
+ * @param jmi A jmi_t struct.
+ * @param x The current values of the iteration variables.
+ * @param nominals The nominals of the iteration variables.
+ * @return Error code.
+ */
+int jmi_dae_iteration_get(jmi_t* jmi, jmi_real_t* x, jmi_real_t* nominals);
+
+/**
+ * \brief Let the ODE blocks evaluate their residuals for the iteration variables in x
+ * instead of solving for them, until jmi_dae_iteration_end() is called.
+ *
+ * @param jmi A jmi_t struct.
+ * @param x The iteration variables, jmi->n_dae_iteration entries.
+ * @param res The block residuals, jmi->n_dae_iteration entries.
+ */
+void jmi_dae_iteration_begin(jmi_t* jmi, jmi_real_t* x, jmi_real_t* res);
+
+/**
+ * \brief Solve the ODE blocks in later evaluations.
+ *
+ * @param jmi A jmi_t struct.
+ */
+void jmi_dae_iteration_end(jmi_t* jmi);
+
 /**
  * \brief Updates the pre() discrete values in the block.
  * 
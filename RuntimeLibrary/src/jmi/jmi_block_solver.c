@@ -22,10 +22,19 @@
  * This code can be compiled either with C or a C++ compiler.
  */
 
+/* For clock_gettime, has to be defined before the system headers are included */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
 
 #include <sundials/sundials_math.h>
 #include <sundials/sundials_direct.h>
@@ -680,6 +689,10 @@ int jmi_block_solver_solve(jmi_block_solver_t * block_solver, double cur_time, i
     }
     else{
         ef = block_solver->solve(block_solver);
+        if (ef == jmi_block_solver_status_time_budget_exhausted) {
+            /* The fallback solution is consistent, the exhausted budget is reported when the model evaluation ends */
+            ef = 0;
+        }
     }
 
     if(block_solver->init) {
@@ -698,6 +711,54 @@ int jmi_block_solver_solve(jmi_block_solver_t * block_solver, double cur_time, i
     return ef;
 }
 
+void jmi_block_solver_set_deadline(jmi_block_solver_t * block_solver, jmi_block_solver_deadline_t* deadline) {
+    block_solver->deadline = deadline;
+}
+
+/* Seconds from a monotonic clock, the budgets are in wall clock time */
+static double jmi_block_solver_deadline_time(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+#elif defined(RT) || defined(NO_FILE_SYSTEM)
+    /* Real-time targets without clock_gettime, the process is not preempted so processor time is wall clock time */
+    return ((double)clock())/CLOCKS_PER_SEC;
+#else
+#error "nle_solver_time_budget needs a monotonic clock, CLOCK_MONOTONIC is not defined"
+#endif
+}
+
+void jmi_block_solver_deadline_start(jmi_block_solver_deadline_t* deadline, double budget) {
+    deadline->budget = budget;
+    deadline->active = budget > 0.0;
+    deadline->exhausted = 0;
+    if (deadline->active) {
+        deadline->start = jmi_block_solver_deadline_time();
+    }
+}
+
+int jmi_block_solver_deadline_exceeded(jmi_block_solver_deadline_t* deadline) {
+    if (deadline == NULL || !deadline->active) {
+        return 0;
+    }
+    if (!deadline->exhausted && jmi_block_solver_deadline_time() - deadline->start >= deadline->budget) {
+        deadline->exhausted = 1;
+        deadline->nbr_exhausted++;
+    }
+    return deadline->exhausted;
+}
+
+int jmi_block_solver_deadline_stop(jmi_block_solver_deadline_t* deadline) {
+    deadline->active = 0;
+    return deadline->exhausted;
+}
+
 /** \brief Start the clock for profiling. */
 clock_t jmi_block_solver_start_clock(jmi_block_solver_t * block_solver) {
     clock_t time = 0;
@@ -783,6 +844,7 @@ void jmi_block_solver_init_default_options(jmi_block_solver_options_t* bsop) {
     bsop->jacobian_variability = JMI_CONTINUOUS_VARIABILITY;
     bsop->label = "";
     bsop->block_profiling = 0;
+    bsop->time_budget = 0.0;
 }
 
 static jmi_block_solver_status_t jmi_block_default_update_discrete_variables(void* b, int* non_reals_changed_flag) {
@@ -180,10 +180,21 @@ typedef enum jmi_block_solver_status_t {
     jmi_block_solver_status_inf_event_loop = 2,
     jmi_block_solver_status_event_non_converge = 3,
     jmi_block_solver_status_err_f_eval = 4,
-    jmi_block_solver_status_err_jac_eval = 5
+    jmi_block_solver_status_err_jac_eval = 5,
+    jmi_block_solver_status_time_budget_exhausted = 6 /**< \brief The block uses its last converged solution since the time budget is exhausted */
 } jmi_block_solver_status_t;
 
 
+/** \brief Time budget shared by the equation blocks solved in one model evaluation. */
+typedef struct jmi_block_solver_deadline_t {
+    double budget;              /**< \brief Time budget in seconds */
+    double start;               /**< \brief Start of the current model evaluation in seconds, from a monotonic clock */
+    int active;                 /**< \brief If a model evaluation with a budget is in progress */
+    int exhausted;              /**< \brief If the budget of the current, or last, model evaluation was exhausted */
+    long int nbr_exhausted;     /**< \brief Number of model evaluations that exhausted the budget */
+    long int nbr_fallbacks;     /**< \brief Number of block solves that used the last converged solution */
+} jmi_block_solver_deadline_t;
+
 /**
  * \brief Function signature for evaluation of a equation block residual
  * in the block solver interface.
@@ -371,6 +382,7 @@ struct jmi_block_solver_options_t {
     int start_from_last_integrator_step; /**< \brief If set, uses the iteration variables from the last integrator step as initial guess. */
     double jacobian_finite_difference_delta; /**< \brief Option for which delta to use in finite differences Jacobian, default sqrt(eps). */
     int block_profiling; /**< \brief Option for enabling profiling of the blocks. */
+    double time_budget;  /**< \brief Time budget in seconds for the realtime solver blocks in one model evaluation, 0 if there is none. */
     
     /* Options below are not supposed to change between invocations of the solver. */
     jmi_block_solver_kind_t solver;                          /**< \brief Kind of block solver to use */
@@ -404,6 +416,18 @@ clock_t jmi_block_solver_start_clock(jmi_block_solver_t * block_solver);
 /** \brief Stop the clock for profiling. */
 double jmi_block_solver_elapsed_time(jmi_block_solver_t * block_solver, clock_t start_clock);
 
+/** \brief Share a time budget with the block, deadline can be NULL. */
+void jmi_block_solver_set_deadline(jmi_block_solver_t * block_solver, jmi_block_solver_deadline_t* deadline);
+
+/** \brief Start a model evaluation with the given budget, a budget of 0 disables the deadline. */
+void jmi_block_solver_deadline_start(jmi_block_solver_deadline_t* deadline, double budget);
+
+/** \brief Returns 1 if the budget of the current model evaluation is exhausted, otherwise 0. */
+int jmi_block_solver_deadline_exceeded(jmi_block_solver_deadline_t* deadline);
+
+/** \brief End the model evaluation, returns 1 if the budget was exhausted during it. */
+int jmi_block_solver_deadline_stop(jmi_block_solver_deadline_t* deadline);
+
 /** \brief Notify the block that an integrator step is completed */
 int jmi_block_solver_completed_integrator_step(jmi_block_solver_t * block_solver);
 
@@ -54,6 +54,7 @@ struct jmi_block_solver_t {
     jmi_real_t* dres;              /**< \brief Work vector for the directional derivative that corresponds to dx */
     jmi_real_t* jac;               /**< \brief Work vector for the block Jacobian */
     int* ipiv;                     /**< \brief Work vector needed for dgesv */
+    jmi_block_solver_deadline_t* deadline; /**< \brief Time budget shared with the other blocks, NULL if there is none */
 #ifdef JMI_PROFILE_RUNTIME
     jmi_block_solver_t * parent_block;
     int is_init_block;
@@ -102,6 +102,80 @@ jmi_block_solver_status_t update_discrete_variables(switch_state_t *sw, int* non
     return jmi_block_solver_status_success;
 }
 
+/*
+Solving x*x*x + x = B with the iteration variable written to the state on evaluation,
+like the generated code does.
+*/
+int g(switch_state_t *sw, double* x, double* res, int evaluation_mode) {
+    if (evaluation_mode == JMI_BLOCK_NOMINAL) {
+        x[0] = 1;
+    } else if (evaluation_mode == JMI_BLOCK_MIN) {
+        x[0] = -100;
+    } else if (evaluation_mode == JMI_BLOCK_MAX) {
+        x[0] = 100;
+    } else if (evaluation_mode == JMI_BLOCK_VALUE_REFERENCE) {
+        x[0] = 1;
+    } else if (evaluation_mode == JMI_BLOCK_EQUATION_NOMINAL) {
+        (res)[0] = 1;
+    } else if (evaluation_mode == JMI_BLOCK_INITIALIZE) {
+        x[0] = sw->x;
+    } else if (evaluation_mode == JMI_BLOCK_EVALUATE) {
+        sw->x = x[0];
+        (res)[0] = x[0]*x[0]*x[0] + x[0] - sw->b;
+    } else if (evaluation_mode == JMI_BLOCK_WRITE_BACK) {
+        sw->x = x[0];
+    }
+    return 0;
+}
+
+/*
+Solves a block with the realtime solver and checks that it falls back to
+the last converged solution when the time budget of the evaluation is exhausted.
+*/
+int test_realtime_deadline(jmi_callbacks_t* cb, jmi_log_t* log) {
+    jmi_block_solver_t* block_solver;
+    jmi_block_solver_options_t options;
+    jmi_block_solver_callbacks_t solver_callbacks;
+    jmi_block_solver_deadline_t deadline = {0};
+    switch_state_t sw = {0};
+    int flag = 0;
+
+    sw.b = 2;
+    sw.log = log;
+    sw.cb = cb;
+    jmi_block_solver_init_default_options(&options);
+    options.solver = JMI_REALTIME_SOLVER;
+
+    solver_callbacks = jmi_block_solver_default_callbacks();
+    solver_callbacks.F = g;
+    jmi_new_block_solver(&block_solver, cb, log, solver_callbacks, 1, &options, &sw);
+    jmi_block_solver_set_deadline(block_solver, &deadline);
+    jmi_block_solver_solve(block_solver, 0, 0, 0);
+    if (JMI_ABS(sw.x - 1) > 1e-6) {
+        flag = -1;
+    }
+
+    /* Exhaust the budget before the block is solved */
+    sw.b = 10;
+    jmi_block_solver_deadline_start(&deadline, 1e-9);
+    while (!jmi_block_solver_deadline_exceeded(&deadline)) {}
+    if (jmi_block_solver_solve(block_solver, 1, 0, 0) != 0) {
+        flag = -1;
+    }
+    if (!jmi_block_solver_deadline_stop(&deadline) || deadline.nbr_fallbacks != 1 || deadline.nbr_exhausted != 1 || JMI_ABS(sw.x - 1) > 1e-6) {
+        flag = -1;
+    }
+
+    /* Without a budget the block is solved again */
+    jmi_block_solver_deadline_start(&deadline, 0.0);
+    jmi_block_solver_solve(block_solver, 2, 0, 0);
+    if (jmi_block_solver_deadline_stop(&deadline) || deadline.nbr_fallbacks != 1 || deadline.nbr_exhausted != 1 || JMI_ABS(sw.x - 2) > 1e-6) {
+        flag = -1;
+    }
+    jmi_delete_block_solver(&block_solver);
+    return flag;
+}
+
 int main() {
     jmi_block_solver_t* block_solver;
     jmi_block_solver_options_t options;
@@ -147,5 +221,8 @@ int main() {
 	if (JMI_ABS(sw.x - 1.3333333333) > 1e-4) {
         return -1; /* Something went wrong */
     }
+    if (test_realtime_deadline(&cb, log)) {
+        return -1;
+    }
     return 0;
 }
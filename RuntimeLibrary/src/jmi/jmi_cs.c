@@ -61,14 +61,20 @@ int jmi_cs_check_discrete_input_change(jmi_t*                       jmi,
     return 0; /* No changed detected */
 }
 
-int jmi_cs_check_input_change(jmi_t* jmi, const jmi_value_reference vrs[], size_t nvr, const jmi_real_t* values) {
+int jmi_cs_check_input_change(jmi_t* jmi, const jmi_value_reference vrs[], size_t nvr, const jmi_real_t* values, jmi_real_t rel_tol) {
     size_t i, z_index;
     int is_real_input;
+    jmi_real_t old_value, new_value;
     
     for (i = 0; i < nvr; i++) {
         z_index = jmi_get_index_from_value_ref(vrs[i]);
         is_real_input = (z_index >= jmi->offs_real_u && z_index < jmi->offs_real_w);
-        if (is_real_input && (*jmi->z)[z_index] != ((jmi_real_t*)values)[i]) {
+        if (!is_real_input) {
+            continue;
+        }
+        old_value = (*jmi->z)[z_index];
+        new_value = ((jmi_real_t*)values)[i];
+        if (jmi_abs(new_value - old_value) > rel_tol * JMI_MAX(1.0, JMI_MAX(jmi_abs(old_value), jmi_abs(new_value)))) {
             jmi_log_node(jmi->log, logInfo, "CoSimulationInputs",
                     "Detected change of inputs, will re-initialize the solver.");
             return 1; /* Detected change */
@@ -78,6 +84,67 @@ int jmi_cs_check_input_change(jmi_t* jmi, const jmi_value_reference vrs[], size_
     return 0;
 }
 
+void jmi_cs_record_input_history(jmi_cs_data_t* cs_data, jmi_t* jmi, const jmi_value_reference vrs[], size_t nvr, const jmi_real_t* values, jmi_real_t time) {
+    size_t i, z_index;
+    jmi_cs_input_history_t* history;
+    
+    for (i = 0; i < nvr; i++) {
+        z_index = jmi_get_index_from_value_ref(vrs[i]);
+        if (z_index < jmi->offs_real_u || z_index >= jmi->offs_real_u + cs_data->n_real_inputs) {
+            continue;
+        }
+        history = &cs_data->input_history[z_index - jmi->offs_real_u];
+        if (history->n > 0 && history->t[1] == time) {
+            history->value[1] = values[i];
+            continue;
+        }
+        history->t[0] = history->t[1];
+        history->value[0] = history->value[1];
+        history->t[1] = time;
+        history->value[1] = values[i];
+        history->n = JMI_MIN(history->n + 1, 2);
+    }
+}
+
+int jmi_cs_extrapolate_input_history(jmi_cs_data_t* cs_data, jmi_t* jmi, jmi_real_t time) {
+    jmi_cs_real_input_t* real_inputs = cs_data->real_inputs;
+    jmi_cs_input_history_t* history;
+    size_t i, j, z_index;
+    int n_extrapolated = 0;
+    
+    for (i = 0; i < cs_data->n_real_inputs; i++) {
+        history = &cs_data->input_history[i];
+        if (history->n < 2 || history->t[1] != time || history->t[1] <= history->t[0]) {
+            continue;
+        }
+        
+        /* Input derivatives set by the user take precedence */
+        z_index = jmi->offs_real_u + i;
+        for (j = 0; j < cs_data->n_real_inputs; j++) {
+            if (real_inputs[j].active == TRUE && jmi_get_index_from_value_ref(real_inputs[j].vr) == z_index) {
+                break;
+            }
+        }
+        if (j < cs_data->n_real_inputs) {
+            continue;
+        }
+        
+        for (j = 0; j < cs_data->n_real_inputs; j++) {
+            if (real_inputs[j].active == FALSE) {
+                jmi_cs_init_real_input_struct(&(real_inputs[j]));
+                real_inputs[j].active = TRUE;
+                real_inputs[j].vr = (jmi_value_reference)z_index;
+                real_inputs[j].input_derivatives[0] = (history->value[1] - history->value[0]) /
+                                                      (history->t[1] - history->t[0]);
+                n_extrapolated++;
+                break;
+            }
+        }
+    }
+    
+    return n_extrapolated;
+}
+
 int jmi_cs_set_real_input_derivatives(jmi_cs_data_t* cs_data, jmi_log_t* log, 
         const jmi_value_reference vr[], size_t nvr, const int order[],
         const jmi_real_t value[]) {
@@ -136,6 +203,31 @@ int jmi_cs_set_real_input_derivatives(jmi_cs_data_t* cs_data, jmi_log_t* log,
     return 0;
 }
 
+size_t jmi_cs_extrapolate_real_inputs(jmi_cs_data_t* cs_data, jmi_real_t time) {
+    jmi_cs_real_input_t* real_inputs = cs_data->real_inputs;
+    size_t i, n = 0;
+    int j;
+    jmi_real_t dt, acc;
+    
+    for (i = 0; i < cs_data->n_real_inputs; i++) {
+        if (real_inputs[i].active == FALSE) {
+            continue;
+        }
+        /* Horner form of value + sum dt^(j+1)*derivative_j/factor_j */
+        dt = time - real_inputs[i].tn;
+        acc = 0.0;
+        for (j = JMI_CS_MAX_INPUT_DERIVATIVES - 1; j >= 0; j--) {
+            acc = acc * dt + real_inputs[i].input_derivatives[j] /
+                             real_inputs[i].input_derivatives_factor[j];
+        }
+        cs_data->input_vrs[n] = real_inputs[i].vr;
+        cs_data->input_values[n] = real_inputs[i].value + dt * acc;
+        n++;
+    }
+    
+    return n;
+}
+
 int jmi_cs_init_real_input_struct(jmi_cs_real_input_t* real_input) {
     int i = 0;
     jmi_real_t fac[JMI_CS_MAX_INPUT_DERIVATIVES] = {1,2,6};
@@ -158,6 +250,15 @@ void jmi_free_cs_data(jmi_cs_data_t* cs_data) {
     if (cs_data->real_inputs != NULL) {
         free(cs_data->real_inputs);
     }
+    if (cs_data->input_history != NULL) {
+        free(cs_data->input_history);
+    }
+    if (cs_data->input_vrs != NULL) {
+        free(cs_data->input_vrs);
+    }
+    if (cs_data->input_values != NULL) {
+        free(cs_data->input_values);
+    }
     
     free(cs_data);
 }
@@ -166,6 +267,7 @@ void jmi_reset_cs_data(jmi_cs_data_t* cs_data) {
     size_t i;
     
     memset(cs_data->real_inputs, 0, cs_data->n_real_inputs* sizeof(jmi_cs_real_input_t));
+    memset(cs_data->input_history, 0, cs_data->n_real_inputs* sizeof(jmi_cs_input_history_t));
     for (i = 0; i < cs_data->n_real_inputs; i++) {
         jmi_cs_init_real_input_struct(&(cs_data->real_inputs[i]));
     }
@@ -179,8 +281,12 @@ jmi_cs_data_t* jmi_new_cs_data(void* fmix_me, size_t n_real_inputs) {
     cs_data->fmix_me = fmix_me;
     cs_data->n_real_inputs = n_real_inputs;
     cs_data->real_inputs = (jmi_cs_real_input_t*)calloc(n_real_inputs, sizeof(jmi_cs_real_input_t));
-    if (cs_data->real_inputs == NULL) {
-        free(cs_data);
+    cs_data->input_history = (jmi_cs_input_history_t*)calloc(n_real_inputs, sizeof(jmi_cs_input_history_t));
+    cs_data->input_vrs = (jmi_value_reference*)calloc(n_real_inputs, sizeof(jmi_value_reference));
+    cs_data->input_values = (jmi_real_t*)calloc(n_real_inputs, sizeof(jmi_real_t));
+    if (cs_data->real_inputs == NULL || cs_data->input_history == NULL ||
+        cs_data->input_vrs == NULL || cs_data->input_values == NULL) {
+        jmi_free_cs_data(cs_data);
         return NULL;
     }
 
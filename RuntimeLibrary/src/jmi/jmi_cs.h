@@ -35,9 +35,18 @@ struct jmi_cs_real_input_t {
     jmi_real_t input_derivatives_factor[JMI_CS_MAX_INPUT_DERIVATIVES];
 };
 
+typedef struct {
+    jmi_real_t t[2];                /**< \brief The two latest communication points where the input was set. */
+    jmi_real_t value[2];            /**< \brief The input values at the communication points in t. */
+    int n;                          /**< \brief Number of valid entries in t and value. */
+} jmi_cs_input_history_t;
+
 typedef struct {
     jmi_cs_real_input_t* real_inputs;   /**< \brief List of real inputs with derivative information */
     size_t n_real_inputs;               /**< \brief Number of real inputs in real_inputs list */
+    jmi_cs_input_history_t* input_history; /**< \brief Set values of each real input, indexed as in z */
+    jmi_value_reference* input_vrs;     /**< \brief Work array with value references of the extrapolated inputs */
+    jmi_real_t* input_values;           /**< \brief Work array with values of the extrapolated inputs */
     
     void* fmix_me;                      /**< \brief The underlying Model Exchange/ODE implementation */
 } jmi_cs_data_t;
@@ -66,17 +75,63 @@ int jmi_cs_check_discrete_input_change(jmi_t*                       jmi,
 /**
  * \brief Checks if the user is changing the values of any real inputs.
  * 
+ * A change is only detected if it is larger than rel_tol*max(1, |old|, |new|),
+ * so rel_tol = 0 detects any change.
+ * 
  * @param jmi The jmi_t struct.
  * @param vr The value references of values the user is setting.
  * @param nvr The number of value references.
  * @param value The new values for variables.
+ * @param rel_tol The relative size of changes that are ignored.
  * @return True if the input would result in changes of real inputs sent to
  * a fmiX_set_XXX function.
  */
 int jmi_cs_check_input_change(jmi_t*                       jmi,
                                        const jmi_value_reference    vr[],
                                        size_t                       nvr,
-                                       const jmi_real_t*                  value);
+                                       const jmi_real_t*                  value,
+                                       jmi_real_t                   rel_tol);
+
+/**
+ * \brief Records the values the user sets for real inputs at a communication
+ * point. A value set again at the same time replaces the previous one.
+ * 
+ * @param cs_data The jmi_cs_data_t struct.
+ * @param jmi The jmi_t struct.
+ * @param vr The value references of values the user is setting.
+ * @param nvr The number of value references.
+ * @param value The new values for variables.
+ * @param time The current communication point.
+ */
+void jmi_cs_record_input_history(jmi_cs_data_t*               cs_data,
+                                 jmi_t*                       jmi,
+                                 const jmi_value_reference    vr[],
+                                 size_t                       nvr,
+                                 const jmi_real_t*            value,
+                                 jmi_real_t                   time);
+
+/**
+ * \brief Activates a first order input derivative for the real inputs that
+ * were set at the current communication point but have no input derivatives,
+ * using the slope between the two latest communication points.
+ * 
+ * @param cs_data The jmi_cs_data_t struct.
+ * @param jmi The jmi_t struct.
+ * @param time The current communication point.
+ * @return The number of extrapolated inputs.
+ */
+int jmi_cs_extrapolate_input_history(jmi_cs_data_t* cs_data, jmi_t* jmi, jmi_real_t time);
+
+/**
+ * \brief Evaluates the Taylor polynomials of all active real inputs at the
+ * given time. The value references and values are stored in the input_vrs and
+ * input_values work arrays, so that they can be set with one call.
+ * 
+ * @param cs_data The jmi_cs_data_t struct.
+ * @param time The time to extrapolate the inputs to.
+ * @return The number of active real inputs.
+ */
+size_t jmi_cs_extrapolate_real_inputs(jmi_cs_data_t* cs_data, jmi_real_t time);
 
 /**
  * \brief Frees all data for struct allocated by the jmi_new_cs_data function.
@@ -408,6 +408,33 @@ int jmi_get_directional_derivative(jmi_t* jmi,
     return ef;
 }
 
+int jmi_get_state_directional_derivative(jmi_t* jmi, const jmi_real_t dx[], jmi_real_t ddx[], size_t nx) {
+    jmi_real_t* store_dz = jmi->dz[0];
+    int i, ef;
+    int offs_x = jmi->offs_real_x - jmi->offs_real_dx;
+    
+    jmi->dz[0]                  = jmi->dz_active_variables_buf[jmi->dz_active_index];
+    jmi->dz_active_variables[0] = jmi->dz_active_variables_buf[jmi->dz_active_index];
+
+    for (i = 0; i < jmi->n_v; i++) {
+        jmi->dz_active_variables[0][i] = 0;
+    }
+    for (i = 0; i < nx; i++) {
+        jmi->dz_active_variables[0][offs_x + i] = dx[i];
+    }
+
+    ef = jmi_ode_derivatives_dir_der(jmi);
+
+    for (i = 0; i < nx; i++) {
+        ddx[i] = jmi->dz_active_variables[0][i];
+    }
+
+    jmi->dz_active_variables[0] = jmi->dz_active_variables_buf[jmi->dz_active_index];
+    jmi->dz[0] = store_dz;
+
+    return ef;
+}
+
 int jmi_get_derivatives(jmi_t* jmi, jmi_real_t derivatives[] , size_t nx) {
     
     /* Transfer control to module */
@@ -438,6 +465,25 @@ int jmi_set_continuous_states(jmi_t* jmi, const jmi_real_t x[], size_t nx) {
     return jmi_set_continuous_states_impl(jmi, x, nx);
 }
 
+int jmi_ode_set_point(jmi_t* jmi, jmi_real_t time, const jmi_real_t x[], size_t nx,
+                      const jmi_value_reference input_vrs[], const jmi_real_t input_values[], size_t n_inputs) {
+
+    if (jmi->user_terminate == 1) {
+        jmi_log_node(jmi->log, logError, "CannotSetVariable",
+                         "Cannot set continuous states when the model is terminated");
+        return -1;
+    }
+
+    /* Transfer control to module */
+    return jmi_ode_set_point_impl(jmi, time, x, nx, input_vrs, input_values, n_inputs);
+}
+
+int jmi_ode_get_derivatives(jmi_t* jmi, jmi_real_t dx[], size_t nx) {
+
+    /* Transfer control to module */
+    return jmi_ode_get_derivatives_impl(jmi, dx, nx);
+}
+
 int jmi_completed_integrator_step(jmi_t* jmi, jmi_real_t* triggered_event) {
     int retval = 0;
     jmi_log_node_t node={0};
@@ -624,6 +670,9 @@ int jmi_enter_event_mode(jmi_t* jmi) {
     /* Reset terminate flag. */
     jmi->model_terminate = 0;
     
+    /* The first event iteration evaluates all blocks */
+    jmi_ode_deps_invalidate(jmi);
+    
     /* Initial evaluation of model so that we enter the event iteration with correct values. */
     /* TODO, make sure all blocks are updated */
     retval = jmi_ode_derivatives(jmi);
@@ -673,6 +722,7 @@ int jmi_event_iteration(jmi_t* jmi, jmi_boolean intermediate_results,
                             
     jmi_int_t retval;
     jmi_int_t i, max_iterations;
+    jmi_int_t incremental = 0;
     jmi_real_t* z = jmi_get_z(jmi);
     jmi_real_t* switches;
     jmi_log_node_t top_node={0};
@@ -723,12 +773,21 @@ int jmi_event_iteration(jmi_t* jmi, jmi_boolean intermediate_results,
         
         /* Copy current values to pre values */
         if (jmi->nbr_event_iter > 1) {
+            /* Only the blocks affected by the changes in the last iteration need to be evaluated */
+            incremental = jmi_ode_deps_begin(jmi);
             jmi_copy_pre_values(jmi);
         }
 
         /* Evaluate the ODE */
         retval = jmi_ode_derivatives(jmi);
         
+        if (incremental) {
+            jmi_ode_deps_end(jmi);
+            jmi_log_fmt(jmi->log, iter_node, logInfo, "Evaluated <evaluated_blocks:%d> of <blocks:%d> blocks",
+                        jmi->ode_deps->n_evaluated, jmi->ode_deps->n_blocks);
+            incremental = 0;
+        }
+        
         if(retval != 0) {
             jmi_log_comment(jmi->log, logError, "Evaluation of model equations during event iteration failed.");
             jmi_log_unwind(jmi->log, top_node);
@@ -777,6 +836,7 @@ int jmi_event_iteration(jmi_t* jmi, jmi_boolean intermediate_results,
             int verify_state_value_changed = 0;
             event_info->iteration_converged = FALSE;
             event_info->state_values_changed = TRUE;
+            jmi_ode_deps_invalidate(jmi);
             
             reinit_node =jmi_log_enter_fmt(jmi->log, logInfo, "ReInitTriggered", 
                                 "A reinit triggered during the last event iteration.");
@@ -1110,12 +1170,39 @@ void jmi_update_runtime_options(jmi_t* jmi) {
     index = get_option_index("_block_solver_profiling");
     if(index)
         bsop->block_profiling  = (int)z[index];
+    index = get_option_index("_nle_solver_time_budget");
+    if(index)
+        bsop->time_budget = z[index];
     index = get_option_index("_cs_solver");
     if(index)
         op->cs_solver = (int)z[index];
+    index = get_option_index("_cs_rk_method");
+    if(index)
+        op->cs_rk_method = (int)z[index];
+    index = get_option_index("_cs_rosenbrock_method");
+    if(index)
+        op->cs_rosenbrock_method = (int)z[index];
+    index = get_option_index("_cs_jacobian_update_interval");
+    if(index)
+        op->cs_jacobian_update_interval = (int)z[index];
+    index = get_option_index("_cs_linear_solver");
+    if(index)
+        op->cs_linear_solver = (int)z[index];
+    index = get_option_index("_cs_precond_block_size");
+    if(index)
+        op->cs_precond_block_size = (int)z[index];
+    index = get_option_index("_cs_num_threads");
+    if(index)
+        op->cs_num_threads = (int)z[index];
     index = get_option_index("_cs_rel_tol");
     if(index)
         op->cs_rel_tol = z[index];
+    index = get_option_index("_cs_input_reinit_tol");
+    if(index)
+        op->cs_input_reinit_tol = z[index];
+    index = get_option_index("_cs_async_do_step");
+    if(index)
+        op->cs_async_do_step = (int)z[index];
     index = get_option_index("_cs_step_size");
     if(index)
         op->cs_step_size = z[index];
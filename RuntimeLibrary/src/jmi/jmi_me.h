@@ -95,6 +95,11 @@ int jmi_get_directional_derivative(jmi_t* jmi,
                 const jmi_value_reference vKnown_ref[],   size_t nKnown,
                 const jmi_real_t dvKnown[], jmi_real_t dvUnknown[]);
 
+/**
+ * \brief Directional derivative of the state derivatives in the direction dx of the states.
+ */
+int jmi_get_state_directional_derivative(jmi_t* jmi, const jmi_real_t dx[], jmi_real_t ddx[], size_t nx);
+
 int jmi_get_derivatives(jmi_t* jmi, jmi_real_t derivatives[] , size_t nx);
 
 int jmi_get_event_indicators(jmi_t* jmi, jmi_real_t eventIndicators[], size_t ni);
@@ -115,6 +120,21 @@ int jmi_set_time(jmi_t* jmi, jmi_real_t time);
 
 int jmi_set_continuous_states(jmi_t* jmi, const jmi_real_t x[], size_t nx);
 
+/**
+ * \brief Set the time, the continuous states and the extrapolated real inputs for an integrator evaluation.
+ *
+ * Internal path for the co-simulation integrators. The values are written directly into z
+ * without the checks of jmi_set_real, the inputs were checked when they were set by the user.
+ * Negated value references are handled here, so input_values are the values of the input variables.
+ */
+int jmi_ode_set_point(jmi_t* jmi, jmi_real_t time, const jmi_real_t x[], size_t nx,
+                      const jmi_value_reference input_vrs[], const jmi_real_t input_values[], size_t n_inputs);
+
+/**
+ * \brief Evaluate the derivatives for an integrator, same as jmi_get_derivatives but without its logging.
+ */
+int jmi_ode_get_derivatives(jmi_t* jmi, jmi_real_t dx[], size_t nx);
+
 int jmi_update_and_terminate(jmi_t* jmi);
 
 /**
@@ -20,7 +20,11 @@
 #include <string.h>
 #include <cvode/cvode.h>             /* main integrator header file */
 #include <cvode/cvode_dense.h>       /* use CVDENSE linear solver */
+#include <cvode/cvode_spgmr.h>       /* use CVSPGMR linear solver */
+#include <cvode/cvode_spbcgs.h>      /* use CVSPBCG linear solver */
+#include <sundials/sundials_dense.h> /* dense LU for the preconditioner blocks */
 #include <nvector/nvector_serial.h>  /* serial N_Vector types, fct. and macros */
+#include <nvector/nvector_pthreads.h>/* threaded N_Vector for large state vectors */
 #include <sundials/sundials_types.h> /* definition of realtype */
 #include <sundials/sundials_math.h>  /* contains the macros ABS, SQR, and EXP*/
 #include "jmi_ode_solver_impl.h"
@@ -28,14 +32,26 @@
 #include "jmi_ode_cvode.h"
 #include "jmi_log.h"
 
+/* Relative tolerance for the check of the directional derivatives against a difference quotient */
+#define JMI_ODE_CVODE_DIR_DER_RTOL 1e-3
+
+/* Creates a state sized vector, threaded if more than one thread is requested. 
+ * All vectors used by CVode are cloned from the state vector. */
+static N_Vector jmi_ode_cvode_new_vector(jmi_ode_solver_t* solver, long int n) {
+    if (solver->num_threads > 1) {
+        return N_VNew_Pthreads(n, solver->num_threads);
+    }
+    return N_VNew_Serial(n);
+}
+
 int cv_rhs(realtype t, N_Vector yy, N_Vector yydot, void *problem_data){
     realtype *y, *ydot;
     int flag;
     jmi_ode_solver_t* solver = (jmi_ode_solver_t*)problem_data;
     jmi_ode_problem_t* p = solver -> ode_problem;
 
-    y = NV_DATA_S(yy); /*y is now a vector of realtype*/
-    ydot = NV_DATA_S(yydot); /*ydot is now a vector of realtype*/
+    y = N_VGetArrayPointer(yy); /*y is now a vector of realtype*/
+    ydot = N_VGetArrayPointer(yydot); /*ydot is now a vector of realtype*/
 
     flag = p->ode_callbacks.rhs_func(t, y, ydot, p->sizes, p->problem_data);
     if(flag != 0) {
@@ -57,7 +73,7 @@ int cv_root(realtype t, N_Vector yy, realtype *gout,  void* problem_data){
     jmi_ode_solver_t* solver = (jmi_ode_solver_t*)problem_data;
     jmi_ode_problem_t* p = solver -> ode_problem;
 
-    y = NV_DATA_S(yy); /*y is now a vector of realtype*/
+    y = N_VGetArrayPointer(yy); /*y is now a vector of realtype*/
 
     flag = p->ode_callbacks.root_func(t, y, gout, p->sizes, p->problem_data);
     if(flag != 0) {
@@ -80,6 +96,211 @@ void cv_err(int error_code, const char *module,const char *function, char *msg,
     }        
 }
 
+/* Product of the state Jacobian and v, from the directional derivatives if the model provides them */
+static int cv_jac_times(jmi_ode_solver_t* solver, realtype t, N_Vector y, N_Vector fy,
+                        N_Vector v, N_Vector jv, N_Vector tmp) {
+    jmi_ode_cvode_t* integrator = (jmi_ode_cvode_t*)solver->integrator;
+    jmi_ode_problem_t* p = solver -> ode_problem;
+    realtype vnorm, sigma, scale, diff;
+    int flag;
+    
+    if (integrator->use_dir_der != 0 && p->ode_callbacks.dir_der_func != NULL) {
+        flag = p->ode_callbacks.dir_der_func(t, N_VGetArrayPointer(y), N_VGetArrayPointer(v), N_VGetArrayPointer(jv), p->sizes, p->problem_data);
+        if (integrator->use_dir_der == 1) {
+            return flag;
+        }
+        /* First product, check the directional derivatives against a difference quotient */
+        integrator->use_dir_der = 0;
+        diff = -1.0;
+        if (flag == 0 && cv_jac_times(solver, t, y, fy, v, integrator->jv_work, tmp) == 0) {
+            scale = SUNMAX(N_VMaxNorm(jv), N_VMaxNorm(integrator->jv_work));
+            N_VLinearSum(1.0, jv, -1.0, integrator->jv_work, tmp);
+            diff = N_VMaxNorm(tmp);
+            if (diff <= JMI_ODE_CVODE_DIR_DER_RTOL * scale) {
+                integrator->use_dir_der = 1;
+            }
+        }
+        jmi_log_node(p->log, logInfo, "JacobianTimesVector", "Using <directional_derivatives: %d> for the Jacobian-vector products, "
+                     "<difference: %g> from the difference quotient.", integrator->use_dir_der, diff);
+        if (integrator->use_dir_der == 0) {
+            N_VScale(1.0, integrator->jv_work, jv);
+        }
+        return 0;
+    }
+    
+    /* Difference quotient */
+    vnorm = N_VMaxNorm(v);
+    if (vnorm == 0.0) {
+        N_VConst(0.0, jv);
+        return 0;
+    }
+    sigma = SUNRsqrt(UNIT_ROUNDOFF) * SUNMAX(N_VMaxNorm(y), 1.0) / vnorm;
+    N_VLinearSum(sigma, v, 1.0, y, tmp);
+    flag = p->ode_callbacks.rhs_func(t, N_VGetArrayPointer(tmp), N_VGetArrayPointer(jv), p->sizes, p->problem_data);
+    if (flag != 0) {
+        return flag;
+    }
+    N_VLinearSum(1.0/sigma, jv, -1.0/sigma, fy, jv);
+    return 0;
+}
+
+int cv_jtimes(N_Vector v, N_Vector jv, realtype t, N_Vector y, N_Vector fy, void *problem_data, N_Vector tmp) {
+    jmi_ode_solver_t* solver = (jmi_ode_solver_t*)problem_data;
+    
+    if (cv_jac_times(solver, t, y, fy, v, jv, tmp) != 0) {
+        jmi_log_node(solver->ode_problem->log, logWarning, "Warning",
+                     "Evaluating the Jacobian-vector product failed (recoverable error).");
+        return 1; /* Recoverable failure */
+    }
+    return 0;
+}
+
+/*
+ * Block diagonal preconditioner P = I - gamma*J, where only the diagonal blocks of J are kept.
+ * The columns with the same position in their block are computed with one product, so that
+ * coupling between blocks is lumped into the diagonal blocks.
+ */
+int cv_psetup(realtype t, N_Vector y, N_Vector fy, booleantype jok, booleantype *jcurPtr,
+              realtype gamma, void *problem_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3) {
+    jmi_ode_solver_t* solver = (jmi_ode_solver_t*)problem_data;
+    jmi_ode_cvode_t* integrator = (jmi_ode_cvode_t*)solver->integrator;
+    jmi_ode_problem_t* p = solver -> ode_problem;
+    long int n = p->sizes.states, bs = integrator->precond_block_size;
+    long int i, j, k, c, nb;
+    realtype* v = N_VGetArrayPointer(integrator->v_work);
+    realtype* jv = N_VGetArrayPointer(tmp1);
+    
+    if (!jok) {
+        for (c = 0; c < bs; c++) {
+            N_VConst(0.0, integrator->v_work);
+            for (j = c; j < n; j += bs) {
+                v[j] = p->nominals[j] != 0.0 ? p->nominals[j] : 1.0;
+            }
+            if (cv_jac_times(solver, t, y, fy, integrator->v_work, tmp1, tmp2) != 0) {
+                jmi_log_node(p->log, logWarning, "Warning",
+                             "Evaluating the preconditioner failed (recoverable error).");
+                return 1; /* Recoverable failure */
+            }
+            for (j = c; j < n; j += bs) {
+                k = j / bs;
+                nb = SUNMIN(bs, n - k*bs);
+                for (i = 0; i < nb; i++) {
+                    integrator->precond_jac[k*bs*bs + c*nb + i] = jv[k*bs + i] / v[j];
+                }
+            }
+        }
+        *jcurPtr = TRUE;
+    } else {
+        *jcurPtr = FALSE;
+    }
+    
+    for (k = 0; k*bs < n; k++) {
+        nb = SUNMIN(bs, n - k*bs);
+        for (j = 0; j < nb*nb; j++) {
+            integrator->precond_fac[k*bs*bs + j] = -gamma*integrator->precond_jac[k*bs*bs + j];
+        }
+        for (j = 0; j < nb; j++) {
+            integrator->precond_fac[k*bs*bs + j*nb + j] += 1.0;
+        }
+        if (denseGETRF(&integrator->precond_cols[k*bs], nb, nb, &integrator->precond_piv[k*bs]) != 0) {
+            return 1; /* Singular block, recoverable */
+        }
+    }
+    
+    return 0;
+}
+
+int cv_psolve(realtype t, N_Vector y, N_Vector fy, N_Vector r, N_Vector z,
+              realtype gamma, realtype delta, int lr, void *problem_data, N_Vector tmp) {
+    jmi_ode_solver_t* solver = (jmi_ode_solver_t*)problem_data;
+    jmi_ode_cvode_t* integrator = (jmi_ode_cvode_t*)solver->integrator;
+    long int n = solver->ode_problem->sizes.states, bs = integrator->precond_block_size;
+    long int k;
+    
+    N_VScale(1.0, r, z);
+    for (k = 0; k*bs < n; k++) {
+        denseGETRS(&integrator->precond_cols[k*bs], SUNMIN(bs, n - k*bs),
+                   &integrator->precond_piv[k*bs], N_VGetArrayPointer(z) + k*bs);
+    }
+    
+    return 0;
+}
+
+/* Krylov linear solver with the block diagonal preconditioner */
+static int jmi_ode_cvode_krylov_new(jmi_ode_cvode_t* integrator, jmi_ode_solver_t* solver) {
+    jmi_ode_problem_t* problem = solver -> ode_problem;
+    void* cvode_mem = integrator->cvode_mem;
+    long int n = problem->sizes.states, bs, k, j, nb;
+    int flag;
+    
+    bs = solver->precond_block_size < 1 ? 1 : solver->precond_block_size;
+    bs = SUNMIN(bs, n);
+    integrator->precond_block_size = (int)bs;
+    integrator->use_dir_der = -1;
+    
+    integrator->precond_jac  = (realtype*)calloc(n*bs, sizeof(realtype));
+    integrator->precond_fac  = (realtype*)calloc(n*bs, sizeof(realtype));
+    integrator->precond_cols = (realtype**)calloc(n, sizeof(realtype*));
+    integrator->precond_piv  = (long int*)calloc(n, sizeof(long int));
+    integrator->v_work  = N_VClone(integrator->y_work);
+    integrator->jv_work = N_VClone(integrator->y_work);
+    if (!integrator->precond_jac || !integrator->precond_fac || !integrator->precond_cols || !integrator->precond_piv) {
+        jmi_log_node(problem->log, logError, "Error", "Failed to allocate the preconditioner.");
+        return -1;
+    }
+    for (k = 0; k*bs < n; k++) {
+        nb = SUNMIN(bs, n - k*bs);
+        for (j = 0; j < nb; j++) {
+            integrator->precond_cols[k*bs + j] = &integrator->precond_fac[k*bs*bs + j*nb];
+        }
+    }
+    
+    /* The preconditioner data is taken from the user data when the solver is attached */
+    flag = CVodeSetUserData(cvode_mem, (void*)solver);
+    if(flag!=0){
+        jmi_log_node(problem->log, logError, "Error", "Failed to specify the user data. Returned with <error_flag: %d>", flag);
+        return -1;
+    }
+    
+    if (solver->linear_solver == JMI_ODE_CVODE_SPBCG) {
+        flag = CVSpbcg(cvode_mem, PREC_LEFT, 0);
+    } else {
+        flag = CVSpgmr(cvode_mem, PREC_LEFT, 0);
+    }
+    if(flag!=0){
+        jmi_log_node(problem->log, logError, "Error", "Failed to specify the linear solver. Returned with <error_flag: %d>", flag);
+        return -1;
+    }
+    
+    flag = CVSpilsSetPreconditioner(cvode_mem, cv_psetup, cv_psolve);
+    if(flag==0 && problem->ode_callbacks.dir_der_func != NULL){
+        flag = CVSpilsSetJacTimesVecFn(cvode_mem, cv_jtimes);
+    }
+    if(flag!=0){
+        jmi_log_node(problem->log, logError, "Error", "Failed to specify the preconditioner. Returned with <error_flag: %d>", flag);
+        return -1;
+    }
+    
+    return 0;
+}
+
+/* Adds the statistics since the latest re-initialization to the accumulated ones. */
+static void jmi_ode_cvode_accumulate_stats(jmi_ode_cvode_t* integrator) {
+    long int nsteps = 0, nfevals = 0, netfails = 0, nniters = 0, nncfails = 0;
+    
+    CVodeGetNumSteps(integrator->cvode_mem, &nsteps);
+    CVodeGetNumRhsEvals(integrator->cvode_mem, &nfevals);
+    CVodeGetNumErrTestFails(integrator->cvode_mem, &netfails);
+    CVodeGetNonlinSolvStats(integrator->cvode_mem, &nniters, &nncfails);
+    
+    integrator->nreinits++;
+    integrator->nsteps_acc   += nsteps;
+    integrator->nfevals_acc  += nfevals;
+    integrator->netfails_acc += netfails;
+    integrator->nniters_acc  += nniters;
+    integrator->nncfails_acc += nncfails;
+}
+
 jmi_ode_status_t jmi_ode_cvode_solve(jmi_ode_solver_t* solver, realtype time_final, int initialize) {
     int flag = 0,retval = 0;
     jmi_ode_cvode_t* integrator = (jmi_ode_cvode_t*)solver->integrator;
@@ -93,12 +314,13 @@ jmi_ode_status_t jmi_ode_cvode_solve(jmi_ode_solver_t* solver, realtype time_fin
         /* statements unused*/
         /*
         if (problem->n_real_x > 0) {
-            y = NV_DATA_S(integrator->y_work);
+            y = N_VGetArrayPointer(integrator->y_work);
             y = problem->states;
         }
         */
-		memcpy (NV_DATA_S(integrator->y_work), problem->states, problem->sizes.states*sizeof(jmi_real_t));
+		memcpy (N_VGetArrayPointer(integrator->y_work), problem->states, problem->sizes.states*sizeof(jmi_real_t));
         time = problem->time;
+        jmi_ode_cvode_accumulate_stats(integrator);
         flag = CVodeReInit(integrator->cvode_mem, time, integrator->y_work);
         if (flag<0){
             jmi_log_node(problem->log, logError, "Error", "Failed to re-initialize the solver. "
@@ -129,7 +351,7 @@ jmi_ode_status_t jmi_ode_cvode_solve(jmi_ode_solver_t* solver, realtype time_fin
         /* Set time */
         problem->time = tret;
         /* Set states */
-        memcpy (problem->states, NV_DATA_S(integrator->y_work), problem->sizes.states*sizeof(jmi_real_t));
+        memcpy (problem->states, N_VGetArrayPointer(integrator->y_work), problem->sizes.states*sizeof(jmi_real_t));
         
         /* Log information */
         if (problem->jmi_callbacks->log_options.log_level >= 4) {
@@ -198,11 +420,11 @@ int jmi_ode_cvode_new(jmi_ode_cvode_t** integrator_ptr, jmi_ode_solver_t* solver
     integrator->rtol = solver->rel_tol;
     
     if (problem->sizes.states > 0) {
-        integrator->atol = N_VNew_Serial(problem->sizes.states);
+        integrator->atol = jmi_ode_cvode_new_vector(solver, problem->sizes.states);
     } else {
         integrator->atol = N_VNew_Serial(1);
     }
-    atol_nv = NV_DATA_S(integrator->atol);
+    atol_nv = N_VGetArrayPointer(integrator->atol);
     
     if (problem->sizes.states > 0) {
         for (i = 0; i < problem->sizes.states; i++) {
@@ -220,12 +442,12 @@ int jmi_ode_cvode_new(jmi_ode_cvode_t** integrator_ptr, jmi_ode_solver_t* solver
 
     /* Get the default values for the time and states */
     if (problem->sizes.states > 0) {
-        integrator->y_work = N_VNew_Serial(problem->sizes.states);
-        y = NV_DATA_S(integrator->y_work);
+        integrator->y_work = jmi_ode_cvode_new_vector(solver, problem->sizes.states);
+        y = N_VGetArrayPointer(integrator->y_work);
 		memcpy (y, problem->states, problem->sizes.states*sizeof(jmi_real_t));
     }else{
         integrator->y_work = N_VNew_Serial(1);
-        y = NV_DATA_S(integrator->y_work);
+        y = N_VGetArrayPointer(integrator->y_work);
         y[0] = 0.0;
     }
     
@@ -241,7 +463,11 @@ int jmi_ode_cvode_new(jmi_ode_cvode_t** integrator_ptr, jmi_ode_solver_t* solver
         return -1;
     }
 
-    if (problem->sizes.states > 0) {
+    if (problem->sizes.states > 0 && solver->linear_solver != JMI_ODE_CVODE_DENSE) {
+        integrator->cvode_mem = cvode_mem;
+        *integrator_ptr = integrator;
+        flag = jmi_ode_cvode_krylov_new(integrator, solver);
+    } else if (problem->sizes.states > 0) {
         flag = CVDense(cvode_mem, problem->sizes.states);
     }else{
         flag = CVDense(cvode_mem, 1);
@@ -295,16 +521,34 @@ void jmi_ode_cvode_delete(jmi_ode_solver_t* solver) {
         
         node = jmi_log_enter_fmt(problem->log, logInfo, "CVodeStatistics", 
                                      "Simulation statistics");
-        jmi_log_fmt(problem->log, node, logInfo, "<nsteps: %d>", nsteps);
-        jmi_log_fmt(problem->log, node, logInfo, "<nfevals: %d>", nfevals);
-        jmi_log_fmt(problem->log, node, logInfo, "<nerrfails: %d>", netfails);
-        jmi_log_fmt(problem->log, node, logInfo, "<nniters: %d>", nniters);
-        jmi_log_fmt(problem->log, node, logInfo, "<nnfails: %d>", nncfails);
+        jmi_log_fmt(problem->log, node, logInfo, "<nsteps: %d>", nsteps + integrator->nsteps_acc);
+        jmi_log_fmt(problem->log, node, logInfo, "<nfevals: %d>", nfevals + integrator->nfevals_acc);
+        jmi_log_fmt(problem->log, node, logInfo, "<nerrfails: %d>", netfails + integrator->netfails_acc);
+        jmi_log_fmt(problem->log, node, logInfo, "<nniters: %d>", nniters + integrator->nniters_acc);
+        jmi_log_fmt(problem->log, node, logInfo, "<nnfails: %d>", nncfails + integrator->nncfails_acc);
+        jmi_log_fmt(problem->log, node, logInfo, "<nreinits: %d>", integrator->nreinits);
+        if (integrator->precond_jac) {
+            long int nliters = 0, npevals = 0, njvevals = 0;
+            CVSpilsGetNumLinIters(integrator->cvode_mem, &nliters);
+            CVSpilsGetNumPrecEvals(integrator->cvode_mem, &npevals);
+            CVSpilsGetNumJtimesEvals(integrator->cvode_mem, &njvevals);
+            jmi_log_fmt(problem->log, node, logInfo, "<nliters: %d>", nliters);
+            jmi_log_fmt(problem->log, node, logInfo, "<npevals: %d>", npevals);
+            jmi_log_fmt(problem->log, node, logInfo, "<njvevals: %d>", njvevals);
+        }
         jmi_log_leave(problem->log, node);
         
+        /*Deallocate the preconditioner.*/
+        free(integrator->precond_jac);
+        free(integrator->precond_fac);
+        free(integrator->precond_cols);
+        free(integrator->precond_piv);
+        if (integrator->v_work)  N_VDestroy(integrator->v_work);
+        if (integrator->jv_work) N_VDestroy(integrator->jv_work);
+        
         /*Deallocate work vectors.*/
-        N_VDestroy_Serial((((jmi_ode_cvode_t*)(solver->integrator))->y_work));
-        N_VDestroy_Serial((((jmi_ode_cvode_t*)(solver->integrator))->atol));
+        N_VDestroy((((jmi_ode_cvode_t*)(solver->integrator))->y_work));
+        N_VDestroy((((jmi_ode_cvode_t*)(solver->integrator))->atol));
         /*Deallocate CVode */
         CVodeFree(&(((jmi_ode_cvode_t*)(solver->integrator))->cvode_mem));
         
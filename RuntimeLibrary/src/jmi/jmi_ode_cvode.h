@@ -45,6 +45,24 @@ struct jmi_ode_cvode_t {
     realtype rtol; /* Specifies the relative tolerance */
     N_Vector atol; /* Specifies the absolute tolerance */
     N_Vector y_work;
+    
+    /* Statistics before the latest re-initialization, CVodeReInit resets the counters */
+    long int nreinits;
+    long int nsteps_acc;
+    long int nfevals_acc;
+    long int netfails_acc;
+    long int nniters_acc;
+    long int nncfails_acc;
+    
+    /* Krylov linear solvers */
+    int use_dir_der;          /* Directional derivatives for Jacobian-vector products: -1 not checked, 0 unavailable, 1 used */
+    int precond_block_size;   /* Size of the diagonal blocks of the preconditioner */
+    realtype* precond_jac;    /* Diagonal blocks of the state Jacobian, column major */
+    realtype* precond_fac;    /* LU factorization of the diagonal blocks of I - gamma*J */
+    realtype** precond_cols;  /* Column pointers into precond_fac */
+    long int* precond_piv;    /* Pivots of the factorization */
+    N_Vector v_work;
+    N_Vector jv_work;
 };
 
 #endif
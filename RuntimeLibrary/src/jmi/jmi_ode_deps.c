@@ -0,0 +1,352 @@
+/*
+    Copyright (C) 2018 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+#include <string.h>
+
+#include "jmi.h"
+#include "jmi_util.h"
+#include "jmi_ode_deps.h"
+
+/* Build the index from z to the blocks computing and reading it */
+static void jmi_ode_deps_init_demand(jmi_t* jmi, jmi_ode_deps_t* deps) {
+    jmi_int_t n_z = jmi->n_z;
+    jmi_int_t b, i, j, k;
+
+    deps->writer       = (jmi_int_t*)malloc(n_z * sizeof(jmi_int_t));
+    deps->readers_offs = (jmi_int_t*)calloc(n_z + 1, sizeof(jmi_int_t));
+    deps->readers      = (jmi_int_t*)malloc((deps->read_offs[deps->n_blocks] + deps->sw_offs[deps->n_blocks] + 1) * sizeof(jmi_int_t));
+    deps->untracked    = (jmi_int_t*)malloc((deps->n_blocks + 1) * sizeof(jmi_int_t));
+    deps->stale        = (char*)malloc(deps->n_blocks + 1);
+    deps->needed       = (char*)calloc(deps->n_blocks + 1, sizeof(char));
+    deps->work         = (jmi_int_t*)malloc((deps->n_blocks + 1) * sizeof(jmi_int_t));
+
+    for (i = 0; i < n_z; i++) {
+        deps->writer[i] = -1;
+    }
+
+    /* Count the readers of each index, stored shifted one step */
+    for (b = 0; b < deps->n_blocks; b++) {
+        for (i = deps->read_offs[b]; i < deps->read_offs[b + 1]; i++) {
+            j = deps->read[i];
+            if (j == JMI_ODE_DEPS_UNTRACKED) {
+                deps->untracked[deps->n_untracked++] = b;
+            } else {
+                deps->readers_offs[(j == JMI_ODE_DEPS_TIME ? jmi->offs_t : j) + 1]++;
+            }
+        }
+        for (i = deps->sw_offs[b]; i < deps->sw_offs[b + 1]; i++) {
+            deps->readers_offs[jmi->offs_sw + deps->sw[i] + 1]++;
+        }
+        for (i = deps->write_offs[b]; i < deps->write_offs[b + 1]; i++) {
+            deps->writer[deps->write[i]] = b;
+        }
+        for (i = deps->sw_offs[b]; i < deps->sw_offs[b + 1]; i++) {
+            if (deps->writer[jmi->offs_sw + deps->sw[i]] < 0) {
+                deps->writer[jmi->offs_sw + deps->sw[i]] = b;
+            }
+        }
+    }
+    for (i = 0; i < n_z; i++) {
+        deps->readers_offs[i + 1] += deps->readers_offs[i];
+    }
+
+    /* Fill in the readers, the offsets are advanced past each entry */
+    for (b = 0; b < deps->n_blocks; b++) {
+        for (i = deps->read_offs[b]; i < deps->read_offs[b + 1]; i++) {
+            j = deps->read[i];
+            if (j != JMI_ODE_DEPS_UNTRACKED) {
+                k = j == JMI_ODE_DEPS_TIME ? jmi->offs_t : j;
+                deps->readers[deps->readers_offs[k]++] = b;
+            }
+        }
+        for (i = deps->sw_offs[b]; i < deps->sw_offs[b + 1]; i++) {
+            k = jmi->offs_sw + deps->sw[i];
+            deps->readers[deps->readers_offs[k]++] = b;
+        }
+    }
+    /* Shift the offsets back */
+    for (i = n_z; i > 0; i--) {
+        deps->readers_offs[i] = deps->readers_offs[i - 1];
+    }
+    deps->readers_offs[0] = 0;
+
+    memset(deps->stale, 1, deps->n_blocks);
+    deps->n_stale = deps->n_blocks;
+}
+
+void jmi_ode_deps_init(jmi_t* jmi, jmi_int_t n_blocks, jmi_int_t features,
+                       const jmi_int_t* read_offs,  const jmi_int_t* read,
+                       const jmi_int_t* write_offs, const jmi_int_t* write,
+                       const jmi_int_t* sw_offs,    const jmi_int_t* sw) {
+    jmi_ode_deps_t* deps = (jmi_ode_deps_t*)calloc(1, sizeof(jmi_ode_deps_t));
+
+    deps->n_blocks   = n_blocks;
+    deps->features   = features;
+    deps->read_offs  = read_offs;
+    deps->read       = read;
+    deps->write_offs = write_offs;
+    deps->write      = write;
+    deps->sw_offs    = sw_offs;
+    deps->sw         = sw;
+    deps->mode       = JMI_ODE_DEPS_COMPLETE;
+    deps->changed    = (char*)calloc(jmi->n_z, sizeof(char));
+    deps->invalid    = 1;
+
+    if (features & JMI_ODE_DEPS_DEMAND) {
+        jmi_ode_deps_init_demand(jmi, deps);
+    }
+
+    jmi_ode_deps_delete(jmi->ode_deps);
+    jmi->ode_deps = deps;
+}
+
+void jmi_ode_deps_delete(jmi_ode_deps_t* deps) {
+    if (deps == NULL) {
+        return;
+    }
+    free(deps->changed);
+    free(deps->writer);
+    free(deps->readers_offs);
+    free(deps->readers);
+    free(deps->untracked);
+    free(deps->stale);
+    free(deps->needed);
+    free(deps->work);
+    free(deps);
+}
+
+void jmi_ode_deps_invalidate(jmi_t* jmi) {
+    jmi_ode_deps_t* deps = jmi->ode_deps;
+
+    if (deps == NULL) {
+        return;
+    }
+    deps->invalid = 1;
+    if (deps->stale != NULL) {
+        memset(deps->stale, 1, deps->n_blocks);
+        deps->n_stale = deps->n_blocks;
+    }
+}
+
+/* Mark a block as out of date and push it on the work stack */
+#define JMI_ODE_DEPS_PUSH_STALE(deps, b, n)  \
+    if (!(deps)->stale[b]) {                 \
+        (deps)->stale[b] = 1;                \
+        (deps)->n_stale++;                   \
+        (deps)->work[(n)++] = (b);           \
+    }
+
+void jmi_ode_deps_mark_changed(jmi_t* jmi, jmi_int_t index) {
+    jmi_ode_deps_t* deps = jmi->ode_deps;
+    jmi_int_t n = 0;
+    jmi_int_t b, i, j, k;
+
+    if (deps == NULL || deps->stale == NULL || deps->n_stale == deps->n_blocks) {
+        return;
+    }
+
+    for (i = 0; i < deps->n_untracked; i++) {
+        JMI_ODE_DEPS_PUSH_STALE(deps, deps->untracked[i], n)
+    }
+    for (i = deps->readers_offs[index]; i < deps->readers_offs[index + 1]; i++) {
+        JMI_ODE_DEPS_PUSH_STALE(deps, deps->readers[i], n)
+    }
+
+    /* Blocks downstream of an out-of-date block are also out of date */
+    while (n > 0) {
+        b = deps->work[--n];
+        for (i = deps->write_offs[b]; i < deps->write_offs[b + 1]; i++) {
+            j = deps->write[i];
+            for (k = deps->readers_offs[j]; k < deps->readers_offs[j + 1]; k++) {
+                JMI_ODE_DEPS_PUSH_STALE(deps, deps->readers[k], n)
+            }
+        }
+        for (i = deps->sw_offs[b]; i < deps->sw_offs[b + 1]; i++) {
+            j = jmi->offs_sw + deps->sw[i];
+            for (k = deps->readers_offs[j]; k < deps->readers_offs[j + 1]; k++) {
+                JMI_ODE_DEPS_PUSH_STALE(deps, deps->readers[k], n)
+            }
+        }
+    }
+}
+
+/* Flag the indices in [start, end) that differ from their pre values */
+static int jmi_ode_deps_compare_pre(jmi_t* jmi, int start, int end, int pre_start) {
+    jmi_real_t* z = jmi_get_z(jmi);
+    char* changed = jmi->ode_deps->changed;
+    int n = 0;
+    int i;
+
+    for (i = start; i < end; i++) {
+        if (z[i] != z[i - start + pre_start]) {
+            changed[i] = 1;
+            n++;
+        }
+    }
+    return n;
+}
+
+int jmi_ode_deps_begin(jmi_t* jmi) {
+    jmi_ode_deps_t* deps = jmi->ode_deps;
+
+    if (deps == NULL || !(deps->features & JMI_ODE_DEPS_EVENT_ITERATION)) {
+        return 0;
+    }
+
+    if (deps->invalid) {
+        deps->invalid = 0;
+        deps->mode = JMI_ODE_DEPS_COMPLETE;
+        return 0;
+    }
+
+    memset(deps->changed, 0, jmi->n_z * sizeof(char));
+    jmi_ode_deps_compare_pre(jmi, jmi->offs_real_dx, jmi->offs_t, jmi->offs_pre_real_dx);
+    jmi_ode_deps_compare_pre(jmi, jmi->offs_real_d, jmi->offs_pre_real_dx, jmi->offs_pre_real_d);
+
+    deps->n_evaluated = 0;
+    deps->mode = JMI_ODE_DEPS_INCREMENTAL;
+    return 1;
+}
+
+/* Add the out-of-date block computing an index in z to the needed blocks */
+#define JMI_ODE_DEPS_PUSH_NEEDED(deps, index, n) {       \
+        jmi_int_t b_ = (deps)->writer[index];            \
+        if (b_ >= 0 && (deps)->stale[b_] && !(deps)->needed[b_]) { \
+            (deps)->needed[b_] = 1;                      \
+            (deps)->work[(n)++] = b_;                    \
+        }                                                \
+    }
+
+int jmi_ode_deps_begin_partial(jmi_t* jmi, const jmi_value_reference vr[], size_t nvr) {
+    jmi_ode_deps_t* deps = jmi->ode_deps;
+    jmi_int_t n = 0;
+    jmi_int_t b, i, j;
+    size_t v;
+
+    if (deps == NULL || deps->stale == NULL) {
+        return 0;
+    }
+
+    memset(deps->needed, 0, deps->n_blocks);
+    for (v = 0; v < nvr; v++) {
+        if (jmi_get_type_from_value_ref(vr[v]) == JMI_STRING) {
+            return 0;
+        }
+        j = jmi_get_index_from_value_ref(vr[v]);
+        if (j >= jmi->offs_real_dx) {
+            JMI_ODE_DEPS_PUSH_NEEDED(deps, j, n)
+        }
+    }
+
+    /* The out-of-date blocks upstream of a needed block are also needed */
+    while (n > 0) {
+        b = deps->work[--n];
+        for (i = deps->read_offs[b]; i < deps->read_offs[b + 1]; i++) {
+            j = deps->read[i];
+            if (j == JMI_ODE_DEPS_UNTRACKED) {
+                /* Unknown dependencies, fall back to a complete evaluation */
+                return 0;
+            } else if (j != JMI_ODE_DEPS_TIME) {
+                JMI_ODE_DEPS_PUSH_NEEDED(deps, j, n)
+            }
+        }
+        for (i = deps->sw_offs[b]; i < deps->sw_offs[b + 1]; i++) {
+            JMI_ODE_DEPS_PUSH_NEEDED(deps, jmi->offs_sw + deps->sw[i], n)
+        }
+    }
+
+    deps->n_evaluated = 0;
+    deps->mode = JMI_ODE_DEPS_PARTIAL;
+    return 1;
+}
+
+void jmi_ode_deps_end(jmi_t* jmi) {
+    if (jmi->ode_deps != NULL) {
+        jmi->ode_deps->mode = JMI_ODE_DEPS_COMPLETE;
+    }
+}
+
+int jmi_ode_deps_has_stale(jmi_t* jmi) {
+    return jmi->ode_deps != NULL && jmi->ode_deps->stale != NULL && jmi->ode_deps->n_stale > 0;
+}
+
+/* Check if a block reads a variable that changed during the event iteration */
+static int jmi_ode_deps_affected(jmi_t* jmi, jmi_ode_deps_t* deps, jmi_int_t block) {
+    char* changed = deps->changed;
+    int i;
+
+    for (i = deps->read_offs[block]; i < deps->read_offs[block + 1]; i++) {
+        if (deps->read[i] == JMI_ODE_DEPS_UNTRACKED || (deps->read[i] >= 0 && changed[deps->read[i]])) {
+            break;
+        }
+    }
+    if (i == deps->read_offs[block + 1]) {
+        for (i = deps->sw_offs[block]; i < deps->sw_offs[block + 1]; i++) {
+            if (changed[jmi->offs_sw + deps->sw[i]]) {
+                break;
+            }
+        }
+        if (i == deps->sw_offs[block + 1]) {
+            return 0;
+        }
+    }
+
+    /* Everything computed by the block may change */
+    for (i = deps->write_offs[block]; i < deps->write_offs[block + 1]; i++) {
+        changed[deps->write[i]] = 1;
+    }
+    for (i = deps->sw_offs[block]; i < deps->sw_offs[block + 1]; i++) {
+        changed[jmi->offs_sw + deps->sw[i]] = 1;
+    }
+    return 1;
+}
+
+int jmi_ode_block_eval(jmi_t* jmi, jmi_int_t block) {
+    jmi_ode_deps_t* deps = jmi->ode_deps;
+    int eval;
+
+    if (deps == NULL) {
+        return 1;
+    }
+
+    switch (deps->mode) {
+    case JMI_ODE_DEPS_INCREMENTAL:
+        /* Blocks that are not affected are still up to date */
+        eval = jmi_ode_deps_affected(jmi, deps, block);
+        break;
+    case JMI_ODE_DEPS_PARTIAL:
+        eval = deps->needed[block];
+        if (!eval) {
+            return 0;
+        }
+        break;
+    default:
+        eval = 1;
+        break;
+    }
+
+    if (deps->stale != NULL && deps->stale[block]) {
+        deps->stale[block] = 0;
+        deps->n_stale--;
+    }
+    if (eval) {
+        deps->n_evaluated++;
+    }
+    return eval;
+}
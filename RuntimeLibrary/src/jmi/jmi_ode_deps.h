@@ -0,0 +1,139 @@
+/*
+    Copyright (C) 2018 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+
+/** \file jmi_ode_deps.h
+ *  \brief Dependency information for the blocks in the ODE evaluation.
+ *
+ *  The information is generated by the compiler when the option
+ *  incremental_event_iteration or demand_driven_evaluation is set. It is
+ *  used during event iteration to evaluate only the blocks that depend on
+ *  variables that changed in the previous iteration, and when getting
+ *  values to evaluate only the out-of-date blocks that the requested
+ *  variables depend on.
+ */
+
+#ifndef _JMI_ODE_DEPS_H
+#define _JMI_ODE_DEPS_H
+
+#include "jmi_types.h"
+
+/* Special entries in the read indices */
+#define JMI_ODE_DEPS_UNTRACKED -1    /**< \brief The block reads values that are not tracked. */
+#define JMI_ODE_DEPS_TIME      -2    /**< \brief The block reads time. */
+
+/* Features enabled by the generated code */
+#define JMI_ODE_DEPS_EVENT_ITERATION 1
+#define JMI_ODE_DEPS_DEMAND          2
+
+typedef enum jmi_ode_deps_mode_t {
+    JMI_ODE_DEPS_COMPLETE,       /**< \brief All blocks are evaluated. */
+    JMI_ODE_DEPS_INCREMENTAL,    /**< \brief Blocks affected by changes in the last event iteration are evaluated. */
+    JMI_ODE_DEPS_PARTIAL         /**< \brief Out-of-date blocks needed for requested variables are evaluated. */
+} jmi_ode_deps_mode_t;
+
+struct jmi_ode_deps_t {
+    jmi_int_t n_blocks;          /**< \brief Number of blocks in the ODE evaluation. */
+    jmi_int_t features;          /**< \brief The enabled features, JMI_ODE_DEPS_EVENT_ITERATION and/or JMI_ODE_DEPS_DEMAND. */
+    const jmi_int_t* read_offs;  /**< \brief Start of the entries of each block in read, n_blocks + 1 entries. */
+    const jmi_int_t* read;       /**< \brief Indices in z read by the blocks, or JMI_ODE_DEPS_UNTRACKED/JMI_ODE_DEPS_TIME. */
+    const jmi_int_t* write_offs; /**< \brief Start of the entries of each block in write, n_blocks + 1 entries. */
+    const jmi_int_t* write;      /**< \brief Indices in z computed by the blocks. */
+    const jmi_int_t* sw_offs;    /**< \brief Start of the entries of each block in sw, n_blocks + 1 entries. */
+    const jmi_int_t* sw;         /**< \brief Switches evaluated by the blocks. */
+
+    jmi_ode_deps_mode_t mode;    /**< \brief How the blocks are selected in the current evaluation. */
+    char* changed;               /**< \brief Flags for the indices in z that have changed, n_z entries. */
+    jmi_int_t invalid;           /**< \brief Flag indicating that the next event iteration must be complete. */
+    jmi_int_t n_evaluated;       /**< \brief Number of blocks evaluated in the last incremental or partial evaluation. */
+
+    jmi_int_t* writer;           /**< \brief Block computing each index in z, -1 if none, n_z entries. */
+    jmi_int_t* readers_offs;     /**< \brief Start of the entries of each index in z in readers, n_z + 1 entries. */
+    jmi_int_t* readers;          /**< \brief Blocks reading each index in z, time is read at offs_t. */
+    jmi_int_t n_untracked;       /**< \brief Number of blocks with untracked reads. */
+    jmi_int_t* untracked;        /**< \brief Blocks with untracked reads. */
+    char* stale;                 /**< \brief Flags for the blocks that are out of date, n_blocks entries. */
+    jmi_int_t n_stale;           /**< \brief Number of blocks that are out of date. */
+    char* needed;                /**< \brief Flags for the blocks evaluated in a partial evaluation, n_blocks entries. */
+    jmi_int_t* work;             /**< \brief Work stack, n_blocks entries. */
+};
+
+/**
+ * \brief Register the block dependencies of the ODE evaluation, called from the generated code.
+ *
+ * The arrays are not copied and must remain valid during the lifetime of jmi.
+ */
+void jmi_ode_deps_init(jmi_t* jmi, jmi_int_t n_blocks, jmi_int_t features,
+                       const jmi_int_t* read_offs,  const jmi_int_t* read,
+                       const jmi_int_t* write_offs, const jmi_int_t* write,
+                       const jmi_int_t* sw_offs,    const jmi_int_t* sw);
+
+/**
+ * \brief Delete the block dependencies.
+ */
+void jmi_ode_deps_delete(jmi_ode_deps_t* deps);
+
+/**
+ * \brief Mark all blocks as out of date and make the next event iteration complete,
+ * e.g. since parameters or internal variables changed.
+ */
+void jmi_ode_deps_invalidate(jmi_t* jmi);
+
+/**
+ * \brief Mark the blocks depending on an index in z as out of date.
+ */
+void jmi_ode_deps_mark_changed(jmi_t* jmi, jmi_int_t index);
+
+/**
+ * \brief Prepare an incremental evaluation by comparing z with the pre values.
+ *
+ * Must be called before the pre values are updated. Returns non-zero if
+ * the next evaluation of the ODE will be incremental.
+ */
+int jmi_ode_deps_begin(jmi_t* jmi);
+
+/**
+ * \brief Prepare a partial evaluation of the blocks needed for the given value references.
+ *
+ * Returns non-zero if the next evaluation of the ODE will be partial, zero
+ * if a complete evaluation is needed.
+ */
+int jmi_ode_deps_begin_partial(jmi_t* jmi, const jmi_value_reference vr[], size_t nvr);
+
+/**
+ * \brief End an incremental or partial evaluation, later evaluations are complete.
+ */
+void jmi_ode_deps_end(jmi_t* jmi);
+
+/**
+ * \brief Check if there are blocks that are out of date.
+ */
+int jmi_ode_deps_has_stale(jmi_t* jmi);
+
+/**
+ * \brief Check if a block needs to be evaluated, called from the generated code.
+ *
+ * During an incremental evaluation a block is evaluated if it reads a
+ * changed variable. The variables computed by the block are then marked as
+ * changed. During a partial evaluation the blocks selected by
+ * jmi_ode_deps_begin_partial() are evaluated.
+ */
+int jmi_ode_block_eval(jmi_t* jmi, jmi_int_t block);
+
+#endif /* _JMI_ODE_DEPS_H */
@@ -0,0 +1,363 @@
+/*
+    Copyright (C) 2018 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+#include <string.h>
+#include <ida/ida.h>                 /* main integrator header file */
+#include <ida/ida_dense.h>           /* use IDADENSE linear solver */
+#include <nvector/nvector_serial.h>  /* serial N_Vector types, fct. and macros */
+#include <sundials/sundials_types.h> /* definition of realtype */
+#include <sundials/sundials_math.h>  /* contains the macros ABS, SQR, and EXP*/
+#include "jmi_ode_solver_impl.h"
+#include "jmi_ode_problem.h"
+#include "jmi_ode_ida.h"
+#include "jmi_log.h"
+
+int ida_res(realtype t, N_Vector yy, N_Vector yyp, N_Vector rr, void *problem_data){
+    realtype *y, *yp, *res;
+    int flag;
+    size_t i;
+    jmi_ode_solver_t* solver = (jmi_ode_solver_t*)problem_data;
+    jmi_ode_problem_t* p = solver -> ode_problem;
+
+    y = NV_DATA_S(yy);
+    yp = NV_DATA_S(yyp);
+    res = NV_DATA_S(rr);
+
+    if (p->ode_callbacks.dae_res_func != NULL) {
+        flag = p->ode_callbacks.dae_res_func(t, y, yp, res, p->sizes, p->problem_data);
+    } else {
+        /* No algebraics, residual of the ODE form */
+        flag = p->ode_callbacks.rhs_func(t, y, res, p->sizes, p->problem_data);
+        for (i = 0; i < p->sizes.states; i++) {
+            res[i] -= yp[i];
+        }
+    }
+    if(flag != 0) {
+        jmi_log_node(p->log, logWarning, "Warning", "Evaluating the residual failed (recoverable error). "
+                     "Returned with <warningFlag: %d>", flag);
+        return 1; /* Recoverable failure */
+    }
+    
+    if (p->sizes.states + p->sizes.algebraics == 0){
+        res[0] = -yp[0];
+    }
+
+    return IDA_SUCCESS;
+}
+
+int ida_root(realtype t, N_Vector yy, N_Vector yyp, realtype *gout, void* problem_data){
+    realtype *y;
+    int flag;
+    jmi_ode_solver_t* solver = (jmi_ode_solver_t*)problem_data;
+    jmi_ode_problem_t* p = solver -> ode_problem;
+
+    y = NV_DATA_S(yy);
+
+    flag = p->ode_callbacks.root_func(t, y, gout, p->sizes, p->problem_data);
+    if(flag != 0) {
+        jmi_log_node(p->log, logError, "Error", "Evaluating the event indicators failed. "
+                     "Returned with <error_flag: %d>", flag);
+        return -1; /* Failure */
+    }
+    
+    return IDA_SUCCESS;
+}
+
+void ida_err(int error_code, const char *module,const char *function, char *msg, void *problem_data){
+    jmi_ode_solver_t* solver = (jmi_ode_solver_t*)problem_data;
+    jmi_ode_problem_t* problem = solver -> ode_problem;
+    
+    if (error_code == IDA_WARNING){
+        jmi_log_node(problem->log, logWarning, "Warning", "Warning from <function: %s>, <msg: %s>", function, msg);
+    } else {
+        jmi_log_node(problem->log, logError, "Error", "Error from <function: %s>, < msg: %s>", function, msg);
+    }        
+}
+
+/* Consistent initial values: the derivatives from the ODE form and the algebraics it converged to */
+static int jmi_ode_ida_initial_values(jmi_ode_solver_t* solver) {
+    jmi_ode_ida_t* integrator = (jmi_ode_ida_t*)solver->integrator;
+    jmi_ode_problem_t* problem = solver -> ode_problem;
+    realtype* y = NV_DATA_S(integrator->y_work);
+    realtype* yp = NV_DATA_S(integrator->yp_work);
+    int flag;
+
+    N_VConst(0.0, integrator->y_work);
+    N_VConst(0.0, integrator->yp_work);
+    memcpy(y, problem->states, problem->sizes.states*sizeof(jmi_real_t));
+
+    flag = problem->ode_callbacks.rhs_func(problem->time, y, yp, problem->sizes, problem->problem_data);
+    if (flag == 0 && problem->sizes.algebraics > 0) {
+        flag = problem->ode_callbacks.dae_alg_func(y + problem->sizes.states, NV_DATA_S(integrator->res_work),
+                                                   problem->sizes, problem->problem_data);
+    }
+    return flag;
+}
+
+jmi_ode_status_t jmi_ode_ida_solve(jmi_ode_solver_t* solver, realtype time_final, int initialize) {
+    int flag = 0,retval = 0;
+    jmi_ode_ida_t* integrator = (jmi_ode_ida_t*)solver->integrator;
+    jmi_ode_problem_t* problem = solver -> ode_problem;
+    realtype tret;
+    char step_event = 0; /* boolean step_event = FALSE */
+    char terminate = 0;
+    
+    if (initialize == TRUE){
+        flag = jmi_ode_ida_initial_values(solver);
+        if (flag != 0){
+            jmi_log_node(problem->log, logError, "Error", "Failed to compute consistent initial values. "
+                         "Returned with <error_flag: %d>", flag);
+            return JMI_ODE_ERROR;
+        }
+        flag = IDAReInit(integrator->ida_mem, problem->time, integrator->y_work, integrator->yp_work);
+        if (flag<0){
+            jmi_log_node(problem->log, logError, "Error", "Failed to re-initialize the solver. "
+                         "Returned with <error_flag: %d>", flag);
+            return JMI_ODE_ERROR;
+        }
+    }
+    
+    /* Dont integrate past t_stop */
+    flag = IDASetStopTime(integrator->ida_mem, time_final);
+    if (flag < 0){
+        jmi_log_node(problem->log, logError, "Error", "Failed to specify the stop time. "
+                     "Returned with <error_flag: %d>", flag);
+        return JMI_ODE_ERROR;
+    }
+    
+    flag = IDA_SUCCESS;
+    while (flag == IDA_SUCCESS) {
+        
+        /* Perform a step */
+        flag = IDASolve(integrator->ida_mem, time_final, &tret, integrator->y_work, integrator->yp_work, IDA_ONE_STEP);
+        if(flag<0){
+            jmi_log_node(problem->log, logError, "Error", "Failed to calculate the next step. "
+                     "Returned with <error_flag: %d>", flag);
+            return JMI_ODE_ERROR;
+        }
+        
+        /* Set time */
+        problem->time = tret;
+        /* Set states */
+        memcpy (problem->states, NV_DATA_S(integrator->y_work), problem->sizes.states*sizeof(jmi_real_t));
+        
+        /* Log information */
+        if (problem->jmi_callbacks->log_options.log_level >= 4) {
+            jmi_log_node_t node = jmi_log_enter_fmt(problem->log, logInfo, "IDA", 
+                                "IDA completed a step at <time:%f>", tret);
+            jmi_real_t last_h = 0.0, next_h = 0.0;
+            int    last_order, next_order;
+            
+            IDAGetLastOrder(integrator->ida_mem, &last_order);
+            IDAGetCurrentOrder(integrator->ida_mem, &next_order);
+            IDAGetLastStep(integrator->ida_mem, &last_h);
+            IDAGetCurrentStep(integrator->ida_mem, &next_h);
+            
+            jmi_log_fmt(problem->log, node, logInfo, 
+                "<lastUsedOrder: %d, newOrder: %d, lastUsedStepsize: %g, newStepsize: %g>",
+                last_order, next_order, last_h, next_h);
+            jmi_log_leave(problem->log, node);
+        }
+        
+        /* The last residual evaluation may have been a Newton iterate, evaluate at the accepted step */
+        if (ida_res(tret, integrator->y_work, integrator->yp_work, integrator->res_work, solver) != IDA_SUCCESS) {
+            jmi_log_node(problem->log, logError, "Error", "Failed to evaluate the residual at <t:%g>", tret);
+            return JMI_ODE_ERROR;
+        }
+        
+        /* After each step call completed integrator step */
+        retval = problem->ode_callbacks.complete_step_func(&step_event, &terminate, problem->problem_data);
+        if (retval != 0) {
+            jmi_log_node(problem->log, logError, "Error", "Failed to complete an integrator step. "
+                     "Returned with <error_flag: %d>", retval);
+            return JMI_ODE_ERROR;
+        }
+        
+        if (step_event == TRUE) {
+            jmi_log_node(problem->log, logInfo, "StepEvent", "An event was detected at <t:%g>", tret);
+            return JMI_ODE_EVENT;
+        }
+        
+        if (terminate == TRUE) {
+            jmi_log_node(problem->log, logInfo, "Terminate",
+                "Terminating simulation after a signal from the model at <t:%g>", tret);
+            return JMI_ODE_TERMINATE;
+        }
+    }
+    
+    if (flag == IDA_ROOT_RETURN) {
+        jmi_log_node(problem->log, logInfo, "StateEvent", "An event was detected at <t:%g>", tret);
+        return JMI_ODE_EVENT;
+    }
+    return JMI_ODE_OK;
+}
+
+int jmi_ode_ida_new(jmi_ode_ida_t** integrator_ptr, jmi_ode_solver_t* solver) {
+    jmi_ode_ida_t* integrator;
+    jmi_ode_problem_t* problem = solver -> ode_problem;
+    int flag = 0;
+    void* ida_mem;
+    jmi_real_t* atol_nv;
+    jmi_real_t* id_nv;
+    size_t i, n_x = problem->sizes.states;
+    
+    integrator = (jmi_ode_ida_t*)calloc(1,sizeof(jmi_ode_ida_t));
+    if(!integrator){
+        jmi_log_node(problem->log, logError, "Error", "Failed to allocate the internal IDA struct.");
+        return -1;
+    }
+    *integrator_ptr = integrator;
+
+    integrator->rtol = solver->rel_tol;
+    integrator->n = n_x + problem->sizes.algebraics;
+    if (integrator->n == 0) {
+        integrator->n = 1;
+    }
+    
+    integrator->atol     = N_VNew_Serial(integrator->n);
+    integrator->id       = N_VNew_Serial(integrator->n);
+    integrator->y_work   = N_VNew_Serial(integrator->n);
+    integrator->yp_work  = N_VNew_Serial(integrator->n);
+    integrator->res_work = N_VNew_Serial(integrator->n);
+    N_VConst(0.0, integrator->y_work);
+    N_VConst(0.0, integrator->yp_work);
+    N_VConst(1.0, integrator->id);
+    N_VConst(1.0, integrator->res_work);
+    
+    /* The algebraics use the nominals of the iteration variables, stored temporarily in res_work */
+    if (problem->sizes.algebraics > 0) {
+        flag = problem->ode_callbacks.dae_alg_func(NV_DATA_S(integrator->y_work) + n_x, NV_DATA_S(integrator->res_work) + n_x,
+                                                   problem->sizes, problem->problem_data);
+        if(flag != 0) {
+            jmi_log_node(problem->log, logError, "Error", "Failed to get the algebraic unknowns. Returned with <error_flag: %d>", flag);
+            return -1;
+        }
+    }
+    
+    atol_nv = NV_DATA_S(integrator->atol);
+    id_nv = NV_DATA_S(integrator->id);
+    for (i = 0; i < n_x; i++) {
+        atol_nv[i] = 0.01*integrator->rtol*problem->nominals[i];
+    }
+    for (i = n_x; i < integrator->n; i++) {
+        jmi_real_t nominal = SUNRabs(NV_DATA_S(integrator->res_work)[i]);
+        atol_nv[i] = 0.01*integrator->rtol*(nominal > 0.0 ? nominal : 1.0);
+        id_nv[i] = i < n_x + problem->sizes.algebraics ? 0.0 : 1.0;
+    }
+
+    ida_mem = IDACreate();
+    if(!ida_mem){
+        jmi_log_node(problem->log, logError, "Error", "Failed to allocate the IDA struct.");
+        return -1;
+    }
+    integrator->ida_mem = ida_mem;
+    
+    flag = IDAInit(ida_mem, ida_res, problem->time, integrator->y_work, integrator->yp_work);
+    if(flag != 0) {
+        jmi_log_node(problem->log, logError, "Error", "Failed to initialize IDA. Returned with <error_flag: %d>", flag);
+        return -1;
+    }
+
+    flag = IDASVtolerances(ida_mem, integrator->rtol, integrator->atol);
+    if(flag!=0){
+        jmi_log_node(problem->log, logError, "Error", "Failed to specify the tolerances. Returned with <error_flag: %d>", flag);
+        return -1;
+    }
+
+    flag = IDADense(ida_mem, integrator->n);
+    if(flag!=0){
+        jmi_log_node(problem->log, logError, "Error", "Failed to specify the linear solver. Returned with <error_flag: %d>", flag);
+        return -1;
+    }
+
+    /* Only the states are used in the error test, as for the ODE solvers */
+    flag = IDASetId(ida_mem, integrator->id);
+    if(flag==0){
+        flag = IDASetSuppressAlg(ida_mem, TRUE);
+    }
+    if(flag!=0){
+        jmi_log_node(problem->log, logError, "Error", "Failed to specify the algebraic unknowns. Returned with <error_flag: %d>", flag);
+        return -1;
+    }
+
+    flag = IDASetUserData(ida_mem, (void*)solver);
+    if(flag!=0){
+        jmi_log_node(problem->log, logError, "Error", "Failed to specify the user data. Returned with <error_flag: %d>", flag);
+        return -1;
+    }
+    
+    if (problem->sizes.event_indicators > 0){
+        flag = IDARootInit(ida_mem, problem->sizes.event_indicators, ida_root);
+        if(flag!=0){
+            jmi_log_node(problem->log, logError, "Error", "Failed to specify the event indicator function. Returned with <error_flag: %d>", flag);
+            return -1;
+        }
+    }
+    
+    flag = IDASetErrHandlerFn(ida_mem, ida_err, (void*)solver);
+    if(flag!=0){
+        jmi_log_node(problem->log, logError, "Error", "Failed to specify the error handling function. Returned with <error_flag: %d>", flag);
+        return -1;
+    }
+
+    return 0;
+}
+
+void jmi_ode_ida_delete(jmi_ode_solver_t* solver) {
+    
+    if((jmi_ode_ida_t*)(solver->integrator)){
+        jmi_ode_ida_t* integrator = (jmi_ode_ida_t*)solver->integrator;
+        jmi_ode_problem_t* problem = solver -> ode_problem;
+        
+        if (integrator->ida_mem) {
+            jmi_log_node_t node;
+            long int nsteps = 0, nrevals = 0, nlinsetups = 0, netfails = 0;
+            long int nniters = 0, nncfails = 0;
+            int qcur = 0, qlast = 0;
+            realtype hinused = 0.0, hlast = 0.0, hcur = 0.0, tcur = 0.0;
+            
+            /* Get statistics */
+            IDAGetIntegratorStats(integrator->ida_mem, &nsteps, &nrevals, &nlinsetups, &netfails, &qlast,
+                                  &qcur, &hinused, &hlast, &hcur, &tcur);
+            IDAGetNonlinSolvStats(integrator->ida_mem, &nniters, &nncfails);
+            
+            node = jmi_log_enter_fmt(problem->log, logInfo, "IDAStatistics", 
+                                         "Simulation statistics");
+            jmi_log_fmt(problem->log, node, logInfo, "<nsteps: %d>", nsteps);
+            jmi_log_fmt(problem->log, node, logInfo, "<nrevals: %d>", nrevals);
+            jmi_log_fmt(problem->log, node, logInfo, "<nerrfails: %d>", netfails);
+            jmi_log_fmt(problem->log, node, logInfo, "<nniters: %d>", nniters);
+            jmi_log_fmt(problem->log, node, logInfo, "<nnfails: %d>", nncfails);
+            jmi_log_fmt(problem->log, node, logInfo, "<nalgebraics: %d>", (int)problem->sizes.algebraics);
+            jmi_log_leave(problem->log, node);
+            
+            /*Deallocate IDA */
+            IDAFree(&(integrator->ida_mem));
+        }
+        
+        /*Deallocate work vectors.*/
+        if (integrator->atol)     N_VDestroy_Serial(integrator->atol);
+        if (integrator->id)       N_VDestroy_Serial(integrator->id);
+        if (integrator->y_work)   N_VDestroy_Serial(integrator->y_work);
+        if (integrator->yp_work)  N_VDestroy_Serial(integrator->yp_work);
+        if (integrator->res_work) N_VDestroy_Serial(integrator->res_work);
+        
+        free(integrator);
+    }
+}
@@ -0,0 +1,56 @@
+/*
+    Copyright (C) 2018 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+
+/** \file jmi_ode_ida.h
+ *  \brief Structures and functions for handling an IDA DAE solver.
+ *
+ *  The solver integrates the states together with the algebraic unknowns
+ *  of the problem, so that equation systems are converged by the Newton
+ *  iteration of the integrator instead of in each right-hand-side evaluation.
+ */
+
+#ifndef _JMI_ODE_IDA_H
+#define _JMI_ODE_IDA_H
+
+#include "jmi_ode_solver.h"
+#include "jmi_ode_problem.h"
+#include <nvector/nvector_serial.h>
+
+typedef struct jmi_ode_ida_t jmi_ode_ida_t;
+
+int jmi_ode_ida_new(jmi_ode_ida_t** integrator_ptr, jmi_ode_solver_t* solver);
+
+jmi_ode_status_t jmi_ode_ida_solve(jmi_ode_solver_t* solver, realtype time_final, int initialize);
+
+void jmi_ode_ida_delete(jmi_ode_solver_t* solver);
+
+struct jmi_ode_ida_t {
+
+    void *ida_mem;
+    size_t n;           /* Number of unknowns, states followed by algebraics */
+    realtype rtol;      /* Specifies the relative tolerance */
+    N_Vector atol;      /* Specifies the absolute tolerance */
+    N_Vector id;        /* 1.0 for the states and 0.0 for the algebraics */
+    N_Vector y_work;
+    N_Vector yp_work;
+    N_Vector res_work;
+};
+
+#endif
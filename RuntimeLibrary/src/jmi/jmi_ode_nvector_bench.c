@@ -0,0 +1,170 @@
+/*
+    Copyright (C) 2017 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+/*
+ * jmi_ode_nvector_bench.c compares the CVode integrator using serial and
+ * threaded vectors for increasing number of states.
+ *
+ * Usage: jmi_ode_nvector_bench [max_states] [max_threads]
+ *
+ * The number of states is increased by a factor 10 from 1000 up to
+ * max_states (default 100000) and the number of threads is doubled from 2 up
+ * to max_threads (default 4). The smallest number of states for which a
+ * threaded run is faster than the serial one is reported as the crossover.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "jmi_ode_problem.h"
+#include "jmi_ode_solver.h"
+
+static double wall_time() {
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + 1e-6 * tv.tv_usec;
+#endif
+}
+
+static void emit_log(jmi_callbacks_t* c, jmi_log_category_t category, jmi_log_category_t severest_category, char* message) {
+    printf("[%s] %s", jmi_callback_log_category_to_string(category), message);
+}
+
+static int is_log_category_emitted (jmi_callbacks_t* c, jmi_log_category_t category) {
+    return category <= logWarning;
+}
+
+static jmi_callbacks_t* jmi_get_default_callbacks() {
+    jmi_callbacks_t* cb = (jmi_callbacks_t*)calloc(1, sizeof(jmi_callbacks_t));
+
+    cb->log_options.logging_on_flag = 1;
+    cb->log_options.log_level = 2;
+    cb->log_options.copy_log_to_file_flag = 0;
+    cb->emit_log = emit_log;
+    cb->is_log_category_emitted = is_log_category_emitted;
+
+    cb->allocate_memory = calloc;
+    cb->free_memory = free;
+    cb->model_name = "bench";
+    cb->instance_name = "bench_instance";
+    return cb;
+}
+
+/* Weakly coupled states, y_i' = -(1 + i%10)*y_i + 0.1*y_(i-1) */
+int bench_rhs(jmi_real_t t, jmi_real_t* y, jmi_real_t* rhs, jmi_ode_sizes_t sizes, void* problem_data) {
+    size_t i;
+    for (i = 0; i < sizes.states; i++) {
+        rhs[i] = -(1.0 + i % 10) * y[i] + (i > 0 ? 0.1 * y[i - 1] : 0.0);
+    }
+    return 0;
+}
+
+int bench_dir_der(jmi_real_t t, jmi_real_t* y, jmi_real_t* v, jmi_real_t* jv, jmi_ode_sizes_t sizes, void* problem_data) {
+    return bench_rhs(t, v, jv, sizes, problem_data);
+}
+
+/* Integrates the benchmark problem to t = 10 and returns the wall time. */
+static double bench_solve(size_t n, int num_threads) {
+    jmi_ode_sizes_t sizes;
+    jmi_ode_callbacks_t ode_callbacks = jmi_ode_problem_default_callbacks();
+    jmi_ode_solver_options_t ode_options = jmi_ode_solver_default_options();
+    jmi_ode_problem_t* ode_problem;
+    jmi_ode_solver_t* ode_solver;
+    jmi_log_t* log;
+    jmi_callbacks_t* cb;
+    jmi_ode_status_t ret;
+    double start, stop;
+    size_t i;
+
+    cb = jmi_get_default_callbacks();
+    log = jmi_log_init(cb);
+
+    ode_callbacks.rhs_func = bench_rhs;
+    ode_callbacks.dir_der_func = bench_dir_der;
+    sizes.states = n;
+    sizes.event_indicators = 0;
+    sizes.algebraics = 0;
+    ode_problem = jmi_new_ode_problem(cb, NULL, ode_callbacks, sizes, log);
+    ode_problem->time = 0.0;
+    for (i = 0; i < n; i++) {
+        ode_problem->states[i] = 1.0;
+        ode_problem->nominals[i] = 1.0;
+    }
+
+    ode_options.cvode_options.linear_solver = JMI_ODE_CVODE_SPGMR;
+    ode_options.cvode_options.precond_block_size = 10;
+    ode_options.cvode_options.num_threads = num_threads;
+
+    start = wall_time();
+    ode_solver = jmi_new_ode_solver(ode_problem, ode_options);
+    ret = jmi_ode_solver_solve(ode_solver, 10.0);
+    jmi_free_ode_solver(ode_solver);
+    stop = wall_time();
+
+    if (ret != JMI_ODE_OK) {
+        fprintf(stderr, "Solver failed for %lu states and %d threads\n", (unsigned long)n, num_threads);
+        exit(EXIT_FAILURE);
+    }
+
+    jmi_free_ode_problem(ode_problem);
+    jmi_log_delete(log);
+    free(cb);
+
+    return stop - start;
+}
+
+int main(int argc, char* argv[]) {
+    size_t max_states = argc > 1 ? (size_t)atol(argv[1]) : 100000;
+    int max_threads = argc > 2 ? atoi(argv[2]) : 4;
+    size_t n, crossover = 0;
+    int threads;
+
+    printf("%10s %8s %12s %10s\n", "states", "threads", "time [s]", "speedup");
+    for (n = 1000; n <= max_states; n *= 10) {
+        double serial = bench_solve(n, 1);
+        printf("%10lu %8d %12.4f %10.2f\n", (unsigned long)n, 1, serial, 1.0);
+        for (threads = 2; threads <= max_threads; threads *= 2) {
+            double threaded = bench_solve(n, threads);
+            printf("%10lu %8d %12.4f %10.2f\n", (unsigned long)n, threads, threaded, serial / threaded);
+            if (threaded < serial && crossover == 0) {
+                crossover = n;
+            }
+        }
+    }
+
+    if (crossover > 0) {
+        printf("Threaded vectors are faster from %lu states.\n", (unsigned long)crossover);
+    } else {
+        printf("Threaded vectors are not faster for up to %lu states.\n", (unsigned long)max_states);
+    }
+
+    return EXIT_SUCCESS;
+}
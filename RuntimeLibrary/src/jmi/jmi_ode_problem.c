@@ -60,6 +60,9 @@ jmi_ode_callbacks_t jmi_ode_problem_default_callbacks() {
     cb.root_func = default_root_fcn;
     cb.complete_step_func = default_completed_integrator_step;
     cb.event_update_func = default_event_update;
+    cb.dir_der_func = NULL;
+    cb.dae_res_func = NULL;
+    cb.dae_alg_func = NULL;
     return cb;
 }
 
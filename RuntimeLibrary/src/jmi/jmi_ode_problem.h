@@ -31,6 +31,7 @@
 typedef struct {
     size_t states;
     size_t event_indicators;
+    size_t algebraics;
 } jmi_ode_sizes_t;
 
 /**
@@ -57,6 +58,44 @@ typedef int (*jmi_rhs_func_t)(jmi_real_t t, jmi_real_t* y, jmi_real_t* rhs, jmi_
   */
 typedef int (*jmi_root_func_t)(jmi_real_t t, jmi_real_t *y, jmi_real_t *root, jmi_ode_sizes_t sizes, void* problem_data);
 
+/**
+ * \brief An ode directional derivative signature, the product of the state Jacobian and a vector.
+ *
+ * @param t The ODE time.
+ * @param y A pointer to the states of the ODE.
+ * @param v A pointer to the direction.
+ * @param jv A pointer to the directional derivative of the state derivatives.
+ * @param sizes A jmi_ode_sizes_t struct with ODE state and root sizes.
+ * @param problem_data Opac callback data depending on implementation.
+ * @return Error code.
+  */
+typedef int (*jmi_dir_der_func_t)(jmi_real_t t, jmi_real_t* y, jmi_real_t* v, jmi_real_t* jv, jmi_ode_sizes_t sizes, void* problem_data);
+
+/**
+ * \brief A dae residual signature, used by integrators that treat the algebraic
+ * unknowns of the problem as unknowns of the integrator.
+ *
+ * @param t The DAE time.
+ * @param y A pointer to the states followed by the algebraic unknowns.
+ * @param yp A pointer to the state derivatives followed by (unused) algebraic derivatives.
+ * @param res A pointer to the residual, state equations followed by algebraic equations.
+ * @param sizes A jmi_ode_sizes_t struct with ODE state, root and algebraic sizes.
+ * @param problem_data Opac callback data depending on implementation.
+ * @return Error code.
+  */
+typedef int (*jmi_dae_res_func_t)(jmi_real_t t, jmi_real_t* y, jmi_real_t* yp, jmi_real_t* res, jmi_ode_sizes_t sizes, void* problem_data);
+
+/**
+ * \brief A dae algebraics signature, gives the current values and nominals of the algebraic unknowns.
+ *
+ * @param w A pointer to the algebraic unknowns.
+ * @param nominals A pointer to the nominals of the algebraic unknowns.
+ * @param sizes A jmi_ode_sizes_t struct with ODE state, root and algebraic sizes.
+ * @param problem_data Opac callback data depending on implementation.
+ * @return Error code.
+  */
+typedef int (*jmi_dae_alg_func_t)(jmi_real_t* w, jmi_real_t* nominals, jmi_ode_sizes_t sizes, void* problem_data);
+
 /**
  * \brief An ode complete-step-function signature.
  *
@@ -80,6 +119,9 @@ typedef struct {
     jmi_root_func_t           root_func;            /**< \brief A callback function for the root of the ODE problem. */
     jmi_complete_step_func_t  complete_step_func;   /**< \brief A callback function for completing the step. */
     jmi_event_update_func_t   event_update_func;    /**< \brief A callback function for updating at events. */
+    jmi_dir_der_func_t        dir_der_func;         /**< \brief A callback function for the directional derivative of the rhs, may be NULL. */
+    jmi_dae_res_func_t        dae_res_func;         /**< \brief A callback function for the DAE residual, NULL if there are no algebraics. */
+    jmi_dae_alg_func_t        dae_alg_func;         /**< \brief A callback function for the algebraic unknowns, NULL if there are no algebraics. */
 } jmi_ode_callbacks_t;
 
 typedef struct {
@@ -0,0 +1,445 @@
+/*
+    Copyright (C) 2017 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+#include <math.h>
+
+#include "jmi_ode_solver_impl.h"
+#include "jmi_ode_problem.h"
+#include "jmi_ode_rk.h"
+#include "jmi_math.h"
+#include "jmi_log.h"
+
+/* Heun's method with explicit Euler as embedded method, order 2(1) */
+static const jmi_real_t heun_a[] = {
+    0.0, 0.0,
+    1.0, 0.0
+};
+static const jmi_real_t heun_b[] = { 0.5, 0.5 };
+static const jmi_real_t heun_c[] = { 0.0, 1.0 };
+static const jmi_real_t heun_e[] = { -0.5, 0.5 };
+
+/* The classical fourth order method */
+static const jmi_real_t rk4_a[] = {
+    0.0, 0.0, 0.0, 0.0,
+    0.5, 0.0, 0.0, 0.0,
+    0.0, 0.5, 0.0, 0.0,
+    0.0, 0.0, 1.0, 0.0
+};
+static const jmi_real_t rk4_b[] = { 1.0/6.0, 1.0/3.0, 1.0/3.0, 1.0/6.0 };
+static const jmi_real_t rk4_c[] = { 0.0, 0.5, 0.5, 1.0 };
+
+/* Bogacki-Shampine, order 3(2) */
+static const jmi_real_t bs3_a[] = {
+    0.0,     0.0,     0.0,     0.0,
+    1.0/2.0, 0.0,     0.0,     0.0,
+    0.0,     3.0/4.0, 0.0,     0.0,
+    2.0/9.0, 1.0/3.0, 4.0/9.0, 0.0
+};
+static const jmi_real_t bs3_b[] = { 2.0/9.0, 1.0/3.0, 4.0/9.0, 0.0 };
+static const jmi_real_t bs3_c[] = { 0.0, 1.0/2.0, 3.0/4.0, 1.0 };
+static const jmi_real_t bs3_e[] = { -5.0/72.0, 1.0/12.0, 1.0/9.0, -1.0/8.0 };
+
+/* Dormand-Prince, order 5(4) */
+static const jmi_real_t dp5_a[] = {
+    0.0,            0.0,             0.0,            0.0,          0.0,             0.0,       0.0,
+    1.0/5.0,        0.0,             0.0,            0.0,          0.0,             0.0,       0.0,
+    3.0/40.0,       9.0/40.0,        0.0,            0.0,          0.0,             0.0,       0.0,
+    44.0/45.0,      -56.0/15.0,      32.0/9.0,       0.0,          0.0,             0.0,       0.0,
+    19372.0/6561.0, -25360.0/2187.0, 64448.0/6561.0, -212.0/729.0, 0.0,             0.0,       0.0,
+    9017.0/3168.0,  -355.0/33.0,     46732.0/5247.0, 49.0/176.0,   -5103.0/18656.0, 0.0,       0.0,
+    35.0/384.0,     0.0,             500.0/1113.0,   125.0/192.0,  -2187.0/6784.0,  11.0/84.0, 0.0
+};
+static const jmi_real_t dp5_b[] = { 35.0/384.0, 0.0, 500.0/1113.0, 125.0/192.0, -2187.0/6784.0, 11.0/84.0, 0.0 };
+static const jmi_real_t dp5_c[] = { 0.0, 1.0/5.0, 3.0/10.0, 4.0/5.0, 8.0/9.0, 1.0, 1.0 };
+static const jmi_real_t dp5_e[] = { 71.0/57600.0, 0.0, -71.0/16695.0, 71.0/1920.0, -17253.0/339200.0, 22.0/525.0, -1.0/40.0 };
+
+static const jmi_ode_rk_tableau_t jmi_ode_rk_tableaus[] = {
+    { "Heun",             2, 2, FALSE, heun_a, heun_b, heun_c, heun_e },
+    { "RK4",              4, 4, FALSE, rk4_a,  rk4_b,  rk4_c,  NULL   },
+    { "Bogacki-Shampine", 4, 3, TRUE,  bs3_a,  bs3_b,  bs3_c,  bs3_e  },
+    { "Dormand-Prince",   7, 5, TRUE,  dp5_a,  dp5_b,  dp5_c,  dp5_e  }
+};
+
+/* Same test as in the solver: an indicator changed sign if it went from negative to non-negative or the other way */
+static int jmi_ode_rk_sign_change(const jmi_real_t* g0, const jmi_real_t* g1, size_t dim) {
+    size_t i;
+
+    for (i = 0; i < dim; i++) {
+        if ((g1[i] >= 0.0 && g0[i] < 0.0) || (g1[i] < 0.0 && g0[i] >= 0.0)) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/* Cubic Hermite interpolation of the states over the step [t0, t0 + h] */
+static void jmi_ode_rk_interpolate(size_t n, jmi_real_t t0, jmi_real_t h,
+                                   const jmi_real_t* y0, const jmi_real_t* ydot0,
+                                   const jmi_real_t* y1, const jmi_real_t* ydot1,
+                                   jmi_real_t t, jmi_real_t* y) {
+    jmi_real_t theta = (t - t0) / h;
+    jmi_real_t h00 = (1.0 + 2.0*theta)*(1.0 - theta)*(1.0 - theta);
+    jmi_real_t h10 = theta*(1.0 - theta)*(1.0 - theta)*h;
+    jmi_real_t h01 = theta*theta*(3.0 - 2.0*theta);
+    jmi_real_t h11 = theta*theta*(theta - 1.0)*h;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        y[i] = h00*y0[i] + h10*ydot0[i] + h01*y1[i] + h11*ydot1[i];
+    }
+}
+
+/* Weighted max norm of the difference between the method and its embedded method, with the weights used by CVode */
+static void jmi_ode_rk_estimate_error(jmi_ode_rk_t* integrator, jmi_ode_problem_t* problem, jmi_real_t h) {
+    const jmi_ode_rk_tableau_t* tab = integrator->tableau;
+    jmi_real_t* y = problem->states;
+    jmi_real_t err = 0.0;
+    size_t i;
+    int j;
+
+    for (i = 0; i < problem->sizes.states; i++) {
+        jmi_real_t e_i = 0.0;
+        jmi_real_t w_i = integrator->rtol*(fabs(y[i]) + 0.01*problem->nominals[i]);
+
+        for (j = 0; j < tab->stages; j++) {
+            e_i += tab->e[j]*integrator->k[j][i];
+        }
+        e_i = fabs(h*e_i) / w_i;
+        if (e_i > err) {
+            err = e_i;
+        }
+    }
+
+    if (err > integrator->max_error) {
+        integrator->max_error = err;
+    }
+    if (err > 1.0 && !integrator->error_warning_emitted) {
+        jmi_log_node(problem->log, logWarning, "RKErrorEstimate",
+            "The local error estimate of the <method: %s> method is <error: %g> times the tolerance at <t: %g>, "
+            "consider decreasing cs_step_size.", tab->name, err, problem->time);
+        integrator->error_warning_emitted = TRUE;
+    }
+}
+
+/*
+ * Locates the first event in the step [t0, t0 + h] with the Illinois variant of regula falsi,
+ * applied to the event indicators evaluated along the interpolated states. On return the
+ * states, the time and the event indicators are those at the right end of the final bracket.
+ */
+static int jmi_ode_rk_locate_event(jmi_ode_solver_t* solver, jmi_real_t t0, jmi_real_t h, jmi_real_t* ydot_end) {
+    jmi_ode_rk_t* integrator = (jmi_ode_rk_t*)solver->integrator;
+    jmi_ode_problem_t* problem = solver->ode_problem;
+    size_t n = problem->sizes.states;
+    size_t n_g = problem->sizes.event_indicators;
+    jmi_real_t* y = problem->states;
+    jmi_real_t* g_low = integrator->g_low;
+    jmi_real_t* g_mid = integrator->g_mid;
+    jmi_real_t* g_high = solver->event_indicators;
+    jmi_real_t t_low = t0;
+    jmi_real_t t_high = t0 + h;
+    jmi_real_t t_mid;
+    jmi_real_t ttol = 100*JMI_EPS*(fabs(t_high) + fabs(h));
+    jmi_real_t alpha = 1.0;
+    int side = 0, side_previous;
+    int flag, iter;
+    size_t i;
+
+    memcpy(g_low, solver->event_indicators_previous, n_g * sizeof(jmi_real_t));
+
+    for (iter = 0; iter < JMI_ODE_RK_MAX_EVENT_ITER && t_high - t_low > ttol; iter++) {
+        /* The earliest secant estimate of the indicators that changed sign */
+        t_mid = t_high;
+        for (i = 0; i < n_g; i++) {
+            if ((g_high[i] >= 0.0 && g_low[i] < 0.0) || (g_high[i] < 0.0 && g_low[i] >= 0.0)) {
+                jmi_real_t t_i = t_high - (t_high - t_low)*g_high[i]/(g_high[i] - alpha*g_low[i]);
+                if (t_i < t_mid) {
+                    t_mid = t_i;
+                }
+            }
+        }
+        if (t_mid - t_low < 0.5*ttol) {
+            t_mid = t_low + 0.5*ttol;
+        }
+        if (t_high - t_mid < 0.5*ttol) {
+            t_mid = t_high - 0.5*ttol;
+        }
+
+        jmi_ode_rk_interpolate(n, t0, h, integrator->y_previous, integrator->k[0], y, ydot_end, t_mid, integrator->y_stage);
+        flag = problem->ode_callbacks.root_func(t_mid, integrator->y_stage, g_mid, problem->sizes, problem->problem_data);
+        if (flag != 0) {
+            return flag;
+        }
+
+        side_previous = side;
+        if (jmi_ode_rk_sign_change(g_low, g_mid, n_g)) {
+            t_high = t_mid;
+            memcpy(g_high, g_mid, n_g * sizeof(jmi_real_t));
+            side = 1;
+        } else {
+            t_low = t_mid;
+            memcpy(g_low, g_mid, n_g * sizeof(jmi_real_t));
+            side = 2;
+        }
+        if (side == side_previous) {
+            alpha = side == 2 ? 2.0*alpha : 0.5*alpha;
+        } else {
+            alpha = 1.0;
+        }
+    }
+
+    jmi_ode_rk_interpolate(n, t0, h, integrator->y_previous, integrator->k[0], y, ydot_end, t_high, integrator->y_stage);
+    memcpy(y, integrator->y_stage, n * sizeof(jmi_real_t));
+    problem->time = t_high;
+
+    jmi_log_node(problem->log, logInfo, "RKEvent", "An event was located at <t: %g> using <evaluations: %d> "
+                 "evaluations of the event indicators", t_high, iter);
+    return 0;
+}
+
+jmi_ode_status_t jmi_ode_rk_solve(jmi_ode_solver_t* solver, double tend, int initialize) {
+    int flag = 0;
+    jmi_ode_rk_t* integrator = (jmi_ode_rk_t*)solver->integrator;
+    const jmi_ode_rk_tableau_t* tab = integrator->tableau;
+    jmi_ode_problem_t* problem = solver->ode_problem;
+    jmi_ode_sizes_t sizes = problem->sizes;
+    size_t n = sizes.states;
+    char step_event = 0; /* boolean step_event = FALSE */
+    char terminate = 0;
+
+    jmi_real_t tcur, tnext, tprevious;
+    jmi_real_t hcur;
+    jmi_real_t hdef = integrator->step_size;
+
+    jmi_real_t* y = problem->states;
+    jmi_real_t* y_stage = integrator->y_stage;
+    jmi_real_t* event_indicators = solver->event_indicators;
+    jmi_real_t* event_indicators_previous = solver->event_indicators_previous;
+    jmi_ode_status_t ret = JMI_ODE_OK;
+
+    tcur = problem->time;
+
+    /* Inputs may have been changed since the last call */
+    integrator->k1_valid = FALSE;
+
+    /* Get the first event indicators */
+    if (sizes.event_indicators > 0) {
+        flag = problem->ode_callbacks.root_func(tcur, y, event_indicators_previous, sizes, problem->problem_data);
+        if (flag != 0) {
+            jmi_log_node(problem->log, logError, "RKSolver", "Could not retrieve event indicators");
+            return JMI_ODE_ERROR;
+        }
+    }
+
+    while (tcur < tend) {
+        jmi_real_t* ydot_end;
+        int ydot_end_valid;
+        int zero_crossing_event = 0;
+        size_t i;
+        int j, s;
+
+        /* The first stage is the derivatives at the current point, unless known from the last step */
+        if (!integrator->k1_valid) {
+            flag = problem->ode_callbacks.rhs_func(tcur, y, integrator->k[0], sizes, problem->problem_data);
+            if (flag != 0) {
+                jmi_log_node(problem->log, logError, "RKSolver", "Could not retrieve time derivatives");
+                return JMI_ODE_ERROR;
+            }
+        }
+
+        /* Choose time step, adjust it to get tend exactly */
+        tnext = tcur + hdef;
+        if (tnext > tend - hdef/1e16) {
+            tnext = tend;
+        }
+        hcur = tnext - tcur;
+
+        /* Remaining stages */
+        for (s = 1; s < tab->stages; s++) {
+            const jmi_real_t* a = tab->a + s*tab->stages;
+            for (i = 0; i < n; i++) {
+                jmi_real_t sum = 0.0;
+                for (j = 0; j < s; j++) {
+                    sum += a[j]*integrator->k[j][i];
+                }
+                y_stage[i] = y[i] + hcur*sum;
+            }
+            flag = problem->ode_callbacks.rhs_func(tcur + tab->c[s]*hcur, y_stage, integrator->k[s], sizes, problem->problem_data);
+            if (flag != 0) {
+                jmi_log_node(problem->log, logError, "RKSolver", "Could not retrieve time derivatives");
+                return JMI_ODE_ERROR;
+            }
+        }
+
+        /* Integrate, keep the states at the beginning of the step for event location */
+        memcpy(integrator->y_previous, y, n * sizeof(jmi_real_t));
+        for (i = 0; i < n; i++) {
+            jmi_real_t sum = 0.0;
+            for (j = 0; j < tab->stages; j++) {
+                sum += tab->b[j]*integrator->k[j][i];
+            }
+            y[i] = y[i] + hcur*sum;
+        }
+        tprevious = tcur;
+        tcur = tnext;
+        problem->time = tnext;
+
+        if (tab->e != NULL) {
+            jmi_ode_rk_estimate_error(integrator, problem, hcur);
+        }
+
+        /* With first same as last the last stage is already the derivatives at the end of the step */
+        ydot_end = tab->fsal ? integrator->k[tab->stages - 1] : integrator->ydot_end;
+        ydot_end_valid = tab->fsal;
+
+        /* Check if an event indicator has triggered and locate it within the step */
+        if (sizes.event_indicators > 0) {
+            flag = problem->ode_callbacks.root_func(tcur, y, event_indicators, sizes, problem->problem_data);
+            if (flag != 0) {
+                jmi_log_node(problem->log, logError, "RKSolver", "Could not retrieve event indicators");
+                return JMI_ODE_ERROR;
+            }
+
+            if (jmi_ode_rk_sign_change(event_indicators_previous, event_indicators, sizes.event_indicators)) {
+                zero_crossing_event = 1;
+                if (!ydot_end_valid) {
+                    flag = problem->ode_callbacks.rhs_func(tcur, y, ydot_end, sizes, problem->problem_data);
+                    if (flag != 0) {
+                        jmi_log_node(problem->log, logError, "RKSolver", "Could not retrieve time derivatives");
+                        return JMI_ODE_ERROR;
+                    }
+                }
+                flag = jmi_ode_rk_locate_event(solver, tprevious, hcur, ydot_end);
+                if (flag != 0) {
+                    jmi_log_node(problem->log, logError, "RKSolver", "Could not locate the event in the step from <t: %g>", tprevious);
+                    return JMI_ODE_ERROR;
+                }
+                tcur = problem->time;
+                ydot_end_valid = FALSE;
+            }
+            memcpy(event_indicators_previous, event_indicators, sizes.event_indicators * sizeof(jmi_real_t));
+        }
+
+        /* Reuse the derivatives at the end of the step as the first stage of the next step */
+        if (ydot_end_valid) {
+            jmi_real_t* tmp = integrator->k[0];
+            integrator->k[0] = integrator->k[tab->stages - 1];
+            integrator->k[tab->stages - 1] = tmp;
+        }
+        integrator->k1_valid = ydot_end_valid;
+
+        /* After each step call completed integrator step */
+        flag = problem->ode_callbacks.complete_step_func(&step_event, &terminate, problem->problem_data);
+        if (flag != 0) {
+            jmi_log_node(problem->log, logError, "Error", "Failed to complete an integrator step. "
+                     "Returned with <error_flag: %d>", flag);
+            return JMI_ODE_ERROR;
+        }
+
+        /* Handle events */
+        if (zero_crossing_event || step_event == TRUE) {
+            jmi_log_node(problem->log, logInfo, "RKEvent", "An event was detected at <t:%g>", tcur);
+            integrator->k1_valid = FALSE;
+            ret = JMI_ODE_EVENT;
+            break;
+        }
+
+        if (terminate == TRUE) {
+            jmi_log_node(problem->log, logInfo, "Terminate",
+                "Terminating simulation after a signal from the model at <t:%g>", tcur);
+            ret = JMI_ODE_TERMINATE;
+            break;
+        }
+    } /* while */
+
+    if (tab->e != NULL && integrator->max_error > 0.0) {
+        jmi_log_node(problem->log, logInfo, "RKErrorEstimate",
+            "Largest local error estimate relative to the tolerance is <error: %g> up to <t: %g>",
+            integrator->max_error, tcur);
+        integrator->max_error = 0.0;
+    }
+
+    return ret;
+}
+
+int jmi_ode_rk_new(jmi_ode_rk_t** integrator_ptr, jmi_ode_solver_t* solver) {
+    jmi_ode_rk_t* integrator;
+    jmi_ode_problem_t* problem = solver -> ode_problem;
+    size_t n = problem->sizes.states > 0 ? problem->sizes.states : 1;
+    size_t n_g = problem->sizes.event_indicators > 0 ? problem->sizes.event_indicators : 1;
+    int i;
+
+    *integrator_ptr = NULL;
+    if (solver->rk_method < 0 || solver->rk_method > JMI_ODE_RK_DORMAND_PRINCE) {
+        jmi_log_node(problem->log, logError, "RKSolver", "Unknown Runge-Kutta <method: %d>", solver->rk_method);
+        return -1;
+    }
+
+    integrator = (jmi_ode_rk_t*)calloc(1, sizeof(jmi_ode_rk_t));
+    if (!integrator) {
+        jmi_log_node(problem->log, logError, "RKSolver", "Failed to allocate the internal struct.");
+        return -1;
+    }
+    *integrator_ptr = integrator;
+
+    integrator->tableau   = &jmi_ode_rk_tableaus[solver->rk_method];
+    integrator->step_size = solver->step_size;
+    integrator->rtol      = solver->rel_tol;
+
+    for (i = 0; i < integrator->tableau->stages; i++) {
+        integrator->k[i] = (jmi_real_t*)calloc(n, sizeof(jmi_real_t));
+    }
+    integrator->y_stage    = (jmi_real_t*)calloc(n, sizeof(jmi_real_t));
+    integrator->y_previous = (jmi_real_t*)calloc(n, sizeof(jmi_real_t));
+    integrator->ydot_end   = (jmi_real_t*)calloc(n, sizeof(jmi_real_t));
+    integrator->g_low      = (jmi_real_t*)calloc(n_g, sizeof(jmi_real_t));
+    integrator->g_mid      = (jmi_real_t*)calloc(n_g, sizeof(jmi_real_t));
+
+    for (i = 0; i < integrator->tableau->stages; i++) {
+        if (!integrator->k[i]) {
+            break;
+        }
+    }
+    if (i < integrator->tableau->stages || !integrator->y_stage || !integrator->y_previous ||
+        !integrator->ydot_end || !integrator->g_low || !integrator->g_mid) {
+        jmi_log_node(problem->log, logError, "RKSolver", "Failed to allocate the work vectors.");
+        return -1;
+    }
+
+    jmi_log_node(problem->log, logInfo, "RKSolver", "Using the fixed step <method: %s> method of <order: %d>",
+                 integrator->tableau->name, integrator->tableau->order);
+
+    return 0;
+}
+
+void jmi_ode_rk_delete(jmi_ode_solver_t* solver) {
+    jmi_ode_rk_t* integrator = (jmi_ode_rk_t*)solver->integrator;
+    int i;
+
+    if (integrator) {
+        for (i = 0; i < JMI_ODE_RK_MAX_STAGES; i++) {
+            free(integrator->k[i]);
+        }
+        free(integrator->y_stage);
+        free(integrator->y_previous);
+        free(integrator->ydot_end);
+        free(integrator->g_low);
+        free(integrator->g_mid);
+        free(integrator);
+    }
+}
@@ -0,0 +1,79 @@
+ /*
+    Copyright (C) 2017 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+
+/** \file jmi_ode_rk.h
+ *  \brief Structures and functions for handling fixed step explicit Runge-Kutta ODE solvers.
+ *
+ *  Every step uses the same number of right-hand-side evaluations. State
+ *  events are located by interpolating the states with a cubic Hermite
+ *  polynomial over the step, and the methods with an embedded pair estimate
+ *  the local error of each step.
+ */
+
+#ifndef _JMI_ODE_RK_H
+#define _JMI_ODE_RK_H
+
+#include <string.h>
+#include "jmi_ode_solver.h"
+
+/** \brief Maximum number of stages of the supported methods */
+#define JMI_ODE_RK_MAX_STAGES 7
+
+/** \brief Maximum number of event indicator evaluations when locating an event */
+#define JMI_ODE_RK_MAX_EVENT_ITER 20
+
+/** \brief Butcher tableau of an explicit Runge-Kutta method */
+typedef struct {
+    const char* name;
+    int stages;
+    int order;
+    int fsal;                   /**< \brief The last stage is the derivative at the end of the step */
+    const jmi_real_t* a;        /**< \brief Stage coefficients, stages x stages row major, strictly lower triangular */
+    const jmi_real_t* b;        /**< \brief Solution weights */
+    const jmi_real_t* c;        /**< \brief Stage times */
+    const jmi_real_t* e;        /**< \brief Difference to the weights of the embedded method, NULL if there is none */
+} jmi_ode_rk_tableau_t;
+
+typedef struct jmi_ode_rk_t jmi_ode_rk_t;
+
+int jmi_ode_rk_new(jmi_ode_rk_t** integrator_ptr, jmi_ode_solver_t* solver);
+
+jmi_ode_status_t jmi_ode_rk_solve(jmi_ode_solver_t* solver, double time_final, int initialize);
+
+void jmi_ode_rk_delete(jmi_ode_solver_t* solver);
+
+struct jmi_ode_rk_t {
+    const jmi_ode_rk_tableau_t* tableau;
+    jmi_real_t step_size;
+    jmi_real_t rtol;            /* Tolerance the error estimate is compared against */
+
+    jmi_real_t* k[JMI_ODE_RK_MAX_STAGES]; /* Stage derivatives */
+    jmi_real_t* y_stage;        /* States of the current stage */
+    jmi_real_t* y_previous;     /* States at the beginning of the step */
+    jmi_real_t* ydot_end;       /* Derivatives at the end of the step */
+    jmi_real_t* g_low;          /* Event indicators at the left end of the event bracket */
+    jmi_real_t* g_mid;          /* Event indicators at the tried point in the event bracket */
+    int k1_valid;               /* k[0] holds the derivatives at the current point */
+
+    jmi_real_t max_error;       /* Largest weighted error estimate since the last report */
+    int error_warning_emitted;
+};
+
+#endif
@@ -0,0 +1,213 @@
+/*
+    Copyright (C) 2017 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+/*
+ * jmi_ode_rk_bench.c compares the accuracy per CPU time of the fixed step
+ * solvers, Euler and the explicit Runge-Kutta methods.
+ *
+ * Usage: jmi_ode_rk_bench [n_pendulums] [error_tol]
+ *
+ * A set of damped pendulums (default 20) is integrated to t = 10 with
+ * communication points every 0.1, as a co-simulation master would, for
+ * step sizes halved from 0.1. The error is the largest deviation from a
+ * reference solution computed with Dormand-Prince and a very small step.
+ * For each method the cheapest run with an error below error_tol
+ * (default 1e-2) is reported together with its speedup over Euler.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#include "jmi_ode_problem.h"
+#include "jmi_ode_solver.h"
+
+#define BENCH_FINAL_TIME 10.0
+#define BENCH_COM_STEP 0.1
+#define BENCH_N_STEP_SIZES 14
+
+static void emit_log(jmi_callbacks_t* c, jmi_log_category_t category, jmi_log_category_t severest_category, char* message) {
+    printf("[%s] %s", jmi_callback_log_category_to_string(category), message);
+}
+
+static int is_log_category_emitted (jmi_callbacks_t* c, jmi_log_category_t category) {
+    return category <= logError;
+}
+
+static jmi_callbacks_t* jmi_get_default_callbacks() {
+    jmi_callbacks_t* cb = (jmi_callbacks_t*)calloc(1, sizeof(jmi_callbacks_t));
+
+    cb->log_options.logging_on_flag = 1;
+    cb->log_options.log_level = 1;
+    cb->log_options.copy_log_to_file_flag = 0;
+    cb->emit_log = emit_log;
+    cb->is_log_category_emitted = is_log_category_emitted;
+
+    cb->allocate_memory = calloc;
+    cb->free_memory = free;
+    cb->model_name = "bench";
+    cb->instance_name = "bench_instance";
+    return cb;
+}
+
+static long n_rhs_evaluations = 0;
+
+/* Damped pendulums of different lengths, y = (phi_0, w_0, phi_1, w_1, ...) */
+int bench_rhs(jmi_real_t t, jmi_real_t* y, jmi_real_t* rhs, jmi_ode_sizes_t sizes, void* problem_data) {
+    size_t i;
+    for (i = 0; i < sizes.states; i += 2) {
+        jmi_real_t g_over_l = 9.81 / (0.5 + 0.1 * (i / 2));
+        rhs[i]     = y[i + 1];
+        rhs[i + 1] = -g_over_l * sin(y[i]) - 0.1 * y[i + 1];
+    }
+    n_rhs_evaluations++;
+    return 0;
+}
+
+typedef struct {
+    const char* name;
+    jmi_ode_method_t method;
+    jmi_ode_rk_method_t rk_method;
+} bench_method_t;
+
+static const bench_method_t bench_methods[] = {
+    { "Euler",            JMI_ODE_EULER, JMI_ODE_RK_RK4 },
+    { "Heun",             JMI_ODE_RK,    JMI_ODE_RK_HEUN },
+    { "Bogacki-Shampine", JMI_ODE_RK,    JMI_ODE_RK_BOGACKI_SHAMPINE },
+    { "RK4",              JMI_ODE_RK,    JMI_ODE_RK_RK4 },
+    { "Dormand-Prince",   JMI_ODE_RK,    JMI_ODE_RK_DORMAND_PRINCE }
+};
+
+/* Integrates the pendulums to the final time and returns the CPU time of one integration,
+ * n_rhs_evaluations is left with the number of evaluations of one integration. */
+static double bench_solve(size_t n, const bench_method_t* m, jmi_real_t step_size, jmi_real_t* y_final) {
+    jmi_ode_sizes_t sizes;
+    jmi_ode_callbacks_t ode_callbacks = jmi_ode_problem_default_callbacks();
+    jmi_ode_solver_options_t ode_options = jmi_ode_solver_default_options();
+    jmi_ode_problem_t* ode_problem;
+    jmi_ode_solver_t* ode_solver;
+    jmi_log_t* log;
+    jmi_callbacks_t* cb;
+    jmi_ode_status_t ret = JMI_ODE_OK;
+    clock_t start, stop;
+    int repeats = 0;
+    size_t i;
+
+    cb = jmi_get_default_callbacks();
+    log = jmi_log_init(cb);
+
+    ode_callbacks.rhs_func = bench_rhs;
+    sizes.states = 2 * n;
+    sizes.event_indicators = 0;
+    sizes.algebraics = 0;
+    ode_problem = jmi_new_ode_problem(cb, NULL, ode_callbacks, sizes, log);
+
+    ode_options.method = m->method;
+    ode_options.rk_options.method = m->rk_method;
+    ode_options.euler_options.step_size = step_size;
+
+    /* Repeat short runs to get a measurable time */
+    start = clock();
+    do {
+        jmi_real_t t;
+        n_rhs_evaluations = 0;
+        ode_problem->time = 0.0;
+        for (i = 0; i < sizes.states; i += 2) {
+            ode_problem->states[i] = 1.0;
+            ode_problem->states[i + 1] = 0.0;
+            ode_problem->nominals[i] = 1.0;
+            ode_problem->nominals[i + 1] = 1.0;
+        }
+        ode_solver = jmi_new_ode_solver(ode_problem, ode_options);
+        for (t = BENCH_COM_STEP; ret == JMI_ODE_OK && t < BENCH_FINAL_TIME + 0.5 * BENCH_COM_STEP; t += BENCH_COM_STEP) {
+            ret = jmi_ode_solver_solve(ode_solver, t);
+        }
+        jmi_free_ode_solver(ode_solver);
+        repeats++;
+        stop = clock();
+    } while (ret == JMI_ODE_OK && stop - start < CLOCKS_PER_SEC / 10);
+
+    if (ret != JMI_ODE_OK) {
+        fprintf(stderr, "Solver %s failed for step size %g\n", m->name, step_size);
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < sizes.states; i++) {
+        y_final[i] = ode_problem->states[i];
+    }
+
+    jmi_free_ode_problem(ode_problem);
+    jmi_log_delete(log);
+    free(cb);
+
+    return (double)(stop - start) / CLOCKS_PER_SEC / repeats;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? (size_t)atol(argv[1]) : 20;
+    double error_tol = argc > 2 ? atof(argv[2]) : 1e-2;
+    size_t n_methods = sizeof(bench_methods) / sizeof(bench_methods[0]);
+    jmi_real_t* y_ref = (jmi_real_t*)calloc(2 * n, sizeof(jmi_real_t));
+    jmi_real_t* y = (jmi_real_t*)calloc(2 * n, sizeof(jmi_real_t));
+    double euler_time = -1.0;
+    size_t i, k, j;
+
+    bench_solve(n, &bench_methods[n_methods - 1], 1e-4, y_ref);
+
+    printf("%18s %10s %12s %12s %12s\n", "method", "step", "rhs calls", "time [s]", "max error");
+    for (k = 0; k < n_methods; k++) {
+        const bench_method_t* m = &bench_methods[k];
+        double best_time = -1.0;
+        jmi_real_t h = 0.1;
+
+        for (j = 0; j < BENCH_N_STEP_SIZES; j++, h /= 2.0) {
+            double time = bench_solve(n, m, h, y);
+            double err = 0.0;
+
+            for (i = 0; i < 2 * n; i++) {
+                double e = fabs(y[i] - y_ref[i]);
+                if (e > err || e != e) {
+                    err = e;
+                }
+            }
+            printf("%18s %10.3g %12ld %12.3e %12.3e\n", m->name, h, n_rhs_evaluations, time, err);
+            if (err < error_tol) {
+                best_time = time;
+                break;
+            }
+        }
+
+        if (k == 0) {
+            euler_time = best_time;
+        }
+        if (best_time < 0.0) {
+            printf("%18s does not reach an error of %g for the step sizes tried.\n", m->name, error_tol);
+        } else if (k == 0 || euler_time < 0.0) {
+            printf("%18s reaches an error of %g in %.3e s.\n", m->name, error_tol, best_time);
+        } else {
+            printf("%18s reaches an error of %g in %.3e s, %.1f times faster than Euler.\n",
+                   m->name, error_tol, best_time, euler_time / best_time);
+        }
+    }
+
+    free(y_ref);
+    free(y);
+    return EXIT_SUCCESS;
+}
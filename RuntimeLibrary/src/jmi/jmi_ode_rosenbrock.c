@@ -0,0 +1,343 @@
+/*
+    Copyright (C) 2017 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+#include <math.h>
+
+#include "jmi_ode_solver_impl.h"
+#include "jmi_ode_problem.h"
+#include "jmi_ode_rosenbrock.h"
+#include "jmi_linear_algebra.h"
+#include "jmi_math.h"
+#include "jmi_log.h"
+
+/* Difference quotient approximation of column j of the state Jacobian, f0 is the derivatives at y */
+static int jmi_ode_rosenbrock_jacobian_column_fd(jmi_ode_solver_t* solver, jmi_real_t t, jmi_real_t* y,
+                                                 jmi_real_t* f0, size_t j, jmi_real_t* col) {
+    jmi_ode_rosenbrock_t* integrator = (jmi_ode_rosenbrock_t*)solver->integrator;
+    jmi_ode_problem_t* p = solver->ode_problem;
+    size_t i, n = p->sizes.states;
+    jmi_real_t nominal = p->nominals[j] != 0.0 ? fabs(p->nominals[j]) : 1.0;
+    jmi_real_t delta = sqrt(JMI_EPS) * (fabs(y[j]) > nominal ? fabs(y[j]) : nominal);
+    int flag;
+
+    memcpy(integrator->y_work, y, n * sizeof(jmi_real_t));
+    integrator->y_work[j] += delta;
+    flag = p->ode_callbacks.rhs_func(t, integrator->y_work, col, p->sizes, p->problem_data);
+    for (i = 0; i < n; i++) {
+        col[i] = (col[i] - f0[i]) / delta;
+    }
+    return flag;
+}
+
+/*
+ * Evaluates the state Jacobian into integrator->lu, column by column from the directional
+ * derivatives if the model provides them and otherwise with difference quotients around
+ * the derivatives in integrator->f_work.
+ */
+static int jmi_ode_rosenbrock_jacobian(jmi_ode_solver_t* solver, jmi_real_t t, jmi_real_t* y) {
+    jmi_ode_rosenbrock_t* integrator = (jmi_ode_rosenbrock_t*)solver->integrator;
+    jmi_ode_problem_t* p = solver->ode_problem;
+    size_t i, j, n = p->sizes.states;
+    jmi_real_t* jac = integrator->lu;
+    int flag = 0;
+
+    if (integrator->use_dir_der != 0 && p->ode_callbacks.dir_der_func != NULL) {
+        jmi_real_t jac_norm = 0.0;
+
+        memset(integrator->v_work, 0, n * sizeof(jmi_real_t));
+        for (j = 0; j < n && flag == 0; j++) {
+            integrator->v_work[j] = 1.0;
+            flag = p->ode_callbacks.dir_der_func(t, y, integrator->v_work, jac + j*n, p->sizes, p->problem_data);
+            integrator->v_work[j] = 0.0;
+        }
+        if (integrator->use_dir_der == 1) {
+            return flag;
+        }
+
+        /* First Jacobian, check that the directional derivatives are generated */
+        for (i = 0; flag == 0 && i < n*n; i++) {
+            if (fabs(jac[i]) > jac_norm) {
+                jac_norm = fabs(jac[i]);
+            }
+        }
+        integrator->use_dir_der = (flag == 0 && jac_norm > 0.0);
+        jmi_log_node(p->log, logInfo, "RosenbrockJacobian", "Using <directional_derivatives: %d> for the Jacobian.",
+                     integrator->use_dir_der);
+        if (integrator->use_dir_der == 1) {
+            return 0;
+        }
+    }
+
+    for (j = 0; j < n && flag == 0; j++) {
+        flag = jmi_ode_rosenbrock_jacobian_column_fd(solver, t, y, integrator->f_work, j, jac + j*n);
+    }
+    return flag;
+}
+
+/*
+ * Evaluates the Jacobian and factorizes I - gamma*h*J for the default step size. The time
+ * derivative of the right-hand-side, from explicit time dependence and extrapolated inputs,
+ * is approximated with a difference quotient and kept scaled as gamma*h*df/dt.
+ */
+static int jmi_ode_rosenbrock_update_matrix(jmi_ode_solver_t* solver, jmi_real_t t, jmi_real_t* y) {
+    jmi_ode_rosenbrock_t* integrator = (jmi_ode_rosenbrock_t*)solver->integrator;
+    jmi_ode_problem_t* p = solver->ode_problem;
+    jmi_int_t n = (jmi_int_t)p->sizes.states;
+    jmi_real_t scale = -integrator->gamma * integrator->step_size;
+    jmi_real_t delta_t = sqrt(JMI_EPS) * (fabs(t) > integrator->step_size ? fabs(t) : integrator->step_size);
+    jmi_int_t i, info;
+    int flag;
+
+    flag = p->ode_callbacks.rhs_func(t, y, integrator->f_work, p->sizes, p->problem_data);
+    if (flag == 0) {
+        flag = p->ode_callbacks.rhs_func(t + delta_t, y, integrator->ft, p->sizes, p->problem_data);
+    }
+    for (i = 0; flag == 0 && i < n; i++) {
+        integrator->ft[i] = -scale * (integrator->ft[i] - integrator->f_work[i]) / delta_t;
+    }
+    if (flag == 0) {
+        flag = jmi_ode_rosenbrock_jacobian(solver, t, y);
+    }
+    if (flag != 0) {
+        jmi_log_node(p->log, logError, "RosenbrockSolver", "Could not evaluate the Jacobian at <t: %g>", t);
+        return flag;
+    }
+
+    for (i = 0; i < n*n; i++) {
+        integrator->lu[i] *= scale;
+    }
+    for (i = 0; i < n; i++) {
+        integrator->lu[i*n + i] += 1.0;
+    }
+
+    info = jmi_linear_algebra_LU_factorize(integrator->lu, integrator->pivots, n);
+    if (info != 0) {
+        jmi_log_node(p->log, logError, "RosenbrockSolver", "The iteration matrix is singular at <t: %g>, "
+                     "dgetrf returned <info: %d>", t, info);
+        return -1;
+    }
+
+    integrator->steps_since_update = 0;
+    return 0;
+}
+
+jmi_ode_status_t jmi_ode_rosenbrock_solve(jmi_ode_solver_t* solver, double tend, int initialize) {
+    int flag = 0;
+    jmi_ode_rosenbrock_t* integrator = (jmi_ode_rosenbrock_t*)solver->integrator;
+    jmi_ode_problem_t* problem = solver->ode_problem;
+    jmi_ode_sizes_t sizes = problem->sizes;
+    jmi_int_t n = (jmi_int_t)sizes.states;
+    char step_event = 0; /* boolean step_event = FALSE */
+    char terminate = 0;
+
+    jmi_real_t tcur, tnext;
+    jmi_real_t hcur;
+    jmi_real_t hdef = integrator->step_size;
+
+    jmi_real_t* y = problem->states;
+    jmi_real_t* k1 = integrator->k1;
+    jmi_real_t* k2 = integrator->k2;
+    jmi_real_t* event_indicators = solver->event_indicators;
+    jmi_real_t* event_indicators_previous = solver->event_indicators_previous;
+
+    tcur = problem->time;
+
+    /* The Jacobian may have changed at an event or a re-initialization */
+    if (initialize) {
+        integrator->steps_since_update = -1;
+    }
+
+    /* Get the first event indicators */
+    if (sizes.event_indicators > 0) {
+        flag = problem->ode_callbacks.root_func(tcur, y, event_indicators_previous, sizes, problem->problem_data);
+        if (flag != 0) {
+            jmi_log_node(problem->log, logError, "RosenbrockSolver", "Could not retrieve event indicators");
+            return JMI_ODE_ERROR;
+        }
+    }
+
+    while (tcur < tend) {
+        jmi_int_t i;
+        int zero_crossning_event = 0;
+
+        if (n > 0 && (integrator->steps_since_update < 0 ||
+                      integrator->steps_since_update >= integrator->jacobian_update_interval)) {
+            if (jmi_ode_rosenbrock_update_matrix(solver, tcur, y) != 0) {
+                return JMI_ODE_ERROR;
+            }
+        }
+
+        /* Get derivatives */
+        flag = problem->ode_callbacks.rhs_func(tcur, y, k1, sizes, problem->problem_data);
+        if (flag != 0) {
+            jmi_log_node(problem->log, logError, "RosenbrockSolver", "Could not retrieve time derivatives");
+            return JMI_ODE_ERROR;
+        }
+
+        /* Choose time step, adjust it to get tend exactly */
+        tnext = tcur + hdef;
+        if (tnext > tend - hdef/1e16) {
+            tnext = tend;
+        }
+        hcur = tnext - tcur;
+
+        /*
+         * A shorter last step keeps the factorization for the default step size,
+         * which is a W-method with the Jacobian scaled by hdef/hcur.
+         */
+        for (i = 0; i < n; i++) {
+            k1[i] += integrator->ft[i];
+        }
+        if (n > 0) {
+            jmi_linear_algebra_LU_solve(integrator->lu, integrator->pivots, k1, n);
+        }
+
+        if (integrator->method == JMI_ODE_ROSENBROCK_ROS2) {
+            /* ROS2 of Verwer et al., second order for any approximation of the Jacobian */
+            for (i = 0; i < n; i++) {
+                integrator->y_work[i] = y[i] + hcur*k1[i];
+            }
+            flag = problem->ode_callbacks.rhs_func(tnext, integrator->y_work, k2, sizes, problem->problem_data);
+            if (flag != 0) {
+                jmi_log_node(problem->log, logError, "RosenbrockSolver", "Could not retrieve time derivatives");
+                return JMI_ODE_ERROR;
+            }
+            for (i = 0; i < n; i++) {
+                k2[i] -= 2.0*k1[i] + integrator->ft[i];
+            }
+            if (n > 0) {
+                jmi_linear_algebra_LU_solve(integrator->lu, integrator->pivots, k2, n);
+            }
+            for (i = 0; i < n; i++) {
+                y[i] = y[i] + hcur*(1.5*k1[i] + 0.5*k2[i]);
+            }
+        } else {
+            for (i = 0; i < n; i++) {
+                y[i] = y[i] + hcur*k1[i];
+            }
+        }
+        integrator->steps_since_update++;
+
+        tcur = tnext;
+        problem->time = tnext;
+
+        /* Check if an event indicator has triggered */
+        if (sizes.event_indicators > 0) {
+            flag = problem->ode_callbacks.root_func(tcur, y, event_indicators, sizes, problem->problem_data);
+            if (flag != 0) {
+                jmi_log_node(problem->log, logError, "RosenbrockSolver", "Could not retrieve event indicators");
+                return JMI_ODE_ERROR;
+            }
+        }
+
+        for (i = 0; i < (jmi_int_t)sizes.event_indicators; i++) {
+            if (event_indicators[i]*event_indicators_previous[i] < 0) {
+                zero_crossning_event = 1;
+                break;
+            }
+        }
+        memcpy(event_indicators_previous, event_indicators, sizes.event_indicators * sizeof(jmi_real_t));
+
+        /* After each step call completed integrator step */
+        flag = problem->ode_callbacks.complete_step_func(&step_event, &terminate, problem->problem_data);
+        if (flag != 0) {
+            jmi_log_node(problem->log, logError, "Error", "Failed to complete an integrator step. "
+                     "Returned with <error_flag: %d>", flag);
+            return JMI_ODE_ERROR;
+        }
+
+        /* Handle events */
+        if (zero_crossning_event || step_event == TRUE) {
+            jmi_log_node(problem->log, logInfo, "RosenbrockEvent", "An event was detected at <t:%g>", tcur);
+            return JMI_ODE_EVENT;
+        }
+
+        if (terminate == TRUE) {
+            jmi_log_node(problem->log, logInfo, "Terminate",
+                "Terminating simulation after a signal from the model at <t:%g>", tcur);
+            return JMI_ODE_TERMINATE;
+        }
+    } /* while */
+
+    return JMI_ODE_OK;
+}
+
+int jmi_ode_rosenbrock_new(jmi_ode_rosenbrock_t** integrator_ptr, jmi_ode_solver_t* solver) {
+    jmi_ode_rosenbrock_t* integrator;
+    jmi_ode_problem_t* problem = solver -> ode_problem;
+    size_t n = problem->sizes.states > 0 ? problem->sizes.states : 1;
+
+    *integrator_ptr = NULL;
+    if (solver->rosenbrock_method != JMI_ODE_ROSENBROCK_EULER &&
+        solver->rosenbrock_method != JMI_ODE_ROSENBROCK_ROS2) {
+        jmi_log_node(problem->log, logError, "RosenbrockSolver", "Unknown linearly implicit <method: %d>",
+                     solver->rosenbrock_method);
+        return -1;
+    }
+
+    integrator = (jmi_ode_rosenbrock_t*)calloc(1, sizeof(jmi_ode_rosenbrock_t));
+    if (!integrator) {
+        jmi_log_node(problem->log, logError, "RosenbrockSolver", "Failed to allocate the internal struct.");
+        return -1;
+    }
+    *integrator_ptr = integrator;
+
+    integrator->method = solver->rosenbrock_method;
+    integrator->step_size = solver->step_size;
+    integrator->gamma = integrator->method == JMI_ODE_ROSENBROCK_ROS2 ? 1.0 + 1.0/sqrt(2.0) : 1.0;
+    integrator->jacobian_update_interval = solver->jacobian_update_interval > 0 ? solver->jacobian_update_interval : 1;
+    integrator->steps_since_update = -1;
+    integrator->use_dir_der = -1;
+
+    integrator->lu     = (jmi_real_t*)calloc(n*n, sizeof(jmi_real_t));
+    integrator->pivots = (jmi_int_t*)calloc(n, sizeof(jmi_int_t));
+    integrator->k1     = (jmi_real_t*)calloc(n, sizeof(jmi_real_t));
+    integrator->k2     = (jmi_real_t*)calloc(n, sizeof(jmi_real_t));
+    integrator->y_work = (jmi_real_t*)calloc(n, sizeof(jmi_real_t));
+    integrator->f_work = (jmi_real_t*)calloc(n, sizeof(jmi_real_t));
+    integrator->v_work = (jmi_real_t*)calloc(n, sizeof(jmi_real_t));
+    integrator->ft     = (jmi_real_t*)calloc(n, sizeof(jmi_real_t));
+    if (!integrator->ft || !integrator->lu || !integrator->pivots || !integrator->k1 || !integrator->k2 ||
+        !integrator->y_work || !integrator->f_work || !integrator->v_work) {
+        jmi_log_node(problem->log, logError, "RosenbrockSolver", "Failed to allocate the work vectors.");
+        return -1;
+    }
+
+    jmi_log_node(problem->log, logInfo, "RosenbrockSolver",
+                 "Using the linearly implicit <method: %s> with a Jacobian update every <steps: %d> steps",
+                 integrator->method == JMI_ODE_ROSENBROCK_ROS2 ? "ROS2" : "Euler", integrator->jacobian_update_interval);
+
+    return 0;
+}
+
+void jmi_ode_rosenbrock_delete(jmi_ode_solver_t* solver) {
+    jmi_ode_rosenbrock_t* integrator = (jmi_ode_rosenbrock_t*)solver->integrator;
+
+    if (integrator) {
+        free(integrator->lu);
+        free(integrator->pivots);
+        free(integrator->k1);
+        free(integrator->k2);
+        free(integrator->y_work);
+        free(integrator->f_work);
+        free(integrator->v_work);
+        free(integrator->ft);
+        free(integrator);
+    }
+}
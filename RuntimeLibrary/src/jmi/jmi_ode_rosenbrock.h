@@ -0,0 +1,63 @@
+ /*
+    Copyright (C) 2017 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+
+/** \file jmi_ode_rosenbrock.h
+ *  \brief Structures and functions for handling fixed step linearly implicit ODE solvers.
+ *
+ *  The methods are W-methods, they keep their order with an approximate
+ *  Jacobian. The LU factorization of I - gamma*h*J is therefore reused for a
+ *  fixed number of steps, which bounds the work of every communication step
+ *  to a known number of right-hand-side evaluations, back substitutions and
+ *  Jacobian updates.
+ */
+
+#ifndef _JMI_ODE_ROSENBROCK_H
+#define _JMI_ODE_ROSENBROCK_H
+
+#include <string.h>
+#include "jmi_ode_solver.h"
+
+typedef struct jmi_ode_rosenbrock_t jmi_ode_rosenbrock_t;
+
+int jmi_ode_rosenbrock_new(jmi_ode_rosenbrock_t** integrator_ptr, jmi_ode_solver_t* solver);
+
+jmi_ode_status_t jmi_ode_rosenbrock_solve(jmi_ode_solver_t* solver, double time_final, int initialize);
+
+void jmi_ode_rosenbrock_delete(jmi_ode_solver_t* solver);
+
+struct jmi_ode_rosenbrock_t {
+    jmi_ode_rosenbrock_method_t method;
+    jmi_real_t step_size;
+    jmi_real_t gamma;               /* Diagonal coefficient of the method */
+    int jacobian_update_interval;   /* Number of steps between Jacobian updates */
+    int steps_since_update;         /* Steps taken with the current factorization, -1 if there is none */
+    int use_dir_der;                /* 1 if the directional derivatives give the Jacobian, 0 if not, -1 if not yet known */
+
+    jmi_real_t* lu;                 /* LU factorization of I - gamma*h*J, column major */
+    jmi_int_t* pivots;
+    jmi_real_t* k1;
+    jmi_real_t* k2;
+    jmi_real_t* y_work;
+    jmi_real_t* f_work;
+    jmi_real_t* v_work;
+    jmi_real_t* ft;                 /* Time derivative of the right-hand-side, scaled by gamma*h */
+};
+
+#endif
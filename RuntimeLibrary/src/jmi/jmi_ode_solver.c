@@ -21,6 +21,9 @@
 #include "jmi_ode_problem.h"
 #include "jmi_ode_euler.h"
 #include "jmi_ode_cvode.h"
+#include "jmi_ode_ida.h"
+#include "jmi_ode_rk.h"
+#include "jmi_ode_rosenbrock.h"
 #include "jmi_math.h"
 
 jmi_ode_solver_options_t jmi_ode_solver_default_options(void) {
@@ -29,7 +32,13 @@ jmi_ode_solver_options_t jmi_ode_solver_default_options(void) {
     options.experimental_mode = jmi_cs_experimental_none;
     options.method = JMI_ODE_CVODE;
     options.cvode_options.rel_tol = 1e-6;
+    options.cvode_options.linear_solver = JMI_ODE_CVODE_DENSE;
+    options.cvode_options.precond_block_size = 10;
+    options.cvode_options.num_threads = 1;
     options.euler_options.step_size = 0.001;
+    options.rk_options.method = JMI_ODE_RK_RK4;
+    options.rosenbrock_options.method = JMI_ODE_ROSENBROCK_ROS2;
+    options.rosenbrock_options.jacobian_update_interval = 10;
     
     return options;
 }
@@ -58,6 +67,12 @@ jmi_ode_solver_t* jmi_new_ode_solver(jmi_ode_problem_t* problem, jmi_ode_solver_
     solver->experimental_mode = solver_options.experimental_mode;
     solver->step_size =solver_options.euler_options.step_size;
     solver->rel_tol = solver_options.cvode_options.rel_tol;
+    solver->linear_solver = solver_options.cvode_options.linear_solver;
+    solver->precond_block_size = solver_options.cvode_options.precond_block_size;
+    solver->num_threads = solver_options.cvode_options.num_threads;
+    solver->rk_method = solver_options.rk_options.method;
+    solver->rosenbrock_method = solver_options.rosenbrock_options.method;
+    solver->jacobian_update_interval = solver_options.rosenbrock_options.jacobian_update_interval;
     
     switch(solver_options.method) {
     case JMI_ODE_CVODE: {
@@ -76,6 +91,30 @@ jmi_ode_solver_t* jmi_new_ode_solver(jmi_ode_problem_t* problem, jmi_ode_solver_
         solver->delete_solver = jmi_ode_euler_delete;
     }
         break;
+    case JMI_ODE_IDA: {
+        jmi_ode_ida_t* integrator;
+        flag = jmi_ode_ida_new(&integrator, solver);
+        solver->integrator = integrator;
+        solver->solve = jmi_ode_ida_solve;
+        solver->delete_solver = jmi_ode_ida_delete;
+    }
+        break;
+    case JMI_ODE_RK: {
+        jmi_ode_rk_t* integrator;
+        flag = jmi_ode_rk_new(&integrator, solver);
+        solver->integrator = integrator;
+        solver->solve = jmi_ode_rk_solve;
+        solver->delete_solver = jmi_ode_rk_delete;
+    }
+        break;
+    case JMI_ODE_ROSENBROCK: {
+        jmi_ode_rosenbrock_t* integrator;
+        flag = jmi_ode_rosenbrock_new(&integrator, solver);
+        solver->integrator = integrator;
+        solver->solve = jmi_ode_rosenbrock_solve;
+        solver->delete_solver = jmi_ode_rosenbrock_delete;
+    }
+        break;
 
     default:
         flag = -1;
@@ -38,12 +38,25 @@ typedef enum {
 /** \brief Integrator methods the solver can use */
 typedef enum {
     JMI_ODE_CVODE,
-    JMI_ODE_EULER
+    JMI_ODE_EULER,
+    JMI_ODE_IDA,
+    JMI_ODE_RK,
+    JMI_ODE_ROSENBROCK
 } jmi_ode_method_t;
 
+/** \brief Linear solvers the cvode integrator can use */
+typedef enum {
+    JMI_ODE_CVODE_DENSE,
+    JMI_ODE_CVODE_SPGMR,
+    JMI_ODE_CVODE_SPBCG
+} jmi_ode_cvode_linear_solver_t;
+
 /** \brief Solver options specific for the cvode integrator */
 typedef struct {
     jmi_real_t rel_tol;
+    jmi_ode_cvode_linear_solver_t linear_solver;
+    int precond_block_size;     /**< \brief Size of the diagonal blocks in the preconditioner of the Krylov solvers */
+    int num_threads;            /**< \brief Number of threads used in the vector operations, 1 gives serial vectors */
 } jmi_ode_cvode_options_t;
 
 /** \brief Solver options specific for the euler integrator */
@@ -51,6 +64,31 @@ typedef struct {
     jmi_real_t step_size;
 } jmi_ode_euler_options_t;
 
+/** \brief Methods of the explicit Runge-Kutta integrator */
+typedef enum {
+    JMI_ODE_RK_HEUN,
+    JMI_ODE_RK_RK4,
+    JMI_ODE_RK_BOGACKI_SHAMPINE,
+    JMI_ODE_RK_DORMAND_PRINCE
+} jmi_ode_rk_method_t;
+
+/** \brief Solver options specific for the explicit Runge-Kutta integrator, the step size is taken from the euler options */
+typedef struct {
+    jmi_ode_rk_method_t method;
+} jmi_ode_rk_options_t;
+
+/** \brief Methods of the linearly implicit integrator */
+typedef enum {
+    JMI_ODE_ROSENBROCK_EULER,
+    JMI_ODE_ROSENBROCK_ROS2
+} jmi_ode_rosenbrock_method_t;
+
+/** \brief Solver options specific for the linearly implicit integrator, the step size is taken from the euler options */
+typedef struct {
+    jmi_ode_rosenbrock_method_t method;
+    int jacobian_update_interval;   /**< \brief Number of steps between updates of the Jacobian and its factorization */
+} jmi_ode_rosenbrock_options_t;
+
 /** \brief Experimental features in the solver */
 typedef enum {
     jmi_cs_experimental_none = 0,
@@ -62,6 +100,8 @@ typedef struct {
     jmi_ode_method_t method;
     jmi_ode_cvode_options_t cvode_options;
     jmi_ode_euler_options_t euler_options;
+    jmi_ode_rk_options_t rk_options;
+    jmi_ode_rosenbrock_options_t rosenbrock_options;
     
     jmi_cs_experimental_mode_t experimental_mode;
 } jmi_ode_solver_options_t;
@@ -49,6 +49,12 @@ struct jmi_ode_solver_t {
     void *integrator;
     jmi_real_t step_size;
     jmi_real_t rel_tol;
+    jmi_ode_cvode_linear_solver_t linear_solver;
+    int precond_block_size;
+    int num_threads;
+    jmi_ode_rk_method_t rk_method;
+    jmi_ode_rosenbrock_method_t rosenbrock_method;
+    int jacobian_update_interval;
     jmi_cs_experimental_mode_t experimental_mode;
     jmi_ode_solve_func_t solve;
     jmi_ode_delete_func_t delete_solver;
@@ -23,6 +23,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <math.h>
 
 #include "jmi_ode_problem.h"
 #include "jmi_ode_solver.h"
@@ -74,6 +75,221 @@ int simple_rhs(jmi_real_t t, jmi_real_t* y, jmi_real_t* rhs, jmi_ode_sizes_t siz
     return 0;
 }
 
+/* The same ODE written as y' = k*w, 0 = y - w, with w as algebraic unknown */
+int simple_dae_res(jmi_real_t t, jmi_real_t* y, jmi_real_t* yp, jmi_real_t* res, jmi_ode_sizes_t sizes, void* problme_data) {
+    assert_true(sizes.states == 1 && sizes.algebraics == 1, "assuming 1 state and 1 algebraic");
+    
+    res[0] = k * y[1] - yp[0];
+    res[1] = y[0] - y[1];
+    return 0;
+}
+
+int simple_dae_alg(jmi_real_t* w, jmi_real_t* nominals, jmi_ode_sizes_t sizes, void* problme_data) {
+    w[0] = 0.0; /* Deliberately inconsistent, should be corrected by the integrator */
+    nominals[0] = 1.0;
+    return 0;
+}
+
+/* Event indicator of simple_rhs, changes sign at t = log(2)/5 */
+int simple_root(jmi_real_t t, jmi_real_t* y, jmi_real_t* root, jmi_ode_sizes_t sizes, void* problme_data) {
+    root[0] = y[0] - 0.5;
+    return 0;
+}
+
+jmi_real_t first_event_time = -1.0;
+
+jmi_ode_status_t simple_event_update(jmi_ode_problem_t* problem) {
+    if (first_event_time < 0.0) {
+        first_event_time = problem->time;
+    }
+    return JMI_ODE_OK;
+}
+
+/* A stiff problem, y' = -1000*(y - cos(t)), explicit Euler is unstable for step sizes above 0.002 */
+int stiff_rhs(jmi_real_t t, jmi_real_t* y, jmi_real_t* rhs, jmi_ode_sizes_t sizes, void* problme_data) {
+    rhs[0] = -1000.0 * (y[0] - cos(t));
+    return 0;
+}
+
+#define CHAIN_N 12
+
+/* A chain of coupled states, y_i' = -(i+1)*y_i + y_(i-1) */
+int chain_rhs(jmi_real_t t, jmi_real_t* y, jmi_real_t* rhs, jmi_ode_sizes_t sizes, void* problme_data) {
+    size_t i;
+    for (i = 0; i < sizes.states; i++) {
+        rhs[i] = -(i + 1.0) * y[i] + (i > 0 ? y[i - 1] : 0.0);
+    }
+    return 0;
+}
+
+/* Scale of the directional derivatives, a scale other than one gives wrong products */
+static jmi_real_t chain_dir_der_scale = 1.0;
+static int chain_dir_der_calls = 0;
+
+int chain_dir_der(jmi_real_t t, jmi_real_t* y, jmi_real_t* v, jmi_real_t* jv, jmi_ode_sizes_t sizes, void* problme_data) {
+    size_t i;
+    chain_dir_der_calls++;
+    chain_rhs(t, v, jv, sizes, problme_data);
+    for (i = 0; i < sizes.states; i++) {
+        jv[i] *= chain_dir_der_scale;
+    }
+    return 0;
+}
+
+static void solve_chain(jmi_ode_cvode_linear_solver_t linear_solver, int use_dir_der, int num_threads, jmi_real_t* y_final) {
+    jmi_ode_sizes_t sizes;
+    jmi_ode_callbacks_t ode_callbacks = jmi_ode_problem_default_callbacks();
+    jmi_ode_solver_options_t ode_options = jmi_ode_solver_default_options();
+    jmi_ode_problem_t* ode_problem;
+    jmi_ode_solver_t* ode_solver;
+    jmi_log_t* log;
+    jmi_callbacks_t* cb;
+    jmi_ode_status_t ret;
+    size_t i;
+    
+    cb = jmi_get_default_callbacks();
+    cb->log_options.log_level = 3;
+    log = jmi_log_init(cb);
+    
+    ode_callbacks.rhs_func = chain_rhs;
+    if (use_dir_der) {
+        ode_callbacks.dir_der_func = chain_dir_der;
+    }
+    sizes.states = CHAIN_N;
+    sizes.event_indicators = 0;
+    sizes.algebraics = 0;
+    ode_problem = jmi_new_ode_problem(cb, NULL, ode_callbacks, sizes, log);
+    ode_problem->time = 0.0;
+    for (i = 0; i < CHAIN_N; i++) {
+        ode_problem->states[i] = 1.0;
+        ode_problem->nominals[i] = 1.0;
+    }
+    
+    ode_options.cvode_options.linear_solver = linear_solver;
+    ode_options.cvode_options.precond_block_size = 5;
+    ode_options.cvode_options.num_threads = num_threads;
+    ode_solver = jmi_new_ode_solver(ode_problem, ode_options);
+    assert_true(ode_solver != NULL, "failed to create the solver");
+    ret = jmi_ode_solver_solve(ode_solver, 1.0);
+    assert_true(ret == JMI_ODE_OK, "solver expected to return ok");
+    for (i = 0; i < CHAIN_N; i++) {
+        y_final[i] = ode_problem->states[i];
+    }
+    
+    jmi_free_ode_solver(ode_solver);
+    jmi_free_ode_problem(ode_problem);
+    jmi_log_delete(log);
+    jmi_free_default_callbacks(cb);
+}
+
+static void test_ode_solver_krylov() {
+    jmi_real_t y_dense[CHAIN_N], y_spgmr[CHAIN_N], y_spbcg[CHAIN_N];
+    size_t i;
+    
+    solve_chain(JMI_ODE_CVODE_DENSE, 0, 1, y_dense);
+    solve_chain(JMI_ODE_CVODE_SPGMR, 0, 1, y_spgmr);
+    chain_dir_der_calls = 0;
+    solve_chain(JMI_ODE_CVODE_SPBCG, 1, 1, y_spbcg);
+    assert_true(chain_dir_der_calls > 1, "Directional derivatives expected to be used");
+    
+    for (i = 0; i < CHAIN_N; i++) {
+        assert_true(ABS_MACRO(y_spgmr[i] - y_dense[i]) < 1e-4, "SPGMR solution differs from the dense solution");
+        assert_true(ABS_MACRO(y_spbcg[i] - y_dense[i]) < 1e-4, "SPBCG solution differs from the dense solution");
+    }
+    
+    /* Products off by a few percent are rejected by the check against the difference quotient */
+    chain_dir_der_scale = 1.05;
+    chain_dir_der_calls = 0;
+    solve_chain(JMI_ODE_CVODE_SPGMR, 1, 1, y_spgmr);
+    chain_dir_der_scale = 1.0;
+    assert_true(chain_dir_der_calls == 1, "Wrong directional derivatives expected to be rejected");
+    for (i = 0; i < CHAIN_N; i++) {
+        assert_true(ABS_MACRO(y_spgmr[i] - y_dense[i]) < 1e-4, "SPGMR solution differs from the dense solution");
+    }
+}
+
+static void test_ode_solver_threaded_vectors() {
+    jmi_real_t y_serial[CHAIN_N], y_dense[CHAIN_N], y_spgmr[CHAIN_N];
+    size_t i;
+    
+    solve_chain(JMI_ODE_CVODE_DENSE, 0, 1, y_serial);
+    solve_chain(JMI_ODE_CVODE_DENSE, 0, 3, y_dense);
+    solve_chain(JMI_ODE_CVODE_SPGMR, 1, 3, y_spgmr);
+    
+    for (i = 0; i < CHAIN_N; i++) {
+        assert_true(ABS_MACRO(y_dense[i] - y_serial[i]) < 1e-10, "Threaded solution differs from the serial solution");
+        assert_true(ABS_MACRO(y_spgmr[i] - y_serial[i]) < 1e-4, "Threaded SPGMR solution differs from the serial solution");
+    }
+}
+
+static void solve_rosenbrock(jmi_ode_callbacks_t ode_callbacks, size_t n, jmi_ode_rosenbrock_method_t method,
+                             jmi_real_t step_size, int jacobian_update_interval, jmi_real_t* y_final) {
+    jmi_ode_sizes_t sizes;
+    jmi_ode_solver_options_t ode_options = jmi_ode_solver_default_options();
+    jmi_ode_problem_t* ode_problem;
+    jmi_ode_solver_t* ode_solver;
+    jmi_log_t* log;
+    jmi_callbacks_t* cb;
+    jmi_ode_status_t ret;
+    size_t i;
+    
+    cb = jmi_get_default_callbacks();
+    cb->log_options.log_level = 3;
+    log = jmi_log_init(cb);
+    
+    sizes.states = n;
+    sizes.event_indicators = 0;
+    sizes.algebraics = 0;
+    ode_problem = jmi_new_ode_problem(cb, NULL, ode_callbacks, sizes, log);
+    ode_problem->time = 0.0;
+    for (i = 0; i < n; i++) {
+        ode_problem->states[i] = 1.0;
+        ode_problem->nominals[i] = 1.0;
+    }
+    
+    ode_options.method = JMI_ODE_ROSENBROCK;
+    ode_options.rosenbrock_options.method = method;
+    ode_options.rosenbrock_options.jacobian_update_interval = jacobian_update_interval;
+    ode_options.euler_options.step_size = step_size;
+    ode_solver = jmi_new_ode_solver(ode_problem, ode_options);
+    assert_true(ode_solver != NULL, "failed to create the linearly implicit solver");
+    ret = jmi_ode_solver_solve(ode_solver, 1.0);
+    assert_true(ret == JMI_ODE_OK, "solver expected to return ok");
+    for (i = 0; i < n; i++) {
+        y_final[i] = ode_problem->states[i];
+    }
+    
+    jmi_free_ode_solver(ode_solver);
+    jmi_free_ode_problem(ode_problem);
+    jmi_log_delete(log);
+    jmi_free_default_callbacks(cb);
+}
+
+static void test_ode_solver_rosenbrock() {
+    jmi_ode_callbacks_t ode_callbacks = jmi_ode_problem_default_callbacks();
+    jmi_real_t y_stiff = (1e6*cos(1.0) + 1e3*sin(1.0)) / (1e6 + 1.0);
+    jmi_real_t y[CHAIN_N], y_stale[CHAIN_N], y_dense[CHAIN_N];
+    size_t i;
+    
+    /* Stiff problem with difference quotient Jacobians and a step size where explicit methods are unstable */
+    ode_callbacks.rhs_func = stiff_rhs;
+    solve_rosenbrock(ode_callbacks, 1, JMI_ODE_ROSENBROCK_EULER, 0.01, 10, y);
+    assert_true(ABS_MACRO(y[0] - y_stiff) < 1e-3, "linearly implicit Euler did not return correct value");
+    solve_rosenbrock(ode_callbacks, 1, JMI_ODE_ROSENBROCK_ROS2, 0.01, 10, y);
+    assert_true(ABS_MACRO(y[0] - y_stiff) < 1e-3, "ROS2 did not return correct value");
+    
+    /* Jacobian from the directional derivatives, updated every step or reused for the whole interval */
+    ode_callbacks.rhs_func = chain_rhs;
+    ode_callbacks.dir_der_func = chain_dir_der;
+    solve_chain(JMI_ODE_CVODE_DENSE, 0, 1, y_dense);
+    solve_rosenbrock(ode_callbacks, CHAIN_N, JMI_ODE_ROSENBROCK_ROS2, 0.001, 1, y);
+    solve_rosenbrock(ode_callbacks, CHAIN_N, JMI_ODE_ROSENBROCK_ROS2, 0.001, 1000, y_stale);
+    for (i = 0; i < CHAIN_N; i++) {
+        assert_true(ABS_MACRO(y[i] - y_dense[i]) < 1e-4, "ROS2 solution differs from the CVode solution");
+        assert_true(ABS_MACRO(y_stale[i] - y_dense[i]) < 1e-4, "ROS2 solution with a reused Jacobian differs from the CVode solution");
+    }
+}
+
 static void test_ode_solver_basic() {
     jmi_ode_sizes_t sizes;
     jmi_ode_callbacks_t ode_callbacks = jmi_ode_problem_default_callbacks();
@@ -92,6 +308,7 @@ static void test_ode_solver_basic() {
     ode_callbacks.rhs_func = simple_rhs;
     sizes.states = 1;
     sizes.event_indicators = 0;
+    sizes.algebraics = 0;
     ode_problem = jmi_new_ode_problem(cb, NULL, ode_callbacks, sizes, log);
     /* Setup initial conditons and nominals */
     ode_problem->time = 0.0;         /* t_0 := 0.0 */
@@ -113,8 +330,108 @@ static void test_ode_solver_basic() {
     jmi_free_default_callbacks(cb);
 }
 
+static void test_ode_solver_ida() {
+    jmi_ode_sizes_t sizes;
+    jmi_ode_callbacks_t ode_callbacks = jmi_ode_problem_default_callbacks();
+    jmi_ode_solver_options_t ode_options = jmi_ode_solver_default_options();
+    jmi_ode_problem_t* ode_problem;
+    jmi_ode_solver_t* ode_solver;
+    jmi_log_t* log;
+    jmi_callbacks_t* cb;
+    jmi_ode_status_t ret;
+    
+    /* Setup callbacks and log */
+    cb = jmi_get_default_callbacks();
+    log = jmi_log_init(cb);
+    
+    /* Setup dae problem */
+    ode_callbacks.rhs_func = simple_rhs;
+    ode_callbacks.dae_res_func = simple_dae_res;
+    ode_callbacks.dae_alg_func = simple_dae_alg;
+    sizes.states = 1;
+    sizes.event_indicators = 0;
+    sizes.algebraics = 1;
+    ode_problem = jmi_new_ode_problem(cb, NULL, ode_callbacks, sizes, log);
+    ode_problem->time = 0.0;
+    ode_problem->states[0] = 1.0;
+    ode_problem->nominals[0] = 1.0;
+    
+    /* Setup solver and solve dae */
+    ode_options.method = JMI_ODE_IDA;
+    ode_solver = jmi_new_ode_solver(ode_problem, ode_options);
+    assert_true(ode_solver != NULL, "failed to create the IDA solver");
+    ret = jmi_ode_solver_solve(ode_solver, 1.0);
+    assert_true(ret == JMI_ODE_OK, "solver expected to return ok");
+    assert_true(ABS_MACRO(ode_problem->states[0] - 0.006737946999085) < 1e-4,
+        "solver did not return correct value");
+    
+    /* Cleanup */
+    jmi_free_ode_solver(ode_solver);
+    jmi_free_ode_problem(ode_problem);
+    jmi_log_delete(log);
+    jmi_free_default_callbacks(cb);
+}
+
+static void test_ode_solver_rk() {
+    jmi_ode_rk_method_t methods[] = { JMI_ODE_RK_HEUN, JMI_ODE_RK_RK4, JMI_ODE_RK_BOGACKI_SHAMPINE, JMI_ODE_RK_DORMAND_PRINCE };
+    jmi_real_t tols[] = { 1e-3, 1e-8, 1e-6, 1e-10 };
+    jmi_real_t event_tols[] = { 1e-4, 1e-7, 1e-5, 1e-8 };
+    jmi_ode_sizes_t sizes;
+    jmi_ode_callbacks_t ode_callbacks = jmi_ode_problem_default_callbacks();
+    jmi_ode_solver_options_t ode_options = jmi_ode_solver_default_options();
+    jmi_ode_problem_t* ode_problem;
+    jmi_ode_solver_t* ode_solver;
+    jmi_log_t* log;
+    jmi_callbacks_t* cb;
+    jmi_ode_status_t ret;
+    int i;
+    
+    cb = jmi_get_default_callbacks();
+    cb->log_options.log_level = 3;
+    log = jmi_log_init(cb);
+    
+    ode_callbacks.rhs_func = simple_rhs;
+    ode_callbacks.root_func = simple_root;
+    ode_callbacks.event_update_func = simple_event_update;
+    sizes.states = 1;
+    sizes.event_indicators = 1;
+    sizes.algebraics = 0;
+    
+    for (i = 0; i < 4; i++) {
+        ode_problem = jmi_new_ode_problem(cb, NULL, ode_callbacks, sizes, log);
+        ode_problem->time = 0.0;
+        ode_problem->states[0] = 1.0;
+        ode_problem->nominals[0] = 1.0;
+        first_event_time = -1.0;
+        
+        ode_options.method = JMI_ODE_RK;
+        ode_options.rk_options.method = methods[i];
+        ode_options.euler_options.step_size = 0.01;
+        ode_solver = jmi_new_ode_solver(ode_problem, ode_options);
+        assert_true(ode_solver != NULL, "failed to create the Runge-Kutta solver");
+        ret = jmi_ode_solver_solve(ode_solver, 1.0);
+        assert_true(ret == JMI_ODE_OK, "solver expected to return ok");
+        assert_true(ABS_MACRO(ode_problem->states[0] - 0.006737946999085) < tols[i],
+            "solver did not return correct value");
+        /* The event is located within the step, not at its end */
+        assert_true(ABS_MACRO(first_event_time - 0.138629436111989) < event_tols[i],
+            "solver did not locate the event");
+        
+        jmi_free_ode_solver(ode_solver);
+        jmi_free_ode_problem(ode_problem);
+    }
+    
+    jmi_log_delete(log);
+    jmi_free_default_callbacks(cb);
+}
+
 main() {
     test_ode_solver_basic();
+    test_ode_solver_ida();
+    test_ode_solver_krylov();
+    test_ode_solver_threaded_vectors();
+    test_ode_solver_rk();
+    test_ode_solver_rosenbrock();
 
     return EXIT_SUCCESS;
 }
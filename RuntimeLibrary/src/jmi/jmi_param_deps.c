@@ -0,0 +1,116 @@
+/*
+    Copyright (C) 2018 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+#include <string.h>
+
+#include "jmi.h"
+#include "jmi_param_deps.h"
+
+void jmi_param_deps_init(jmi_t* jmi, jmi_int_t n_elems,
+                         const jmi_int_t* read_offs,  const jmi_int_t* read,
+                         const jmi_int_t* write_offs, const jmi_int_t* write) {
+    jmi_param_deps_t* deps = (jmi_param_deps_t*)calloc(1, sizeof(jmi_param_deps_t));
+
+    deps->n_elems    = n_elems;
+    deps->read_offs  = read_offs;
+    deps->read       = read;
+    deps->write_offs = write_offs;
+    deps->write      = write;
+    deps->changed    = (char*)calloc(jmi->n_z, sizeof(char));
+    deps->invalid    = 1;
+
+    jmi_param_deps_delete(jmi->param_deps);
+    jmi->param_deps = deps;
+}
+
+void jmi_param_deps_delete(jmi_param_deps_t* deps) {
+    if (deps == NULL) {
+        return;
+    }
+    free(deps->changed);
+    free(deps);
+}
+
+void jmi_param_deps_invalidate(jmi_t* jmi) {
+    if (jmi->param_deps != NULL) {
+        jmi->param_deps->invalid = 1;
+    }
+}
+
+void jmi_param_deps_mark_changed(jmi_t* jmi, jmi_int_t index) {
+    if (jmi->param_deps != NULL) {
+        jmi->param_deps->changed[index] = 1;
+    }
+}
+
+int jmi_param_deps_begin(jmi_t* jmi) {
+    jmi_param_deps_t* deps = jmi->param_deps;
+
+    if (deps == NULL) {
+        return 0;
+    }
+    deps->n_evaluated = 0;
+    deps->incremental = !deps->invalid;
+    return deps->incremental;
+}
+
+void jmi_param_deps_end(jmi_t* jmi, int status) {
+    jmi_param_deps_t* deps = jmi->param_deps;
+
+    if (deps == NULL) {
+        return;
+    }
+    deps->incremental = 0;
+    if (status == 0) {
+        memset(deps->changed, 0, jmi->n_z * sizeof(char));
+        deps->invalid = 0;
+    } else {
+        deps->invalid = 1;
+    }
+}
+
+int jmi_param_eval(jmi_t* jmi, jmi_int_t elem) {
+    jmi_param_deps_t* deps = jmi->param_deps;
+    char* changed;
+    int i;
+
+    if (deps == NULL) {
+        return 1;
+    }
+
+    if (deps->incremental) {
+        changed = deps->changed;
+        for (i = deps->read_offs[elem]; i < deps->read_offs[elem + 1]; i++) {
+            if (deps->read[i] < 0 || changed[deps->read[i]]) {
+                break;
+            }
+        }
+        if (i == deps->read_offs[elem + 1]) {
+            return 0;
+        }
+
+        /* Everything computed by the element may change */
+        for (i = deps->write_offs[elem]; i < deps->write_offs[elem + 1]; i++) {
+            changed[deps->write[i]] = 1;
+        }
+    }
+
+    deps->n_evaluated++;
+    return 1;
+}
@@ -0,0 +1,96 @@
+/*
+    Copyright (C) 2018 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3 as published
+    by the Free Software Foundation, or optionally, under the terms of the
+    Common Public License version 1.0 as published by IBM.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License, or the Common Public License, for more details.
+
+    You should have received copies of the GNU General Public License
+    and the Common Public License along with this program.  If not,
+    see <http://www.gnu.org/licenses/> or
+    <http://www.ibm.com/developerworks/library/os-cpl.html/> respectively.
+*/
+
+
+/** \file jmi_param_deps.h
+ *  \brief Dependency information for the evaluation of dependent parameters.
+ *
+ *  The information is generated by the compiler when the option
+ *  incremental_parameter_evaluation is set. It is used to evaluate only
+ *  the parameter equations and dependent start values that depend on
+ *  values set since the last evaluation.
+ */
+
+#ifndef _JMI_PARAM_DEPS_H
+#define _JMI_PARAM_DEPS_H
+
+#include "jmi_types.h"
+
+struct jmi_param_deps_t {
+    jmi_int_t n_elems;           /**< \brief Number of parameter equations and dependent start values. */
+    const jmi_int_t* read_offs;  /**< \brief Start of the entries of each element in read, n_elems + 1 entries. */
+    const jmi_int_t* read;       /**< \brief Indices in z read by the elements, -1 means that the element always is evaluated. */
+    const jmi_int_t* write_offs; /**< \brief Start of the entries of each element in write, n_elems + 1 entries. */
+    const jmi_int_t* write;      /**< \brief Indices in z computed by the elements. */
+
+    char* changed;               /**< \brief Flags for the indices in z that have changed since the last evaluation, n_z entries. */
+    jmi_int_t incremental;       /**< \brief Flag indicating that only affected elements are evaluated. */
+    jmi_int_t invalid;           /**< \brief Flag indicating that the next evaluation must be complete. */
+    jmi_int_t n_evaluated;       /**< \brief Number of elements evaluated in the last evaluation. */
+};
+
+/**
+ * \brief Register the dependencies of the dependent parameters, called from the generated code.
+ *
+ * The arrays are not copied and must remain valid during the lifetime of jmi.
+ */
+void jmi_param_deps_init(jmi_t* jmi, jmi_int_t n_elems,
+                         const jmi_int_t* read_offs,  const jmi_int_t* read,
+                         const jmi_int_t* write_offs, const jmi_int_t* write);
+
+/**
+ * \brief Delete the dependencies of the dependent parameters.
+ */
+void jmi_param_deps_delete(jmi_param_deps_t* deps);
+
+/**
+ * \brief Make the next evaluation of the dependent parameters complete.
+ */
+void jmi_param_deps_invalidate(jmi_t* jmi);
+
+/**
+ * \brief Record that the value at an index in z has been set.
+ */
+void jmi_param_deps_mark_changed(jmi_t* jmi, jmi_int_t index);
+
+/**
+ * \brief Prepare an evaluation of the dependent parameters.
+ *
+ * Returns non-zero if the evaluation will be incremental.
+ */
+int jmi_param_deps_begin(jmi_t* jmi);
+
+/**
+ * \brief End an evaluation of the dependent parameters with the given status.
+ *
+ * After a successful evaluation only later changes are tracked, after a
+ * failed evaluation the next evaluation is complete.
+ */
+void jmi_param_deps_end(jmi_t* jmi, int status);
+
+/**
+ * \brief Check if a parameter equation or dependent start value needs to be evaluated, called from the generated code.
+ *
+ * During an incremental evaluation an element is evaluated if it reads a
+ * changed value. The values computed by the element are then marked as
+ * changed.
+ */
+int jmi_param_eval(jmi_t* jmi, jmi_int_t elem);
+
+#endif /* _JMI_PARAM_DEPS_H */
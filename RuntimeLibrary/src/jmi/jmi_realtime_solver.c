@@ -62,6 +62,7 @@ void jmi_realtime_solver_delete(jmi_block_solver_t *block) {
     jmi_realtime_solver_t* solver = (jmi_realtime_solver_t*)block->solver;
     
     free(solver->weights);
+    free(solver->last_converged_x);
     free(solver->pivots);
     free(solver->dx);
     free(solver->df);
@@ -78,6 +79,8 @@ int jmi_realtime_solver_new(jmi_realtime_solver_t** solver_ptr, jmi_block_solver
     if (!solver) return -1;
     
     solver->weights       = (jmi_real_t*)calloc(block->n,sizeof(jmi_real_t));
+    solver->last_converged_x = (jmi_real_t*)calloc(block->n,sizeof(jmi_real_t));
+    solver->has_converged = 0;
     solver->pivots        = (jmi_int_t*)calloc(block->n,sizeof(jmi_int_t));
     solver->dx            = (jmi_real_t*)calloc(block->n,sizeof(jmi_real_t));
     solver->df            = (jmi_real_t*)calloc(block->n,sizeof(jmi_real_t));
@@ -86,6 +89,7 @@ int jmi_realtime_solver_new(jmi_realtime_solver_t** solver_ptr, jmi_block_solver
     
     /* Statistics */
     solver->nbr_non_convergence = 0;
+    solver->nbr_deadline_fallbacks = 0;
     solver->nbr_iterations      = 0;
     solver->last_wrms           = 0.0;
     solver->last_wrms_id        = -1;
@@ -128,6 +132,31 @@ static void jmi_realtime_solver_progress(jmi_block_solver_t *block) {
     return;
 }
 
+/*
+ * Ends a solve that exhausted the time budget by evaluating the block at the
+ * last converged solution, which bounds the remaining work to one evaluation.
+ * Returns jmi_block_solver_status_time_budget_exhausted, or -1 if the evaluation fails.
+ */
+static int jmi_realtime_solver_deadline_fallback(jmi_block_solver_t *block) {
+    jmi_realtime_solver_t* solver = (jmi_realtime_solver_t*)block->solver;
+    jmi_int_t ret;
+    
+    progress_char_log(block, 'D');
+    
+    solver->nbr_deadline_fallbacks++;
+    block->deadline->nbr_fallbacks++;
+    
+    memcpy(block->x, solver->last_converged_x, block->n*sizeof(jmi_real_t));
+    ret = block->F(block->problem_data,block->x,block->res,JMI_BLOCK_EVALUATE);
+    if(ret) { jmi_realtime_solver_error_handling(block, block->x, JMI_REALTIME_SOLVER_BLOCK_EVALUATION_FAIL); return -1; }
+    
+    jmi_log_node(block->log, logWarning, "RealtimeDeadlineExceeded", 
+                "Time budget exhausted in <block: %s> at <t: %f> after <iteration: %d>, using the last converged solution, <fallbacks: %d> in total. Continuing...", 
+                block->label, block->cur_time, solver->nbr_iterations, solver->nbr_deadline_fallbacks);
+    
+    return jmi_block_solver_status_time_budget_exhausted;
+}
+
 int jmi_realtime_solver_solve(jmi_block_solver_t *block) {
     jmi_realtime_solver_t* solver = (jmi_realtime_solver_t*)block->solver;
     jmi_real_t tolerance = block->options->res_tol;
@@ -137,18 +166,29 @@ int jmi_realtime_solver_solve(jmi_block_solver_t *block) {
     clock_t start_measuring = jmi_block_solver_start_clock(block);
     clock_t jac_measuring, fac_measuring;
     jmi_real_t elapsed_time_jac = 0.0, elapsed_time_fac = 0.0;
+    /* The time budget only applies when there is a converged solution to fall back to, and not at events */
+    jmi_int_t use_deadline = solver->has_converged && !block->init && !block->at_event;
+    jmi_int_t deadline_exceeded = 0;
     
     /* Initialize the work vector */
     block->F(block->problem_data,block->x,block->res,JMI_BLOCK_INITIALIZE);
     
     /* Initialize statistics */
     solver->nbr_iterations = 0;
+    
+    if (use_deadline && jmi_block_solver_deadline_exceeded(block->deadline)) {
+        return jmi_realtime_solver_deadline_fallback(block);
+    }
 
     /* Evaluate */
     ret = block->F(block->problem_data,block->x,block->res,JMI_BLOCK_EVALUATE);
     if(ret) { jmi_realtime_solver_error_handling(block, block->x, JMI_REALTIME_SOLVER_BLOCK_EVALUATION_FAIL); return -1; }
     
 
+    if (use_deadline && jmi_block_solver_deadline_exceeded(block->deadline)) {
+        return jmi_realtime_solver_deadline_fallback(block);
+    }
+
     if(block->init || block->at_event || !broyden_updates) {
         /* Compute the Jacobian (always and only done once) */
         jac_measuring = jmi_block_solver_start_clock(block);
@@ -186,6 +226,10 @@ int jmi_realtime_solver_solve(jmi_block_solver_t *block) {
     
     /* Iterate */
     for (i = 0; i < JMI_REALTIME_SOLVER_MAX_ITER; i++) {
+        if (use_deadline && jmi_block_solver_deadline_exceeded(block->deadline)) {
+            deadline_exceeded = 1;
+            break;
+        }
         solver->nbr_iterations++;
 
         /* Values x and res are current */
@@ -236,6 +280,10 @@ int jmi_realtime_solver_solve(jmi_block_solver_t *block) {
         jmi_log_leave(block->log, destnode);
     }
     
+    if (deadline_exceeded) {
+        return jmi_realtime_solver_deadline_fallback(block);
+    }
+    
     if (solver->last_wrms >= 1.0) {
         solver->nbr_non_convergence++;
         
@@ -243,6 +291,9 @@ int jmi_realtime_solver_solve(jmi_block_solver_t *block) {
                     "Failed to converge <block: %s> at <t: %f> due to <WRMS: %f> after <iteration: %d> and after elapsed <time: %f> whereof <Jac: %f> and <LU: %f>. Continuing...", 
                     block->label, block->cur_time, solver->last_wrms, i, jmi_block_solver_elapsed_time(block, start_measuring), elapsed_time_jac, elapsed_time_fac);
     } else {
+        memcpy(solver->last_converged_x, block->x, block->n*sizeof(jmi_real_t));
+        solver->has_converged = 1;
+        
         jmi_log_node(block->log, logInfo, "RealtimeConvergence", 
                     "Succeeded to converge <block: %s> at <t: %f> with <WRMS: %f> after <iteration: %d> and after elapsed <time: %f> whereof <Jac: %f> and <LU: %f>.", 
                     block->label, block->cur_time, solver->last_wrms, i, jmi_block_solver_elapsed_time(block, start_measuring), elapsed_time_jac, elapsed_time_fac);
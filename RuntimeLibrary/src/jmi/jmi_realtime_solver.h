@@ -46,12 +46,15 @@ struct jmi_realtime_solver_t {
     jmi_real_t* factorization;      /**< \brief Matrix for storing the Jacobian factorization. */
     jmi_int_t*  pivots;             /**< \brief Pivots related to the Jacobian factorization. */
     jmi_real_t* weights;            /**< \brief Weights used when computing the WRMS norm. */
+    jmi_real_t* last_converged_x;   /**< \brief IVs of the last converged solve, used when the time budget is exhausted. */
+    int has_converged;              /**< \brief If last_converged_x holds a converged solution. */
     
     
     int char_log_length;                                       /** Number of chars in char_log */
     char char_log[JMI_REALTIME_SOLVER_MAX_CHAR_LOG_LENGTH+1];  /** Short log like "Js". Null-terminated. */
     
     jmi_int_t nbr_non_convergence;
+    jmi_int_t nbr_deadline_fallbacks; /**< \brief Number of solves that used last_converged_x due to the time budget. */
     jmi_int_t nbr_iterations;
     jmi_real_t last_wrms;
     jmi_int_t  last_wrms_id;
@@ -56,6 +56,8 @@ typedef struct jmi_dynamic_state_set_t jmi_dynamic_state_set_t;     /**< \brief
 typedef struct jmi_modules_t jmi_modules_t;                         /**< \brief Forward declaration of struct. */
 typedef struct jmi_module_t jmi_module_t;                           /**< \brief Forward declaration of struct. */
 typedef struct jmi_chattering_t jmi_chattering_t;                   /**< \brief Forward declaration of struct. */
+typedef struct jmi_ode_deps_t jmi_ode_deps_t;                       /**< \brief Forward declaration of struct. */
+typedef struct jmi_param_deps_t jmi_param_deps_t;                   /**< \brief Forward declaration of struct. */
 
 #define JMI_MAX(X,Y) ((X) > (Y) ? (X) : (Y))
 #define JMI_MIN(X,Y) ((X) < (Y) ? (X) : (Y))
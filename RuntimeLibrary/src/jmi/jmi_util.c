@@ -207,7 +207,15 @@ void jmi_init_runtime_options(jmi_t *jmi, jmi_options_t* op) {
     op->time_events_default_tol = JMI_ALMOST_EPS; /** <\brief Default tolerance for the time event iterations. */
     op->events_tol_factor = 0.0001;               /**< \brief Tolerance safety factor for the event iterations. */
     op->cs_solver = JMI_ODE_CVODE;                /**< \brief Option for changing the internal CS solver. */
+    op->cs_rk_method = JMI_ODE_RK_RK4;            /**< \brief Option for changing the method of the explicit Runge-Kutta solver. */
+    op->cs_rosenbrock_method = JMI_ODE_ROSENBROCK_ROS2; /**< \brief Option for changing the method of the linearly implicit solver. */
+    op->cs_jacobian_update_interval = 10;         /**< \brief Number of steps between Jacobian updates of the linearly implicit solver. */
+    op->cs_linear_solver = JMI_ODE_CVODE_DENSE;   /**< \brief Option for changing the linear solver of CVode in the CS case. */
+    op->cs_precond_block_size = 10;               /**< \brief Size of the diagonal blocks in the preconditioner of the Krylov solvers. */
+    op->cs_num_threads = 1;                       /**< \brief Number of threads used in the vector operations of CVode. */
     op->cs_rel_tol = 1e-6;                        /**< \brief Default tolerance for the adaptive solvers in the CS case. */
+    op->cs_input_reinit_tol = 0.0;                /**< \brief Relative size of real input changes that re-initializes the solver. */
+    op->cs_async_do_step = 0;                     /**< \brief Option for running fmi2DoStep asynchronously in a worker thread. */
     op->cs_step_size = 1e-3;                      /**< \brief Default step-size for the non-adaptive solvers in the CS case. */   
     op->cs_experimental_mode = 0;
 
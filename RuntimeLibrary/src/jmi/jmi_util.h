@@ -194,7 +194,15 @@ typedef struct jmi_options_t {
     double events_tol_factor;               /**< \brief Tolerance safety factor for the event iterations. */
 
     int cs_solver;                          /**< \brief Option for changing the internal CS solver */
+    int cs_rk_method;                       /**< \brief Option for changing the method of the explicit Runge-Kutta solver in the CS case */
+    int cs_rosenbrock_method;               /**< \brief Option for changing the method of the linearly implicit solver in the CS case */
+    int cs_jacobian_update_interval;        /**< \brief Number of steps between Jacobian updates of the linearly implicit solver in the CS case */
+    int cs_linear_solver;                   /**< \brief Option for changing the linear solver of CVode in the CS case */
+    int cs_precond_block_size;              /**< \brief Size of the diagonal blocks in the preconditioner of the Krylov solvers in the CS case */
+    int cs_num_threads;                     /**< \brief Number of threads used in the vector operations of CVode in the CS case */
     double cs_rel_tol;                      /** < \brief Default tolerance for the adaptive solvers in the CS case. */
+    double cs_input_reinit_tol;             /**< \brief Relative size of real input changes that re-initializes the solver in the CS case */
+    int cs_async_do_step;                   /**< \brief Option for running fmi2DoStep asynchronously in a worker thread */
     double cs_step_size;                    /** < \brief Default step-size for the non-adaptive solvers in the CS case. */   
     int cs_experimental_mode;  
 } jmi_options_t;
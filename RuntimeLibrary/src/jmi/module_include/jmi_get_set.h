@@ -59,6 +59,11 @@ int jmi_get_event_indicators_impl(jmi_t* jmi, jmi_real_t eventIndicators[], size
 
 int jmi_get_derivatives_impl(jmi_t* jmi, jmi_real_t derivatives[] , size_t nx);
 
+int jmi_ode_set_point_impl(jmi_t* jmi, jmi_real_t time, const jmi_real_t x[], size_t nx,
+                           const jmi_value_reference input_vrs[], const jmi_real_t input_values[], size_t n_inputs);
+
+int jmi_ode_get_derivatives_impl(jmi_t* jmi, jmi_real_t dx[], size_t nx);
+
 int jmi_save_last_successful_values(jmi_t *jmi);
 
 int jmi_reset_last_successful_values(jmi_t *jmi);
@@ -71,6 +71,8 @@ void jmi_set_recompute(jmi_t* jmi, int index, int offset, int* needRecomputeVars
 int jmi_set_update(jmi_t* jmi, int needParameterUpdate, int needRecomputeVars) {
     if (needParameterUpdate) {
         jmi_init_eval_dependent_set_dirty(jmi);
+        /* Parameters are not tracked by the block dependencies */
+        jmi_ode_deps_invalidate(jmi);
     }
     if(needRecomputeVars) {
         RECOMPUTE_VARIABLES_SET(jmi);
@@ -90,6 +92,8 @@ int jmi_set_real_impl(jmi_t* jmi, const jmi_value_reference vr[], size_t nvr,
         index = jmi_get_index_from_value_ref(vr[i]);
         if(z[index] != value[i]) {
             jmi_set_recompute(jmi, index, jmi->offs_real_dx, &needRecomputeVars, &needParameterUpdate);
+            jmi_ode_deps_mark_changed(jmi, index);
+            jmi_param_deps_mark_changed(jmi, index);
             z[index] = value[i];
         }
     }
@@ -109,6 +113,8 @@ int jmi_set_integer_impl(jmi_t* jmi, const jmi_value_reference vr[], size_t nvr,
         index = jmi_get_index_from_value_ref(vr[i]);
         if(z[index] != value[i]) {
             jmi_set_recompute(jmi, index, jmi->offs_real_dx, &needRecomputeVars, &needParameterUpdate);
+            jmi_ode_deps_mark_changed(jmi, index);
+            jmi_param_deps_mark_changed(jmi, index);
             z[index] = value[i];
         }
     }
@@ -128,6 +134,8 @@ int jmi_set_boolean_impl(jmi_t* jmi, const jmi_value_reference vr[], size_t nvr,
         index = jmi_get_index_from_value_ref(vr[i]);
         if(z[index] != value[i]) {
             jmi_set_recompute(jmi, index, jmi->offs_real_dx, &needRecomputeVars, &needParameterUpdate);
+            jmi_ode_deps_mark_changed(jmi, index);
+            jmi_param_deps_mark_changed(jmi, index);
             z[index] = value[i];
         }
     }
@@ -160,6 +168,12 @@ int jmi_set_string_impl(jmi_t* jmi, const jmi_value_reference vr[], size_t nvr,
         }
     }
     
+    if (needRecomputeVars) {
+        /* Strings are not tracked by the block dependencies */
+        jmi_ode_deps_invalidate(jmi);
+        jmi_param_deps_invalidate(jmi);
+    }
+    
     return jmi_set_update(jmi, needParameterUpdate, needRecomputeVars);
 }
 
@@ -186,13 +200,21 @@ int jmi_get_update(jmi_t* jmi, const jmi_value_reference vr[], size_t nvr, size_
     
     eval_variables_required = jmi_evaluate_variables_required(jmi, vr, nvr, offset);
     if (jmi->recomputeVariables == 1 && jmi->is_initialized == 1 && eval_variables_required == 1 && jmi->user_terminate == 0) {
+        /* Outside of events only the out-of-date blocks needed for the requested variables are evaluated */
+        int partial = jmi->atEvent == JMI_FALSE && jmi->atInitial == JMI_FALSE &&
+                      jmi_ode_deps_begin_partial(jmi, vr, nvr);
         retval = jmi_ode_derivatives(jmi);
+        if (partial) {
+            jmi_ode_deps_end(jmi);
+        }
         if(retval != 0) {
             jmi_log_node(jmi->log, logError, "ModelEquationsEvaluationFailed", "Error evaluating model equations.");
             jmi_reset_internal_variables(jmi);
             return -1;
         }
-        RECOMPUTE_VARIABLES_CLR(jmi);
+        if (!partial || !jmi_ode_deps_has_stale(jmi)) {
+            RECOMPUTE_VARIABLES_CLR(jmi);
+        }
     }
     return 0;
 }
@@ -296,6 +318,7 @@ int jmi_set_time_impl(jmi_t* jmi, jmi_real_t time) {
         }
 
         *time_old = time;
+        jmi_ode_deps_mark_changed(jmi, jmi->offs_t);
         RECOMPUTE_VARIABLES_SET(jmi);
     }
 
@@ -310,6 +333,7 @@ int jmi_set_continuous_states_impl(jmi_t* jmi, const jmi_real_t x[], size_t nx)
         if (x_cur[i] != x[i]){
             x_cur[i] = x[i];
 
+            jmi_ode_deps_mark_changed(jmi, jmi->offs_real_x + i);
             RECOMPUTE_VARIABLES_SET(jmi);
         }
     }
@@ -369,6 +393,21 @@ int jmi_get_event_indicators_impl(jmi_t* jmi, jmi_real_t eventIndicators[], size
     return 0;
 }
 
+/* Evaluate the derivatives, retrying once from the last successful values on failure */
+static int jmi_ode_derivatives_with_retry(jmi_t* jmi) {
+    int retval = jmi_ode_derivatives(jmi);
+    if(retval != 0) {
+        jmi_log_node(jmi->log, logWarning, "Warning",
+            "Evaluating the derivatives failed at <t:%g>, retrying with restored values.", jmi_get_t(jmi)[0]);
+        /* If it failed, reset to the previous succesful values */
+        jmi_reset_internal_variables(jmi);
+
+        /* Try again */
+        retval = jmi_ode_derivatives(jmi);
+    }
+    return retval;
+}
+
 int jmi_get_derivatives_impl(jmi_t* jmi, jmi_real_t derivatives[] , size_t nx) {
     int retval;
     jmi_log_node_t node={0};
@@ -384,26 +423,17 @@ int jmi_get_derivatives_impl(jmi_t* jmi, jmi_real_t derivatives[] , size_t nx) {
     }
 
     if (RECOMPUTE_VARIABLES(jmi) == 1  && jmi->user_terminate == 0) {
-        retval = jmi_ode_derivatives(jmi);
+        retval = jmi_ode_derivatives_with_retry(jmi);
         if(retval != 0) {
-            jmi_log_node(jmi->log, logWarning, "Warning",
-                "Evaluating the derivatives failed at <t:%g>, retrying with restored values.", jmi_get_t(jmi)[0]);
-            /* If it failed, reset to the previous succesful values */
+            if (jmi->jmi_callbacks.log_options.log_level >= 5){
+                jmi_log_leave(jmi->log, node);
+            }
+            jmi_log_node(jmi->log, logError, "Error",
+                "Evaluating the derivatives failed at <t:%g>", jmi_get_t(jmi)[0]);
+            /* If it failed, reset to the previous successful values */
             jmi_reset_internal_variables(jmi);
 
-            /* Try again */
-            retval = jmi_ode_derivatives(jmi);
-            if(retval != 0) {
-                if (jmi->jmi_callbacks.log_options.log_level >= 5){
-                    jmi_log_leave(jmi->log, node);
-                }
-                jmi_log_node(jmi->log, logError, "Error",
-                    "Evaluating the derivatives failed at <t:%g>", jmi_get_t(jmi)[0]);
-                /* If it failed, reset to the previous successful values */
-                jmi_reset_internal_variables(jmi);
-
-                return -1;
-            }
+            return -1;
         }
 
         RECOMPUTE_VARIABLES_CLR(jmi);
@@ -429,6 +459,62 @@ int jmi_get_derivatives_impl(jmi_t* jmi, jmi_real_t derivatives[] , size_t nx) {
     return 0;
 }
 
+int jmi_ode_set_point_impl(jmi_t* jmi, jmi_real_t time, const jmi_real_t x[], size_t nx,
+                           const jmi_value_reference input_vrs[], const jmi_real_t input_values[], size_t n_inputs) {
+    jmi_real_t* z = jmi_get_z(jmi);
+    jmi_value_reference index;
+    jmi_real_t value;
+    size_t i;
+
+    jmi_set_continuous_states_impl(jmi, x, nx);
+    jmi_set_time_impl(jmi, time);
+
+    for (i = 0; i < n_inputs; i++) {
+        index = jmi_get_index_from_value_ref(input_vrs[i]);
+        value = jmi_value_ref_is_negated(input_vrs[i]) ? -input_values[i] : input_values[i];
+        if (z[index] != value) {
+            z[index] = value;
+            jmi_ode_deps_mark_changed(jmi, index);
+            jmi_param_deps_mark_changed(jmi, index);
+            RECOMPUTE_VARIABLES_SET(jmi);
+        }
+    }
+
+    return 0;
+}
+
+int jmi_ode_get_derivatives_impl(jmi_t* jmi, jmi_real_t dx[], size_t nx) {
+    jmi_real_t* z_dx;
+    size_t i;
+
+    if (jmi->jmi_callbacks.log_options.log_level >= 5) {
+        /* Keep the log of the FMI getter */
+        return jmi_get_derivatives_impl(jmi, dx, nx);
+    }
+
+    if (RECOMPUTE_VARIABLES(jmi) == 1 && jmi->user_terminate == 0) {
+        if (jmi_ode_derivatives_with_retry(jmi) != 0) {
+            jmi_log_node(jmi->log, logError, "Error",
+                "Evaluating the derivatives failed at <t:%g>", jmi_get_t(jmi)[0]);
+            jmi_reset_internal_variables(jmi);
+            return -1;
+        }
+        RECOMPUTE_VARIABLES_CLR(jmi);
+    }
+
+    /* Copy and check for NaN in one pass */
+    z_dx = jmi_get_real_dx(jmi);
+    for (i = 0; i < nx; i++) {
+        dx[i] = z_dx[i];
+        if (dx[i] - dx[i] != 0) {
+            jmi_log_node(jmi->log, logError, "Error",
+                "Evaluating the derivatives failed at <t:%g>. Produced NaN in <index:%I>", jmi_get_t(jmi)[0], (jmi_int_t)i);
+            return -1;
+        }
+    }
+
+    return 0;
+}
 
 int jmi_save_last_successful_values(jmi_t *jmi) {
     jmi_real_t* z;
@@ -474,6 +560,7 @@ int jmi_reset_internal_variables(jmi_t* jmi) {
     memcpy(u, jmi_get_real_u(jmi), jmi->n_real_u*sizeof(jmi_real_t));
 
     jmi_reset_last_internal_successful_values(jmi);
+    jmi_ode_deps_invalidate(jmi);
 
     /* Restore the current time and states */
     memcpy (jmi_get_real_u(jmi), u, jmi->n_real_u*sizeof(jmi_real_t));
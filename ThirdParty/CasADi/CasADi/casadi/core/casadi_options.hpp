@@ -79,6 +79,14 @@ namespace casadi {
 
       static bool allowed_internal_api;
 
+      /** \brief Directory where dynamically compiled functions are cached
+      *  If set, generated code is compiled into a library in this directory, named
+      *  after a hash of the code and the compiler command. Later compilations of
+      *  identical code load the cached library instead of compiling again.
+      *  Default: "" (no caching, compile in the current directory)
+      */
+      static std::string compilation_cache_dir;
+
 #endif //SWIG
       // Setter and getter for catch_errors_swig
       static void setCatchErrorsSwig(bool flag) { catch_errors_swig = flag; }
@@ -105,6 +113,10 @@ namespace casadi {
 
       static void setAllowedInternalAPI(bool flag) { allowed_internal_api= flag; }
       static bool getAllowedInternalAPI() { return allowed_internal_api; }
+
+      // Setter and getter for compilation_cache_dir
+      static void setCompilationCacheDir(const std::string& dir) { compilation_cache_dir = dir; }
+      static std::string getCompilationCacheDir() { return compilation_cache_dir; }
   };
 
 } // namespace casadi
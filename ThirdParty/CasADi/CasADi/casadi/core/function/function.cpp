@@ -124,6 +124,19 @@ namespace casadi {
     return ret;
   }
 
+  vector<vector<MX> > Function::map(const vector<vector<MX> > &x) {
+    assertInit();
+
+    // No need for a parallelizer for a single point
+    if (x.size()==1) {
+      return vector<vector<MX> >(1, call(x.front()));
+    }
+
+    Dictionary paropt;
+    paropt["parallelization"] = "batch";
+    return callParallel(x, paropt);
+  }
+
   void Function::evaluate() {
     assertInit();
     (*this)->evaluate();
@@ -355,6 +355,12 @@ namespace casadi {
     std::vector<std::vector<MX> > callParallel(const std::vector<std::vector<MX> > &arg,
                                                const Dictionary& paropt=Dictionary());
 
+    /** \brief  Evaluate symbolically at several points (matrix graph)
+        If the function is an SXFunction, all points are evaluated numerically
+        with a single pass over its algorithm.
+    */
+    std::vector<std::vector<MX> > map(const std::vector<std::vector<MX> > &arg);
+
     /** \brief Get a function that calculates nfwd forward derivatives and nadj adjoint derivatives
      *
      *         Returns a function with <tt>(1+nfwd)*n_in+nadj*n_out</tt> inputs
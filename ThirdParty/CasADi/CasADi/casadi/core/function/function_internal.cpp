@@ -40,7 +40,15 @@
 #include <cctype>
 #ifdef WITH_DL
 #include <cstdlib>
+#include <cstdio>
 #include <ctime>
+#include <iomanip>
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else // _WIN32
+#include <unistd.h>
+#endif // _WIN32
 #endif // WITH_DL
 
 using namespace std;
@@ -2354,34 +2362,88 @@ namespace casadi {
     string cname = fname + ".c";
     string dlname = fname + ".so";
 
-    // Remove existing files, if any
-    string rm_command = "rm -rf " + cname + " " + dlname;
-    int flag = system(rm_command.c_str());
-    casadi_assert_message(flag==0, "Failed to remove old source");
+    // Library to load
+    string dlpath = "./" + dlname;
 
-    // Codegen it
-    f.generateCode(cname);
-    if (verbose_) {
-      cout << "Generated c-code for " << fdescr << " (" << cname << ")" << endl;
-    }
+    const string& cache_dir = CasadiOptions::compilation_cache_dir;
+    if (cache_dir.empty()) {
+      // Remove existing files, if any
+      string rm_command = "rm -rf " + cname + " " + dlname;
+      int flag = system(rm_command.c_str());
+      casadi_assert_message(flag==0, "Failed to remove old source");
 
-    // Compile it
-    string compile_command = compiler + " " + dlflag + " " + cname + " -o " + dlname;
-    if (verbose_) {
-      cout << "Compiling " << fdescr <<  " using \"" << compile_command << "\"" << endl;
-    }
+      // Codegen it
+      f.generateCode(cname);
+      if (verbose_) {
+        cout << "Generated c-code for " << fdescr << " (" << cname << ")" << endl;
+      }
 
-    time_t time1 = time(0);
-    flag = system(compile_command.c_str());
-    time_t time2 = time(0);
-    double comp_time = difftime(time2, time1);
-    casadi_assert_message(flag==0, "Compilation failed");
-    if (verbose_) {
-      cout << "Compiled " << fdescr << " (" << dlname << ") in " << comp_time << " s."  << endl;
+      // Compile it
+      bool compiled = compileLibrary(compiler + " " + dlflag, cname, dlname, fdescr);
+      casadi_assert_message(compiled, "Compilation failed");
+    } else {
+      // Codegen it
+      string code = f.generateCode();
+
+      // The library is named after a hash of the code and the compiler command,
+      // 64-bit FNV-1a. The code does not depend on fname, which may contain an
+      // object address, so fname is not part of the name.
+      string key = code + '\0' + compiler + " " + dlflag;
+      unsigned long long hash = 14695981039346656037ULL;
+      for (string::const_iterator it=key.begin(); it!=key.end(); ++it) {
+        hash = (hash ^ static_cast<unsigned char>(*it)) * 1099511628211ULL;
+      }
+      stringstream ss;
+      ss << cache_dir << "/casadi_" << hex << setw(16) << setfill('0') << hash;
+      dlpath = ss.str() + ".so";
+
+      if (ifstream(dlpath.c_str()).good()) {
+        if (verbose_) {
+          cout << "Found " << fdescr << " in compilation cache (" << dlpath << ")" << endl;
+        }
+      } else {
+        // Generate and compile under names unique to this compilation and then move
+        // the library in place, so that concurrent compilations never load a partial
+        // library. The object address and the counter separate threads of a process.
+        static unsigned int tmp_counter = 0;
+        ss << "." << dec << getpid() << "_" << this << "_" << tmp_counter++;
+        string tmp_cname = ss.str() + ".c";
+        string tmp_dlname = ss.str() + ".so";
+        bool written;
+        {
+          ofstream cfile(tmp_cname.c_str());
+          casadi_assert_message(cfile.good(), "Failed to open \"" << tmp_cname << "\"");
+          cfile << code;
+          cfile.close();
+          written = !cfile.fail();
+        }
+        if (!written) {
+          remove(tmp_cname.c_str());
+          casadi_error("Failed to write \"" << tmp_cname << "\"");
+        }
+        if (verbose_) {
+          cout << "Generated c-code for " << fdescr << " (" << tmp_cname << ")" << endl;
+        }
+        bool compiled = compileLibrary(compiler + " " + dlflag, tmp_cname, tmp_dlname, fdescr);
+        remove(tmp_cname.c_str());
+        if (!compiled) {
+          // Do not leave partial output in the shared directory
+          remove(tmp_dlname.c_str());
+          casadi_error("Compilation failed");
+        }
+
+        // Renaming fails on some platforms if another process got there first,
+        // the libraries are identical so the existing one is used
+        if (rename(tmp_dlname.c_str(), dlpath.c_str())!=0) {
+          remove(tmp_dlname.c_str());
+          casadi_assert_message(ifstream(dlpath.c_str()).good(),
+                                "Failed to add \"" << dlpath << "\" to compilation cache");
+        }
+      }
     }
 
     // Load it
-    ExternalFunction f_gen("./" + dlname);
+    ExternalFunction f_gen(dlpath);
     f_gen.setOption("name", fname + "_gen");
 
     // Initialize it if f was initialized
@@ -2398,6 +2460,30 @@ namespace casadi {
 #endif // WITH_DL
   }
 
+  bool FunctionInternal::compileLibrary(const std::string& compiler, const std::string& cname,
+                                        const std::string& dlname, const std::string& fdescr) {
+#ifdef WITH_DL
+    string compile_command = compiler + " " + cname + " -o " + dlname;
+    if (verbose_) {
+      cout << "Compiling " << fdescr <<  " using \"" << compile_command << "\"" << endl;
+    }
+
+    time_t time1 = time(0);
+    int flag = system(compile_command.c_str());
+    time_t time2 = time(0);
+    double comp_time = difftime(time2, time1);
+    if (flag!=0) return false;
+    if (verbose_) {
+      cout << "Compiled " << fdescr << " (" << dlname << ") in " << comp_time << " s."  << endl;
+    }
+    return true;
+#else // WITH_DL
+    casadi_error("Compilation requires CasADi to be compiled "
+                 "with option \"WITH_DL\" enabled");
+    return false;
+#endif // WITH_DL
+  }
+
   void FunctionInternal::createCall(const std::vector<MX> &arg,
                           std::vector<MX> &res, const std::vector<std::vector<MX> > &fseed,
                           std::vector<std::vector<MX> > &fsens,
@@ -334,6 +334,10 @@ namespace casadi {
     Function dynamicCompilation(Function f, std::string fname, std::string fdescr,
                                 std::string compiler);
 
+    /// Compile generated code into a dynamic library, returns false if compilation failed
+    bool compileLibrary(const std::string& compiler, const std::string& cname,
+                        const std::string& dlname, const std::string& fdescr);
+
     /// The following functions are called internally from EvaluateMX.
     /// For documentation, see the MXNode class
     ///@{
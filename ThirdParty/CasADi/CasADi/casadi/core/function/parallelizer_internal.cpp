@@ -25,6 +25,7 @@
 
 #include "parallelizer_internal.hpp"
 #include "mx_function.hpp"
+#include "sx_function_internal.hpp"
 #include <algorithm>
 #ifdef WITH_OPENMP
 #include <omp.h>
@@ -35,7 +36,7 @@ using namespace std;
 namespace casadi {
 
   ParallelizerInternal::ParallelizerInternal(const std::vector<Function>& funcs) : funcs_(funcs) {
-    addOption("parallelization", OT_STRING, "serial", "", "serial|openmp|mpi");
+    addOption("parallelization", OT_STRING, "serial", "", "serial|openmp|mpi|batch");
   }
 
   ParallelizerInternal::~ParallelizerInternal() {
@@ -49,6 +50,8 @@ namespace casadi {
       mode_ = OPENMP;
     } else if (getOption("parallelization")=="mpi") {
       mode_ = MPI;
+    } else if (getOption("parallelization")=="batch") {
+      mode_ = BATCH;
     } else {
       casadi_error("Parallelization mode " << getOption("parallelization") << " unknown.");
     }
@@ -75,6 +78,19 @@ namespace casadi {
       }
     }
 
+    // Batch evaluation requires all tasks to be the same SXFunction
+    if (mode_ == BATCH) {
+      bool batchable = is_a<SXFunction>(funcs_.front());
+      for (int i=1; i<funcs_.size() && batchable; ++i) {
+        batchable = copy_of_[i]==0;
+      }
+      if (!batchable) {
+        casadi_warning("Batch parallelization requires all tasks to be the same SXFunction, "
+                       "switching to serial mode.");
+        mode_ = SERIAL;
+      }
+    }
+
     // Initialize the dependend functions
     for (vector<Function>::iterator it=funcs_.begin(); it!=funcs_.end(); ++it) {
       // Initialize
@@ -166,9 +182,22 @@ namespace casadi {
 #endif //WITH_OPENMP
     } else if (mode_ == MPI) {
       casadi_error("ParallelizerInternal::evaluate: MPI not implemented");
+    } else if (mode_ == BATCH) {
+      evaluateBatch();
     }
   }
 
+  void ParallelizerInternal::evaluateBatch() {
+    // The inputs and outputs are ordered task by task, as expected by evaluateBatch
+    batch_arg_.resize(getNumInputs());
+    for (int j=0; j<batch_arg_.size(); ++j) batch_arg_[j] = input(j).ptr();
+    batch_res_.resize(getNumOutputs());
+    for (int j=0; j<batch_res_.size(); ++j) batch_res_[j] = output(j).ptr();
+
+    SXFunction f = shared_cast<SXFunction>(funcs_.front());
+    f->evaluateBatch(funcs_.size(), getPtr(batch_arg_), getPtr(batch_res_));
+  }
+
   void ParallelizerInternal::evaluateTask(int task) {
 
     // Get a reference to the function
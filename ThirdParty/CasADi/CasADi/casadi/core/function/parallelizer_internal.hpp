@@ -64,6 +64,9 @@ namespace casadi {
     /// Evaluate a single task
     virtual void evaluateTask(int task);
 
+    /// Evaluate all tasks with a single batched evaluation of the common SXFunction
+    void evaluateBatch();
+
     /// Reset the sparsity propagation
     virtual void spInit(bool use_fwd);
 
@@ -106,10 +109,14 @@ namespace casadi {
     std::vector<int> copy_of_;
 
     /// Parallelization modes
-    enum Mode {SERIAL, OPENMP, MPI};
+    enum Mode {SERIAL, OPENMP, MPI, BATCH};
 
     /// Mode
     Mode mode_;
+
+    /// Pointers to the inputs and outputs of all tasks, used in batch mode
+    std::vector<const double*> batch_arg_;
+    std::vector<double*> batch_res_;
   };
 
 
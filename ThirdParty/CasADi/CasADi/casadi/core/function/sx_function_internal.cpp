@@ -166,6 +166,55 @@ namespace casadi {
     }
   }
 
+  void SXFunctionInternal::evaluateBatch(int npoint, const double* const* arg,
+                                         double* const* res) {
+    casadi_log("SXFunctionInternal::evaluateBatch():begin  " << getOption("name"));
+
+    if (!free_vars_.empty()) {
+      std::stringstream ss;
+      repr(ss);
+      casadi_error("Cannot evaluate \"" << ss.str() << "\" since variables "
+                   << free_vars_ << " are free.");
+    }
+
+    int n_in = getNumInputs();
+    int n_out = getNumOutputs();
+
+    // Point-major work vector: element k of point p is stored at k*npoint+p
+    work_batch_.resize(work_.size()*npoint);
+    double* w = getPtr(work_batch_);
+
+    // Evaluate the algorithm, one operation for all points at a time
+    for (vector<AlgEl>::const_iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      switch (it->op) {
+      case OP_CONST:
+        std::fill(w+it->i0*npoint, w+(it->i0+1)*npoint, it->d);
+        break;
+      case OP_INPUT:
+        {
+          double* w0 = w+it->i0*npoint;
+          for (int p=0; p<npoint; ++p) w0[p] = arg[p*n_in+it->i1][it->i2];
+        }
+        break;
+      case OP_OUTPUT:
+        {
+          const double* w1 = w+it->i1*npoint;
+          for (int p=0; p<npoint; ++p) {
+            double* r = res[p*n_out+it->i0];
+            if (r!=0) r[it->i2] = w1[p];
+          }
+        }
+        break;
+      default:
+        // Unary operations have i2==i1, see init()
+        casadi_math<double>::fun(it->op, w+it->i1*npoint, w+it->i2*npoint, w+it->i0*npoint,
+                                 npoint);
+      }
+    }
+
+    casadi_log("SXFunctionInternal::evaluateBatch():end " << getOption("name"));
+  }
+
 
   SX SXFunctionInternal::hess(int iind, int oind) {
     casadi_assert_message(output(oind).numel() == 1, "Function must be scalar");
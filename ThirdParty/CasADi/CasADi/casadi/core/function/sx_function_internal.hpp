@@ -94,6 +94,16 @@ class CASADI_CORE_EXPORT SXFunctionInternal :
   /** \brief  Evaluate the function numerically */
   virtual void evaluate();
 
+  /** \brief  Evaluate the function numerically at several points at once
+   *
+   * The nonzeros of input i at point p are read from arg[p*getNumInputs()+i]
+   * and the nonzeros of output j at point p are written to
+   * res[p*getNumOutputs()+j], which may be null to skip the output.
+   * The algorithm is interpreted once, with each operation applied to all
+   * points before moving on to the next operation.
+   */
+  void evaluateBatch(int npoint, const double* const* arg, double* const* res);
+
   /** \brief  Helper class to be plugged into evaluateGen when working
    * with a value known only at runtime */
   struct int_runtime {
@@ -141,6 +151,10 @@ class CASADI_CORE_EXPORT SXFunctionInternal :
   /** \brief  Working vector for numeric calculation */
   std::vector<double> work_;
 
+  /** \brief  Working vector for batched numeric calculation,
+   * the points of each work element are stored consecutively */
+  std::vector<double> work_batch_;
+
   /// work vector for symbolic calculations (allocated first time)
   std::vector<SXElement> s_work_;
   std::vector<SXElement> free_vars_;
@@ -187,6 +187,39 @@ class Functiontests(casadiTestCase):
     self.checkarray(sin(n1)+N1,p.getOutput(0),"output")
     self.checkarray(sin(n2)+N2,p.getOutput(1),"output")
 
+  def test_ParallelizerMap(self):
+    self.message("MX map of SXFunction")
+    x = SX.sym("x",2)
+    y = SX.sym("y")
+
+    f = SXFunction([x,y],[sin(x)*y + y**2, x[0]])
+    f.init()
+
+    X = [MX.sym("x",2) for i in range(3)]
+    Y = [MX.sym("y") for i in range(3)]
+    res = f.map([[X[i],Y[i]] for i in range(3)])
+    p = MXFunction(X+Y,[r[0] for r in res]+[r[1] for r in res])
+    p.init()
+
+    n = [DMatrix([4,5]),DMatrix([5,7]),DMatrix([-1,0.5])]
+    N = [3,8,-2]
+    for i in range(3):
+      p.setInput(n[i],i)
+      p.setInput(N[i],3+i)
+
+    p.evaluate()
+
+    for i in range(3):
+      self.checkarray(sin(n[i])*N[i]+N[i]**2,p.getOutput(i),"output")
+      self.checkarray(n[i][0],p.getOutput(3+i),"output")
+
+    J = p.jacobian(0,0)
+    J.init()
+    J.setInput(n[0],0)
+    J.setInput(N[0],3)
+    J.evaluate()
+    self.checkarray(c.diag(cos(n[0])*N[0]),J.getOutput(),"jacobian")
+
   def test_set_wrong(self):
     self.message("setter, wrong sparsity")
     x = SXElement.sym("x")
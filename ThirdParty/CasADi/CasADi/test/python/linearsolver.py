@@ -502,6 +502,48 @@ class LinearSolverTests(casadiTestCase):
         f.evaluate()
 
         self.checkarray(mul(A_,f.getOutput()),b)
+
+  @requiresPlugin(LinearSolver,"symbolicqr")
+  def test_compilation_cache(self):
+    import os
+    import shutil
+    import tempfile
+    
+    A = DMatrix([[3,1],[7,2]])
+    cache_dir = tempfile.mkdtemp()
+    CasadiOptions.setCompilationCacheDir(cache_dir)
+    try:
+      libs = None
+      for i in range(2):
+        solver = LinearSolver("symbolicqr", A.sparsity())
+        solver.setOption("codegen",True)
+        solver.init()
+        solver.setInput(A,"A")
+        solver.prepare()
+        solver.setInput(DMatrix([1,0.5]),"B")
+        solver.solve()
+        self.checkarray(solver.getOutput("X"),DMatrix([-1.5,5.5]))
+        
+        # Factorization and the two solve functions, without temporary files
+        files = dict((f, os.path.getmtime(os.path.join(cache_dir,f))) for f in os.listdir(cache_dir))
+        self.assertEqual(len(files),3)
+        for f in files:
+          self.assertTrue(f.startswith("casadi_") and f.endswith(".so"))
+        
+        # The second solver loads the cached libraries
+        if libs is not None:
+          self.assertEqual(files,libs)
+        libs = files
+      
+      # A failed compilation leaves no files in the cache directory
+      solver = LinearSolver("symbolicqr", DMatrix.ones(3,3).sparsity())
+      solver.setOption("codegen",True)
+      solver.setOption("compiler","false")
+      self.assertRaises(Exception, solver.init)
+      self.assertEqual(sorted(os.listdir(cache_dir)),sorted(libs.keys()))
+    finally:
+      CasadiOptions.setCompilationCacheDir("")
+      shutil.rmtree(cache_dir)
       
 if __name__ == '__main__':
     unittest.main()
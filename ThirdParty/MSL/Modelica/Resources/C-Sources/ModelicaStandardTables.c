@@ -44,6 +44,10 @@
                            arrays are stored in a global hash table in order to
                            avoid superfluous file input access and to decrease the
                            utilized memory (tickets #1110 and #1550).
+                           A shared table is only reused as long as the
+                           modification time of its file is unchanged. The
+                           spline coefficients of file tables are shared as
+                           well.
 
    Release Notes:
       Dec. 16, 2015: by Thomas Beutlich, ITI GmbH
@@ -117,6 +121,9 @@
 #include <locale.h>
 #include "ModelicaMatIO.h"
 #if defined(TABLE_SHARE)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <time.h>
 #define uthash_fatal(msg) ModelicaFormatMessage("Error: %s\n", msg); break
 #include "uthash.h"
 #include "gconstructor.h"
@@ -282,12 +289,30 @@ typedef struct TableShare {
     size_t nRow; /* Number of rows of table */
     size_t nCol; /* Number of columns of table */
     double* table; /* Table values */
+    time_t mtime; /* Modification time of file when table was read */
     UT_hash_handle hh; /* Hashable structure */
 } TableShare;
 
+typedef struct SplineKey {
+    const double* table; /* Table values the coefficients are calculated from */
+    size_t nRow; /* Number of rows of table */
+    size_t nCol; /* Number of columns of table */
+    int dim; /* Dimension of interpolation, 1 or 2 */
+    int smoothness; /* Smoothness kind */
+    /* Followed by the columns to be interpolated (only 1D) */
+} SplineKey;
+
+typedef struct SplineShare {
+    char* key; /* Key consisting of SplineKey and the interpolated columns */
+    size_t refCount; /* Reference counter */
+    void* spline; /* Pre-calculated cubic Hermite spline coefficients */
+    UT_hash_handle hh; /* Hashable structure */
+} SplineShare;
+
 /* ----- Static variables ----- */
 
 static TableShare* tableShare = NULL;
+static SplineShare* splineShare = NULL;
 #if defined(_POSIX_)
 #include <pthread.h>
 #if defined(G_HAS_CONSTRUCTORS)
@@ -417,6 +442,43 @@ static double* readTxtTable(_In_z_ const char* tableName, _In_z_ const char* fil
 
 static int readLine(_In_ char** buf, _In_ int* bufLen, _In_ FILE* fp) MODELICA_NONNULLATTR;
   /* Read line (of unknown and arbitrary length) from an ASCII text file */
+
+#if defined(TABLE_SHARE)
+static time_t fileModificationTime(_In_z_ const char* fileName) MODELICA_NONNULLATTR;
+  /* Get the modification time of a file, 0 if not available */
+
+static void releaseTable(_In_z_ const char* tableName, _In_z_ const char* fileName,
+                         _In_ double* table) MODELICA_NONNULLATTR;
+  /* Release a table returned by readTable, either by decrementing the
+     reference counter of the table share or by freeing a private table
+  */
+
+static void* acquireSpline(_In_ const double* table, size_t nRow, size_t nCol,
+                           const int* cols, size_t nCols, int dim,
+                           enum Smoothness smoothness);
+  /* Get the spline coefficients of a table from the spline share, or
+     calculate and insert them on a share miss
+
+     <- RETURN: Pointer to array of coefficients
+  */
+
+static int releaseSpline(void* spline, _In_ const double* table, size_t nRow,
+                         size_t nCol, const int* cols, size_t nCols, int dim,
+                         enum Smoothness smoothness);
+  /* Decrement the reference counter of shared spline coefficients, the
+     arguments after spline must be the ones passed to acquireSpline
+
+     <- RETURN: 1 if the coefficients were shared, 0 otherwise
+  */
+
+static char* splineKey(_In_ const double* table, size_t nRow, size_t nCol,
+                       const int* cols, size_t nCols, int dim,
+                       enum Smoothness smoothness, size_t* keyLen);
+  /* Build the key of the spline share
+
+     <- RETURN: Pointer to key of length keyLen, NULL on allocation error
+  */
+#endif
 #endif /* #if !defined(NO_FILE_SYSTEM) */
 
 static CubicHermite1D* akimaSpline1DInit(_In_ const double* table, size_t nRow,
@@ -713,28 +775,15 @@ void ModelicaStandardTables_CombiTimeTable_close(void* _tableID) {
     if (tableID != NULL) {
         if (tableID->table != NULL && tableID->source == TABLESOURCE_FILE) {
 #if defined(TABLE_SHARE) && !defined(NO_FILE_SYSTEM)
+            /* Release the spline first since it is shared by table address */
+            if (releaseSpline(tableID->spline, (const double*)tableID->table,
+                tableID->nRow, tableID->nCol, (const int*)tableID->cols,
+                tableID->nCols, 1, tableID->smoothness)) {
+                tableID->spline = NULL;
+            }
             if (tableID->tableName != NULL && tableID->fileName != NULL) {
-                char* key = malloc((strlen(tableID->tableName) +
-                    strlen(tableID->fileName) + 2)*sizeof(char));
-                if (key != NULL) {
-                    TableShare *iter;
-                    strcpy(key, tableID->tableName);
-                    strcat(key, "|");
-                    strcat(key, tableID->fileName);
-                    MUTEX_LOCK();
-                    HASH_FIND_STR(tableShare, key, iter);
-                    if (iter != NULL) {
-                        /* Share hit */
-                        if (--iter->refCount == 0) {
-                            free(iter->table);
-                            free(iter->key);
-                            HASH_DEL(tableShare, iter);
-                            free(iter);
-                        }
-                    }
-                    MUTEX_UNLOCK();
-                    free(key);
-                }
+                releaseTable(tableID->tableName, tableID->fileName,
+                    tableID->table);
             }
             else {
                 /* Should not be possible to get here */
@@ -1563,7 +1612,18 @@ double ModelicaStandardTables_CombiTimeTable_read(void* _tableID, int force,
     CombiTimeTable* tableID = (CombiTimeTable*)_tableID;
     if (tableID != NULL && tableID->source == TABLESOURCE_FILE) {
         if (force || tableID->table == NULL) {
-#if !defined(TABLE_SHARE)
+#if defined(TABLE_SHARE)
+            if (releaseSpline(tableID->spline, (const double*)tableID->table,
+                tableID->nRow, tableID->nCol, (const int*)tableID->cols,
+                tableID->nCols, 1, tableID->smoothness)) {
+                tableID->spline = NULL;
+            }
+            if (tableID->table != NULL) {
+                releaseTable(tableID->tableName, tableID->fileName,
+                    tableID->table);
+                tableID->table = NULL;
+            }
+#else
             if (tableID->table != NULL) {
                 free(tableID->table);
             }
@@ -1584,6 +1644,24 @@ double ModelicaStandardTables_CombiTimeTable_read(void* _tableID, int force,
                     tableID->smoothness = LINEAR_SEGMENTS;
                 }
             }
+#if defined(TABLE_SHARE)
+            if (tableID->smoothness == AKIMA_C1 ||
+                tableID->smoothness == FRITSCH_BUTLAND_MONOTONE_C1 ||
+                tableID->smoothness == STEFFEN_MONOTONE_C1) {
+                /* Reinitialization of the shared cubic Hermite spline
+                   coefficients
+                */
+                spline1DClose(&tableID->spline);
+                tableID->spline = (CubicHermite1D*)acquireSpline(
+                    (const double*)tableID->table, tableID->nRow,
+                    tableID->nCol, (const int*)tableID->cols, tableID->nCols,
+                    1, tableID->smoothness);
+                if (tableID->spline == NULL) {
+                    ModelicaError("Memory allocation error\n");
+                    return 0.; /* Error */
+                }
+            }
+#else
             if (tableID->smoothness == AKIMA_C1) {
                 /* Reinitialization of the cubic Hermite spline coefficients */
                 spline1DClose(&tableID->spline);
@@ -1617,6 +1695,7 @@ double ModelicaStandardTables_CombiTimeTable_read(void* _tableID, int force,
                     return 0.; /* Error */
                 }
             }
+#endif
         }
     }
 #endif
@@ -1870,28 +1949,15 @@ void ModelicaStandardTables_CombiTable1D_close(void* _tableID) {
     if (tableID != NULL) {
         if (tableID->table != NULL && tableID->source == TABLESOURCE_FILE) {
 #if defined(TABLE_SHARE) && !defined(NO_FILE_SYSTEM)
+            /* Release the spline first since it is shared by table address */
+            if (releaseSpline(tableID->spline, (const double*)tableID->table,
+                tableID->nRow, tableID->nCol, (const int*)tableID->cols,
+                tableID->nCols, 1, tableID->smoothness)) {
+                tableID->spline = NULL;
+            }
             if (tableID->tableName != NULL && tableID->fileName != NULL) {
-                char* key = malloc((strlen(tableID->tableName) +
-                    strlen(tableID->fileName) + 2)*sizeof(char));
-                if (key != NULL) {
-                    TableShare *iter;
-                    strcpy(key, tableID->tableName);
-                    strcat(key, "|");
-                    strcat(key, tableID->fileName);
-                    MUTEX_LOCK();
-                    HASH_FIND_STR(tableShare, key, iter);
-                    if (iter != NULL) {
-                        /* Share hit */
-                        if (--iter->refCount == 0) {
-                            free(iter->table);
-                            free(iter->key);
-                            HASH_DEL(tableShare, iter);
-                            free(iter);
-                        }
-                    }
-                    MUTEX_UNLOCK();
-                    free(key);
-                }
+                releaseTable(tableID->tableName, tableID->fileName,
+                    tableID->table);
             }
             else {
                 /* Should not be possible to get here */
@@ -2080,13 +2146,232 @@ double ModelicaStandardTables_CombiTable1D_getDerValue(void* _tableID, int iCol,
     return der_y;
 }
 
+void ModelicaStandardTables_CombiTable1D_getValues(void* _tableID, double u,
+                                                   double* y, size_t ny) {
+    CombiTable1D* tableID = (CombiTable1D*)_tableID;
+    size_t i;
+    for (i = 0; i < ny; i++) {
+        y[i] = 0.;
+    }
+    if (tableID != NULL && tableID->table != NULL && tableID->cols != NULL) {
+        const double* table = tableID->table;
+        const size_t nRow = tableID->nRow;
+        const size_t nCol = tableID->nCol;
+        const int* cols = tableID->cols;
+
+        if (ny > tableID->nCols) {
+            ModelicaFormatError("Requested %lu columns of table \"%s\" "
+                "but only %lu columns are interpolated\n", (unsigned long)ny,
+                tableID->tableName, (unsigned long)tableID->nCols);
+            return;
+        }
+
+        if (nRow == 1) {
+            /* Single row */
+            for (i = 0; i < ny; i++) {
+                y[i] = TABLE_ROW0((size_t)cols[i] - 1);
+            }
+        }
+        else {
+            enum PointInterval extrapolate = IN_TABLE;
+            size_t last;
+
+            /* One interval search for all columns */
+            if (u < TABLE_ROW0(0)) {
+                extrapolate = LEFT;
+                last = 0;
+            }
+            else if (u > TABLE_COL0(nRow - 1)) {
+                extrapolate = RIGHT;
+                last = nRow - 2;
+            }
+            else {
+                last = findRowIndex(table, nRow, nCol, tableID->last, u);
+                tableID->last = last;
+            }
+
+            switch (tableID->smoothness) {
+                case CONSTANT_SEGMENTS:
+                    if (extrapolate == IN_TABLE) {
+                        const double* row;
+                        if (u >= TABLE_COL0(last + 1)) {
+                            last += 1;
+                        }
+                        row = &TABLE(last, 0);
+                        for (i = 0; i < ny; i++) {
+                            y[i] = row[cols[i] - 1];
+                        }
+                        break;
+                    }
+                    /* Fall through - linear extrapolation */
+                case LINEAR_SEGMENTS: {
+                    const double u0 = TABLE_COL0(last);
+                    const double du = u - u0;
+                    const double dx = TABLE_COL0(last + 1) - u0;
+                    const double* row0 = &TABLE(last, 0);
+                    const double* row1 = &TABLE(last + 1, 0);
+                    for (i = 0; i < ny; i++) {
+                        const size_t col = (size_t)cols[i] - 1;
+                        y[i] = row0[col] + (row1[col] - row0[col])*du/dx;
+                    }
+                    break;
+                }
+
+                case AKIMA_C1:
+                case FRITSCH_BUTLAND_MONOTONE_C1:
+                case STEFFEN_MONOTONE_C1:
+                    if (tableID->spline != NULL) {
+                        /* The coefficients of all columns are stored
+                           contiguously for each interval */
+                        CubicHermite1D* c = &tableID->spline[
+                            IDX(last, 0, tableID->nCols)];
+                        const double u0 = TABLE_COL0(last);
+                        if (extrapolate == IN_TABLE) {
+                            const double v = u - u0;
+                            const double* row = &TABLE(last, 0);
+                            for (i = 0; i < ny; i++) {
+                                y[i] = row[cols[i] - 1] +
+                                    ((c[i][0]*v + c[i][1])*v + c[i][2])*v;
+                            }
+                        }
+                        else if (extrapolate == LEFT) {
+                            const double* row = &TABLE(last, 0);
+                            for (i = 0; i < ny; i++) {
+                                y[i] = LINEAR_SLOPE(row[cols[i] - 1], c[i][2], u - u0);
+                            }
+                        }
+                        else /* if (extrapolate == RIGHT) */ {
+                            const double u1 = TABLE_COL0(last + 1);
+                            const double v = u1 - u0;
+                            const double* row = &TABLE(last + 1, 0);
+                            for (i = 0; i < ny; i++) {
+                                y[i] = LINEAR_SLOPE(row[cols[i] - 1],
+                                    (3*c[i][0]*v + 2*c[i][1])*v + c[i][2], u - u1);
+                            }
+                        }
+                    }
+                    break;
+
+                default:
+                    ModelicaError("Unknown smoothness kind\n");
+                    return;
+            }
+        }
+    }
+}
+
+void ModelicaStandardTables_CombiTable1D_getDerValues(void* _tableID, double u,
+                                                      double der_u,
+                                                      double* der_y, size_t ny) {
+    CombiTable1D* tableID = (CombiTable1D*)_tableID;
+    size_t i;
+    for (i = 0; i < ny; i++) {
+        der_y[i] = 0.;
+    }
+    if (tableID != NULL && tableID->table != NULL && tableID->cols != NULL) {
+        const double* table = tableID->table;
+        const size_t nRow = tableID->nRow;
+        const size_t nCol = tableID->nCol;
+        const int* cols = tableID->cols;
+
+        if (ny > tableID->nCols) {
+            ModelicaFormatError("Requested %lu columns of table \"%s\" "
+                "but only %lu columns are interpolated\n", (unsigned long)ny,
+                tableID->tableName, (unsigned long)tableID->nCols);
+            return;
+        }
+
+        if (nRow > 1) {
+            enum PointInterval extrapolate = IN_TABLE;
+            size_t last;
+
+            /* One interval search for all columns */
+            if (u < TABLE_ROW0(0)) {
+                extrapolate = LEFT;
+                last = 0;
+            }
+            else if (u > TABLE_COL0(nRow - 1)) {
+                extrapolate = RIGHT;
+                last = nRow - 2;
+            }
+            else {
+                last = findRowIndex(table, nRow, nCol, tableID->last, u);
+                tableID->last = last;
+            }
+
+            switch (tableID->smoothness) {
+                case CONSTANT_SEGMENTS:
+                    if (extrapolate == IN_TABLE) {
+                        break;
+                    }
+                    /* Fall through - linear extrapolation */
+                case LINEAR_SEGMENTS: {
+                    const double dx = TABLE_COL0(last + 1) - TABLE_COL0(last);
+                    const double* row0 = &TABLE(last, 0);
+                    const double* row1 = &TABLE(last + 1, 0);
+                    for (i = 0; i < ny; i++) {
+                        const size_t col = (size_t)cols[i] - 1;
+                        der_y[i] = (row1[col] - row0[col])/dx;
+                        der_y[i] *= der_u;
+                    }
+                    break;
+                }
+
+                case AKIMA_C1:
+                case FRITSCH_BUTLAND_MONOTONE_C1:
+                case STEFFEN_MONOTONE_C1:
+                    if (tableID->spline != NULL) {
+                        CubicHermite1D* c = &tableID->spline[
+                            IDX(last, 0, tableID->nCols)];
+                        if (extrapolate == IN_TABLE) {
+                            const double v = u - TABLE_COL0(last);
+                            for (i = 0; i < ny; i++) {
+                                der_y[i] = (3*c[i][0]*v + 2*c[i][1])*v + c[i][2];
+                                der_y[i] *= der_u;
+                            }
+                        }
+                        else if (extrapolate == LEFT) {
+                            for (i = 0; i < ny; i++) {
+                                der_y[i] = c[i][2]*der_u;
+                            }
+                        }
+                        else /* if (extrapolate == RIGHT) */ {
+                            const double v = TABLE_COL0(last + 1) -
+                                TABLE_COL0(last);
+                            for (i = 0; i < ny; i++) {
+                                der_y[i] = (3*c[i][0]*v + 2*c[i][1])*v + c[i][2];
+                                der_y[i] *= der_u;
+                            }
+                        }
+                    }
+                    break;
+
+                default:
+                    ModelicaError("Unknown smoothness kind\n");
+                    return;
+            }
+        }
+    }
+}
+
 double ModelicaStandardTables_CombiTable1D_read(void* _tableID, int force,
                                                 int verbose) {
 #if !defined(NO_FILE_SYSTEM)
     CombiTable1D* tableID = (CombiTable1D*)_tableID;
     if (tableID != NULL && tableID->source == TABLESOURCE_FILE) {
         if (force || tableID->table == NULL) {
-#if !defined(TABLE_SHARE)
+#if defined(TABLE_SHARE)
+            if (releaseSpline(tableID->spline, (const double*)tableID->table,
+                tableID->nRow, tableID->nCol, (const int*)tableID->cols,
+                tableID->nCols, 1, tableID->smoothness)) {
+                tableID->spline = NULL;
+            }
+            if (tableID->table != NULL) {
+                releaseTable(tableID->tableName, tableID->fileName,
+                    tableID->table);
+                tableID->table = NULL;
+            }
+#else
             if (tableID->table != NULL) {
                 free(tableID->table);
             }
@@ -2107,6 +2392,24 @@ double ModelicaStandardTables_CombiTable1D_read(void* _tableID, int force,
                     tableID->smoothness = LINEAR_SEGMENTS;
                 }
             }
+#if defined(TABLE_SHARE)
+            if (tableID->smoothness == AKIMA_C1 ||
+                tableID->smoothness == FRITSCH_BUTLAND_MONOTONE_C1 ||
+                tableID->smoothness == STEFFEN_MONOTONE_C1) {
+                /* Reinitialization of the shared cubic Hermite spline
+                   coefficients
+                */
+                spline1DClose(&tableID->spline);
+                tableID->spline = (CubicHermite1D*)acquireSpline(
+                    (const double*)tableID->table, tableID->nRow,
+                    tableID->nCol, (const int*)tableID->cols, tableID->nCols,
+                    1, tableID->smoothness);
+                if (tableID->spline == NULL) {
+                    ModelicaError("Memory allocation error\n");
+                    return 0.; /* Error */
+                }
+            }
+#else
             if (tableID->smoothness == AKIMA_C1) {
                 /* Reinitialization of the cubic Hermite spline coefficients */
                 spline1DClose(&tableID->spline);
@@ -2140,6 +2443,7 @@ double ModelicaStandardTables_CombiTable1D_read(void* _tableID, int force,
                     return 0.; /* Error */
                 }
             }
+#endif
         }
     }
 #endif
@@ -2288,28 +2592,15 @@ void ModelicaStandardTables_CombiTable2D_close(void* _tableID) {
     if (tableID != NULL) {
         if (tableID->table != NULL && tableID->source == TABLESOURCE_FILE) {
 #if defined(TABLE_SHARE) && !defined(NO_FILE_SYSTEM)
+            /* Release the spline first since it is shared by table address */
+            if (releaseSpline(tableID->spline, (const double*)tableID->table,
+                tableID->nRow, tableID->nCol, NULL, 0, 2,
+                tableID->smoothness)) {
+                tableID->spline = NULL;
+            }
             if (tableID->tableName != NULL && tableID->fileName != NULL) {
-                char* key = malloc((strlen(tableID->tableName) +
-                    strlen(tableID->fileName) + 2)*sizeof(char));
-                if (key != NULL) {
-                    TableShare *iter;
-                    strcpy(key, tableID->tableName);
-                    strcat(key, "|");
-                    strcat(key, tableID->fileName);
-                    MUTEX_LOCK();
-                    HASH_FIND_STR(tableShare, key, iter);
-                    if (iter != NULL) {
-                        /* Share hit */
-                        if (--iter->refCount == 0) {
-                            free(iter->table);
-                            free(iter->key);
-                            HASH_DEL(tableShare, iter);
-                            free(iter);
-                        }
-                    }
-                    MUTEX_UNLOCK();
-                    free(key);
-                }
+                releaseTable(tableID->tableName, tableID->fileName,
+                    tableID->table);
             }
             else {
                 /* Should not be possible to get here */
@@ -2347,7 +2638,18 @@ double ModelicaStandardTables_CombiTable2D_read(void* _tableID, int force,
     CombiTable2D* tableID = (CombiTable2D*)_tableID;
     if (tableID != NULL && tableID->source == TABLESOURCE_FILE) {
         if (force || tableID->table == NULL) {
-#if !defined(TABLE_SHARE)
+#if defined(TABLE_SHARE)
+            if (releaseSpline(tableID->spline, (const double*)tableID->table,
+                tableID->nRow, tableID->nCol, NULL, 0, 2,
+                tableID->smoothness)) {
+                tableID->spline = NULL;
+            }
+            if (tableID->table != NULL) {
+                releaseTable(tableID->tableName, tableID->fileName,
+                    tableID->table);
+                tableID->table = NULL;
+            }
+#else
             if (tableID->table != NULL) {
                 free(tableID->table);
             }
@@ -2368,8 +2670,14 @@ double ModelicaStandardTables_CombiTable2D_read(void* _tableID, int force,
             if (tableID->smoothness == AKIMA_C1) {
                 /* Reinitialization of the Akima-spline coefficients */
                 spline2DClose(&tableID->spline);
+#if defined(TABLE_SHARE)
+                tableID->spline = (CubicHermite2D*)acquireSpline(
+                    (const double*)tableID->table, tableID->nRow,
+                    tableID->nCol, NULL, 0, 2, tableID->smoothness);
+#else
                 tableID->spline = spline2DInit(tableID->table, tableID->nRow,
                     tableID->nCol);
+#endif
                 if (tableID->spline == NULL) {
                     ModelicaError("Memory allocation error\n");
                     return 0.; /* Error */
@@ -4131,14 +4439,14 @@ static double* readTable(const char* tableName, const char* fileName,
         char* key = malloc((strlen(tableName) +
             strlen(fileName) + 2)*sizeof(char));
         if (key != NULL) {
-            int updateError = 0;
+            const time_t mtime = fileModificationTime(fileName);
             TableShare *iter;
             strcpy(key, tableName);
             strcat(key, "|");
             strcat(key, fileName);
             MUTEX_LOCK();
             HASH_FIND_STR(tableShare, key, iter);
-            if (iter == NULL || force) {
+            if (iter == NULL || force || iter->mtime != mtime) {
 #endif
                 const char* ext;
                 int isMatExt = 0;
@@ -4190,26 +4498,20 @@ static double* readTable(const char* tableName, const char* fileName,
                     iter->nRow = *nRow;
                     iter->nCol = *nCol;
                     iter->table = table;
+                    iter->mtime = mtime;
                     HASH_ADD_KEYPTR(hh, tableShare, key, strlen(key), iter);
                 }
                 else {
                     free(key);
                 }
             }
-            else if (force) {
-                /* Share hit -> Update table share (only if not shared
-                   by multiple table objects)
+            else if (force || iter->mtime != mtime) {
+                /* Share hit with forced read or modified file -> Keep the
+                   newly read table private, the table objects still
+                   referencing the shared table are not affected. The
+                   private table is freed by releaseTable.
                 */
                 free(key);
-                if (iter->refCount == 1) {
-                    free(iter->table);
-                    iter->nRow = *nRow;
-                    iter->nCol = *nCol;
-                    iter->table = table;
-                }
-                else {
-                    updateError = 1;
-                }
             }
             else {
                 /* Share hit -> Read from table share and increment table
@@ -4225,17 +4527,171 @@ static double* readTable(const char* tableName, const char* fileName,
                 *nCol = iter->nCol;
             }
             MUTEX_UNLOCK();
-            if (updateError == 1) {
-                ModelicaFormatError("Not possible to update shared "
-                    "table \"%s\" from \"%s\": File and table name "
-                    "must be unique.\n", tableName, fileName);
-            }
         }
 #endif
     }
     return table;
 }
 
+#if defined(TABLE_SHARE)
+static time_t fileModificationTime(const char* fileName) {
+    struct stat fileStat;
+    if (stat(fileName, &fileStat) == 0) {
+        return fileStat.st_mtime;
+    }
+    return 0;
+}
+
+static void releaseTable(const char* tableName, const char* fileName,
+                         double* table) {
+    char* key = malloc((strlen(tableName) +
+        strlen(fileName) + 2)*sizeof(char));
+    if (key != NULL) {
+        int shared = 0;
+        TableShare *iter;
+        strcpy(key, tableName);
+        strcat(key, "|");
+        strcat(key, fileName);
+        MUTEX_LOCK();
+        HASH_FIND_STR(tableShare, key, iter);
+        if (iter != NULL && iter->table == table) {
+            /* Share hit */
+            shared = 1;
+            if (--iter->refCount == 0) {
+                free(iter->table);
+                free(iter->key);
+                HASH_DEL(tableShare, iter);
+                free(iter);
+            }
+        }
+        MUTEX_UNLOCK();
+        free(key);
+        if (shared == 0) {
+            /* Private table of a forced read or a modified file */
+            free(table);
+        }
+    }
+}
+
+static void* acquireSpline(const double* table, size_t nRow, size_t nCol,
+                           const int* cols, size_t nCols, int dim,
+                           enum Smoothness smoothness) {
+    void* spline = NULL;
+    SplineShare *iter;
+    size_t keyLen;
+    char* key = splineKey(table, nRow, nCol, cols, nCols, dim, smoothness,
+        &keyLen);
+    if (key != NULL) {
+        MUTEX_LOCK();
+        HASH_FIND(hh, splineShare, key, keyLen, iter);
+        if (iter != NULL) {
+            /* Share hit -> Increment spline reference counter */
+            iter->refCount++;
+            spline = iter->spline;
+            MUTEX_UNLOCK();
+            free(key);
+            return spline;
+        }
+        MUTEX_UNLOCK();
+    }
+
+    /* Share miss -> Calculate coefficients without holding the lock */
+    if (dim == 2) {
+        spline = spline2DInit(table, nRow, nCol);
+    }
+    else if (smoothness == AKIMA_C1) {
+        spline = akimaSpline1DInit(table, nRow, nCol, cols, nCols);
+    }
+    else if (smoothness == FRITSCH_BUTLAND_MONOTONE_C1) {
+        spline = fritschButlandSpline1DInit(table, nRow, nCol, cols, nCols);
+    }
+    else if (smoothness == STEFFEN_MONOTONE_C1) {
+        spline = steffenSpline1DInit(table, nRow, nCol, cols, nCols);
+    }
+    if (spline == NULL || key == NULL) {
+        /* Error or private coefficients */
+        free(key);
+        return spline;
+    }
+
+    /* Again ask for lock and search in hash spline share */
+    MUTEX_LOCK();
+    HASH_FIND(hh, splineShare, key, keyLen, iter);
+    if (iter == NULL) {
+        /* Insert new coefficients */
+        iter = (SplineShare*)malloc(sizeof(SplineShare));
+        if (iter != NULL) {
+            iter->key = key;
+            iter->refCount = 1;
+            iter->spline = spline;
+            HASH_ADD_KEYPTR(hh, splineShare, key, keyLen, iter);
+        }
+        else {
+            free(key);
+        }
+    }
+    else {
+        /* Inserted by another table object in the meantime */
+        free(key);
+        free(spline);
+        iter->refCount++;
+        spline = iter->spline;
+    }
+    MUTEX_UNLOCK();
+    return spline;
+}
+
+static int releaseSpline(void* spline, const double* table, size_t nRow,
+                         size_t nCol, const int* cols, size_t nCols, int dim,
+                         enum Smoothness smoothness) {
+    int shared = 0;
+    if (spline != NULL) {
+        SplineShare *iter;
+        size_t keyLen;
+        char* key = splineKey(table, nRow, nCol, cols, nCols, dim, smoothness,
+            &keyLen);
+        if (key != NULL) {
+            MUTEX_LOCK();
+            HASH_FIND(hh, splineShare, key, keyLen, iter);
+            if (iter != NULL && iter->spline == spline) {
+                /* Share hit */
+                shared = 1;
+                if (--iter->refCount == 0) {
+                    free(iter->spline);
+                    free(iter->key);
+                    HASH_DEL(splineShare, iter);
+                    free(iter);
+                }
+            }
+            MUTEX_UNLOCK();
+            free(key);
+        }
+    }
+    return shared;
+}
+
+static char* splineKey(const double* table, size_t nRow, size_t nCol,
+                       const int* cols, size_t nCols, int dim,
+                       enum Smoothness smoothness, size_t* keyLen) {
+    char* key;
+    *keyLen = sizeof(SplineKey) + nCols*sizeof(int);
+    /* Zero-initialized since the padding of SplineKey is part of the key */
+    key = (char*)calloc(*keyLen, 1);
+    if (key != NULL) {
+        SplineKey* k = (SplineKey*)key;
+        k->table = table;
+        k->nRow = nRow;
+        k->nCol = nCol;
+        k->dim = dim;
+        k->smoothness = (int)smoothness;
+        if (nCols > 0) {
+            memcpy(key + sizeof(SplineKey), cols, nCols*sizeof(int));
+        }
+    }
+    return key;
+}
+#endif
+
 static double* readMatTable(const char* tableName, const char* fileName,
                             size_t* _nRow, size_t* _nCol) {
     double* table = NULL;
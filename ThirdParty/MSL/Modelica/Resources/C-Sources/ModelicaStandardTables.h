@@ -236,6 +236,29 @@ double ModelicaStandardTables_CombiTable1D_getDerValue(void* tableID, int icol,
      <- RETURN: Derivative of ordinate value
   */
 
+void ModelicaStandardTables_CombiTable1D_getValues(void* tableID, double u,
+                                                   double* y, size_t ny);
+  /* Interpolate the first ny columns in table at the same abscissa value
+
+     -> tableID: Pointer to table defined with ModelicaStandardTables_CombiTable1D_init
+     -> u: Abscissa value
+     <- y: Ordinate values
+     -> ny: Number of columns to interpolate
+  */
+
+void ModelicaStandardTables_CombiTable1D_getDerValues(void* tableID, double u,
+                                                      double der_u,
+                                                      double* der_y,
+                                                      size_t ny);
+  /* Interpolated derivatives of the first ny columns in table
+
+     -> tableID: Pointer to table defined with ModelicaStandardTables_CombiTable1D_init
+     -> u: Abscissa value
+     -> der_u: Derivative of abscissa value
+     <- der_y: Derivatives of ordinate values
+     -> ny: Number of columns to interpolate
+  */
+
 void* ModelicaStandardTables_CombiTable2D_init(_In_z_ const char* tableName,
                                                _In_z_ const char* fileName,
                                                _In_ double* table, size_t nRow,
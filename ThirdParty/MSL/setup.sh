@@ -22,3 +22,5 @@ patch -i ActuatorWithNoiseStateSelect.patch -p0
 patch -i modelicaRandomMutex.patch -p0
 patch -i visualstudio2015.patch -p0
 patch -i dynamicSelect.patch -p0
+patch -i combiTable1DsBatch.patch -p0
+patch -i tableShare.patch -p0
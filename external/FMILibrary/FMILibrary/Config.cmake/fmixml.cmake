@@ -105,6 +105,7 @@ set(FMIXMLHEADERS
 
     include/FMI2/fmi2_xml_model_description.h
     src/FMI2/fmi2_xml_model_description_impl.h
+    src/FMI2/fmi2_xml_model_description_cache.h
     include/FMI2/fmi2_xml_model_structure.h
     src/FMI2/fmi2_xml_model_structure_impl.h
     src/FMI2/fmi2_xml_parser.h
@@ -130,6 +131,7 @@ set(FMIXMLSOURCE
 
     src/FMI2/fmi2_xml_parser.c
     src/FMI2/fmi2_xml_model_description.c
+    src/FMI2/fmi2_xml_model_description_cache.c
     src/FMI2/fmi2_xml_model_structure.c
     src/FMI2/fmi2_xml_type.c
     src/FMI2/fmi2_xml_unit.c
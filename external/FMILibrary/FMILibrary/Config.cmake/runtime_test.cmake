@@ -124,6 +124,9 @@ target_link_libraries (fmi_zip_zip_test ${FMIZIP_LIBRARIES})
 add_executable (fmi_zip_unzip_test ${RTTESTDIR}/FMI1/fmi_zip_unzip_test.c )
 target_link_libraries (fmi_zip_unzip_test ${FMIZIP_LIBRARIES})
 
+add_executable (fmi_zip_unzip_cache_test ${RTTESTDIR}/FMI1/fmi_zip_unzip_cache_test.c )
+target_link_libraries (fmi_zip_unzip_cache_test ${FMIZIP_LIBRARIES})
+
 add_executable (fmi_import_test 
 					${RTTESTDIR}/fmi_import_test.c
 					${RTTESTDIR}/FMI1/fmi1_import_test.c
@@ -133,6 +136,7 @@ target_link_libraries (fmi_import_test  ${FMILIBFORTEST})
 set_target_properties(
 	fmi_zip_zip_test   
 	fmi_zip_unzip_test
+	fmi_zip_unzip_cache_test
 	fmi_import_test
     PROPERTIES FOLDER "Test")
 # include CTest gives more options (such as running valgrind automatically)
@@ -154,6 +158,7 @@ if(FMILIB_BUILD_BEFORE_TESTS)
 endif()
 
 ADD_TEST(ctest_fmi_zip_unzip_test fmi_zip_unzip_test)
+ADD_TEST(ctest_fmi_zip_unzip_cache_test fmi_zip_unzip_cache_test)
 ADD_TEST(ctest_fmi_zip_zip_test fmi_zip_zip_test)
 
 include(test_fmi1)
@@ -174,6 +179,7 @@ if(FMILIB_BUILD_BEFORE_TESTS)
 		ctest_fmi_import_test_me_2
 		ctest_fmi_import_test_cs_2
 		ctest_fmi_zip_unzip_test
+		ctest_fmi_zip_unzip_cache_test
 		ctest_fmi_zip_zip_test
 		PROPERTIES DEPENDS ctest_build_all)
 endif()
@@ -46,6 +46,10 @@ set(VARIABLE_NO_TYPE_MODEL_DESC_DIR
     ${RTTESTDIR}/FMI2/parser_test_xmls/variable_no_type)
 set(VARIABLE_BAD_VARIABILITY_CAUSALITY_MODEL_DESC_DIR
     ${RTTESTDIR}/FMI2/parser_test_xmls/variable_bad_variability_causality)
+set(VARIABLE_ALIAS_MODEL_DESC_DIR
+    ${RTTESTDIR}/FMI2/parser_test_xmls/variable_alias)
+set(DEPENDENCIES_MODEL_DESC_DIR
+    ${RTTESTDIR}/FMI2/parser_test_xmls/dependencies)
 
 set(SHARED_LIBRARY_ME_PATH ${CMAKE_CURRENT_BINARY_DIR}/${CMAKE_CFG_INTDIR}/${CMAKE_SHARED_LIBRARY_PREFIX}fmu2_dll_me${CMAKE_SHARED_LIBRARY_SUFFIX})
 set(SHARED_LIBRARY_CS_PATH ${CMAKE_CURRENT_BINARY_DIR}/${CMAKE_CFG_INTDIR}/${CMAKE_SHARED_LIBRARY_PREFIX}fmu2_dll_cs${CMAKE_SHARED_LIBRARY_SUFFIX})
@@ -85,8 +89,14 @@ target_link_libraries(fmi2_variable_no_type_test ${FMILIBFORTEST})
 add_executable(fmi2_variable_bad_variability_causality_test
                ${RTTESTDIR}/FMI2/fmi2_variable_bad_variability_causality_test.c)
 target_link_libraries(fmi2_variable_bad_variability_causality_test ${FMILIBFORTEST})
+add_executable(fmi2_variable_alias_test ${RTTESTDIR}/FMI2/fmi2_variable_alias_test.c)
+target_link_libraries(fmi2_variable_alias_test ${FMILIBFORTEST})
+add_executable(fmi2_dependencies_test ${RTTESTDIR}/FMI2/fmi2_dependencies_test.c)
+target_link_libraries(fmi2_dependencies_test ${FMILIBFORTEST})
 add_executable(fmi2_enum_test ${RTTESTDIR}/FMI2/fmi2_enum_test.c)
 target_link_libraries(fmi2_enum_test ${FMILIBFORTEST})
+add_executable(fmi2_xml_cache_test ${RTTESTDIR}/FMI2/fmi2_xml_cache_test.c)
+target_link_libraries(fmi2_xml_cache_test ${FMILIBFORTEST})
 
 set_target_properties(
     fmi2_xml_parsing_test
@@ -116,8 +126,20 @@ add_test(ctest_fmi2_variable_no_type_test
 add_test(ctest_fmi2_variable_bad_variability_causality_test
          fmi2_variable_bad_variability_causality_test
          ${VARIABLE_BAD_VARIABILITY_CAUSALITY_MODEL_DESC_DIR})
+add_test(ctest_fmi2_variable_alias_test
+         fmi2_variable_alias_test
+         ${VARIABLE_ALIAS_MODEL_DESC_DIR})
+add_test(ctest_fmi2_dependencies_test
+         fmi2_dependencies_test
+         ${DEPENDENCIES_MODEL_DESC_DIR})
 add_test(ctest_fmi2_enum_test
          fmi2_enum_test)
+add_test(ctest_fmi2_xml_cache_test
+         fmi2_xml_cache_test
+         ${VARIALBE_TEST_MODEL_DESC_DIR})
+add_test(ctest_fmi2_xml_cache_test_dummy
+         fmi2_xml_cache_test
+         ${FMU2_DUMMY_FOLDER})
 
 if(FMILIB_BUILD_BEFORE_TESTS)
     SET_TESTS_PROPERTIES (
@@ -131,6 +153,10 @@ if(FMILIB_BUILD_BEFORE_TESTS)
         ctest_fmi2_import_variable_test
         ctest_fmi2_variable_no_type_test
         ctest_fmi2_enum_test
+        ctest_fmi2_xml_cache_test
+        ctest_fmi2_xml_cache_test_dummy
         ctest_fmi2_variable_bad_variability_causality_test
+        ctest_fmi2_variable_alias_test
+        ctest_fmi2_dependencies_test
         PROPERTIES DEPENDS ctest_build_all)
 endif()
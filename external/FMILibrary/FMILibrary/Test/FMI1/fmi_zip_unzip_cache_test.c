@@ -0,0 +1,249 @@
+/*
+    Copyright (C) 2017 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zip.h>
+
+#include <JM/jm_types.h>
+#include <JM/jm_callbacks.h>
+#include <JM/jm_portability.h>
+#include <FMI/fmi_zip_unzip.h>
+#include "config_test.h"
+
+#define PATH_SIZE 4096
+
+/* Number and length of the directories in the entry name that is longer than 1024 characters */
+#define LONG_NAME_DIRS 11
+#define LONG_NAME_DIR_LEN 100
+
+static char work_dir[PATH_SIZE];
+static char long_name[LONG_NAME_DIRS * (LONG_NAME_DIR_LEN + 1) + 32];
+
+void do_exit(int code)
+{
+	if (work_dir[0]) {
+		jm_rmdir(jm_get_default_callbacks(), work_dir);
+	}
+	exit(code);
+}
+
+static void assert_true(int should_be_true, const char* message)
+{
+	if (!should_be_true) {
+		printf("%s\n", message);
+		do_exit(CTEST_RETURN_FAIL);
+	}
+}
+
+/* Logger function */
+void importlogger(jm_callbacks* c, jm_string module, jm_log_level_enu_t log_level, jm_string message)
+{
+	printf("module = %s, log level = %d: %s\n", module, log_level, message);
+}
+
+static void write_file(const char* path, const char* content)
+{
+	FILE* f = fopen(path, "wb");
+	assert_true(f != NULL, "Could not create a test file");
+	fwrite(content, 1, strlen(content), f);
+	fclose(f);
+}
+
+/* Returns 1 if the file at dir/name exists and has the given content */
+static int has_content(const char* dir, const char* name, const char* content)
+{
+	char path[PATH_SIZE];
+	char buf[64];
+	size_t n;
+	FILE* f;
+
+	jm_snprintf(path, sizeof(path), "%s/%s", dir, name);
+	f = fopen(path, "rb");
+	if (f == NULL) {
+		return 0;
+	}
+	n = fread(buf, 1, sizeof(buf) - 1, f);
+	fclose(f);
+	buf[n] = 0;
+	return strcmp(buf, content) == 0;
+}
+
+static int exists(const char* dir, const char* name)
+{
+	char path[PATH_SIZE];
+	FILE* f;
+
+	jm_snprintf(path, sizeof(path), "%s/%s", dir, name);
+	f = fopen(path, "rb");
+	if (f != NULL) {
+		fclose(f);
+	}
+	return f != NULL;
+}
+
+static void add_entry(zipFile zf, const char* name, const char* content)
+{
+	assert_true(zipOpenNewFileInZip(zf, name, NULL, NULL, 0, NULL, 0, NULL, Z_DEFLATED, Z_DEFAULT_COMPRESSION) == ZIP_OK,
+		"Could not add an entry to the test zip file");
+	assert_true(zipWriteInFileInZip(zf, content, (unsigned int)strlen(content)) == ZIP_OK,
+		"Could not write an entry of the test zip file");
+	assert_true(zipCloseFileInZip(zf) == ZIP_OK, "Could not close an entry of the test zip file");
+}
+
+/* Writes a zip file laid out as an FMU, with an entry outside of the output folder and an entry with a long name */
+static void create_zip(const char* path)
+{
+	zipFile zf;
+	char* p;
+	int i;
+
+	strcpy(long_name, "resources/");
+	p = long_name + strlen(long_name);
+	for (i = 0; i < LONG_NAME_DIRS; i++) {
+		memset(p, 'd', LONG_NAME_DIR_LEN);
+		p[LONG_NAME_DIR_LEN] = '/';
+		p += LONG_NAME_DIR_LEN + 1;
+	}
+	strcpy(p, "long.txt");
+	assert_true(strlen(long_name) > 1024, "The long entry name is too short");
+
+	zf = zipOpen64(path, APPEND_STATUS_CREATE);
+	assert_true(zf != NULL, "Could not create the test zip file");
+	add_entry(zf, "modelDescription.xml", "md");
+	add_entry(zf, "binaries/plat/a.txt", "a");
+	add_entry(zf, "sources/b.c", "b");
+	add_entry(zf, "../escape.txt", "escape");
+	add_entry(zf, long_name, "long");
+	assert_true(zipClose(zf, NULL) == ZIP_OK, "Could not close the test zip file");
+}
+
+/* The key without prefixes is the SHA-256 of the file, the second message needs two blocks of padding */
+static void test_content_key(jm_callbacks* callbacks)
+{
+	const char* prefixes[] = {"binaries/"};
+	char path[PATH_SIZE];
+	char key[FMI_ZIP_CONTENT_KEY_SIZE];
+	char key_prefixes[FMI_ZIP_CONTENT_KEY_SIZE];
+
+	jm_snprintf(path, sizeof(path), "%s/abc", work_dir);
+	write_file(path, "abc");
+	assert_true(fmi_zip_get_content_key(path, 0, NULL, key, sizeof(key), callbacks) == jm_status_success,
+		"Failed to compute the content key");
+	assert_true(strcmp(key, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad") == 0,
+		"Unexpected content key of \"abc\"");
+
+	write_file(path, "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+	assert_true(fmi_zip_get_content_key(path, 0, NULL, key, sizeof(key), callbacks) == jm_status_success,
+		"Failed to compute the content key");
+	assert_true(strcmp(key, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1") == 0,
+		"Unexpected content key of a 56 byte file");
+
+	assert_true(fmi_zip_get_content_key(path, 1, prefixes, key_prefixes, sizeof(key_prefixes), callbacks) == jm_status_success,
+		"Failed to compute the content key");
+	assert_true(strcmp(key, key_prefixes) != 0, "The prefixes do not change the content key");
+
+	assert_true(fmi_zip_get_content_key(path, 0, NULL, key, FMI_ZIP_CONTENT_KEY_SIZE - 1, callbacks) == jm_status_error,
+		"A too small key buffer was accepted");
+}
+
+/* Entries that would end up outside of the output folder are skipped, long names are kept */
+static void test_unzip_all(const char* zip_path, jm_callbacks* callbacks)
+{
+	char out_dir[PATH_SIZE];
+
+	jm_snprintf(out_dir, sizeof(out_dir), "%s/out", work_dir);
+	assert_true(jm_mkdir(callbacks, out_dir) == jm_status_success, "Could not create the output folder");
+	assert_true(fmi_zip_unzip_selected(zip_path, out_dir, 0, NULL, callbacks) == jm_status_success,
+		"Failed to uncompress the test zip file");
+
+	assert_true(!exists(work_dir, "escape.txt"), "An entry was written outside of the output folder");
+	assert_true(has_content(out_dir, "modelDescription.xml", "md"), "modelDescription.xml was not extracted");
+	assert_true(has_content(out_dir, "sources/b.c", "b"), "sources/b.c was not extracted");
+	assert_true(has_content(out_dir, long_name, "long"), "The entry with a long name was not extracted intact");
+}
+
+/* Only selected entries go into the cache, and a second call reuses the first extraction */
+static void test_unzip_cached(const char* zip_path, jm_callbacks* callbacks)
+{
+	const char* prefixes[] = {"modelDescription.xml", "binaries/plat/", "resources/"};
+	char cache_dir[PATH_SIZE];
+	char* dir;
+	char* dir_again;
+	char md_path[PATH_SIZE];
+
+	jm_snprintf(cache_dir, sizeof(cache_dir), "%s/cache", work_dir);
+	assert_true(jm_mkdir(callbacks, cache_dir) == jm_status_success, "Could not create the cache folder");
+
+	dir = fmi_zip_unzip_cached(zip_path, cache_dir, 3, prefixes, callbacks);
+	assert_true(dir != NULL, "Failed to uncompress the test zip file into the cache");
+	assert_true(has_content(dir, "modelDescription.xml", "md"), "modelDescription.xml was not extracted into the cache");
+	assert_true(has_content(dir, "binaries/plat/a.txt", "a"), "The binary was not extracted into the cache");
+	assert_true(has_content(dir, long_name, "long"), "The resource with a long name was not extracted into the cache");
+	assert_true(!exists(dir, "sources/b.c"), "An entry that was not selected was extracted");
+	assert_true(!exists(cache_dir, "escape.txt"), "An entry was written outside of the cache entry");
+
+	/* Removing a file shows whether the second call extracts again */
+	jm_snprintf(md_path, sizeof(md_path), "%s/modelDescription.xml", dir);
+	assert_true(remove(md_path) == 0, "Could not remove the cached modelDescription.xml");
+	dir_again = fmi_zip_unzip_cached(zip_path, cache_dir, 3, prefixes, callbacks);
+	assert_true(dir_again != NULL && strcmp(dir, dir_again) == 0, "The cached extraction was not reused");
+	assert_true(!exists(dir_again, "modelDescription.xml"), "The FMU was extracted again on a cache hit");
+	callbacks->free(dir_again);
+
+	/* Another selection is another cache entry */
+	dir_again = fmi_zip_unzip_cached(zip_path, cache_dir, 1, prefixes, callbacks);
+	assert_true(dir_again != NULL && strcmp(dir, dir_again) != 0, "Different selections share a cache entry");
+	assert_true(has_content(dir_again, "modelDescription.xml", "md"), "modelDescription.xml was not extracted into the cache");
+	assert_true(!exists(dir_again, "binaries/plat/a.txt"), "An entry that was not selected was extracted");
+	callbacks->free(dir_again);
+	callbacks->free(dir);
+}
+
+/**
+ * \brief Test of selective extraction, the extraction cache and its content key.
+ *
+ */
+int main(int argc, char *argv[])
+{
+	jm_callbacks callbacks;
+	char zip_path[PATH_SIZE];
+
+	callbacks.malloc = malloc;
+	callbacks.calloc = calloc;
+	callbacks.realloc = realloc;
+	callbacks.free = free;
+	callbacks.logger = importlogger;
+	callbacks.log_level = jm_log_level_verbose;
+	callbacks.context = 0;
+
+	jm_snprintf(work_dir, sizeof(work_dir), "%s/fmi_zip_unzip_cache_test_XXXXXX", UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST);
+	if (jm_mkdtemp(&callbacks, work_dir) == NULL) {
+		work_dir[0] = 0;
+		assert_true(0, "Could not create a temporary directory");
+	}
+	jm_snprintf(zip_path, sizeof(zip_path), "%s/test.fmu", work_dir);
+	create_zip(zip_path);
+
+	test_content_key(&callbacks);
+	test_unzip_all(zip_path, &callbacks);
+	test_unzip_cached(zip_path, &callbacks);
+
+	printf("Selective and cached extraction work\n");
+	do_exit(CTEST_RETURN_SUCCESS);
+	return 0;
+}
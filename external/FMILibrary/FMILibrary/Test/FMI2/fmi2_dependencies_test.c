@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "fmilib.h"
+#include "fmil_test.h"
+#include "config_test.h"
+
+#define PATH_SIZE 4096
+
+static fmi2_import_t *parse_xml(const char *dir, const char *name)
+{
+    char mdpath[PATH_SIZE];
+    fmi2_import_t *parsed;
+    jm_callbacks *cb = jm_get_default_callbacks();
+    fmi_import_context_t *ctx = fmi_import_allocate_context(cb);
+
+    if (ctx == NULL) {
+        return NULL;
+    }
+
+    jm_snprintf(mdpath, sizeof(mdpath), "%s/%s", dir, name);
+    parsed = fmi2_import_parse_xml(ctx, mdpath, NULL);
+    fmi_import_free_context(ctx);
+    return parsed;
+}
+
+/* White space in the lists and signs on the items are accepted, missing lists mean dependence on all */
+static int valid_dependencies_test(const char *dir)
+{
+    size_t startOut[] = {0, 3, 3, 4};
+    size_t depOut[] = {1, 3, 4, 0};
+    char kindOut[] = {fmi2_dependency_factor_kind_dependent, fmi2_dependency_factor_kind_dependent,
+                      fmi2_dependency_factor_kind_fixed, fmi2_dependency_factor_kind_dependent};
+    size_t startDer[] = {0, 2};
+    size_t depDer[] = {1, 3};
+    size_t *start, *dep;
+    char *kind;
+    fmi2_import_t *xml = parse_xml(dir, "valid");
+
+    ASSERT_MSG(xml != NULL, "Parsing of valid dependencies failed");
+
+    fmi2_import_get_outputs_dependencies(xml, &start, &dep, &kind);
+    ASSERT_MSG(start != NULL, "No output dependencies");
+    ASSERT_MSG(memcmp(start, startOut, sizeof(startOut)) == 0, "Wrong start indices of output dependencies");
+    ASSERT_MSG(memcmp(dep, depOut, sizeof(depOut)) == 0, "Wrong output dependencies");
+    ASSERT_MSG(memcmp(kind, kindOut, sizeof(kindOut)) == 0, "Wrong kinds of output dependencies");
+
+    fmi2_import_get_derivatives_dependencies(xml, &start, &dep, &kind);
+    ASSERT_MSG(start != NULL, "No derivative dependencies");
+    ASSERT_MSG(memcmp(start, startDer, sizeof(startDer)) == 0, "Wrong start indices of derivative dependencies");
+    ASSERT_MSG(memcmp(dep, depDer, sizeof(depDer)) == 0, "Wrong derivative dependencies");
+    ASSERT_MSG(kind[0] == fmi2_dependency_factor_kind_dependent && kind[1] == fmi2_dependency_factor_kind_dependent,
+               "Derivative dependencies without kinds should be dependent");
+
+    fmi2_import_free(xml);
+    return TEST_OK;
+}
+
+/* An item that is not a number makes the model structure invalid */
+static int bad_item_test(const char *dir)
+{
+    fmi2_import_t *xml = parse_xml(dir, "bad_item");
+
+    if (xml != NULL) {
+        fmi2_import_free(xml);
+    }
+    ASSERT_MSG(xml == NULL, "Parsing should fail on a dependency that is not a number");
+
+    return TEST_OK;
+}
+
+int main(int argc, char **argv)
+{
+    int ret = TEST_OK;
+
+    printf("Running test %s\n", argv[0]);
+
+    if (argc != 2) {
+        printf("Usage: %s <dependencies_dir>\n", argv[0]);
+        return CTEST_RETURN_FAIL;
+    }
+
+    ret &= valid_dependencies_test(argv[1]);
+    ret &= bad_item_test(argv[1]);
+
+    return ret == TEST_OK ? CTEST_RETURN_SUCCESS : CTEST_RETURN_FAIL;
+}
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <string.h>
 
 #include <fmilib.h>
 #include "config_test.h"
@@ -104,6 +105,52 @@ static int enum_maximal_test(fmi2_import_t *xml)
     return TEST_OK;
 }
 
+typedef struct {
+    int calls;
+    int found;
+    int abort;
+} variables_ready_data_t;
+
+static int variables_ready(fmi2_import_t *fmu, void *data)
+{
+    variables_ready_data_t *d = (variables_ready_data_t *)data;
+    fmi2_import_variable_t *v = fmi2_import_get_variable_by_vr(fmu, fmi2_base_type_enum, 4);
+
+    d->calls++;
+    d->found = v != NULL && strcmp(fmi2_import_get_variable_name(v), "minEnumVar") == 0;
+    return d->abort;
+}
+
+/* Variables are available from the callback before ModelStructure is parsed */
+static int variables_ready_test(const char *model_desc_path)
+{
+    jm_callbacks *cb = jm_get_default_callbacks();
+    fmi_import_context_t *ctx = fmi_import_allocate_context(cb);
+    variables_ready_data_t data = {0, 0, 0};
+    fmi2_import_t *xml;
+
+    ASSERT_MSG(ctx != NULL, "Could not allocate context");
+
+    xml = fmi2_import_parse_xml_with_variables_callback(ctx, model_desc_path, NULL,
+                                                         variables_ready, &data);
+    ASSERT_MSG(xml != NULL, "Parsing failed");
+    ASSERT_MSG(data.calls == 1, "Callback should be invoked once");
+    ASSERT_MSG(data.found, "Variable not found by value reference in callback");
+    ASSERT_MSG(fmi2_import_get_number_of_continuous_states(xml) == 1,
+               "Model structure should be parsed after the callback");
+    fmi2_import_free(xml);
+
+    data.calls = 0;
+    data.abort = 1;
+    xml = fmi2_import_parse_xml_with_variables_callback(ctx, model_desc_path, NULL,
+                                                         variables_ready, &data);
+    ASSERT_MSG(xml == NULL, "Non-zero return from callback should abort parsing");
+    ASSERT_MSG(data.calls == 1, "Callback should be invoked once");
+
+    fmi_import_free_context(ctx);
+    return TEST_OK;
+}
+
 int main(int argc, char **argv)
 {
     fmi2_import_t *xml;
@@ -122,6 +169,7 @@ int main(int argc, char **argv)
 
     ret &= enum_minimal_test(xml);
     ret &= enum_maximal_test(xml);
+    ret &= variables_ready_test(argv[1]);
 
     fmi2_import_free(xml);
     return ret == 0 ? CTEST_RETURN_FAIL : CTEST_RETURN_SUCCESS;
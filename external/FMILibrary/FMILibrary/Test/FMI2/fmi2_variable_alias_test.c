@@ -0,0 +1,84 @@
+#include <stdio.h>
+
+#include "fmilib.h"
+#include "fmil_test.h"
+#include "config_test.h"
+
+static fmi2_import_t *parse_xml(const char *mdpath)
+{
+    fmi2_import_t *parsed;
+    jm_callbacks *cb = jm_get_default_callbacks();
+    fmi_import_context_t *ctx = fmi_import_allocate_context(cb);
+
+    if (ctx == NULL) {
+        return NULL;
+    }
+
+    parsed = fmi2_import_parse_xml(ctx, mdpath, NULL);
+    fmi_import_free_context(ctx);
+    return parsed;
+}
+
+/* The bad alias set of integers is removed without affecting the other types with the same vr */
+static int mixed_type_alias_set_test(fmi2_import_t *xml)
+{
+    fmi2_import_variable_t *v;
+
+    ASSERT_MSG(fmi2_import_get_variable_by_name(xml, "int1") == NULL,
+               "int1 should be removed with the bad alias set");
+    ASSERT_MSG(fmi2_import_get_variable_by_name(xml, "int2") == NULL,
+               "int2 should be removed with the bad alias set");
+    ASSERT_MSG(fmi2_import_get_variable_by_name(xml, "int3") == NULL,
+               "int3 should be removed with the bad alias set");
+
+    v = fmi2_import_get_variable_by_vr(xml, fmi2_base_type_enum, 1);
+    ASSERT_MSG(v != NULL, "enum1 should not be removed with the integers");
+    ASSERT_MSG(fmi2_import_get_variable_alias_kind(v) == fmi2_variable_is_not_alias,
+               "enum1 should not be an alias");
+
+    v = fmi2_import_get_variable_by_vr(xml, fmi2_base_type_real, 1);
+    ASSERT_MSG(v != NULL, "real1 should not be removed with the integers");
+
+    return TEST_OK;
+}
+
+/* Alias resolution continues with all the variables after the removed alias set */
+static int alias_after_bad_alias_set_test(fmi2_import_t *xml)
+{
+    fmi2_import_variable_t *v = fmi2_import_get_variable_by_name(xml, "int4");
+    fmi2_import_variable_t *alias = fmi2_import_get_variable_by_name(xml, "int4Alias");
+
+    ASSERT_MSG(v != NULL && alias != NULL, "Could not find the variables with vr 2");
+    ASSERT_MSG(fmi2_import_get_variable_alias_kind(v) == fmi2_variable_is_not_alias,
+               "int4 should not be an alias");
+    ASSERT_MSG(fmi2_import_get_variable_alias_kind(alias) == fmi2_variable_is_alias,
+               "int4Alias should be an alias of int4");
+    ASSERT_MSG(fmi2_import_get_variable_alias_base(xml, alias) == v,
+               "The alias base of int4Alias should be int4");
+
+    return TEST_OK;
+}
+
+int main(int argc, char **argv)
+{
+    int ret = TEST_OK;
+    fmi2_import_t *xml;
+
+    printf("Running test %s\n", argv[0]);
+
+    if (argc != 2) {
+        printf("Usage: %s <variable_alias_dir>\n", argv[0]);
+        return CTEST_RETURN_FAIL;
+    }
+
+    xml = parse_xml(argv[1]);
+    if (xml == NULL) {
+        return CTEST_RETURN_FAIL;
+    }
+
+    ret &= mixed_type_alias_set_test(xml);
+    ret &= alias_after_bad_alias_set_test(xml);
+
+    fmi2_import_free(xml);
+    return ret == TEST_OK ? CTEST_RETURN_SUCCESS : CTEST_RETURN_FAIL;
+}
@@ -0,0 +1,460 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+/* Checks that a model description read from the binary cache gives the same
+   query results as the one parsed from the XML file. */
+#include <stdio.h>
+#include <string.h>
+
+#include <fmilib.h>
+#include "config_test.h"
+#include "fmil_test.h"
+
+#define CACHE_SUFFIX ".fmilcache"
+
+static fmi2_import_t *parse_xml(const char *model_desc_path, int configuration)
+{
+    jm_callbacks *cb = jm_get_default_callbacks();
+    fmi_import_context_t *ctx = fmi_import_allocate_context(cb);
+    fmi2_import_t *xml;
+
+    if (ctx == NULL) {
+        return NULL;
+    }
+    fmi_import_set_configuration(ctx, configuration);
+    xml = fmi2_import_parse_xml(ctx, model_desc_path, NULL);
+
+    fmi_import_free_context(ctx);
+    return xml;
+}
+
+static int copy_file(const char *src, const char *dst)
+{
+    char buf[4096];
+    size_t n;
+    FILE *in = fopen(src, "rb");
+    FILE *out = fopen(dst, "wb");
+    int ok = (in != NULL && out != NULL);
+
+    while (ok && (n = fread(buf, 1, sizeof(buf), in)) > 0) {
+        ok = fwrite(buf, 1, n, out) == n;
+    }
+    if (in) fclose(in);
+    if (out) fclose(out);
+    return ok;
+}
+
+static int file_exists(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return 0;
+    fclose(f);
+    return 1;
+}
+
+static int same_str(const char *a, const char *b)
+{
+    if (a == NULL || b == NULL) return a == b;
+    return strcmp(a, b) == 0;
+}
+
+static const char *unit_name(fmi2_import_unit_t *u)
+{
+    return u ? fmi2_import_get_unit_name(u) : NULL;
+}
+
+static const char *display_unit_name(fmi2_import_display_unit_t *du)
+{
+    return du ? fmi2_import_get_display_unit_name(du) : NULL;
+}
+
+static const char *variable_name(fmi2_import_variable_t *v)
+{
+    return v ? fmi2_import_get_variable_name(v) : NULL;
+}
+
+static int compare_header(fmi2_import_t *a, fmi2_import_t *b)
+{
+    size_t i;
+    int k;
+
+    ASSERT_MSG(same_str(fmi2_import_get_model_name(a), fmi2_import_get_model_name(b)), "Model name differs");
+    ASSERT_MSG(same_str(fmi2_import_get_GUID(a), fmi2_import_get_GUID(b)), "GUID differs");
+    ASSERT_MSG(same_str(fmi2_import_get_description(a), fmi2_import_get_description(b)), "Description differs");
+    ASSERT_MSG(same_str(fmi2_import_get_author(a), fmi2_import_get_author(b)), "Author differs");
+    ASSERT_MSG(same_str(fmi2_import_get_model_version(a), fmi2_import_get_model_version(b)), "Version differs");
+    ASSERT_MSG(same_str(fmi2_import_get_model_standard_version(a), fmi2_import_get_model_standard_version(b)), "FMI version differs");
+    ASSERT_MSG(same_str(fmi2_import_get_generation_tool(a), fmi2_import_get_generation_tool(b)), "Generation tool differs");
+    ASSERT_MSG(same_str(fmi2_import_get_model_identifier_ME(a), fmi2_import_get_model_identifier_ME(b)), "ME identifier differs");
+    ASSERT_MSG(same_str(fmi2_import_get_model_identifier_CS(a), fmi2_import_get_model_identifier_CS(b)), "CS identifier differs");
+    ASSERT_MSG(fmi2_import_get_fmu_kind(a) == fmi2_import_get_fmu_kind(b), "FMU kind differs");
+    ASSERT_MSG(fmi2_import_get_naming_convention(a) == fmi2_import_get_naming_convention(b), "Naming convention differs");
+    ASSERT_MSG(fmi2_import_get_number_of_continuous_states(a) == fmi2_import_get_number_of_continuous_states(b), "Number of states differs");
+    ASSERT_MSG(fmi2_import_get_number_of_event_indicators(a) == fmi2_import_get_number_of_event_indicators(b), "Number of event indicators differs");
+    ASSERT_MSG(fmi2_import_get_default_experiment_start(a) == fmi2_import_get_default_experiment_start(b), "Start time differs");
+    ASSERT_MSG(fmi2_import_get_default_experiment_stop(a) == fmi2_import_get_default_experiment_stop(b), "Stop time differs");
+    ASSERT_MSG(fmi2_import_get_default_experiment_tolerance(a) == fmi2_import_get_default_experiment_tolerance(b), "Tolerance differs");
+    ASSERT_MSG(fmi2_import_get_default_experiment_step(a) == fmi2_import_get_default_experiment_step(b), "Step size differs");
+    for (k = 0; k < fmi2_capabilities_Num; k++) {
+        ASSERT_MSG(fmi2_import_get_capability(a, (fmi2_capabilities_enu_t)k) == fmi2_import_get_capability(b, (fmi2_capabilities_enu_t)k), "Capability differs");
+    }
+    ASSERT_MSG(fmi2_import_get_log_categories_num(a) == fmi2_import_get_log_categories_num(b), "Number of log categories differs");
+    for (i = 0; i < fmi2_import_get_log_categories_num(a); i++) {
+        ASSERT_MSG(same_str(fmi2_import_get_log_category(a, i), fmi2_import_get_log_category(b, i)), "Log category differs");
+        ASSERT_MSG(same_str(fmi2_import_get_log_category_description(a, i), fmi2_import_get_log_category_description(b, i)), "Log category description differs");
+    }
+    ASSERT_MSG(fmi2_import_get_source_files_me_num(a) == fmi2_import_get_source_files_me_num(b), "Number of source files differs");
+    for (i = 0; i < fmi2_import_get_source_files_me_num(a); i++) {
+        ASSERT_MSG(same_str(fmi2_import_get_source_file_me(a, i), fmi2_import_get_source_file_me(b, i)), "Source file differs");
+    }
+    ASSERT_MSG(fmi2_import_get_vendors_num(a) == fmi2_import_get_vendors_num(b), "Number of vendors differs");
+    for (i = 0; i < fmi2_import_get_vendors_num(a); i++) {
+        ASSERT_MSG(same_str(fmi2_import_get_vendor_name(a, i), fmi2_import_get_vendor_name(b, i)), "Vendor differs");
+    }
+    return TEST_OK;
+}
+
+static int compare_units(fmi2_import_t *a, fmi2_import_t *b)
+{
+    fmi2_import_unit_definitions_t *ua = fmi2_import_get_unit_definitions(a);
+    fmi2_import_unit_definitions_t *ub = fmi2_import_get_unit_definitions(b);
+    unsigned int i, j, n;
+
+    n = ua ? fmi2_import_get_unit_definitions_number(ua) : 0;
+    ASSERT_MSG(n == (ub ? fmi2_import_get_unit_definitions_number(ub) : 0), "Number of units differs");
+    for (i = 0; i < n; i++) {
+        fmi2_import_unit_t *x = fmi2_import_get_unit(ua, i);
+        fmi2_import_unit_t *y = fmi2_import_get_unit(ub, i);
+        ASSERT_MSG(same_str(unit_name(x), unit_name(y)), "Unit name differs");
+        ASSERT_MSG(memcmp(fmi2_import_get_SI_unit_exponents(x), fmi2_import_get_SI_unit_exponents(y), fmi2_SI_base_units_Num * sizeof(int)) == 0, "Unit exponents differ");
+        ASSERT_MSG(fmi2_import_get_SI_unit_factor(x) == fmi2_import_get_SI_unit_factor(y), "Unit factor differs");
+        ASSERT_MSG(fmi2_import_get_SI_unit_offset(x) == fmi2_import_get_SI_unit_offset(y), "Unit offset differs");
+        ASSERT_MSG(fmi2_import_get_unit_display_unit_number(x) == fmi2_import_get_unit_display_unit_number(y), "Number of display units differs");
+        for (j = 0; j < fmi2_import_get_unit_display_unit_number(x); j++) {
+            fmi2_import_display_unit_t *dx = fmi2_import_get_unit_display_unit(x, j);
+            fmi2_import_display_unit_t *dy = fmi2_import_get_unit_display_unit(y, j);
+            ASSERT_MSG(same_str(display_unit_name(dx), display_unit_name(dy)), "Display unit name differs");
+            ASSERT_MSG(fmi2_import_get_display_unit_factor(dx) == fmi2_import_get_display_unit_factor(dy), "Display unit factor differs");
+            ASSERT_MSG(fmi2_import_get_display_unit_offset(dx) == fmi2_import_get_display_unit_offset(dy), "Display unit offset differs");
+            ASSERT_MSG(same_str(unit_name(fmi2_import_get_base_unit(dx)), unit_name(fmi2_import_get_base_unit(dy))), "Display unit base differs");
+        }
+    }
+    return TEST_OK;
+}
+
+static int compare_typedef(fmi2_import_variable_typedef_t *x, fmi2_import_variable_typedef_t *y)
+{
+    unsigned int k;
+
+    if (x == NULL || y == NULL) {
+        ASSERT_MSG(x == y, "Declared type differs");
+        return TEST_OK;
+    }
+    ASSERT_MSG(same_str(fmi2_import_get_type_name(x), fmi2_import_get_type_name(y)), "Type name differs");
+    ASSERT_MSG(same_str(fmi2_import_get_type_description(x), fmi2_import_get_type_description(y)), "Type description differs");
+    ASSERT_MSG(fmi2_import_get_base_type(x) == fmi2_import_get_base_type(y), "Base type differs");
+    ASSERT_MSG(same_str(fmi2_import_get_type_quantity(x), fmi2_import_get_type_quantity(y)), "Type quantity differs");
+    switch (fmi2_import_get_base_type(x)) {
+    case fmi2_base_type_real: {
+        fmi2_import_real_typedef_t *rx = fmi2_import_get_type_as_real(x);
+        fmi2_import_real_typedef_t *ry = fmi2_import_get_type_as_real(y);
+        ASSERT_MSG(fmi2_import_get_real_type_min(rx) == fmi2_import_get_real_type_min(ry), "Real type min differs");
+        ASSERT_MSG(fmi2_import_get_real_type_max(rx) == fmi2_import_get_real_type_max(ry), "Real type max differs");
+        ASSERT_MSG(fmi2_import_get_real_type_nominal(rx) == fmi2_import_get_real_type_nominal(ry), "Real type nominal differs");
+        ASSERT_MSG(same_str(unit_name(fmi2_import_get_real_type_unit(rx)), unit_name(fmi2_import_get_real_type_unit(ry))), "Real type unit differs");
+        ASSERT_MSG(same_str(display_unit_name(fmi2_import_get_type_display_unit(rx)), display_unit_name(fmi2_import_get_type_display_unit(ry))), "Real type display unit differs");
+        ASSERT_MSG(fmi2_import_get_real_type_is_relative_quantity(rx) == fmi2_import_get_real_type_is_relative_quantity(ry), "Relative quantity differs");
+        ASSERT_MSG(fmi2_import_get_real_type_is_unbounded(rx) == fmi2_import_get_real_type_is_unbounded(ry), "Unbounded differs");
+        break;
+    }
+    case fmi2_base_type_int: {
+        fmi2_import_integer_typedef_t *ix = fmi2_import_get_type_as_int(x);
+        fmi2_import_integer_typedef_t *iy = fmi2_import_get_type_as_int(y);
+        ASSERT_MSG(fmi2_import_get_integer_type_min(ix) == fmi2_import_get_integer_type_min(iy), "Integer type min differs");
+        ASSERT_MSG(fmi2_import_get_integer_type_max(ix) == fmi2_import_get_integer_type_max(iy), "Integer type max differs");
+        break;
+    }
+    case fmi2_base_type_enum: {
+        fmi2_import_enumeration_typedef_t *ex = fmi2_import_get_type_as_enum(x);
+        fmi2_import_enumeration_typedef_t *ey = fmi2_import_get_type_as_enum(y);
+        ASSERT_MSG(fmi2_import_get_enum_type_min(ex) == fmi2_import_get_enum_type_min(ey), "Enum type min differs");
+        ASSERT_MSG(fmi2_import_get_enum_type_max(ex) == fmi2_import_get_enum_type_max(ey), "Enum type max differs");
+        ASSERT_MSG(fmi2_import_get_enum_type_size(ex) == fmi2_import_get_enum_type_size(ey), "Enum type size differs");
+        for (k = 1; k <= fmi2_import_get_enum_type_size(ex); k++) {
+            ASSERT_MSG(same_str(fmi2_import_get_enum_type_item_name(ex, k), fmi2_import_get_enum_type_item_name(ey, k)), "Enum item name differs");
+            ASSERT_MSG(fmi2_import_get_enum_type_item_value(ex, k) == fmi2_import_get_enum_type_item_value(ey, k), "Enum item value differs");
+            ASSERT_MSG(same_str(fmi2_import_get_enum_type_item_description(ex, k), fmi2_import_get_enum_type_item_description(ey, k)), "Enum item description differs");
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return TEST_OK;
+}
+
+static int compare_types(fmi2_import_t *a, fmi2_import_t *b)
+{
+    fmi2_import_type_definitions_t *ta = fmi2_import_get_type_definitions(a);
+    fmi2_import_type_definitions_t *tb = fmi2_import_get_type_definitions(b);
+    unsigned int i, n;
+
+    n = fmi2_import_get_type_definition_number(ta);
+    ASSERT_MSG(n == fmi2_import_get_type_definition_number(tb), "Number of type definitions differs");
+    for (i = 0; i < n; i++) {
+        if (compare_typedef(fmi2_import_get_typedef(ta, i), fmi2_import_get_typedef(tb, i)) != TEST_OK) return 0;
+    }
+    return TEST_OK;
+}
+
+static int compare_variable(fmi2_import_t *a, fmi2_import_t *b, fmi2_import_variable_t *x, fmi2_import_variable_t *y)
+{
+    fmi2_base_type_enu_t bt = fmi2_import_get_variable_base_type(x);
+
+    ASSERT_MSG(same_str(variable_name(x), variable_name(y)), "Variable name differs");
+    ASSERT_MSG(same_str(fmi2_import_get_variable_description(x), fmi2_import_get_variable_description(y)), "Variable description differs");
+    ASSERT_MSG(fmi2_import_get_variable_vr(x) == fmi2_import_get_variable_vr(y), "Value reference differs");
+    ASSERT_MSG(bt == fmi2_import_get_variable_base_type(y), "Variable base type differs");
+    ASSERT_MSG(fmi2_import_get_variable_has_start(x) == fmi2_import_get_variable_has_start(y), "Has start differs");
+    ASSERT_MSG(fmi2_import_get_variability(x) == fmi2_import_get_variability(y), "Variability differs");
+    ASSERT_MSG(fmi2_import_get_causality(x) == fmi2_import_get_causality(y), "Causality differs");
+    ASSERT_MSG(fmi2_import_get_initial(x) == fmi2_import_get_initial(y), "Initial differs");
+    ASSERT_MSG(fmi2_import_get_variable_alias_kind(x) == fmi2_import_get_variable_alias_kind(y), "Alias kind differs");
+    ASSERT_MSG(fmi2_import_get_variable_original_order(x) == fmi2_import_get_variable_original_order(y), "Original order differs");
+    ASSERT_MSG(fmi2_import_get_canHandleMultipleSetPerTimeInstant(x) == fmi2_import_get_canHandleMultipleSetPerTimeInstant(y), "canHandleMultipleSetPerTimeInstant differs");
+    ASSERT_MSG(same_str(variable_name(fmi2_import_get_previous(x)), variable_name(fmi2_import_get_previous(y))), "Previous differs");
+    ASSERT_MSG(same_str(variable_name(fmi2_import_get_variable_alias_base(a, x)), variable_name(fmi2_import_get_variable_alias_base(b, y))), "Alias base differs");
+    if (compare_typedef(fmi2_import_get_variable_declared_type(x), fmi2_import_get_variable_declared_type(y)) != TEST_OK) return 0;
+
+    switch (bt) {
+    case fmi2_base_type_real: {
+        fmi2_import_real_variable_t *rx = fmi2_import_get_variable_as_real(x);
+        fmi2_import_real_variable_t *ry = fmi2_import_get_variable_as_real(y);
+        ASSERT_MSG(fmi2_import_get_real_variable_start(rx) == fmi2_import_get_real_variable_start(ry), "Real start differs");
+        ASSERT_MSG(fmi2_import_get_real_variable_min(rx) == fmi2_import_get_real_variable_min(ry), "Real min differs");
+        ASSERT_MSG(fmi2_import_get_real_variable_max(rx) == fmi2_import_get_real_variable_max(ry), "Real max differs");
+        ASSERT_MSG(fmi2_import_get_real_variable_nominal(rx) == fmi2_import_get_real_variable_nominal(ry), "Real nominal differs");
+        ASSERT_MSG(fmi2_import_get_real_variable_reinit(rx) == fmi2_import_get_real_variable_reinit(ry), "Reinit differs");
+        ASSERT_MSG(same_str(unit_name(fmi2_import_get_real_variable_unit(rx)), unit_name(fmi2_import_get_real_variable_unit(ry))), "Real unit differs");
+        ASSERT_MSG(same_str(display_unit_name(fmi2_import_get_real_variable_display_unit(rx)), display_unit_name(fmi2_import_get_real_variable_display_unit(ry))), "Real display unit differs");
+        ASSERT_MSG(same_str(variable_name((fmi2_import_variable_t*)fmi2_import_get_real_variable_derivative_of(rx)),
+                            variable_name((fmi2_import_variable_t*)fmi2_import_get_real_variable_derivative_of(ry))), "Derivative of differs");
+        break;
+    }
+    case fmi2_base_type_int: {
+        fmi2_import_integer_variable_t *ix = fmi2_import_get_variable_as_integer(x);
+        fmi2_import_integer_variable_t *iy = fmi2_import_get_variable_as_integer(y);
+        ASSERT_MSG(fmi2_import_get_integer_variable_start(ix) == fmi2_import_get_integer_variable_start(iy), "Integer start differs");
+        ASSERT_MSG(fmi2_import_get_integer_variable_min(ix) == fmi2_import_get_integer_variable_min(iy), "Integer min differs");
+        ASSERT_MSG(fmi2_import_get_integer_variable_max(ix) == fmi2_import_get_integer_variable_max(iy), "Integer max differs");
+        break;
+    }
+    case fmi2_base_type_enum: {
+        fmi2_import_enum_variable_t *ex = fmi2_import_get_variable_as_enum(x);
+        fmi2_import_enum_variable_t *ey = fmi2_import_get_variable_as_enum(y);
+        ASSERT_MSG(fmi2_import_get_enum_variable_start(ex) == fmi2_import_get_enum_variable_start(ey), "Enum start differs");
+        ASSERT_MSG(fmi2_import_get_enum_variable_min(ex) == fmi2_import_get_enum_variable_min(ey), "Enum min differs");
+        ASSERT_MSG(fmi2_import_get_enum_variable_max(ex) == fmi2_import_get_enum_variable_max(ey), "Enum max differs");
+        break;
+    }
+    case fmi2_base_type_bool:
+        ASSERT_MSG(fmi2_import_get_boolean_variable_start(fmi2_import_get_variable_as_boolean(x)) ==
+                   fmi2_import_get_boolean_variable_start(fmi2_import_get_variable_as_boolean(y)), "Boolean start differs");
+        break;
+    case fmi2_base_type_str:
+        ASSERT_MSG(same_str(fmi2_import_get_string_variable_start(fmi2_import_get_variable_as_string(x)),
+                            fmi2_import_get_string_variable_start(fmi2_import_get_variable_as_string(y))), "String start differs");
+        break;
+    default:
+        break;
+    }
+    return TEST_OK;
+}
+
+static int compare_variable_lists(fmi2_import_t *a, fmi2_import_t *b, fmi2_import_variable_list_t *la, fmi2_import_variable_list_t *lb)
+{
+    size_t i, n = la ? fmi2_import_get_variable_list_size(la) : 0;
+    int ret = TEST_OK;
+
+    if (n != (lb ? fmi2_import_get_variable_list_size(lb) : 0)) {
+        printf("  Variable list sizes differ\n");
+        ret = 0;
+    }
+    for (i = 0; ret == TEST_OK && i < n; i++) {
+        ret = compare_variable(a, b, fmi2_import_get_variable(la, i), fmi2_import_get_variable(lb, i));
+    }
+    fmi2_import_free_variable_list(la);
+    fmi2_import_free_variable_list(lb);
+    return ret;
+}
+
+static int compare_dependencies(size_t nrows, size_t *sa, size_t *da, char *fa, size_t *sb, size_t *db, char *fb)
+{
+    if (sa == NULL || sb == NULL) {
+        ASSERT_MSG(sa == sb, "Presence of dependencies differs");
+        return TEST_OK;
+    }
+    ASSERT_MSG(memcmp(sa, sb, (nrows + 1) * sizeof(size_t)) == 0, "Dependency start index differs");
+    ASSERT_MSG(memcmp(da, db, sa[nrows] * sizeof(size_t)) == 0, "Dependency index differs");
+    ASSERT_MSG(memcmp(fa, fb, sa[nrows]) == 0, "Dependency factor kind differs");
+    return TEST_OK;
+}
+
+static int compare_model_structure(fmi2_import_t *a, fmi2_import_t *b)
+{
+    size_t *sa, *da, *sb, *db;
+    char *fa, *fb;
+    fmi2_import_variable_list_t *l;
+    size_t n;
+    int ret = TEST_OK;
+
+    if (compare_variable_lists(a, b, fmi2_import_get_outputs_list(a), fmi2_import_get_outputs_list(b)) != TEST_OK ||
+        compare_variable_lists(a, b, fmi2_import_get_derivatives_list(a), fmi2_import_get_derivatives_list(b)) != TEST_OK ||
+        compare_variable_lists(a, b, fmi2_import_get_discrete_states_list(a), fmi2_import_get_discrete_states_list(b)) != TEST_OK ||
+        compare_variable_lists(a, b, fmi2_import_get_initial_unknowns_list(a), fmi2_import_get_initial_unknowns_list(b)) != TEST_OK) {
+        return 0;
+    }
+
+    l = fmi2_import_get_outputs_list(a);
+    n = l ? fmi2_import_get_variable_list_size(l) : 0;
+    fmi2_import_free_variable_list(l);
+    fmi2_import_get_outputs_dependencies(a, &sa, &da, &fa);
+    fmi2_import_get_outputs_dependencies(b, &sb, &db, &fb);
+    ret &= compare_dependencies(n, sa, da, fa, sb, db, fb);
+
+    l = fmi2_import_get_derivatives_list(a);
+    n = l ? fmi2_import_get_variable_list_size(l) : 0;
+    fmi2_import_free_variable_list(l);
+    fmi2_import_get_derivatives_dependencies(a, &sa, &da, &fa);
+    fmi2_import_get_derivatives_dependencies(b, &sb, &db, &fb);
+    ret &= compare_dependencies(n, sa, da, fa, sb, db, fb);
+
+    l = fmi2_import_get_discrete_states_list(a);
+    n = l ? fmi2_import_get_variable_list_size(l) : 0;
+    fmi2_import_free_variable_list(l);
+    fmi2_import_get_discrete_states_dependencies(a, &sa, &da, &fa);
+    fmi2_import_get_discrete_states_dependencies(b, &sb, &db, &fb);
+    ret &= compare_dependencies(n, sa, da, fa, sb, db, fb);
+
+    l = fmi2_import_get_initial_unknowns_list(a);
+    n = l ? fmi2_import_get_variable_list_size(l) : 0;
+    fmi2_import_free_variable_list(l);
+    fmi2_import_get_initial_unknowns_dependencies(a, &sa, &da, &fa);
+    fmi2_import_get_initial_unknowns_dependencies(b, &sb, &db, &fb);
+    ret &= compare_dependencies(n, sa, da, fa, sb, db, fb);
+
+    return ret;
+}
+
+static int compare_model_descriptions(fmi2_import_t *a, fmi2_import_t *b)
+{
+    int sortOrder;
+
+    if (compare_header(a, b) != TEST_OK ||
+        compare_units(a, b) != TEST_OK ||
+        compare_types(a, b) != TEST_OK) {
+        return 0;
+    }
+    /* original, name and value reference order */
+    for (sortOrder = 0; sortOrder <= 2; sortOrder++) {
+        if (compare_variable_lists(a, b, fmi2_import_get_variable_list(a, sortOrder), fmi2_import_get_variable_list(b, sortOrder)) != TEST_OK) {
+            return 0;
+        }
+    }
+    return compare_model_structure(a, b);
+}
+
+int main(int argc, char **argv)
+{
+    jm_callbacks *cb = jm_get_default_callbacks();
+    fmi2_import_t *reference, *cached;
+    char *tmp_dir;
+    char src[FILENAME_MAX], dst[FILENAME_MAX], cache[FILENAME_MAX];
+    int ret = TEST_OK;
+
+    printf("Running test %s\n", argv[0]);
+
+    if (argc != 2) {
+        printf("Usage: %s <model_description_dir>\n", argv[0]);
+        return CTEST_RETURN_FAIL;
+    }
+
+    tmp_dir = fmi_import_mk_temp_dir(cb, NULL, "fmil_cache_test_");
+    if (tmp_dir == NULL) {
+        return CTEST_RETURN_FAIL;
+    }
+    sprintf(src, "%s/modelDescription.xml", argv[1]);
+    sprintf(dst, "%s/modelDescription.xml", tmp_dir);
+    sprintf(cache, "%s/modelDescription.xml" CACHE_SUFFIX, tmp_dir);
+    if (!copy_file(src, dst)) {
+        printf("Could not copy %s to %s\n", src, dst);
+        fmi_import_rmdir(cb, tmp_dir);
+        cb->free(tmp_dir);
+        return CTEST_RETURN_FAIL;
+    }
+
+    reference = parse_xml(tmp_dir, 0);
+    if (reference == NULL) {
+        ret = 0;
+    }
+    if (ret == TEST_OK && file_exists(cache)) {
+        printf("  Cache file was written without being requested\n");
+        ret = 0;
+    }
+
+    /* First parse writes the cache, second one reads it */
+    if (ret == TEST_OK) {
+        cached = parse_xml(tmp_dir, FMI_IMPORT_MODEL_DESCRIPTION_CACHE);
+        if (cached == NULL || !file_exists(cache)) {
+            printf("  Cache file was not written\n");
+            ret = 0;
+        } else {
+            ret = compare_model_descriptions(reference, cached);
+        }
+        if (cached) fmi2_import_free(cached);
+    }
+    if (ret == TEST_OK) {
+        cached = parse_xml(tmp_dir, FMI_IMPORT_MODEL_DESCRIPTION_CACHE);
+        if (cached == NULL) {
+            printf("  Could not load model description from cache\n");
+            ret = 0;
+        } else {
+            ret = compare_model_descriptions(reference, cached);
+            fmi2_import_free(cached);
+        }
+    }
+
+    /* A changed XML file must not use the old cache */
+    if (ret == TEST_OK) {
+        FILE *f = fopen(dst, "ab");
+        if (f != NULL) {
+            fputs("\n", f);
+            fclose(f);
+        }
+        cached = parse_xml(tmp_dir, FMI_IMPORT_MODEL_DESCRIPTION_CACHE);
+        if (cached == NULL) {
+            printf("  Could not parse changed model description\n");
+            ret = 0;
+        } else {
+            ret = compare_model_descriptions(reference, cached);
+            fmi2_import_free(cached);
+        }
+    }
+
+    if (reference) fmi2_import_free(reference);
+    fmi_import_rmdir(cb, tmp_dir);
+    cb->free(tmp_dir);
+    return ret == TEST_OK ? CTEST_RETURN_SUCCESS : CTEST_RETURN_FAIL;
+}
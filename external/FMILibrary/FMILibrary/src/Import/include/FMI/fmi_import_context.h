@@ -83,10 +83,18 @@ FMILIB_EXPORT void fmi_import_free_context( fmi_import_context_t* c);
 */
 #define FMI_IMPORT_NAME_CHECK 1
 
+/**
+    \brief If this configuration option is set, the parsed model description is
+    cached in a binary file next to the XML file in the unzipped FMU. Loading the
+    same FMU again from that directory reads the cache instead of parsing the XML.
+    Only supported for FMI 2.0.
+*/
+#define FMI_IMPORT_MODEL_DESCRIPTION_CACHE 2
+
 /**
     \brief Sets advanced configuration, if zero is passed default configuration
-    is set. Currently only one non default configuration is available:
-    FMI_IMPORT_XML_NAME_CHECK.
+    is set. The non default configurations are FMI_IMPORT_NAME_CHECK and
+    FMI_IMPORT_MODEL_DESCRIPTION_CACHE, which may be combined.
     @param conf - specifies the configuration to use
 */
 FMILIB_EXPORT void fmi_import_set_configuration( fmi_import_context_t* c, int conf);
@@ -99,6 +107,21 @@ FMILIB_EXPORT void fmi_import_set_configuration( fmi_import_context_t* c, int co
 */
 FMILIB_EXPORT fmi_version_enu_t fmi_import_get_fmi_version( fmi_import_context_t* c, const char* fileName, const char* dirName);
 
+/**
+	\brief Unzip the parts of an FMU needed to load it into an extraction cache and parse XML to get FMI standard version.
+
+	The model description, the binaries for the current platform and the resources are extracted into
+	a sub directory of cacheDir named by the SHA-256 of the FMU, unless that directory already exists.
+	Loading the same FMU again, also from another process, then skips the extraction. The directory is
+	shared and must not be removed while the FMU may be loaded.
+	@param c - library context.
+	@param fileName - an FMU file name.
+	@param cacheDir - an existing directory for the extraction cache.
+	@param dirName - output, the directory the FMU is unpacked in. Must be freed with the free function of the context callbacks.
+	Set to NULL on error.
+*/
+FMILIB_EXPORT fmi_version_enu_t fmi_import_get_fmi_version_cached( fmi_import_context_t* c, const char* fileName, const char* cacheDir, char** dirName);
+
 /**
 	\brief FMU version 1.0 object
 */
@@ -126,6 +149,30 @@ FMILIB_EXPORT fmi1_import_t* fmi1_import_parse_xml( fmi_import_context_t* c, con
 */
 FMILIB_EXPORT fmi2_import_t* fmi2_import_parse_xml( fmi_import_context_t* context, const char* dirPath, fmi2_xml_callbacks_t* xml_callbacks);
 
+/**
+    \brief Callback invoked while parsing an FMI 2.0 XML file as soon as the model variables are available.
+
+    Variables may be looked up, e.g., with fmi2_import_get_variable_by_vr(), before the ModelStructure
+    element is parsed, so that a client can start its own setup while the rest of a large file is processed.
+    Functions accessing the model structure (outputs, derivatives, dependencies) must not be used from the callback.
+	\param fmu - the FMU object being created.
+	\param data - the data pointer given to fmi2_import_parse_xml_with_variables_callback().
+	\return 0 to continue parsing. Non-zero value aborts parsing.
+*/
+typedef int (*fmi2_import_variables_ready_ft)(fmi2_import_t* fmu, void* data);
+
+/**
+    \brief Same as fmi2_import_parse_xml() but invokes a callback as soon as the model variables are available.
+	\param context - library context.
+	\param dirPath - a directory where the FMU was unpacked and XML file is present.
+	\param xml_callbacks Callbacks to use for processing of annotations (may be NULL).
+	\param variablesReady Callback invoked once the model variables are parsed (may be NULL).
+	\param data Pointer that is forwarded to the variablesReady callback.
+	\return fmi2_import_t:: opaque object pointer
+*/
+FMILIB_EXPORT fmi2_import_t* fmi2_import_parse_xml_with_variables_callback( fmi_import_context_t* context, const char* dirPath, fmi2_xml_callbacks_t* xml_callbacks,
+                                                                            fmi2_import_variables_ready_ft variablesReady, void* data);
+
 /** 
 @}
 */
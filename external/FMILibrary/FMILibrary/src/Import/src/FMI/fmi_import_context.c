@@ -38,10 +38,18 @@ void fmi_import_set_configuration( fmi_import_context_t* c, int conf) {
     fmi_xml_set_configuration(c, conf);
 }
 
+/* Reads the FMI standard version from the model description in an unzipped FMU */
+static fmi_version_enu_t fmi_import_read_fmi_version( fmi_import_context_t* c, const char* dirName) {
+	fmi_version_enu_t ret;
+	char* mdpath = fmi_import_get_model_description_path(dirName, c->callbacks);
+	ret = fmi_xml_get_fmi_version(c, mdpath);
+	jm_log_info(c->callbacks, MODULE, "XML specifies FMI standard version %s", fmi_version_to_string(ret));
+	c->callbacks->free(mdpath);
+	return ret;
+}
+
 fmi_version_enu_t fmi_import_get_fmi_version( fmi_import_context_t* c, const char* fileName, const char* dirName) {
-	fmi_version_enu_t ret = fmi_version_unknown_enu;
 	jm_status_enu_t status;
-	char* mdpath;
 	jm_log_verbose(c->callbacks, MODULE, "Detecting FMI standard version");
 	if(!fileName || !*fileName) {
 		jm_log_fatal(c->callbacks, MODULE, "No FMU filename specified");
@@ -53,9 +61,37 @@ fmi_version_enu_t fmi_import_get_fmi_version( fmi_import_context_t* c, const cha
 	}
 	status = fmi_zip_unzip(fileName, dirName, c->callbacks);
 	if(status == jm_status_error) return fmi_version_unknown_enu;
-	mdpath = fmi_import_get_model_description_path(dirName, c->callbacks);
-	ret = fmi_xml_get_fmi_version(c, mdpath);
-	jm_log_info(c->callbacks, MODULE, "XML specifies FMI standard version %s", fmi_version_to_string(ret));
-	c->callbacks->free(mdpath);
+	return fmi_import_read_fmi_version(c, dirName);
+}
+
+fmi_version_enu_t fmi_import_get_fmi_version_cached( fmi_import_context_t* c, const char* fileName, const char* cacheDir, char** dirName) {
+	/* Entry names in the zip file always use '/' */
+	const char* prefixes[] = {
+		FMI_MODEL_DESCRIPTION_XML,
+		FMI_BINARIES "/" FMI_PLATFORM "/",
+		"resources/"
+	};
+	fmi_version_enu_t ret;
+	jm_log_verbose(c->callbacks, MODULE, "Detecting FMI standard version");
+	if(!dirName) {
+		jm_log_fatal(c->callbacks, MODULE, "No output argument for the directory name specified");
+		return fmi_version_unknown_enu;
+	}
+	*dirName = 0;
+	if(!fileName || !*fileName) {
+		jm_log_fatal(c->callbacks, MODULE, "No FMU filename specified");
+		return fmi_version_unknown_enu;
+	}
+	if(!cacheDir || !*cacheDir) {
+		jm_log_fatal(c->callbacks, MODULE, "No cache directory name specified");
+		return fmi_version_unknown_enu;
+	}
+	*dirName = fmi_zip_unzip_cached(fileName, cacheDir, sizeof(prefixes)/sizeof(prefixes[0]), prefixes, c->callbacks);
+	if(!*dirName) return fmi_version_unknown_enu;
+	ret = fmi_import_read_fmi_version(c, *dirName);
+	if(ret == fmi_version_unknown_enu) {
+		c->callbacks->free(*dirName);
+		*dirName = 0;
+	}
 	return ret;
 }
@@ -59,6 +59,24 @@ const char* fmi2_import_get_last_error(fmi2_import_t* fmu) {
 }
 
 fmi2_import_t* fmi2_import_parse_xml( fmi_import_context_t* context, const char* dirPath, fmi2_xml_callbacks_t* xml_callbacks) {
+	return fmi2_import_parse_xml_with_variables_callback(context, dirPath, xml_callbacks, 0, 0);
+}
+
+/** \brief Forwards the XML level variables ready callback to the import level one. */
+typedef struct fmi2_import_variables_ready_context_t {
+	fmi2_import_t* fmu;
+	fmi2_import_variables_ready_ft handle;
+	void* data;
+} fmi2_import_variables_ready_context_t;
+
+static int fmi2_import_variables_ready(fmi2_xml_model_description_t* md, void* context) {
+	fmi2_import_variables_ready_context_t* c = (fmi2_import_variables_ready_context_t*)context;
+	return c->handle(c->fmu, c->data);
+}
+
+fmi2_import_t* fmi2_import_parse_xml_with_variables_callback( fmi_import_context_t* context, const char* dirPath, fmi2_xml_callbacks_t* xml_callbacks,
+                                                              fmi2_import_variables_ready_ft variablesReady, void* data) {
+	fmi2_import_variables_ready_context_t readyContext;
 	char* xmlPath;
 	char absPath[FILENAME_MAX + 2];
 	fmi2_import_t* fmu = 0;
@@ -97,11 +115,24 @@ fmi2_import_t* fmi2_import_parse_xml( fmi_import_context_t* context, const char*
     if (context->configuration & FMI_IMPORT_NAME_CHECK) {
         configuration |= FMI2_XML_NAME_CHECK;
     }
+    if (context->configuration & FMI_IMPORT_MODEL_DESCRIPTION_CACHE) {
+        configuration |= FMI2_XML_MODEL_DESCRIPTION_CACHE;
+    }
+
+	if (variablesReady) {
+		readyContext.fmu = fmu;
+		readyContext.handle = variablesReady;
+		readyContext.data = data;
+		fmi2_xml_set_variables_ready_callback(fmu->md, fmi2_import_variables_ready, &readyContext);
+	}
 
 	if (fmi2_xml_parse_model_description( fmu->md, xmlPath, xml_callbacks, configuration)) {
 		fmi2_import_free(fmu);
 		fmu = 0;
 	}
+	else {
+		fmi2_xml_set_variables_ready_callback(fmu->md, 0, 0);
+	}
 	context->callbacks->free(xmlPath);
 
 	if(fmu)
@@ -106,6 +106,38 @@ fmi2_xml_model_description_t* fmi2_xml_allocate_model_description( jm_callbacks*
 */
 #define FMI2_XML_NAME_CHECK 1
 
+/**
+    \brief If this configuration option is set, the parsed model description is
+    saved to a binary cache file next to the XML file and read back from it on
+    subsequent calls as long as the XML file is unchanged. The cache is not used
+    when annotation callbacks are given.
+*/
+#define FMI2_XML_MODEL_DESCRIPTION_CACHE 2
+
+/**
+    \brief Callback invoked while parsing as soon as the model variables are available.
+
+    The callback is called when the ModelVariables element has been processed, i.e., when
+    the variables are sorted and the alias information is set, but before the ModelStructure
+    element is parsed. Variables may be looked up by name or value reference from within the
+    callback. Functions accessing the model structure must not be used.
+    @param md The model description being parsed.
+    @param context The context pointer given to fmi2_xml_set_variables_ready_callback().
+    @return 0 to continue parsing. Non-zero value aborts parsing with an error.
+*/
+typedef int (*fmi2_xml_variables_ready_ft)(fmi2_xml_model_description_t* md, void* context);
+
+/**
+    \brief Set the callback that is invoked as soon as the model variables are available.
+
+    When the model description is read from the binary cache the callback is invoked
+    right after loading, and then the model structure is already available.
+    @param md A model description object as returned by fmi2_xml_allocate_model_description.
+    @param handle The callback, or NULL to remove a previously set callback.
+    @param context A pointer that is forwarded to the callback.
+*/
+void fmi2_xml_set_variables_ready_callback(fmi2_xml_model_description_t* md, fmi2_xml_variables_ready_ft handle, void* context);
+
 /**
    \brief Parse XML file
    Repeaded calls invalidate the data structures created with the previous call to fmiParseXML,
@@ -115,7 +147,8 @@ fmi2_xml_model_description_t* fmi2_xml_allocate_model_description( jm_callbacks*
     @param fileName A name (full path) of the XML file name with model definition.
 	@param xml_callbacks Callbacks to use for processing annotations (may be NULL).
     @param configuration Specifies how to parse the model description, 0 is
-           default. Other possible configuration is FMI_XML_NAME_CHECK.
+           default. Other possible configurations are FMI2_XML_NAME_CHECK and
+           FMI2_XML_MODEL_DESCRIPTION_CACHE.
    @return 0 if parsing was successfull. Non-zero value indicates an error.
 */
 int fmi2_xml_parse_model_description( fmi2_xml_model_description_t* md,
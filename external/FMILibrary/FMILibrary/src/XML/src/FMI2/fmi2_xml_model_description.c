@@ -171,6 +171,11 @@ int fmi2_xml_is_model_description_empty(fmi2_xml_model_description_t* md) {
     return (md->status == fmi2_xml_model_description_enu_empty);
 }
 
+void fmi2_xml_set_variables_ready_callback(fmi2_xml_model_description_t* md, fmi2_xml_variables_ready_ft handle, void* context) {
+    md->variablesReadyHandle = handle;
+    md->variablesReadyContext = context;
+}
+
 const char* fmi2_xml_get_last_error(fmi2_xml_model_description_t* md) {
 	return jm_get_last_error(md->callbacks);
 }
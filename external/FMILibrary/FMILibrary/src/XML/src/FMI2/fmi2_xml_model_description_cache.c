@@ -0,0 +1,1341 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+/** \file fmi2_xml_model_description_cache.c
+*  \brief Binary cache of a parsed model description.
+*
+*  The cache file holds a header identifying the XML file it was created from
+*  (size and two 32 bit hashes of the content) followed by a payload with all
+*  the data in ::fmi2_xml_model_description_t. Pointers between the structures
+*  are stored as indices:
+*  - strings in the descriptions and quantities sets by their position in the set,
+*  - units and display units by their position in the definition vectors,
+*  - type structures by an id: 0-4 are the default types, then come the type
+*    definitions in sorted order and then the type properties list in list order,
+*  - variables by their position in variablesOrigOrder.
+*
+*  Data is stored in the native representation. The header records the byte order
+*  and the sizes of the basic types so that a cache written on another platform
+*  is ignored rather than misread. The payload is verified by its own hashes
+*  before anything is put into the model description.
+*/
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fmi2_xml_model_description_impl.h"
+#include "fmi2_xml_model_structure_impl.h"
+#include "fmi2_xml_type_impl.h"
+#include "fmi2_xml_unit_impl.h"
+#include "fmi2_xml_variable_impl.h"
+#include "fmi2_xml_model_description_cache.h"
+
+static const char* module = "FMI2XML";
+
+#define FMI2_XML_CACHE_MAGIC "FMIL2MDC"
+#define FMI2_XML_CACHE_MAGIC_SIZE 8
+#define FMI2_XML_CACHE_FORMAT_VERSION 1
+#define FMI2_XML_CACHE_BYTE_ORDER 0x01020304
+
+/* Reference to nothing (NULL pointer) */
+#define FMI2_XML_CACHE_NONE ((size_t)-1)
+/* Reference to a string literal "" that is not in a string set */
+#define FMI2_XML_CACHE_EMPTY_STRING ((size_t)-2)
+
+/* Type ids of the default types, followed by the type definitions and the type properties list */
+#define FMI2_XML_CACHE_NUM_DEFAULT_TYPES 5
+
+#define FMI2_XML_CACHE_HASH1_INIT 2166136261UL
+#define FMI2_XML_CACHE_HASH2_INIT 0UL
+
+#define FMI2_XML_CACHE_READ_BLOCK 16384
+
+/* Kinds of the structures on the type properties list */
+typedef enum fmi2_xml_cache_node_kind_enu_t {
+    fmi2_xml_cache_node_base,
+    fmi2_xml_cache_node_real_props,
+    fmi2_xml_cache_node_integer_props,
+    fmi2_xml_cache_node_enum_variable_props,
+    fmi2_xml_cache_node_enum_typedef_props,
+    fmi2_xml_cache_node_real_start,
+    fmi2_xml_cache_node_integer_start,
+    fmi2_xml_cache_node_string_start
+} fmi2_xml_cache_node_kind_enu_t;
+
+typedef struct fmi2_xml_cache_header_t {
+    char magic[FMI2_XML_CACHE_MAGIC_SIZE];
+    unsigned int formatVersion;
+    unsigned int byteOrder;
+    unsigned char typeSizes[4];
+    size_t xmlSize;
+    unsigned long xmlHash1;
+    unsigned long xmlHash2;
+    size_t payloadSize;
+    unsigned long payloadHash1;
+    unsigned long payloadHash2;
+} fmi2_xml_cache_header_t;
+
+typedef struct fmi2_xml_cache_writer_t {
+    jm_callbacks* callbacks;
+    char* data;
+    size_t size;
+    size_t capacity;
+    int err;
+} fmi2_xml_cache_writer_t;
+
+typedef struct fmi2_xml_cache_reader_t {
+    const char* cur;
+    const char* end;
+    int err;
+} fmi2_xml_cache_reader_t;
+
+/* Sorted pointer to index map used to translate pointers when saving */
+typedef struct fmi2_xml_cache_map_item_t {
+    const void* ptr;
+    size_t id;
+} fmi2_xml_cache_map_item_t;
+
+typedef struct fmi2_xml_cache_map_t {
+    fmi2_xml_cache_map_item_t* items;
+    size_t size;
+} fmi2_xml_cache_map_t;
+
+/* FNV-1a and sdbm hashes, both truncated to 32 bits */
+static void fmi2_xml_cache_hash(const char* data, size_t n, unsigned long* hash1, unsigned long* hash2) {
+    unsigned long h1 = *hash1, h2 = *hash2;
+    size_t i;
+    for(i = 0; i < n; i++) {
+        unsigned long c = (unsigned char)data[i];
+        h1 = ((h1 ^ c) * 16777619UL) & 0xFFFFFFFFUL;
+        h2 = (c + (h2 << 6) + (h2 << 16) - h2) & 0xFFFFFFFFUL;
+    }
+    *hash1 = h1;
+    *hash2 = h2;
+}
+
+static int fmi2_xml_cache_hash_file(const char* fileName, size_t* size, unsigned long* hash1, unsigned long* hash2) {
+    char buf[FMI2_XML_CACHE_READ_BLOCK];
+    FILE* file = fopen(fileName, "rb");
+    if(!file) return -1;
+    *size = 0;
+    *hash1 = FMI2_XML_CACHE_HASH1_INIT;
+    *hash2 = FMI2_XML_CACHE_HASH2_INIT;
+    while(!feof(file)) {
+        size_t n = fread(buf, 1, sizeof(buf), file);
+        if(ferror(file)) {
+            fclose(file);
+            return -1;
+        }
+        fmi2_xml_cache_hash(buf, n, hash1, hash2);
+        *size += n;
+    }
+    fclose(file);
+    return 0;
+}
+
+static char* fmi2_xml_cache_file_name(jm_callbacks* cb, const char* xmlFileName, const char* suffix) {
+    size_t len = strlen(xmlFileName);
+    char* name = (char*)cb->malloc(len + strlen(FMI2_XML_MODEL_DESCRIPTION_CACHE_SUFFIX) + strlen(suffix) + 1);
+    if(!name) return 0;
+    memcpy(name, xmlFileName, len);
+    strcpy(name + len, FMI2_XML_MODEL_DESCRIPTION_CACHE_SUFFIX);
+    strcat(name, suffix);
+    return name;
+}
+
+static void fmi2_xml_cache_init_header(fmi2_xml_cache_header_t* h) {
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, FMI2_XML_CACHE_MAGIC, FMI2_XML_CACHE_MAGIC_SIZE);
+    h->formatVersion = FMI2_XML_CACHE_FORMAT_VERSION;
+    h->byteOrder = FMI2_XML_CACHE_BYTE_ORDER;
+    h->typeSizes[0] = (unsigned char)sizeof(size_t);
+    h->typeSizes[1] = (unsigned char)sizeof(double);
+    h->typeSizes[2] = (unsigned char)sizeof(int);
+    h->typeSizes[3] = (unsigned char)sizeof(unsigned long);
+}
+
+/* ---------------------------------------------------------------- */
+/* Writing */
+
+static void fmi2_xml_cache_put(fmi2_xml_cache_writer_t* w, const void* src, size_t n) {
+    if(w->err) return;
+    if(w->size + n > w->capacity) {
+        size_t capacity = 2 * w->capacity + n + 1024;
+        char* data = (char*)w->callbacks->realloc(w->data, capacity);
+        if(!data) {
+            w->err = 1;
+            return;
+        }
+        w->data = data;
+        w->capacity = capacity;
+    }
+    if(n) memcpy(w->data + w->size, src, n);
+    w->size += n;
+}
+
+static void fmi2_xml_cache_put_size(fmi2_xml_cache_writer_t* w, size_t v) {
+    fmi2_xml_cache_put(w, &v, sizeof(v));
+}
+
+static void fmi2_xml_cache_put_int(fmi2_xml_cache_writer_t* w, int v) {
+    fmi2_xml_cache_put(w, &v, sizeof(v));
+}
+
+static void fmi2_xml_cache_put_uint(fmi2_xml_cache_writer_t* w, unsigned int v) {
+    fmi2_xml_cache_put(w, &v, sizeof(v));
+}
+
+static void fmi2_xml_cache_put_double(fmi2_xml_cache_writer_t* w, double v) {
+    fmi2_xml_cache_put(w, &v, sizeof(v));
+}
+
+static void fmi2_xml_cache_put_char(fmi2_xml_cache_writer_t* w, char v) {
+    fmi2_xml_cache_put(w, &v, 1);
+}
+
+/* Strings are stored with the terminating zero */
+static void fmi2_xml_cache_put_string(fmi2_xml_cache_writer_t* w, const char* s) {
+    size_t len;
+    if(!s) {
+        w->err = 1;
+        return;
+    }
+    len = strlen(s) + 1;
+    fmi2_xml_cache_put_size(w, len);
+    fmi2_xml_cache_put(w, s, len);
+}
+
+static void fmi2_xml_cache_put_char_vector(fmi2_xml_cache_writer_t* w, jm_vector(char)* v) {
+    size_t n = jm_vector_get_size(char)(v);
+    fmi2_xml_cache_put_size(w, n);
+    if(n) fmi2_xml_cache_put(w, jm_vector_get_itemp(char)(v, 0), n);
+}
+
+static void fmi2_xml_cache_put_strings(fmi2_xml_cache_writer_t* w, jm_vector(jm_string)* v) {
+    size_t i, n = jm_vector_get_size(jm_string)(v);
+    fmi2_xml_cache_put_size(w, n);
+    for(i = 0; i < n; i++) {
+        fmi2_xml_cache_put_string(w, jm_vector_get_item(jm_string)(v, i));
+    }
+}
+
+static void fmi2_xml_cache_put_set_ref(fmi2_xml_cache_writer_t* w, jm_string_set* set, const char* s) {
+    jm_string* found;
+    if(!s) {
+        fmi2_xml_cache_put_size(w, FMI2_XML_CACHE_NONE);
+        return;
+    }
+    found = jm_vector_bsearch(jm_string)(set, &s, jm_compare_string);
+    if(found) {
+        fmi2_xml_cache_put_size(w, (size_t)(found - jm_vector_get_itemp(jm_string)(set, 0)));
+    }
+    else if(s[0] == 0) {
+        fmi2_xml_cache_put_size(w, FMI2_XML_CACHE_EMPTY_STRING);
+    }
+    else {
+        w->err = 1;
+    }
+}
+
+static int fmi2_xml_cache_compare_map_item(const void* first, const void* second) {
+    const char* a = (const char*)((const fmi2_xml_cache_map_item_t*)first)->ptr;
+    const char* b = (const char*)((const fmi2_xml_cache_map_item_t*)second)->ptr;
+    if(a < b) return -1;
+    if(a > b) return 1;
+    return 0;
+}
+
+static int fmi2_xml_cache_map_alloc(jm_callbacks* cb, fmi2_xml_cache_map_t* map, size_t n) {
+    map->size = 0;
+    map->items = (fmi2_xml_cache_map_item_t*)cb->malloc((n + 1) * sizeof(fmi2_xml_cache_map_item_t));
+    return map->items ? 0 : -1;
+}
+
+static void fmi2_xml_cache_map_add(fmi2_xml_cache_map_t* map, const void* ptr, size_t id) {
+    map->items[map->size].ptr = ptr;
+    map->items[map->size].id = id;
+    map->size++;
+}
+
+static void fmi2_xml_cache_map_sort(fmi2_xml_cache_map_t* map) {
+    qsort(map->items, map->size, sizeof(fmi2_xml_cache_map_item_t), fmi2_xml_cache_compare_map_item);
+}
+
+static size_t fmi2_xml_cache_map_find(fmi2_xml_cache_map_t* map, const void* ptr) {
+    fmi2_xml_cache_map_item_t key, *found;
+    key.ptr = ptr;
+    found = (fmi2_xml_cache_map_item_t*)bsearch(&key, map->items, map->size, sizeof(fmi2_xml_cache_map_item_t), fmi2_xml_cache_compare_map_item);
+    return found ? found->id : FMI2_XML_CACHE_NONE;
+}
+
+static void fmi2_xml_cache_put_ref(fmi2_xml_cache_writer_t* w, fmi2_xml_cache_map_t* map, const void* ptr) {
+    size_t id;
+    if(!ptr) {
+        fmi2_xml_cache_put_size(w, FMI2_XML_CACHE_NONE);
+        return;
+    }
+    id = fmi2_xml_cache_map_find(map, ptr);
+    if(id == FMI2_XML_CACHE_NONE) {
+        w->err = 1;
+        return;
+    }
+    fmi2_xml_cache_put_size(w, id);
+}
+
+static void fmi2_xml_cache_put_refs(fmi2_xml_cache_writer_t* w, fmi2_xml_cache_map_t* map, jm_vector(jm_voidp)* v) {
+    size_t i, n = jm_vector_get_size(jm_voidp)(v);
+    fmi2_xml_cache_put_size(w, n);
+    for(i = 0; i < n; i++) {
+        fmi2_xml_cache_put_ref(w, map, jm_vector_get_item(jm_voidp)(v, i));
+    }
+}
+
+static void fmi2_xml_cache_put_type_base(fmi2_xml_cache_writer_t* w, fmi2_xml_cache_map_t* types, fmi2_xml_variable_type_base_t* type) {
+    fmi2_xml_cache_put_char(w, type->baseType);
+    fmi2_xml_cache_put_char(w, type->isRelativeQuantity);
+    fmi2_xml_cache_put_char(w, type->isUnbounded);
+    fmi2_xml_cache_put_ref(w, types, type->baseTypeStruct);
+}
+
+static void fmi2_xml_cache_put_dependencies(fmi2_xml_cache_writer_t* w, fmi2_xml_dependencies_t* dep) {
+    size_t n;
+    fmi2_xml_cache_put_char(w, dep != 0);
+    if(!dep) return;
+    fmi2_xml_cache_put_int(w, dep->isRowMajor);
+    n = jm_vector_get_size(size_t)(&dep->startIndex);
+    fmi2_xml_cache_put_size(w, n);
+    if(n) fmi2_xml_cache_put(w, jm_vector_get_itemp(size_t)(&dep->startIndex, 0), n * sizeof(size_t));
+    n = jm_vector_get_size(size_t)(&dep->dependencyIndex);
+    fmi2_xml_cache_put_size(w, n);
+    if(n) fmi2_xml_cache_put(w, jm_vector_get_itemp(size_t)(&dep->dependencyIndex, 0), n * sizeof(size_t));
+    fmi2_xml_cache_put_char_vector(w, &dep->dependencyFactorKind);
+}
+
+static fmi2_xml_cache_node_kind_enu_t fmi2_xml_cache_get_node_kind(fmi2_xml_variable_type_base_t* type, fmi2_xml_cache_map_t* enumTypedefProps) {
+    if(type->structKind == fmi2_xml_type_struct_enu_start) {
+        switch(type->baseType) {
+        case fmi2_base_type_real: return fmi2_xml_cache_node_real_start;
+        case fmi2_base_type_str: return fmi2_xml_cache_node_string_start;
+        default: return fmi2_xml_cache_node_integer_start;
+        }
+    }
+    switch(type->baseType) {
+    case fmi2_base_type_real: return fmi2_xml_cache_node_real_props;
+    case fmi2_base_type_int: return fmi2_xml_cache_node_integer_props;
+    case fmi2_base_type_enum:
+        /* Type definitions and variables both base their enumeration properties on the default type */
+        if(fmi2_xml_cache_map_find(enumTypedefProps, type) != FMI2_XML_CACHE_NONE)
+            return fmi2_xml_cache_node_enum_typedef_props;
+        return fmi2_xml_cache_node_enum_variable_props;
+    default: return fmi2_xml_cache_node_base;
+    }
+}
+
+static void fmi2_xml_cache_put_display_unit(fmi2_xml_cache_writer_t* w, fmi2_xml_cache_map_t* units, fmi2_xml_cache_map_t* displayUnits, fmi2_xml_display_unit_t* du) {
+    size_t id;
+    if(!du) {
+        fmi2_xml_cache_put_size(w, 0);
+        return;
+    }
+    if(du->baseUnit && (du == &du->baseUnit->defaultDisplay)) {
+        id = fmi2_xml_cache_map_find(units, du->baseUnit);
+        if(id == FMI2_XML_CACHE_NONE) {
+            w->err = 1;
+            return;
+        }
+        fmi2_xml_cache_put_size(w, 2 * id + 1);
+        return;
+    }
+    id = fmi2_xml_cache_map_find(displayUnits, du);
+    if(id == FMI2_XML_CACHE_NONE) {
+        w->err = 1;
+        return;
+    }
+    fmi2_xml_cache_put_size(w, 2 * id + 2);
+}
+
+static void fmi2_xml_cache_put_units(fmi2_xml_cache_writer_t* w, fmi2_xml_model_description_t* md, fmi2_xml_cache_map_t* units, fmi2_xml_cache_map_t* displayUnits) {
+    size_t i, k, n = jm_vector_get_size(jm_named_ptr)(&md->unitDefinitions);
+    size_t nd = jm_vector_get_size(jm_named_ptr)(&md->displayUnitDefinitions);
+    int j;
+
+    fmi2_xml_cache_put_size(w, n);
+    for(i = 0; i < n; i++) {
+        jm_named_ptr named = jm_vector_get_item(jm_named_ptr)(&md->unitDefinitions, i);
+        fmi2_xml_unit_t* u = (fmi2_xml_unit_t*)named.ptr;
+        fmi2_xml_cache_put_string(w, named.name);
+        for(j = 0; j < fmi2_SI_base_units_Num; j++)
+            fmi2_xml_cache_put_int(w, u->SI_base_unit_exp[j]);
+        fmi2_xml_cache_put_double(w, u->factor);
+        fmi2_xml_cache_put_double(w, u->offset);
+        fmi2_xml_cache_put_double(w, u->defaultDisplay.factor);
+        fmi2_xml_cache_put_double(w, u->defaultDisplay.offset);
+    }
+    fmi2_xml_cache_put_size(w, nd);
+    for(i = 0; i < nd; i++) {
+        jm_named_ptr named = jm_vector_get_item(jm_named_ptr)(&md->displayUnitDefinitions, i);
+        fmi2_xml_display_unit_t* du = (fmi2_xml_display_unit_t*)named.ptr;
+        fmi2_xml_cache_put_string(w, named.name);
+        fmi2_xml_cache_put_double(w, du->factor);
+        fmi2_xml_cache_put_double(w, du->offset);
+        fmi2_xml_cache_put_ref(w, units, du->baseUnit);
+    }
+    for(i = 0; i < n; i++) {
+        fmi2_xml_unit_t* u = (fmi2_xml_unit_t*)jm_vector_get_item(jm_named_ptr)(&md->unitDefinitions, i).ptr;
+        size_t ndu = jm_vector_get_size(jm_voidp)(&u->displayUnits);
+        fmi2_xml_cache_put_size(w, ndu);
+        for(k = 0; k < ndu; k++)
+            fmi2_xml_cache_put_ref(w, displayUnits, jm_vector_get_item(jm_voidp)(&u->displayUnits, k));
+    }
+}
+
+static void fmi2_xml_cache_put_types(fmi2_xml_cache_writer_t* w, fmi2_xml_model_description_t* md,
+                                     fmi2_xml_cache_map_t* types, fmi2_xml_cache_map_t* enumTypedefProps,
+                                     fmi2_xml_cache_map_t* units, fmi2_xml_cache_map_t* displayUnits) {
+    fmi2_xml_type_definitions_t* td = &md->typeDefinitions;
+    size_t i, nt = jm_vector_get_size(jm_named_ptr)(&td->typeDefinitions);
+    size_t nl = types->size - FMI2_XML_CACHE_NUM_DEFAULT_TYPES - nt;
+    fmi2_xml_variable_type_base_t* cur;
+
+    fmi2_xml_cache_put_size(w, nt);
+    fmi2_xml_cache_put_size(w, nl);
+    for(i = 0; i < nt; i++) {
+        jm_named_ptr named = jm_vector_get_item(jm_named_ptr)(&td->typeDefinitions, i);
+        fmi2_xml_variable_typedef_t* type = (fmi2_xml_variable_typedef_t*)named.ptr;
+        fmi2_xml_cache_put_string(w, named.name);
+        fmi2_xml_cache_put_set_ref(w, &md->descriptions, type->description);
+        fmi2_xml_cache_put_type_base(w, types, &type->typeBase);
+    }
+    for(cur = td->typePropsList; cur; cur = cur->next) {
+        fmi2_xml_cache_node_kind_enu_t kind = fmi2_xml_cache_get_node_kind(cur, enumTypedefProps);
+        fmi2_xml_cache_put_char(w, (char)kind);
+        fmi2_xml_cache_put_type_base(w, types, cur);
+        switch(kind) {
+        case fmi2_xml_cache_node_real_props: {
+            fmi2_xml_real_type_props_t* props = (fmi2_xml_real_type_props_t*)cur;
+            fmi2_xml_cache_put_set_ref(w, &td->quantities, props->quantity);
+            fmi2_xml_cache_put_display_unit(w, units, displayUnits, props->displayUnit);
+            fmi2_xml_cache_put_double(w, props->typeMin);
+            fmi2_xml_cache_put_double(w, props->typeMax);
+            fmi2_xml_cache_put_double(w, props->typeNominal);
+            break;
+        }
+        case fmi2_xml_cache_node_integer_props: {
+            fmi2_xml_integer_type_props_t* props = (fmi2_xml_integer_type_props_t*)cur;
+            fmi2_xml_cache_put_set_ref(w, &td->quantities, props->quantity);
+            fmi2_xml_cache_put_int(w, props->typeMin);
+            fmi2_xml_cache_put_int(w, props->typeMax);
+            break;
+        }
+        case fmi2_xml_cache_node_enum_variable_props:
+        case fmi2_xml_cache_node_enum_typedef_props: {
+            fmi2_xml_enum_variable_props_t* props = (fmi2_xml_enum_variable_props_t*)cur;
+            fmi2_xml_cache_put_set_ref(w, &td->quantities, props->quantity);
+            fmi2_xml_cache_put_int(w, props->typeMin);
+            fmi2_xml_cache_put_int(w, props->typeMax);
+            if(kind == fmi2_xml_cache_node_enum_typedef_props) {
+                jm_vector(jm_named_ptr)* items = &((fmi2_xml_enum_typedef_props_t*)cur)->enumItems;
+                size_t k, ni = jm_vector_get_size(jm_named_ptr)(items);
+                fmi2_xml_cache_put_size(w, ni);
+                for(k = 0; k < ni; k++) {
+                    fmi2_xml_enum_type_item_t* item = (fmi2_xml_enum_type_item_t*)jm_vector_get_item(jm_named_ptr)(items, k).ptr;
+                    fmi2_xml_cache_put_string(w, item->itemName);
+                    fmi2_xml_cache_put_int(w, item->value);
+                    fmi2_xml_cache_put_string(w, item->itemDesciption);
+                }
+            }
+            break;
+        }
+        case fmi2_xml_cache_node_real_start:
+            fmi2_xml_cache_put_double(w, ((fmi2_xml_variable_start_real_t*)cur)->start);
+            break;
+        case fmi2_xml_cache_node_integer_start:
+            fmi2_xml_cache_put_int(w, ((fmi2_xml_variable_start_integer_t*)cur)->start);
+            break;
+        case fmi2_xml_cache_node_string_start:
+            fmi2_xml_cache_put_string(w, ((fmi2_xml_variable_start_string_t*)cur)->start);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+static void fmi2_xml_cache_put_variables(fmi2_xml_cache_writer_t* w, fmi2_xml_model_description_t* md,
+                                         fmi2_xml_cache_map_t* types, fmi2_xml_cache_map_t* variables) {
+    size_t i, n = variables->size;
+
+    if(!md->variablesOrigOrder) {
+        if(jm_vector_get_size(jm_named_ptr)(&md->variablesByName) || md->variablesByVR) w->err = 1;
+        fmi2_xml_cache_put_size(w, FMI2_XML_CACHE_NONE);
+        return;
+    }
+    if(jm_vector_get_size(jm_named_ptr)(&md->variablesByName) != n) {
+        w->err = 1;
+        return;
+    }
+    fmi2_xml_cache_put_size(w, n);
+    for(i = 0; i < n; i++) {
+        fmi2_xml_variable_t* v = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(md->variablesOrigOrder, i);
+        fmi2_xml_cache_put_string(w, v->name);
+        fmi2_xml_cache_put_set_ref(w, &md->descriptions, v->description);
+        fmi2_xml_cache_put_ref(w, types, v->typeBase);
+        fmi2_xml_cache_put_ref(w, variables, v->derivativeOf);
+        fmi2_xml_cache_put_ref(w, variables, v->previous);
+        fmi2_xml_cache_put_uint(w, v->vr);
+        fmi2_xml_cache_put_size(w, v->originalIndex);
+        fmi2_xml_cache_put_char(w, v->aliasKind);
+        fmi2_xml_cache_put_char(w, v->initial);
+        fmi2_xml_cache_put_char(w, v->variability);
+        fmi2_xml_cache_put_char(w, v->causality);
+        fmi2_xml_cache_put_char(w, v->reinit);
+        fmi2_xml_cache_put_char(w, v->canHandleMultipleSetPerTimeInstant);
+    }
+    for(i = 0; i < n; i++) {
+        fmi2_xml_cache_put_ref(w, variables, jm_vector_get_item(jm_named_ptr)(&md->variablesByName, i).ptr);
+    }
+    if(md->variablesByVR) {
+        fmi2_xml_cache_put_char(w, 1);
+        fmi2_xml_cache_put_refs(w, variables, md->variablesByVR);
+    }
+    else {
+        fmi2_xml_cache_put_char(w, 0);
+    }
+}
+
+static void fmi2_xml_cache_put_model_structure(fmi2_xml_cache_writer_t* w, fmi2_xml_model_structure_t* ms, fmi2_xml_cache_map_t* variables) {
+    fmi2_xml_cache_put_char(w, ms != 0);
+    if(!ms) return;
+    fmi2_xml_cache_put_refs(w, variables, &ms->outputs);
+    fmi2_xml_cache_put_refs(w, variables, &ms->derivatives);
+    fmi2_xml_cache_put_refs(w, variables, &ms->discreteStates);
+    fmi2_xml_cache_put_refs(w, variables, &ms->initialUnknowns);
+    fmi2_xml_cache_put_dependencies(w, ms->outputDeps);
+    fmi2_xml_cache_put_dependencies(w, ms->derivativeDeps);
+    fmi2_xml_cache_put_dependencies(w, ms->discreteStateDeps);
+    fmi2_xml_cache_put_dependencies(w, ms->initialUnknownDeps);
+    fmi2_xml_cache_put_int(w, ms->isValidFlag);
+}
+
+/* Serialize the model description into w. Returns non-zero if it could not be represented. */
+static int fmi2_xml_cache_put_model_description(fmi2_xml_cache_writer_t* w, fmi2_xml_model_description_t* md) {
+    jm_callbacks* cb = md->callbacks;
+    fmi2_xml_type_definitions_t* td = &md->typeDefinitions;
+    fmi2_xml_cache_map_t units, displayUnits, types, enumTypedefProps, variables;
+    fmi2_xml_variable_type_base_t* cur;
+    size_t i, n, nl = 0;
+    int ret = -1;
+
+    units.items = displayUnits.items = types.items = enumTypedefProps.items = variables.items = 0;
+    for(cur = td->typePropsList; cur; cur = cur->next) nl++;
+
+    n = jm_vector_get_size(jm_named_ptr)(&td->typeDefinitions);
+    if(fmi2_xml_cache_map_alloc(cb, &units, jm_vector_get_size(jm_named_ptr)(&md->unitDefinitions)) ||
+       fmi2_xml_cache_map_alloc(cb, &displayUnits, jm_vector_get_size(jm_named_ptr)(&md->displayUnitDefinitions)) ||
+       fmi2_xml_cache_map_alloc(cb, &types, FMI2_XML_CACHE_NUM_DEFAULT_TYPES + n + nl) ||
+       fmi2_xml_cache_map_alloc(cb, &enumTypedefProps, n) ||
+       fmi2_xml_cache_map_alloc(cb, &variables, md->variablesOrigOrder ? jm_vector_get_size(jm_voidp)(md->variablesOrigOrder) : 0))
+        goto cleanup;
+
+    for(i = 0; i < jm_vector_get_size(jm_named_ptr)(&md->unitDefinitions); i++)
+        fmi2_xml_cache_map_add(&units, jm_vector_get_item(jm_named_ptr)(&md->unitDefinitions, i).ptr, i);
+    fmi2_xml_cache_map_sort(&units);
+    for(i = 0; i < jm_vector_get_size(jm_named_ptr)(&md->displayUnitDefinitions); i++)
+        fmi2_xml_cache_map_add(&displayUnits, jm_vector_get_item(jm_named_ptr)(&md->displayUnitDefinitions, i).ptr, i);
+    fmi2_xml_cache_map_sort(&displayUnits);
+
+    fmi2_xml_cache_map_add(&types, &td->defaultRealType.typeBase, 0);
+    fmi2_xml_cache_map_add(&types, &td->defaultEnumType.base.typeBase, 1);
+    fmi2_xml_cache_map_add(&types, &td->defaultIntegerType.typeBase, 2);
+    fmi2_xml_cache_map_add(&types, &td->defaultBooleanType, 3);
+    fmi2_xml_cache_map_add(&types, &td->defaultStringType, 4);
+    for(i = 0; i < n; i++) {
+        fmi2_xml_variable_typedef_t* type = (fmi2_xml_variable_typedef_t*)jm_vector_get_item(jm_named_ptr)(&td->typeDefinitions, i).ptr;
+        fmi2_xml_cache_map_add(&types, type, FMI2_XML_CACHE_NUM_DEFAULT_TYPES + i);
+        if(type->typeBase.baseType == fmi2_base_type_enum && type->typeBase.baseTypeStruct)
+            fmi2_xml_cache_map_add(&enumTypedefProps, type->typeBase.baseTypeStruct, i);
+    }
+    for(cur = td->typePropsList, i = FMI2_XML_CACHE_NUM_DEFAULT_TYPES + n; cur; cur = cur->next, i++)
+        fmi2_xml_cache_map_add(&types, cur, i);
+    fmi2_xml_cache_map_sort(&types);
+    fmi2_xml_cache_map_sort(&enumTypedefProps);
+
+    if(md->variablesOrigOrder) {
+        for(i = 0; i < jm_vector_get_size(jm_voidp)(md->variablesOrigOrder); i++)
+            fmi2_xml_cache_map_add(&variables, jm_vector_get_item(jm_voidp)(md->variablesOrigOrder, i), i);
+        fmi2_xml_cache_map_sort(&variables);
+    }
+
+    fmi2_xml_cache_put_char_vector(w, &md->fmi2_xml_standard_version);
+    fmi2_xml_cache_put_char_vector(w, &md->modelName);
+    fmi2_xml_cache_put_char_vector(w, &md->GUID);
+    fmi2_xml_cache_put_char_vector(w, &md->description);
+    fmi2_xml_cache_put_char_vector(w, &md->author);
+    fmi2_xml_cache_put_char_vector(w, &md->copyright);
+    fmi2_xml_cache_put_char_vector(w, &md->license);
+    fmi2_xml_cache_put_char_vector(w, &md->version);
+    fmi2_xml_cache_put_char_vector(w, &md->generationTool);
+    fmi2_xml_cache_put_char_vector(w, &md->generationDateAndTime);
+    fmi2_xml_cache_put_char_vector(w, &md->modelIdentifierME);
+    fmi2_xml_cache_put_char_vector(w, &md->modelIdentifierCS);
+    fmi2_xml_cache_put_int(w, (int)md->namingConvension);
+    fmi2_xml_cache_put_size(w, md->numberOfContinuousStates);
+    fmi2_xml_cache_put_size(w, md->numberOfEventIndicators);
+    fmi2_xml_cache_put_double(w, md->defaultExperimentStartTime);
+    fmi2_xml_cache_put_double(w, md->defaultExperimentStopTime);
+    fmi2_xml_cache_put_double(w, md->defaultExperimentTolerance);
+    fmi2_xml_cache_put_double(w, md->defaultExperimentStepSize);
+    fmi2_xml_cache_put_int(w, (int)md->fmuKind);
+    for(i = 0; i < fmi2_capabilities_Num; i++)
+        fmi2_xml_cache_put_uint(w, md->capabilities[i]);
+
+    fmi2_xml_cache_put_strings(w, &md->sourceFilesME);
+    fmi2_xml_cache_put_strings(w, &md->sourceFilesCS);
+    fmi2_xml_cache_put_strings(w, &md->logCategories);
+    fmi2_xml_cache_put_strings(w, &md->logCategoryDescriptions);
+    fmi2_xml_cache_put_strings(w, &md->vendorList);
+    fmi2_xml_cache_put_strings(w, &md->descriptions);
+    fmi2_xml_cache_put_strings(w, &td->quantities);
+
+    fmi2_xml_cache_put_units(w, md, &units, &displayUnits);
+    fmi2_xml_cache_put_types(w, md, &types, &enumTypedefProps, &units, &displayUnits);
+    fmi2_xml_cache_put_variables(w, md, &types, &variables);
+    fmi2_xml_cache_put_model_structure(w, md->modelStructure, &variables);
+
+    ret = w->err ? -1 : 0;
+
+cleanup:
+    cb->free(units.items);
+    cb->free(displayUnits.items);
+    cb->free(types.items);
+    cb->free(enumTypedefProps.items);
+    cb->free(variables.items);
+    return ret;
+}
+
+int fmi2_xml_save_model_description_cache(fmi2_xml_model_description_t* md, const char* xmlFileName) {
+    jm_callbacks* cb = md->callbacks;
+    fmi2_xml_cache_writer_t w;
+    fmi2_xml_cache_header_t header;
+    char suffix[64];
+    char* cacheName = 0;
+    char* tmpName = 0;
+    FILE* file;
+    int ret = -1;
+
+    fmi2_xml_cache_init_header(&header);
+    if(fmi2_xml_cache_hash_file(xmlFileName, &header.xmlSize, &header.xmlHash1, &header.xmlHash2)) {
+        jm_log_verbose(cb, module, "Could not read '%s' to create the model description cache", xmlFileName);
+        return -1;
+    }
+
+    w.callbacks = cb;
+    w.data = 0;
+    w.size = w.capacity = 0;
+    w.err = 0;
+    if(fmi2_xml_cache_put_model_description(&w, md)) {
+        jm_log_verbose(cb, module, "The model description could not be stored in a cache");
+        cb->free(w.data);
+        return -1;
+    }
+    header.payloadSize = w.size;
+    header.payloadHash1 = FMI2_XML_CACHE_HASH1_INIT;
+    header.payloadHash2 = FMI2_XML_CACHE_HASH2_INIT;
+    fmi2_xml_cache_hash(w.data, w.size, &header.payloadHash1, &header.payloadHash2);
+
+    /* Write to a temporary file that is renamed when complete so that readers never see a partial file */
+    sprintf(suffix, ".%p.tmp", (void*)md);
+    cacheName = fmi2_xml_cache_file_name(cb, xmlFileName, "");
+    tmpName = fmi2_xml_cache_file_name(cb, xmlFileName, suffix);
+    if(!cacheName || !tmpName) goto cleanup;
+
+    file = fopen(tmpName, "wb");
+    if(!file) {
+        jm_log_verbose(cb, module, "Could not create model description cache file '%s'", tmpName);
+        goto cleanup;
+    }
+    if((fwrite(&header, sizeof(header), 1, file) != 1) ||
+       (w.size && (fwrite(w.data, 1, w.size, file) != w.size))) {
+        fclose(file);
+        remove(tmpName);
+        jm_log_verbose(cb, module, "Could not write model description cache file '%s'", tmpName);
+        goto cleanup;
+    }
+    if(fclose(file)) {
+        remove(tmpName);
+        goto cleanup;
+    }
+    if(rename(tmpName, cacheName)) {
+        /* rename does not replace an existing file on Windows */
+        remove(cacheName);
+        if(rename(tmpName, cacheName)) {
+            remove(tmpName);
+            jm_log_verbose(cb, module, "Could not create model description cache file '%s'", cacheName);
+            goto cleanup;
+        }
+    }
+    jm_log_verbose(cb, module, "Saved model description cache '%s'", cacheName);
+    ret = 0;
+
+cleanup:
+    cb->free(cacheName);
+    cb->free(tmpName);
+    cb->free(w.data);
+    return ret;
+}
+
+/* ---------------------------------------------------------------- */
+/* Reading */
+
+static void fmi2_xml_cache_get(fmi2_xml_cache_reader_t* r, void* dst, size_t n) {
+    if(r->err || ((size_t)(r->end - r->cur) < n)) {
+        r->err = 1;
+        memset(dst, 0, n);
+        return;
+    }
+    memcpy(dst, r->cur, n);
+    r->cur += n;
+}
+
+static size_t fmi2_xml_cache_get_size(fmi2_xml_cache_reader_t* r) {
+    size_t v;
+    fmi2_xml_cache_get(r, &v, sizeof(v));
+    return v;
+}
+
+static int fmi2_xml_cache_get_int(fmi2_xml_cache_reader_t* r) {
+    int v;
+    fmi2_xml_cache_get(r, &v, sizeof(v));
+    return v;
+}
+
+static unsigned int fmi2_xml_cache_get_uint(fmi2_xml_cache_reader_t* r) {
+    unsigned int v;
+    fmi2_xml_cache_get(r, &v, sizeof(v));
+    return v;
+}
+
+static double fmi2_xml_cache_get_double(fmi2_xml_cache_reader_t* r) {
+    double v;
+    fmi2_xml_cache_get(r, &v, sizeof(v));
+    return v;
+}
+
+static char fmi2_xml_cache_get_char(fmi2_xml_cache_reader_t* r) {
+    char v;
+    fmi2_xml_cache_get(r, &v, 1);
+    return v;
+}
+
+/* Returns a pointer into the payload to a zero terminated string */
+static const char* fmi2_xml_cache_get_string(fmi2_xml_cache_reader_t* r) {
+    size_t len = fmi2_xml_cache_get_size(r);
+    const char* s;
+    if(r->err || (len == 0) || ((size_t)(r->end - r->cur) < len) || (r->cur[len - 1] != 0)) {
+        r->err = 1;
+        return "";
+    }
+    s = r->cur;
+    r->cur += len;
+    return s;
+}
+
+/* Index that must be less than n or FMI2_XML_CACHE_NONE */
+static size_t fmi2_xml_cache_get_ref(fmi2_xml_cache_reader_t* r, size_t n) {
+    size_t id = fmi2_xml_cache_get_size(r);
+    if((id != FMI2_XML_CACHE_NONE) && (id >= n)) {
+        r->err = 1;
+        return FMI2_XML_CACHE_NONE;
+    }
+    return id;
+}
+
+static const char* fmi2_xml_cache_get_set_ref(fmi2_xml_cache_reader_t* r, jm_string_set* set) {
+    size_t id = fmi2_xml_cache_get_size(r);
+    if(id == FMI2_XML_CACHE_NONE) return 0;
+    if(id == FMI2_XML_CACHE_EMPTY_STRING) return "";
+    if(id >= jm_vector_get_size(jm_string)(set)) {
+        r->err = 1;
+        return 0;
+    }
+    return jm_vector_get_item(jm_string)(set, id);
+}
+
+static int fmi2_xml_cache_get_char_vector(fmi2_xml_cache_reader_t* r, jm_vector(char)* v) {
+    size_t n = fmi2_xml_cache_get_size(r);
+    if(r->err || ((size_t)(r->end - r->cur) < n)) {
+        r->err = 1;
+        return -1;
+    }
+    /* keep a terminating zero after the items as the parser does, the vectors are used as strings */
+    if(jm_vector_resize(char)(v, n + 1) != n + 1) return -1;
+    if(n) memcpy(jm_vector_get_itemp(char)(v, 0), r->cur, n);
+    jm_vector_set_item(char)(v, n, 0);
+    jm_vector_resize(char)(v, n);
+    r->cur += n;
+    return 0;
+}
+
+static int fmi2_xml_cache_get_strings(fmi2_xml_cache_reader_t* r, jm_callbacks* cb, jm_vector(jm_string)* v) {
+    size_t i, n = fmi2_xml_cache_get_size(r);
+    if(r->err || ((size_t)(r->end - r->cur) < n)) return -1;
+    if(jm_vector_reserve(jm_string)(v, n) < n) return -1;
+    for(i = 0; i < n; i++) {
+        const char* s = fmi2_xml_cache_get_string(r);
+        size_t len = strlen(s) + 1;
+        char* copy;
+        if(r->err) return -1;
+        copy = (char*)cb->malloc(len);
+        if(!copy) return -1;
+        memcpy(copy, s, len);
+        jm_vector_push_back(jm_string)(v, copy);
+    }
+    return 0;
+}
+
+static int fmi2_xml_cache_get_refs(fmi2_xml_cache_reader_t* r, jm_vector(jm_voidp)* v, fmi2_xml_variable_t** variables, size_t nv) {
+    size_t i, n = fmi2_xml_cache_get_size(r);
+    if(r->err || ((size_t)(r->end - r->cur) < n)) return -1;
+    if(jm_vector_resize(jm_voidp)(v, n) != n) return -1;
+    for(i = 0; i < n; i++) {
+        size_t id = fmi2_xml_cache_get_ref(r, nv);
+        if(id == FMI2_XML_CACHE_NONE) return -1;
+        jm_vector_set_item(jm_voidp)(v, i, variables[id]);
+    }
+    return r->err ? -1 : 0;
+}
+
+static int fmi2_xml_cache_get_size_vector(fmi2_xml_cache_reader_t* r, jm_vector(size_t)* v) {
+    size_t n = fmi2_xml_cache_get_size(r);
+    if(r->err || ((size_t)(r->end - r->cur) / sizeof(size_t) < n)) return -1;
+    if(jm_vector_resize(size_t)(v, n) != n) return -1;
+    if(n) fmi2_xml_cache_get(r, jm_vector_get_itemp(size_t)(v, 0), n * sizeof(size_t));
+    return r->err ? -1 : 0;
+}
+
+static int fmi2_xml_cache_get_dependencies(fmi2_xml_cache_reader_t* r, fmi2_xml_dependencies_t** pdep) {
+    fmi2_xml_dependencies_t* dep = *pdep;
+    if(!fmi2_xml_cache_get_char(r)) {
+        fmi2_xml_free_dependencies(dep);
+        *pdep = 0;
+        return r->err ? -1 : 0;
+    }
+    dep->isRowMajor = fmi2_xml_cache_get_int(r);
+    if(fmi2_xml_cache_get_size_vector(r, &dep->startIndex) ||
+       fmi2_xml_cache_get_size_vector(r, &dep->dependencyIndex) ||
+       fmi2_xml_cache_get_char_vector(r, &dep->dependencyFactorKind))
+        return -1;
+    return 0;
+}
+
+static int fmi2_xml_cache_get_units(fmi2_xml_cache_reader_t* r, fmi2_xml_model_description_t* md) {
+    jm_callbacks* cb = md->callbacks;
+    size_t i, k, n, nd;
+    int j;
+
+    n = fmi2_xml_cache_get_size(r);
+    if(r->err || ((size_t)(r->end - r->cur) < n)) return -1;
+    for(i = 0; i < n; i++) {
+        fmi2_xml_unit_t dummy, *u;
+        jm_named_ptr named = jm_named_alloc(fmi2_xml_cache_get_string(r), sizeof(fmi2_xml_unit_t), dummy.baseUnit - (char*)&dummy, cb);
+        u = (fmi2_xml_unit_t*)named.ptr;
+        if(!u) return -1;
+        jm_vector_init(jm_voidp)(&u->displayUnits, 0, cb);
+        if(!jm_vector_push_back(jm_named_ptr)(&md->unitDefinitions, named)) {
+            cb->free(u);
+            return -1;
+        }
+        for(j = 0; j < fmi2_SI_base_units_Num; j++)
+            u->SI_base_unit_exp[j] = fmi2_xml_cache_get_int(r);
+        u->factor = fmi2_xml_cache_get_double(r);
+        u->offset = fmi2_xml_cache_get_double(r);
+        u->defaultDisplay.factor = fmi2_xml_cache_get_double(r);
+        u->defaultDisplay.offset = fmi2_xml_cache_get_double(r);
+        u->defaultDisplay.baseUnit = u;
+        u->defaultDisplay.displayUnit[0] = 0;
+    }
+
+    nd = fmi2_xml_cache_get_size(r);
+    if(r->err || ((size_t)(r->end - r->cur) < nd)) return -1;
+    for(i = 0; i < nd; i++) {
+        fmi2_xml_display_unit_t dummy, *du;
+        jm_named_ptr named = jm_named_alloc(fmi2_xml_cache_get_string(r), sizeof(fmi2_xml_display_unit_t), dummy.displayUnit - (char*)&dummy, cb);
+        size_t id;
+        du = (fmi2_xml_display_unit_t*)named.ptr;
+        if(!du) return -1;
+        if(!jm_vector_push_back(jm_named_ptr)(&md->displayUnitDefinitions, named)) {
+            cb->free(du);
+            return -1;
+        }
+        du->factor = fmi2_xml_cache_get_double(r);
+        du->offset = fmi2_xml_cache_get_double(r);
+        id = fmi2_xml_cache_get_ref(r, n);
+        du->baseUnit = (id == FMI2_XML_CACHE_NONE) ? 0 : (fmi2_xml_unit_t*)jm_vector_get_item(jm_named_ptr)(&md->unitDefinitions, id).ptr;
+    }
+
+    for(i = 0; i < n; i++) {
+        fmi2_xml_unit_t* u = (fmi2_xml_unit_t*)jm_vector_get_item(jm_named_ptr)(&md->unitDefinitions, i).ptr;
+        size_t ndu = fmi2_xml_cache_get_size(r);
+        if(r->err || ((size_t)(r->end - r->cur) < ndu)) return -1;
+        for(k = 0; k < ndu; k++) {
+            size_t id = fmi2_xml_cache_get_ref(r, nd);
+            if(id == FMI2_XML_CACHE_NONE) return -1;
+            if(!jm_vector_push_back(jm_voidp)(&u->displayUnits, jm_vector_get_item(jm_named_ptr)(&md->displayUnitDefinitions, id).ptr))
+                return -1;
+        }
+    }
+    return r->err ? -1 : 0;
+}
+
+static fmi2_xml_display_unit_t* fmi2_xml_cache_get_display_unit(fmi2_xml_cache_reader_t* r, fmi2_xml_model_description_t* md) {
+    size_t code = fmi2_xml_cache_get_size(r);
+    size_t id;
+    if(code == 0) return 0;
+    id = (code - 1) / 2;
+    if(code % 2) {
+        if(id >= jm_vector_get_size(jm_named_ptr)(&md->unitDefinitions)) {
+            r->err = 1;
+            return 0;
+        }
+        return &((fmi2_xml_unit_t*)jm_vector_get_item(jm_named_ptr)(&md->unitDefinitions, id).ptr)->defaultDisplay;
+    }
+    if(id >= jm_vector_get_size(jm_named_ptr)(&md->displayUnitDefinitions)) {
+        r->err = 1;
+        return 0;
+    }
+    return (fmi2_xml_display_unit_t*)jm_vector_get_item(jm_named_ptr)(&md->displayUnitDefinitions, id).ptr;
+}
+
+static int fmi2_xml_cache_get_enum_items(fmi2_xml_cache_reader_t* r, jm_callbacks* cb, jm_vector(jm_named_ptr)* items) {
+    size_t k, n = fmi2_xml_cache_get_size(r);
+    if(r->err || ((size_t)(r->end - r->cur) < n)) return -1;
+    for(k = 0; k < n; k++) {
+        const char* name = fmi2_xml_cache_get_string(r);
+        int value = fmi2_xml_cache_get_int(r);
+        const char* descr = fmi2_xml_cache_get_string(r);
+        size_t descrlen = strlen(descr);
+        fmi2_xml_enum_type_item_t* item;
+        jm_named_ptr named;
+        if(r->err) return -1;
+        named = jm_named_alloc(name, sizeof(fmi2_xml_enum_type_item_t) + descrlen + 1, sizeof(fmi2_xml_enum_type_item_t) + descrlen, cb);
+        item = (fmi2_xml_enum_type_item_t*)named.ptr;
+        if(!item) return -1;
+        if(!jm_vector_push_back(jm_named_ptr)(items, named)) {
+            cb->free(item);
+            return -1;
+        }
+        item->itemName = named.name;
+        item->value = value;
+        memcpy(item->itemDesciption, descr, descrlen + 1);
+    }
+    return 0;
+}
+
+static void fmi2_xml_cache_get_type_base(fmi2_xml_cache_reader_t* r, fmi2_xml_variable_type_base_t* type,
+                                         fmi2_xml_type_struct_kind_enu_t structKind, size_t* baseId, size_t ntypes) {
+    char baseType = fmi2_xml_cache_get_char(r);
+    fmi2_xml_init_variable_type_base(type, structKind, (fmi2_base_type_enu_t)baseType);
+    type->isRelativeQuantity = fmi2_xml_cache_get_char(r);
+    type->isUnbounded = fmi2_xml_cache_get_char(r);
+    *baseId = fmi2_xml_cache_get_ref(r, ntypes);
+}
+
+static int fmi2_xml_cache_get_types(fmi2_xml_cache_reader_t* r, fmi2_xml_model_description_t* md) {
+    jm_callbacks* cb = md->callbacks;
+    fmi2_xml_type_definitions_t* td = &md->typeDefinitions;
+    fmi2_xml_variable_type_base_t** types = 0;
+    fmi2_xml_variable_type_base_t* tail = 0;
+    size_t* baseIds = 0;
+    size_t i, nt, nl, ntypes;
+    int ret = -1;
+
+    nt = fmi2_xml_cache_get_size(r);
+    nl = fmi2_xml_cache_get_size(r);
+    if(r->err || ((size_t)(r->end - r->cur) < nt) || ((size_t)(r->end - r->cur) < nl)) return -1;
+    ntypes = FMI2_XML_CACHE_NUM_DEFAULT_TYPES + nt + nl;
+    types = (fmi2_xml_variable_type_base_t**)cb->malloc(ntypes * sizeof(fmi2_xml_variable_type_base_t*));
+    baseIds = (size_t*)cb->malloc(ntypes * sizeof(size_t));
+    if(!types || !baseIds) goto cleanup;
+
+    types[0] = &td->defaultRealType.typeBase;
+    types[1] = &td->defaultEnumType.base.typeBase;
+    types[2] = &td->defaultIntegerType.typeBase;
+    types[3] = &td->defaultBooleanType;
+    types[4] = &td->defaultStringType;
+    for(i = 0; i < FMI2_XML_CACHE_NUM_DEFAULT_TYPES; i++) baseIds[i] = FMI2_XML_CACHE_NONE;
+
+    for(i = 0; i < nt; i++) {
+        fmi2_xml_variable_typedef_t dummy, *type;
+        size_t id = FMI2_XML_CACHE_NUM_DEFAULT_TYPES + i;
+        jm_named_ptr named = jm_named_alloc(fmi2_xml_cache_get_string(r), sizeof(fmi2_xml_variable_typedef_t), dummy.typeName - (char*)&dummy, cb);
+        type = (fmi2_xml_variable_typedef_t*)named.ptr;
+        if(!type) goto cleanup;
+        if(!jm_vector_push_back(jm_named_ptr)(&td->typeDefinitions, named)) {
+            cb->free(type);
+            goto cleanup;
+        }
+        type->description = fmi2_xml_cache_get_set_ref(r, &md->descriptions);
+        fmi2_xml_cache_get_type_base(r, &type->typeBase, fmi2_xml_type_struct_enu_typedef, &baseIds[id], ntypes);
+        types[id] = &type->typeBase;
+    }
+
+    for(i = 0; i < nl; i++) {
+        size_t id = FMI2_XML_CACHE_NUM_DEFAULT_TYPES + nt + i;
+        fmi2_xml_cache_node_kind_enu_t kind = (fmi2_xml_cache_node_kind_enu_t)fmi2_xml_cache_get_char(r);
+        fmi2_xml_type_struct_kind_enu_t structKind = fmi2_xml_type_struct_enu_props;
+        const char* startString = 0;
+        size_t typeSize;
+        fmi2_xml_variable_type_base_t* type;
+
+        switch(kind) {
+        case fmi2_xml_cache_node_base: typeSize = sizeof(fmi2_xml_variable_type_base_t); break;
+        case fmi2_xml_cache_node_real_props: typeSize = sizeof(fmi2_xml_real_type_props_t); break;
+        case fmi2_xml_cache_node_integer_props: typeSize = sizeof(fmi2_xml_integer_type_props_t); break;
+        case fmi2_xml_cache_node_enum_variable_props: typeSize = sizeof(fmi2_xml_enum_variable_props_t); break;
+        case fmi2_xml_cache_node_enum_typedef_props: typeSize = sizeof(fmi2_xml_enum_typedef_props_t); break;
+        case fmi2_xml_cache_node_real_start:
+            structKind = fmi2_xml_type_struct_enu_start;
+            typeSize = sizeof(fmi2_xml_variable_start_real_t);
+            break;
+        case fmi2_xml_cache_node_integer_start:
+            structKind = fmi2_xml_type_struct_enu_start;
+            typeSize = sizeof(fmi2_xml_variable_start_integer_t);
+            break;
+        case fmi2_xml_cache_node_string_start:
+            structKind = fmi2_xml_type_struct_enu_start;
+            typeSize = sizeof(fmi2_xml_variable_start_string_t);
+            break;
+        default:
+            goto cleanup;
+        }
+
+        type = (fmi2_xml_variable_type_base_t*)cb->malloc(typeSize);
+        if(!type) goto cleanup;
+        fmi2_xml_cache_get_type_base(r, type, structKind, &baseIds[id], ntypes);
+        if(kind == fmi2_xml_cache_node_enum_typedef_props)
+            jm_vector_init(jm_named_ptr)(&((fmi2_xml_enum_typedef_props_t*)type)->enumItems, 0, cb);
+        if(kind == fmi2_xml_cache_node_string_start) {
+            /* the start string is stored after the structure */
+            fmi2_xml_variable_type_base_t* resized;
+            startString = fmi2_xml_cache_get_string(r);
+            resized = (fmi2_xml_variable_type_base_t*)cb->realloc(type, typeSize + strlen(startString));
+            if(!resized) {
+                cb->free(type);
+                goto cleanup;
+            }
+            type = resized;
+            strcpy(((fmi2_xml_variable_start_string_t*)type)->start, startString);
+        }
+        /* keep the list order so that it is freed the same way as after parsing */
+        if(tail)
+            tail->next = type;
+        else
+            td->typePropsList = type;
+        tail = type;
+        types[id] = type;
+
+        switch(kind) {
+        case fmi2_xml_cache_node_real_props: {
+            fmi2_xml_real_type_props_t* props = (fmi2_xml_real_type_props_t*)type;
+            props->quantity = fmi2_xml_cache_get_set_ref(r, &td->quantities);
+            props->displayUnit = fmi2_xml_cache_get_display_unit(r, md);
+            props->typeMin = fmi2_xml_cache_get_double(r);
+            props->typeMax = fmi2_xml_cache_get_double(r);
+            props->typeNominal = fmi2_xml_cache_get_double(r);
+            break;
+        }
+        case fmi2_xml_cache_node_integer_props: {
+            fmi2_xml_integer_type_props_t* props = (fmi2_xml_integer_type_props_t*)type;
+            props->quantity = fmi2_xml_cache_get_set_ref(r, &td->quantities);
+            props->typeMin = fmi2_xml_cache_get_int(r);
+            props->typeMax = fmi2_xml_cache_get_int(r);
+            break;
+        }
+        case fmi2_xml_cache_node_enum_variable_props:
+        case fmi2_xml_cache_node_enum_typedef_props: {
+            fmi2_xml_enum_variable_props_t* props = (fmi2_xml_enum_variable_props_t*)type;
+            props->quantity = fmi2_xml_cache_get_set_ref(r, &td->quantities);
+            props->typeMin = fmi2_xml_cache_get_int(r);
+            props->typeMax = fmi2_xml_cache_get_int(r);
+            if((kind == fmi2_xml_cache_node_enum_typedef_props) &&
+               fmi2_xml_cache_get_enum_items(r, cb, &((fmi2_xml_enum_typedef_props_t*)type)->enumItems))
+                goto cleanup;
+            break;
+        }
+        case fmi2_xml_cache_node_real_start:
+            ((fmi2_xml_variable_start_real_t*)type)->start = fmi2_xml_cache_get_double(r);
+            break;
+        case fmi2_xml_cache_node_integer_start:
+            ((fmi2_xml_variable_start_integer_t*)type)->start = fmi2_xml_cache_get_int(r);
+            break;
+        default:
+            break;
+        }
+        if(r->err) goto cleanup;
+    }
+
+    /* all structures exist now, link them to their base types */
+    for(i = FMI2_XML_CACHE_NUM_DEFAULT_TYPES; i < ntypes; i++) {
+        types[i]->baseTypeStruct = (baseIds[i] == FMI2_XML_CACHE_NONE) ? 0 : types[baseIds[i]];
+    }
+    ret = r->err ? -1 : 0;
+
+cleanup:
+    cb->free(types);
+    cb->free(baseIds);
+    return ret;
+}
+
+static int fmi2_xml_cache_get_variables(fmi2_xml_cache_reader_t* r, fmi2_xml_model_description_t* md, fmi2_xml_variable_t*** pvariables, size_t* pnv) {
+    jm_callbacks* cb = md->callbacks;
+    fmi2_xml_type_definitions_t* td = &md->typeDefinitions;
+    fmi2_xml_variable_t** variables;
+    size_t* links;
+    size_t ntypes, i, n;
+    fmi2_xml_variable_type_base_t* cur;
+
+    *pvariables = 0;
+    *pnv = 0;
+    n = fmi2_xml_cache_get_size(r);
+    if(n == FMI2_XML_CACHE_NONE) return r->err ? -1 : 0;
+    if(r->err || ((size_t)(r->end - r->cur) < n)) return -1;
+
+    ntypes = FMI2_XML_CACHE_NUM_DEFAULT_TYPES + jm_vector_get_size(jm_named_ptr)(&td->typeDefinitions);
+    for(cur = td->typePropsList; cur; cur = cur->next) ntypes++;
+
+    md->variablesOrigOrder = jm_vector_alloc(jm_voidp)(n, n, cb);
+    variables = (fmi2_xml_variable_t**)cb->malloc((n + 1) * sizeof(fmi2_xml_variable_t*));
+    links = (size_t*)cb->malloc((2 * n + 1) * sizeof(size_t));
+    if(!md->variablesOrigOrder || !variables || !links ||
+       (jm_vector_reserve(jm_named_ptr)(&md->variablesByName, n) < n)) {
+        cb->free(variables);
+        cb->free(links);
+        return -1;
+    }
+    *pvariables = variables;
+
+    /* The type list is needed to translate type ids to pointers */
+    {
+        fmi2_xml_variable_type_base_t** types = (fmi2_xml_variable_type_base_t**)cb->malloc(ntypes * sizeof(fmi2_xml_variable_type_base_t*));
+        size_t k = 0;
+        if(!types) {
+            cb->free(links);
+            return -1;
+        }
+        types[k++] = &td->defaultRealType.typeBase;
+        types[k++] = &td->defaultEnumType.base.typeBase;
+        types[k++] = &td->defaultIntegerType.typeBase;
+        types[k++] = &td->defaultBooleanType;
+        types[k++] = &td->defaultStringType;
+        for(i = 0; i < jm_vector_get_size(jm_named_ptr)(&td->typeDefinitions); i++)
+            types[k++] = (fmi2_xml_variable_type_base_t*)jm_vector_get_item(jm_named_ptr)(&td->typeDefinitions, i).ptr;
+        for(cur = td->typePropsList; cur; cur = cur->next)
+            types[k++] = cur;
+
+        for(i = 0; i < n; i++) {
+            fmi2_xml_variable_t dummyV, *v;
+            jm_named_ptr named = jm_named_alloc(fmi2_xml_cache_get_string(r), sizeof(fmi2_xml_variable_t), dummyV.name - (char*)&dummyV, cb);
+            size_t typeId;
+            v = (fmi2_xml_variable_t*)named.ptr;
+            if(!v) break;
+            /* the variables are owned by variablesByName, which is put in name order below */
+            jm_vector_push_back(jm_named_ptr)(&md->variablesByName, named);
+            variables[i] = v;
+            jm_vector_set_item(jm_voidp)(md->variablesOrigOrder, i, v);
+            v->description = fmi2_xml_cache_get_set_ref(r, &md->descriptions);
+            typeId = fmi2_xml_cache_get_ref(r, ntypes);
+            v->typeBase = (typeId == FMI2_XML_CACHE_NONE) ? 0 : types[typeId];
+            links[2 * i] = fmi2_xml_cache_get_ref(r, n);
+            links[2 * i + 1] = fmi2_xml_cache_get_ref(r, n);
+            v->vr = fmi2_xml_cache_get_uint(r);
+            v->originalIndex = fmi2_xml_cache_get_size(r);
+            v->aliasKind = fmi2_xml_cache_get_char(r);
+            v->initial = fmi2_xml_cache_get_char(r);
+            v->variability = fmi2_xml_cache_get_char(r);
+            v->causality = fmi2_xml_cache_get_char(r);
+            v->reinit = fmi2_xml_cache_get_char(r);
+            v->canHandleMultipleSetPerTimeInstant = fmi2_xml_cache_get_char(r);
+            if(r->err) break;
+        }
+        cb->free(types);
+    }
+    if(i < n) {
+        cb->free(links);
+        return -1;
+    }
+    *pnv = n;
+
+    for(i = 0; i < n; i++) {
+        variables[i]->derivativeOf = (links[2 * i] == FMI2_XML_CACHE_NONE) ? 0 : variables[links[2 * i]];
+        variables[i]->previous = (links[2 * i + 1] == FMI2_XML_CACHE_NONE) ? 0 : variables[links[2 * i + 1]];
+    }
+
+    /* variablesByName order */
+    for(i = 0; i < n; i++) {
+        size_t id = fmi2_xml_cache_get_ref(r, n);
+        if(id == FMI2_XML_CACHE_NONE) {
+            cb->free(links);
+            return -1;
+        }
+        links[i] = id;
+    }
+    for(i = 0; i < n; i++) {
+        jm_named_ptr named;
+        named.ptr = variables[links[i]];
+        named.name = variables[links[i]]->name;
+        jm_vector_set_item(jm_named_ptr)(&md->variablesByName, i, named);
+    }
+    cb->free(links);
+
+    if(fmi2_xml_cache_get_char(r)) {
+        md->variablesByVR = jm_vector_alloc(jm_voidp)(0, 0, cb);
+        if(!md->variablesByVR || fmi2_xml_cache_get_refs(r, md->variablesByVR, variables, n)) return -1;
+    }
+    return r->err ? -1 : 0;
+}
+
+static int fmi2_xml_cache_get_model_structure(fmi2_xml_cache_reader_t* r, fmi2_xml_model_description_t* md, fmi2_xml_variable_t** variables, size_t nv) {
+    fmi2_xml_model_structure_t* ms;
+    if(!fmi2_xml_cache_get_char(r)) return r->err ? -1 : 0;
+    ms = md->modelStructure = fmi2_xml_allocate_model_structure(md->callbacks);
+    if(!ms) return -1;
+    if(fmi2_xml_cache_get_refs(r, &ms->outputs, variables, nv) ||
+       fmi2_xml_cache_get_refs(r, &ms->derivatives, variables, nv) ||
+       fmi2_xml_cache_get_refs(r, &ms->discreteStates, variables, nv) ||
+       fmi2_xml_cache_get_refs(r, &ms->initialUnknowns, variables, nv) ||
+       fmi2_xml_cache_get_dependencies(r, &ms->outputDeps) ||
+       fmi2_xml_cache_get_dependencies(r, &ms->derivativeDeps) ||
+       fmi2_xml_cache_get_dependencies(r, &ms->discreteStateDeps) ||
+       fmi2_xml_cache_get_dependencies(r, &ms->initialUnknownDeps))
+        return -1;
+    ms->isValidFlag = fmi2_xml_cache_get_int(r);
+    return r->err ? -1 : 0;
+}
+
+static int fmi2_xml_cache_get_model_description(fmi2_xml_cache_reader_t* r, fmi2_xml_model_description_t* md) {
+    jm_callbacks* cb = md->callbacks;
+    fmi2_xml_variable_t** variables = 0;
+    size_t i, nv = 0;
+    int ret = -1;
+
+    if(fmi2_xml_cache_get_char_vector(r, &md->fmi2_xml_standard_version) ||
+       fmi2_xml_cache_get_char_vector(r, &md->modelName) ||
+       fmi2_xml_cache_get_char_vector(r, &md->GUID) ||
+       fmi2_xml_cache_get_char_vector(r, &md->description) ||
+       fmi2_xml_cache_get_char_vector(r, &md->author) ||
+       fmi2_xml_cache_get_char_vector(r, &md->copyright) ||
+       fmi2_xml_cache_get_char_vector(r, &md->license) ||
+       fmi2_xml_cache_get_char_vector(r, &md->version) ||
+       fmi2_xml_cache_get_char_vector(r, &md->generationTool) ||
+       fmi2_xml_cache_get_char_vector(r, &md->generationDateAndTime) ||
+       fmi2_xml_cache_get_char_vector(r, &md->modelIdentifierME) ||
+       fmi2_xml_cache_get_char_vector(r, &md->modelIdentifierCS))
+        return -1;
+    md->namingConvension = (fmi2_variable_naming_convension_enu_t)fmi2_xml_cache_get_int(r);
+    md->numberOfContinuousStates = fmi2_xml_cache_get_size(r);
+    md->numberOfEventIndicators = fmi2_xml_cache_get_size(r);
+    md->defaultExperimentStartTime = fmi2_xml_cache_get_double(r);
+    md->defaultExperimentStopTime = fmi2_xml_cache_get_double(r);
+    md->defaultExperimentTolerance = fmi2_xml_cache_get_double(r);
+    md->defaultExperimentStepSize = fmi2_xml_cache_get_double(r);
+    md->fmuKind = (fmi2_fmu_kind_enu_t)fmi2_xml_cache_get_int(r);
+    for(i = 0; i < fmi2_capabilities_Num; i++)
+        md->capabilities[i] = fmi2_xml_cache_get_uint(r);
+
+    if(fmi2_xml_cache_get_strings(r, cb, &md->sourceFilesME) ||
+       fmi2_xml_cache_get_strings(r, cb, &md->sourceFilesCS) ||
+       fmi2_xml_cache_get_strings(r, cb, &md->logCategories) ||
+       fmi2_xml_cache_get_strings(r, cb, &md->logCategoryDescriptions) ||
+       fmi2_xml_cache_get_strings(r, cb, &md->vendorList) ||
+       fmi2_xml_cache_get_strings(r, cb, &md->descriptions) ||
+       fmi2_xml_cache_get_strings(r, cb, &md->typeDefinitions.quantities) ||
+       fmi2_xml_cache_get_units(r, md) ||
+       fmi2_xml_cache_get_types(r, md) ||
+       fmi2_xml_cache_get_variables(r, md, &variables, &nv) ||
+       fmi2_xml_cache_get_model_structure(r, md, variables, nv))
+        goto cleanup;
+
+    ret = (r->err || (r->cur != r->end)) ? -1 : 0;
+
+cleanup:
+    cb->free(variables);
+    return ret;
+}
+
+int fmi2_xml_load_model_description_cache(fmi2_xml_model_description_t* md, const char* xmlFileName) {
+    jm_callbacks* cb = md->callbacks;
+    fmi2_xml_cache_header_t expected, header;
+    fmi2_xml_cache_reader_t r;
+    unsigned long hash1, hash2;
+    char* cacheName;
+    char* payload;
+    FILE* file;
+    size_t n;
+
+    if(!fmi2_xml_is_model_description_empty(md) || jm_vector_get_size(jm_named_ptr)(&md->variablesByName)) return 1;
+
+    fmi2_xml_cache_init_header(&expected);
+    if(fmi2_xml_cache_hash_file(xmlFileName, &expected.xmlSize, &expected.xmlHash1, &expected.xmlHash2)) return 1;
+
+    cacheName = fmi2_xml_cache_file_name(cb, xmlFileName, "");
+    if(!cacheName) return 1;
+    file = fopen(cacheName, "rb");
+    if(!file) {
+        jm_log_verbose(cb, module, "No model description cache '%s'", cacheName);
+        cb->free(cacheName);
+        return 1;
+    }
+    if((fread(&header, sizeof(header), 1, file) != 1) ||
+       memcmp(header.magic, expected.magic, FMI2_XML_CACHE_MAGIC_SIZE) ||
+       (header.formatVersion != expected.formatVersion) ||
+       (header.byteOrder != expected.byteOrder) ||
+       memcmp(header.typeSizes, expected.typeSizes, sizeof(expected.typeSizes)) ||
+       (header.xmlSize != expected.xmlSize) ||
+       (header.xmlHash1 != expected.xmlHash1) ||
+       (header.xmlHash2 != expected.xmlHash2)) {
+        jm_log_verbose(cb, module, "Model description cache '%s' does not match '%s'", cacheName, xmlFileName);
+        fclose(file);
+        cb->free(cacheName);
+        return 1;
+    }
+
+    payload = (char*)cb->malloc(header.payloadSize + 1);
+    n = payload ? fread(payload, 1, header.payloadSize + 1, file) : 0;
+    fclose(file);
+    hash1 = FMI2_XML_CACHE_HASH1_INIT;
+    hash2 = FMI2_XML_CACHE_HASH2_INIT;
+    if(payload) fmi2_xml_cache_hash(payload, n, &hash1, &hash2);
+    if(!payload || (n != header.payloadSize) || (hash1 != header.payloadHash1) || (hash2 != header.payloadHash2)) {
+        jm_log_verbose(cb, module, "Model description cache '%s' is corrupt", cacheName);
+        cb->free(payload);
+        cb->free(cacheName);
+        return 1;
+    }
+
+    jm_log_verbose(cb, module, "Reading model description cache '%s'", cacheName);
+    r.cur = payload;
+    r.end = payload + n;
+    r.err = 0;
+    if(fmi2_xml_cache_get_model_description(&r, md)) {
+        fmi2_xml_clear_model_description(md);
+        jm_log_fatal(cb, module, "Could not read model description cache '%s'", cacheName);
+        cb->free(payload);
+        cb->free(cacheName);
+        return -1;
+    }
+    cb->free(payload);
+    cb->free(cacheName);
+    return 0;
+}
@@ -0,0 +1,55 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+/** \file fmi2_xml_model_description_cache.h
+*  \brief Private header file. Binary cache of a parsed model description.
+*/
+
+#ifndef FMI2_XML_MODEL_DESCRIPTION_CACHE_H_
+#define FMI2_XML_MODEL_DESCRIPTION_CACHE_H_
+
+#include <FMI2/fmi2_xml_model_description.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Suffix appended to the XML file name to get the name of the cache file. */
+#define FMI2_XML_MODEL_DESCRIPTION_CACHE_SUFFIX ".fmilcache"
+
+/**
+    \brief Fill an empty model description from the cache file of an XML file.
+
+    The cache file is only used if it was written for the current content of the XML file.
+    @param md An empty model description.
+    @param xmlFileName The name of the XML file.
+    @return 0 if the model description was loaded, 1 if no valid cache was found
+            (md is not modified) and -1 on a fatal error (md is cleared).
+*/
+int fmi2_xml_load_model_description_cache(fmi2_xml_model_description_t* md, const char* xmlFileName);
+
+/**
+    \brief Save a successfully parsed model description to the cache file of the XML file.
+    @param md A model description that was parsed from xmlFileName.
+    @param xmlFileName The name of the XML file.
+    @return 0 if the cache was written. Non-zero value indicates that it could not be written.
+*/
+int fmi2_xml_save_model_description_cache(fmi2_xml_model_description_t* md, const char* xmlFileName);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FMI2_XML_MODEL_DESCRIPTION_CACHE_H_ */
@@ -95,6 +95,10 @@ struct fmi2_xml_model_description_t {
     unsigned int capabilities[fmi2_capabilities_Num];
 
 	fmi2_xml_model_structure_t* modelStructure;
+
+    fmi2_xml_variables_ready_ft variablesReadyHandle;
+
+    void* variablesReadyContext;
 };
 
 void fmi2_xml_report_error(fmi2_xml_model_description_t* md, const char* module, const char* fmt, ...);
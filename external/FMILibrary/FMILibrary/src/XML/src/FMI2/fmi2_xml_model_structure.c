@@ -18,6 +18,7 @@
 */
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "fmi2_xml_parser.h"
 #include "fmi2_xml_model_structure_impl.h"
@@ -260,22 +261,26 @@ int fmi2_xml_parse_dependencies(fmi2_xml_parser_context_t *context,
     }
     if(listInd) {
          const char* cur = listInd;
-         int ind;
+         long ind;
          while(*cur) {
              char ch = *cur;
+             char* end;
              while((ch ==' ') || (ch == '\t') || (ch =='\n') || (ch == '\r')) {
                  cur++; ch = *cur;
                  if(!ch) break;
              }
              if(!ch) break;
-             if(sscanf(cur, "%d", &ind) != 1) {
+             /* strtol rather than sscanf: sscanf may scan the whole remaining string on each call,
+                which makes long dependency lists quadratic */
+             ind = strtol(cur, &end, 10);
+             if(end == cur) {
                  fmi2_xml_parse_error(context, "XML element 'Unknown': could not parse item %d in the list for attribute 'dependencies'",
                      numDepInd);
                 ms->isValidFlag = 0;
                 return 0;
              }
              if(ind < 1) {
-                 fmi2_xml_parse_error(context, "XML element 'Unknown': item %d=%d is less than one in the list for attribute 'dependencies'",
+                 fmi2_xml_parse_error(context, "XML element 'Unknown': item %d=%ld is less than one in the list for attribute 'dependencies'",
                      numDepInd, ind);
                 ms->isValidFlag = 0;
                 return 0;
@@ -284,7 +289,7 @@ int fmi2_xml_parse_dependencies(fmi2_xml_parser_context_t *context,
                 fmi2_xml_parse_fatal(context, "Could not allocate memory");
                 return -1;
             }
-             while((*cur >= '0') && (*cur <= '9')) cur++;
+             cur = end;
              numDepInd++;
          }
     }
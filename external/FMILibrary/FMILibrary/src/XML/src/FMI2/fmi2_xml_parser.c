@@ -23,6 +23,7 @@
 
 #include "fmi2_xml_model_description_impl.h"
 #include "fmi2_xml_parser.h"
+#include "fmi2_xml_model_description_cache.h"
 
 static const char * module = "FMI2XML";
 
@@ -658,6 +659,25 @@ int fmi2_xml_parse_model_description(fmi2_xml_model_description_t* md,
     fmi2_xml_parser_context_t* context;
     XML_Parser parser = NULL;
     FILE* file;
+    /* annotations are not cached, the callbacks need the XML */
+    int useCache = (configuration & FMI2_XML_MODEL_DESCRIPTION_CACHE) && !xml_callbacks;
+
+    if (useCache) {
+        int ret = fmi2_xml_load_model_description_cache(md, filename);
+        if (ret < 0) return -1;
+        if (ret == 0) {
+            if (md->variablesReadyHandle && md->variablesReadyHandle(md, md->variablesReadyContext)) {
+                jm_log_fatal(md->callbacks, module, "Parsing was aborted by the variables ready callback");
+                fmi2_xml_clear_model_description(md);
+                return -1;
+            }
+            if (configuration & FMI2_XML_NAME_CHECK) {
+                fmi2_check_variable_naming_conventions(md);
+            }
+            md->status = fmi2_xml_model_description_enu_ok;
+            return 0;
+        }
+    }
 
     context = (fmi2_xml_parser_context_t*)md->callbacks->calloc(1, sizeof(fmi2_xml_parser_context_t));
     if(!context) {
@@ -741,6 +761,10 @@ int fmi2_xml_parse_model_description(fmi2_xml_model_description_t* md,
     context->modelDescription = 0;
     fmi2_xml_parse_free_context(context);
 
+    if (useCache) {
+        fmi2_xml_save_model_description_cache(md, filename);
+    }
+
     return 0;
 }
 
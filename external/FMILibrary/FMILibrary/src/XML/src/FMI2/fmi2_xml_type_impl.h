@@ -182,6 +182,7 @@ struct fmi2_xml_type_definitions_t {
 };
 
 extern void fmi2_xml_init_type_definitions(fmi2_xml_type_definitions_t* td, jm_callbacks* cb) ;
+extern void fmi2_xml_init_variable_type_base(fmi2_xml_variable_type_base_t* type, fmi2_xml_type_struct_kind_enu_t kind, fmi2_base_type_enu_t baseType);
 
 extern void fmi2_xml_free_type_definitions_data(fmi2_xml_type_definitions_t* td);
 
@@ -871,6 +871,15 @@ void fmi2_xml_eliminate_bad_alias(fmi2_xml_parser_context_t *context, size_t ind
     }
 }
 
+/* Returns non-zero if v is sorted at or after the variables with the given base type and vr in variablesByVR */
+static int fmi2_xml_is_sorted_at_or_after_vr(fmi2_xml_variable_t* v, fmi2_base_type_enu_t type, fmi2_value_reference_t vr) {
+    fmi2_base_type_enu_t vt = fmi2_xml_get_variable_base_type(v);
+    if(vt == fmi2_base_type_enum) vt = fmi2_base_type_int;
+    if(type == fmi2_base_type_enum) type = fmi2_base_type_int;
+    if(vt != type) return vt > type;
+    return v->vr >= vr;
+}
+
 static int fmi2_xml_compare_vr_and_original_index (const void* first, const void* second) {
     int ret = fmi2_xml_compare_vr(first, second);
     if(ret != 0) return ret;
@@ -989,17 +998,21 @@ int fmi2_xml_handle_ModelVariables(fmi2_xml_parser_context_t *context, const cha
 
         if(numvar > 1){
             int foundBadAlias;
+            size_t start = 0;
+            fmi2_value_reference_t badVR = 0;
+            fmi2_base_type_enu_t badType = fmi2_base_type_real;
 
             jm_log_verbose(context->callbacks, module,"Building alias index");
             do {
-                fmi2_xml_variable_t* a = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(varByVR, 0);
+                fmi2_xml_variable_t* a = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(varByVR, start);
                 int startPresent = fmi2_xml_get_variable_has_start(a);
                 int isConstant = (fmi2_xml_get_variability(a) == fmi2_variability_enu_constant);
+                size_t aliasSetStart = start;
                 a->aliasKind = fmi2_variable_is_not_alias;
 
                 foundBadAlias = 0;
 
-                for(i = 1; i< numvar; i++) {
+                for(i = start + 1; i< numvar; i++) {
                     fmi2_xml_variable_t* b = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(varByVR, i);
                     int b_startPresent = fmi2_xml_get_variable_has_start(b);
                     int b_isConstant = (fmi2_xml_get_variability(b) == fmi2_variability_enu_constant);
@@ -1014,6 +1027,8 @@ int fmi2_xml_handle_ModelVariables(fmi2_xml_parser_context_t *context, const cha
                                 jm_log_error(context->callbacks,module,
                                 "Only constants can be aliases with constants (variables: %s and %s)",
                                     a->name, b->name);
+                                badVR = b->vr;
+                                badType = fmi2_xml_get_variable_base_type(b);
                                 fmi2_xml_eliminate_bad_alias(context,i);
                                 numvar = jm_vector_get_size(jm_voidp)(varByVR);
                                 foundBadAlias = 1;
@@ -1023,6 +1038,8 @@ int fmi2_xml_handle_ModelVariables(fmi2_xml_parser_context_t *context, const cha
                                     jm_log_error(context->callbacks,module,
                                         "Constants in alias set must all have start attributes (variables: %s and %s)",
                                         a->name, b->name);
+                                    badVR = b->vr;
+                                    badType = fmi2_xml_get_variable_base_type(b);
                                     fmi2_xml_eliminate_bad_alias(context,i);
                                     numvar = jm_vector_get_size(jm_voidp)(varByVR);
                                     foundBadAlias = 1;
@@ -1033,6 +1050,8 @@ int fmi2_xml_handle_ModelVariables(fmi2_xml_parser_context_t *context, const cha
                                 jm_log_error(context->callbacks,module,
                                     "Only one variable among non constant aliases is allowed to have start attribute (variables: %s and %s) %d, %d, const enum value: %d",
                                         a->name, b->name, fmi2_xml_get_variability(a), fmi2_xml_get_variability(b), fmi2_variability_enu_constant);
+                                badVR = b->vr;
+                                badType = fmi2_xml_get_variable_base_type(b);
                                 fmi2_xml_eliminate_bad_alias(context,i);
                                 numvar = jm_vector_get_size(jm_voidp)(varByVR);
                                 foundBadAlias = 1;
@@ -1047,14 +1066,31 @@ int fmi2_xml_handle_ModelVariables(fmi2_xml_parser_context_t *context, const cha
                         b->aliasKind = fmi2_variable_is_not_alias;
                         startPresent = b_startPresent;
                         isConstant = b_isConstant;
+                        aliasSetStart = i;
                         a = b;
                     }
                 }
-            } while(foundBadAlias);
+                /* only variables with the type and vr of the bad alias set were removed and the ones
+                   sorted before them are already processed, so continue with the first one with that vr
+                   (integers and enumerations with the same vr are sorted together) */
+                if(foundBadAlias) {
+                    start = (aliasSetStart < numvar) ? aliasSetStart : numvar;
+                    while((start > 0) && fmi2_xml_is_sorted_at_or_after_vr(
+                              (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(varByVR, start - 1), badType, badVR)) {
+                        start--;
+                    }
+                }
+            } while(foundBadAlias && (start < numvar));
         }
 
         numvar = jm_vector_get_size(jm_named_ptr)(&md->variablesByName);
 
+        /* variables can be looked up from here on, let the client start before ModelStructure is parsed */
+        if(md->variablesReadyHandle && md->variablesReadyHandle(md, md->variablesReadyContext)) {
+            fmi2_xml_parse_fatal(context, "Parsing was aborted by the variables ready callback");
+            return -1;
+        }
+
         /* might give out a warning if(data[0] != 0) */
     }
     return 0;
@@ -42,6 +42,58 @@ extern "C" {
  */
 jm_status_enu_t fmi_zip_unzip(const char* zip_file_path, const char* output_folder, jm_callbacks* callbacks);
 
+/**
+ * \brief Uncompress selected entries of a zip file
+ *
+ * Only entries with a name starting with one of the prefixes are extracted, e.g.
+ * "modelDescription.xml" and "binaries/linux64/" to get what is needed to load an FMU.
+ * The current working directory is not changed, so the function may be called from several threads.
+ *
+ * @param zip_file_path Full file path of the file to uncompress.
+ * @param output_folder Full file path of the directory where the uncompressed files are put. The folder must already exist. Files with the same name are overwritten.
+ * @param n_prefixes Number of prefixes.
+ * @param prefixes Entry name prefixes to extract. All entries are extracted if this is NULL.
+ * @param callbacks Callback functions
+ * @return Error status.
+ */
+jm_status_enu_t fmi_zip_unzip_selected(const char* zip_file_path, const char* output_folder, size_t n_prefixes, const char** prefixes, jm_callbacks* callbacks);
+
+/** \brief Size of the buffer needed for a content key, including the terminating zero. */
+#define FMI_ZIP_CONTENT_KEY_SIZE 65
+
+/**
+ * \brief Compute a key identifying the content of a zip file
+ *
+ * The key is the SHA-256 of the zip file, followed by the prefixes with terminating zeros
+ * if any are given. Without prefixes it is the same as the output of sha256sum.
+ *
+ * @param zip_file_path Full file path of the zip file.
+ * @param n_prefixes Number of prefixes.
+ * @param prefixes Entry name prefixes of a selective extraction, or NULL.
+ * @param key Buffer for the key, a hexadecimal string.
+ * @param len Length of the buffer, at least FMI_ZIP_CONTENT_KEY_SIZE.
+ * @param callbacks Callback functions
+ * @return Error status.
+ */
+jm_status_enu_t fmi_zip_get_content_key(const char* zip_file_path, size_t n_prefixes, const char** prefixes, char* key, size_t len, jm_callbacks* callbacks);
+
+/**
+ * \brief Uncompress a zip file into an extraction cache
+ *
+ * The entries selected by the prefixes are uncompressed into a sub directory of the cache folder
+ * named by the content key, unless that directory already exists. Extraction is done into a
+ * temporary directory that is renamed when complete, so that several processes may share the
+ * cache folder. The directory must not be removed while other loaders may use it.
+ *
+ * @param zip_file_path Full file path of the file to uncompress.
+ * @param cache_folder Full file path of the cache directory. The folder must already exist.
+ * @param n_prefixes Number of prefixes.
+ * @param prefixes Entry name prefixes to extract. All entries are extracted if this is NULL.
+ * @param callbacks Callback functions
+ * @return Full path of the directory holding the uncompressed files or NULL on error. Caller is responsible for freeing the memory.
+ */
+char* fmi_zip_unzip_cached(const char* zip_file_path, const char* cache_folder, size_t n_prefixes, const char** prefixes, jm_callbacks* callbacks);
+
 /** @} */
 
 #ifdef __cplusplus 
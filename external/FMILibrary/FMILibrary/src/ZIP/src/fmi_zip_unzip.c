@@ -19,69 +19,457 @@ extern "C" {
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
-#include <miniunz.h>
+#include <zlib.h>
+#include <unzip.h>
+#ifdef _WIN32
+#include <direct.h>
+#include <iowin32.h>
+#endif
 
 #include <JM/jm_types.h>
 #include <JM/jm_callbacks.h>
 #include <JM/jm_portability.h>
+#include <FMI/fmi_zip_unzip.h>
 
 static const char* module = "FMIZIP";
 
-jm_status_enu_t fmi_zip_unzip(const char* zip_file_path, const char* output_folder, jm_callbacks* callbacks)
+#define FMI_ZIP_BUFFER_SIZE 8192
+
+#ifdef _WIN32
+#define FMI_ZIP_MKDIR(dir) _mkdir(dir)
+#else
+#define FMI_ZIP_MKDIR(dir) mkdir(dir, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH)
+#endif
+
+/* Opens the zip file without relying on the current directory */
+static unzFile fmi_zip_open(const char* zip_file_path) {
+#ifdef _WIN32
+	zlib_filefunc64_def ffunc;
+	fill_win32_filefunc64A(&ffunc);
+	return unzOpen2_64(zip_file_path, &ffunc);
+#else
+	return unzOpen64(zip_file_path);
+#endif
+}
+
+static int fmi_zip_dir_exists(const char* dir) {
+#ifdef _WIN32
+	struct _stat st;
+	return _stat(dir, &st) == 0 && (st.st_mode & _S_IFDIR);
+#else
+	struct stat st;
+	return stat(dir, &st) == 0 && S_ISDIR(st.st_mode);
+#endif
+}
+
+/* Creates all directories in path up to, but not including, the last path component */
+static jm_status_enu_t fmi_zip_make_parent_dirs(char* path, size_t root_len, jm_callbacks* callbacks) {
+	char* p;
+	for (p = path + root_len + 1; *p; p++) {
+		if (*p == '/' || *p == '\\') {
+			char c = *p;
+			*p = 0;
+			if (FMI_ZIP_MKDIR(path) && errno != EEXIST) {
+				jm_log_fatal(callbacks, module, "Could not create directory %s", path);
+				*p = c;
+				return jm_status_error;
+			}
+			*p = c;
+		}
+	}
+	return jm_status_success;
+}
+
+/* Entries with absolute paths or parent references would be written outside of the output folder */
+static int fmi_zip_is_safe_entry_name(const char* name) {
+	const char* p = name;
+	if (name[0] == '/' || name[0] == '\\' || (name[0] && name[1] == ':')) {
+		return 0;
+	}
+	while (*p) {
+		const char* next = p;
+		while (*next && *next != '/' && *next != '\\') next++;
+		if (next - p == 2 && p[0] == '.' && p[1] == '.') {
+			return 0;
+		}
+		p = *next ? next + 1 : next;
+	}
+	return 1;
+}
+
+static int fmi_zip_is_selected(const char* name, size_t n_prefixes, const char** prefixes) {
+	size_t i;
+	if (prefixes == NULL) {
+		return 1;
+	}
+	for (i = 0; i < n_prefixes; i++) {
+		if (strncmp(name, prefixes[i], strlen(prefixes[i])) == 0) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* Extracts the current entry of the zip file into output_folder */
+static jm_status_enu_t fmi_zip_extract_current(unzFile uf, const char* output_folder, const char* name, char* buf, jm_callbacks* callbacks) {
+	jm_status_enu_t status = jm_status_success;
+	size_t root_len = strlen(output_folder);
+	size_t name_len = strlen(name);
+	char* path;
+	FILE* fout;
+	int err;
+
+	path = (char*)callbacks->malloc(root_len + name_len + 2);
+	if (path == NULL) {
+		jm_log_fatal(callbacks, module, "Could not allocate memory");
+		return jm_status_error;
+	}
+	memcpy(path, output_folder, root_len);
+	path[root_len] = '/';
+	memcpy(path + root_len + 1, name, name_len + 1);
+
+	if (fmi_zip_make_parent_dirs(path, root_len, callbacks) != jm_status_success) {
+		callbacks->free(path);
+		return jm_status_error;
+	}
+	if (name_len == 0 || name[name_len - 1] == '/' || name[name_len - 1] == '\\') {
+		/* Directory entry, already created above */
+		callbacks->free(path);
+		return jm_status_success;
+	}
+
+	if (unzOpenCurrentFile(uf) != UNZ_OK) {
+		jm_log_fatal(callbacks, module, "Could not open %s in the FMU", name);
+		callbacks->free(path);
+		return jm_status_error;
+	}
+	fout = fopen(path, "wb");
+	if (fout == NULL) {
+		jm_log_fatal(callbacks, module, "Could not create file %s", path);
+		unzCloseCurrentFile(uf);
+		callbacks->free(path);
+		return jm_status_error;
+	}
+	do {
+		err = unzReadCurrentFile(uf, buf, FMI_ZIP_BUFFER_SIZE);
+		if (err > 0 && fwrite(buf, (size_t)err, 1, fout) != 1) {
+			err = UNZ_ERRNO;
+		}
+	} while (err > 0);
+	fclose(fout);
+
+	if (err < 0) {
+		jm_log_fatal(callbacks, module, "Error %d when extracting %s", err, name);
+		unzCloseCurrentFile(uf);
+		status = jm_status_error;
+	} else if (unzCloseCurrentFile(uf) != UNZ_OK) {
+		jm_log_fatal(callbacks, module, "CRC error when extracting %s", name);
+		status = jm_status_error;
+	}
+	callbacks->free(path);
+	return status;
+}
+
+/* Reads the name of the current entry into a buffer that is grown as needed, names are not truncated */
+static jm_status_enu_t fmi_zip_get_current_name(unzFile uf, char** name, size_t* size, jm_callbacks* callbacks) {
+	unz_file_info64 file_info;
+
+	if (unzGetCurrentFileInfo64(uf, &file_info, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK) {
+		return jm_status_error;
+	}
+	if (file_info.size_filename + 1 > *size) {
+		char* larger = (char*)callbacks->realloc(*name, file_info.size_filename + 1);
+		if (larger == NULL) {
+			jm_log_fatal(callbacks, module, "Could not allocate memory");
+			return jm_status_error;
+		}
+		*name = larger;
+		*size = file_info.size_filename + 1;
+	}
+	if (unzGetCurrentFileInfo64(uf, NULL, *name, (uLong)*size, NULL, 0, NULL, 0) != UNZ_OK) {
+		return jm_status_error;
+	}
+	return jm_status_success;
+}
+
+jm_status_enu_t fmi_zip_unzip_selected(const char* zip_file_path, const char* output_folder, size_t n_prefixes, const char** prefixes, jm_callbacks* callbacks)
 {
-	/*
-	Usage : miniunz [-e] [-x] [-v] [-l] [-o] [-p password] file.zip [file_to_extr.] [-d extractdir]
-	  -e  Extract without pathname (junk paths)
-	  -x  Extract with pathname
-	  -v  list files
-	  -l  list files
-	  -d  directory to extract into
-	  -o  overwrite files without prompting
-	  -p  extract crypted file using password
-	*/
-
-	/* A call to minunz may change the current directory and therefore we must change it back */
-	char cd[FILENAME_MAX];
-
-	int argc = 6;
-	const char *argv[6];
-	int status;
+	jm_status_enu_t status = jm_status_success;
+	char* name = NULL;
+	size_t name_size = 0;
+	char* buf;
+	unzFile uf;
+	int err;
+
+	uf = fmi_zip_open(zip_file_path);
+	if (uf == NULL) {
+		jm_log_fatal(callbacks, module, "Could not open FMU %s", zip_file_path);
+		return jm_status_error;
+	}
+	buf = (char*)callbacks->malloc(FMI_ZIP_BUFFER_SIZE);
+	if (buf == NULL) {
+		jm_log_fatal(callbacks, module, "Could not allocate memory");
+		unzClose(uf);
+		return jm_status_error;
+	}
 
+	for (err = unzGoToFirstFile(uf); err == UNZ_OK; err = unzGoToNextFile(uf)) {
+		if (fmi_zip_get_current_name(uf, &name, &name_size, callbacks) != jm_status_success) {
+			status = jm_status_error;
+			break;
+		}
+		if (!fmi_zip_is_selected(name, n_prefixes, prefixes)) {
+			continue;
+		}
+		if (!fmi_zip_is_safe_entry_name(name)) {
+			jm_log_warning(callbacks, module, "Skipping %s since it would be extracted outside of %s", name, output_folder);
+			continue;
+		}
+		jm_log_debug(callbacks, module, "Extracting %s", name);
+		status = fmi_zip_extract_current(uf, output_folder, name, buf, callbacks);
+		if (status == jm_status_error) {
+			break;
+		}
+	}
+	if (err != UNZ_OK && err != UNZ_END_OF_LIST_OF_FILE) {
+		status = jm_status_error;
+	}
+
+	callbacks->free(name);
+	callbacks->free(buf);
+	unzClose(uf);
+
+	if (status == jm_status_error) {
+		jm_log_fatal(callbacks, module, "Unpacking of FMU %s into %s failed", zip_file_path, output_folder);
+	}
+	return status;
+}
+
+jm_status_enu_t fmi_zip_unzip(const char* zip_file_path, const char* output_folder, jm_callbacks* callbacks)
+{
 	jm_log_verbose(callbacks, module, "Unpacking FMU into %s", output_folder);
+	return fmi_zip_unzip_selected(zip_file_path, output_folder, 0, NULL, callbacks);
+}
+
+/* SHA-256 (FIPS 180-4), words are kept in unsigned long and masked to 32 bits */
+typedef struct fmi_zip_sha256_t {
+	unsigned long h[8];
+	unsigned long n_bits_lo;
+	unsigned long n_bits_hi;
+	unsigned char block[64];
+	size_t block_len;
+} fmi_zip_sha256_t;
+
+static const unsigned long fmi_zip_sha256_k[64] = {
+	0x428a2f98UL, 0x71374491UL, 0xb5c0fbcfUL, 0xe9b5dba5UL, 0x3956c25bUL, 0x59f111f1UL, 0x923f82a4UL, 0xab1c5ed5UL,
+	0xd807aa98UL, 0x12835b01UL, 0x243185beUL, 0x550c7dc3UL, 0x72be5d74UL, 0x80deb1feUL, 0x9bdc06a7UL, 0xc19bf174UL,
+	0xe49b69c1UL, 0xefbe4786UL, 0x0fc19dc6UL, 0x240ca1ccUL, 0x2de92c6fUL, 0x4a7484aaUL, 0x5cb0a9dcUL, 0x76f988daUL,
+	0x983e5152UL, 0xa831c66dUL, 0xb00327c8UL, 0xbf597fc7UL, 0xc6e00bf3UL, 0xd5a79147UL, 0x06ca6351UL, 0x14292967UL,
+	0x27b70a85UL, 0x2e1b2138UL, 0x4d2c6dfcUL, 0x53380d13UL, 0x650a7354UL, 0x766a0abbUL, 0x81c2c92eUL, 0x92722c85UL,
+	0xa2bfe8a1UL, 0xa81a664bUL, 0xc24b8b70UL, 0xc76c51a3UL, 0xd192e819UL, 0xd6990624UL, 0xf40e3585UL, 0x106aa070UL,
+	0x19a4c116UL, 0x1e376c08UL, 0x2748774cUL, 0x34b0bcb5UL, 0x391c0cb3UL, 0x4ed8aa4aUL, 0x5b9cca4fUL, 0x682e6ff3UL,
+	0x748f82eeUL, 0x78a5636fUL, 0x84c87814UL, 0x8cc70208UL, 0x90befffaUL, 0xa4506cebUL, 0xbef9a3f7UL, 0xc67178f2UL
+};
+
+#define FMI_ZIP_ROTR(x, n) ((((x) >> (n)) | ((x) << (32 - (n)))) & 0xffffffffUL)
+
+static void fmi_zip_sha256_init(fmi_zip_sha256_t* s) {
+	s->h[0] = 0x6a09e667UL; s->h[1] = 0xbb67ae85UL; s->h[2] = 0x3c6ef372UL; s->h[3] = 0xa54ff53aUL;
+	s->h[4] = 0x510e527fUL; s->h[5] = 0x9b05688cUL; s->h[6] = 0x1f83d9abUL; s->h[7] = 0x5be0cd19UL;
+	s->n_bits_lo = 0;
+	s->n_bits_hi = 0;
+	s->block_len = 0;
+}
+
+static void fmi_zip_sha256_block(fmi_zip_sha256_t* s) {
+	unsigned long w[64];
+	unsigned long a, b, c, d, e, f, g, h, t1, t2;
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		w[i] = ((unsigned long)s->block[4*i] << 24) | ((unsigned long)s->block[4*i + 1] << 16) |
+		       ((unsigned long)s->block[4*i + 2] << 8) | (unsigned long)s->block[4*i + 3];
+	}
+	for (i = 16; i < 64; i++) {
+		unsigned long s0 = FMI_ZIP_ROTR(w[i-15], 7) ^ FMI_ZIP_ROTR(w[i-15], 18) ^ (w[i-15] >> 3);
+		unsigned long s1 = FMI_ZIP_ROTR(w[i-2], 17) ^ FMI_ZIP_ROTR(w[i-2], 19) ^ (w[i-2] >> 10);
+		w[i] = (w[i-16] + s0 + w[i-7] + s1) & 0xffffffffUL;
+	}
+	a = s->h[0]; b = s->h[1]; c = s->h[2]; d = s->h[3];
+	e = s->h[4]; f = s->h[5]; g = s->h[6]; h = s->h[7];
+	for (i = 0; i < 64; i++) {
+		t1 = (h + (FMI_ZIP_ROTR(e, 6) ^ FMI_ZIP_ROTR(e, 11) ^ FMI_ZIP_ROTR(e, 25)) +
+		      ((e & f) ^ (~e & g)) + fmi_zip_sha256_k[i] + w[i]) & 0xffffffffUL;
+		t2 = ((FMI_ZIP_ROTR(a, 2) ^ FMI_ZIP_ROTR(a, 13) ^ FMI_ZIP_ROTR(a, 22)) +
+		      ((a & b) ^ (a & c) ^ (b & c))) & 0xffffffffUL;
+		h = g; g = f; f = e;
+		e = (d + t1) & 0xffffffffUL;
+		d = c; c = b; b = a;
+		a = (t1 + t2) & 0xffffffffUL;
+	}
+	s->h[0] = (s->h[0] + a) & 0xffffffffUL; s->h[1] = (s->h[1] + b) & 0xffffffffUL;
+	s->h[2] = (s->h[2] + c) & 0xffffffffUL; s->h[3] = (s->h[3] + d) & 0xffffffffUL;
+	s->h[4] = (s->h[4] + e) & 0xffffffffUL; s->h[5] = (s->h[5] + f) & 0xffffffffUL;
+	s->h[6] = (s->h[6] + g) & 0xffffffffUL; s->h[7] = (s->h[7] + h) & 0xffffffffUL;
+}
+
+static void fmi_zip_sha256_update(fmi_zip_sha256_t* s, const unsigned char* data, size_t len) {
+	while (len > 0) {
+		size_t n = 64 - s->block_len;
+		if (n > len) n = len;
+		memcpy(s->block + s->block_len, data, n);
+		s->block_len += n;
+		data += n;
+		len -= n;
+		s->n_bits_lo = (s->n_bits_lo + 8 * (unsigned long)n) & 0xffffffffUL;
+		if (s->n_bits_lo < 8 * (unsigned long)n) {
+			s->n_bits_hi = (s->n_bits_hi + 1) & 0xffffffffUL;
+		}
+		if (s->block_len == 64) {
+			fmi_zip_sha256_block(s);
+			s->block_len = 0;
+		}
+	}
+}
+
+/* Writes the digest as 64 hexadecimal digits and a terminating zero */
+static void fmi_zip_sha256_final(fmi_zip_sha256_t* s, char* hex) {
+	static const char digits[] = "0123456789abcdef";
+	unsigned long hi = s->n_bits_hi;
+	unsigned long lo = s->n_bits_lo;
+	int i;
+
+	s->block[s->block_len++] = 0x80;
+	if (s->block_len > 56) {
+		memset(s->block + s->block_len, 0, 64 - s->block_len);
+		fmi_zip_sha256_block(s);
+		s->block_len = 0;
+	}
+	memset(s->block + s->block_len, 0, 56 - s->block_len);
+	for (i = 0; i < 4; i++) {
+		s->block[59 - i] = (unsigned char)(hi >> (8 * i));
+		s->block[63 - i] = (unsigned char)(lo >> (8 * i));
+	}
+	fmi_zip_sha256_block(s);
+	for (i = 0; i < 32; i++) {
+		unsigned char byte = (unsigned char)(s->h[i / 4] >> (8 * (3 - i % 4)));
+		hex[2*i] = digits[byte >> 4];
+		hex[2*i + 1] = digits[byte & 0xf];
+	}
+	hex[64] = 0;
+}
+
+jm_status_enu_t fmi_zip_get_content_key(const char* zip_file_path, size_t n_prefixes, const char** prefixes, char* key, size_t len, jm_callbacks* callbacks)
+{
+	fmi_zip_sha256_t sha;
+	unsigned char* buf;
+	size_t n_read;
+	size_t i;
+	int read_error;
+	FILE* f;
+
+	if (len < FMI_ZIP_CONTENT_KEY_SIZE) {
+		jm_log_error(callbacks, module, "Buffer for the content key of %s is too small", zip_file_path);
+		return jm_status_error;
+	}
+	f = fopen(zip_file_path, "rb");
+	if (f == NULL) {
+		jm_log_fatal(callbacks, module, "Could not open FMU %s", zip_file_path);
+		return jm_status_error;
+	}
+	buf = (unsigned char*)callbacks->malloc(FMI_ZIP_BUFFER_SIZE);
+	if (buf == NULL) {
+		jm_log_fatal(callbacks, module, "Could not allocate memory");
+		fclose(f);
+		return jm_status_error;
+	}
 
-	argv[0]="miniunz";
-	argv[1]="-x";
-	argv[2]="-o";
-	argv[3]=zip_file_path;
-	argv[4]="-d";
-	argv[5]=output_folder;
-	
-
-	/* Temporary save the current directory */
-	if (jm_portability_get_current_working_directory(cd, sizeof(cd) / sizeof(char)) == jm_status_error) {
-		jm_log_fatal(callbacks, module, "Could not get Current Directory");
+	/* The whole archive is hashed, two FMUs share a key only if they are byte for byte equal */
+	fmi_zip_sha256_init(&sha);
+	while ((n_read = fread(buf, 1, FMI_ZIP_BUFFER_SIZE, f)) > 0) {
+		fmi_zip_sha256_update(&sha, buf, n_read);
+	}
+	read_error = ferror(f);
+	fclose(f);
+	callbacks->free(buf);
+	if (read_error) {
+		jm_log_fatal(callbacks, module, "Could not read FMU %s", zip_file_path);
 		return jm_status_error;
 	}
 
-	/* Unzip */
-	status = miniunz(argc, (char**)argv);
+	/* Selective extractions of the same FMU get different keys */
+	if (prefixes != NULL) {
+		for (i = 0; i < n_prefixes; i++) {
+			fmi_zip_sha256_update(&sha, (const unsigned char*)prefixes[i], strlen(prefixes[i]) + 1);
+		}
+	}
+	fmi_zip_sha256_final(&sha, key);
+	return jm_status_success;
+}
 
-	/* Reset the current directory */
-	if (jm_portability_set_current_working_directory(cd) == jm_status_error) {
-		jm_log_warning(callbacks, module, "Could not restore Current Directory after unpacking");
-		return jm_status_warning;
+char* fmi_zip_unzip_cached(const char* zip_file_path, const char* cache_folder, size_t n_prefixes, const char** prefixes, jm_callbacks* callbacks)
+{
+	char key[FMI_ZIP_CONTENT_KEY_SIZE];
+	size_t dir_len;
+	char* dir;
+	char* tmp_dir;
+
+	if (fmi_zip_get_content_key(zip_file_path, n_prefixes, prefixes, key, sizeof(key), callbacks) != jm_status_success) {
+		return NULL;
 	}
 
-	/* Return error status */
-	if (status == 0) {
-		return jm_status_success;
-	} else {
-		jm_log_fatal(callbacks, "FMIZIP", "Unpacking of FMU %s into %s failed", zip_file_path, output_folder);
-		return jm_status_error;	
+	dir_len = strlen(cache_folder) + 1 + strlen(key);
+	dir = (char*)callbacks->malloc(dir_len + 1);
+	tmp_dir = (char*)callbacks->malloc(dir_len + 8);
+	if (dir == NULL || tmp_dir == NULL) {
+		jm_log_fatal(callbacks, module, "Could not allocate memory");
+		callbacks->free(dir);
+		callbacks->free(tmp_dir);
+		return NULL;
 	}
+	sprintf(dir, "%s/%s", cache_folder, key);
+
+	if (fmi_zip_dir_exists(dir)) {
+		jm_log_verbose(callbacks, module, "Using cached extraction of FMU in %s", dir);
+		callbacks->free(tmp_dir);
+		return dir;
+	}
+
+	/* Extract into a private directory and publish it with a rename so that
+	   concurrent loaders never see a partially extracted FMU */
+	sprintf(tmp_dir, "%s.XXXXXX", dir);
+	if (jm_mkdtemp(callbacks, tmp_dir) == NULL) {
+		jm_log_fatal(callbacks, module, "Could not create a temporary directory in %s", cache_folder);
+		callbacks->free(dir);
+		callbacks->free(tmp_dir);
+		return NULL;
+	}
+	jm_log_verbose(callbacks, module, "Unpacking FMU into cache %s", dir);
+	if (fmi_zip_unzip_selected(zip_file_path, tmp_dir, n_prefixes, prefixes, callbacks) == jm_status_error) {
+		jm_rmdir(callbacks, tmp_dir);
+		callbacks->free(dir);
+		callbacks->free(tmp_dir);
+		return NULL;
+	}
+	if (rename(tmp_dir, dir) != 0) {
+		/* Another loader published the same content first */
+		jm_rmdir(callbacks, tmp_dir);
+		if (!fmi_zip_dir_exists(dir)) {
+			jm_log_fatal(callbacks, module, "Could not move %s to %s", tmp_dir, dir);
+			callbacks->free(dir);
+			callbacks->free(tmp_dir);
+			return NULL;
+		}
+	}
+	callbacks->free(tmp_dir);
+	return dir;
 }
 
 #ifdef __cplusplus 
 }
-#endif
\ No newline at end of file
+#endif
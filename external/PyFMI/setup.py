@@ -244,6 +244,10 @@ def check_extensions():
         ext_list[i].language = "c"
         ext_list[i].libraries = ["fmilib_shared"] if sys.platform.startswith("win") else ["fmilib"] #If windows shared, else static
         
+        #The chunked result writer compresses using zlib
+        if ext_list[i].name.endswith("fmi_util"):
+            ext_list[i].libraries.append("zlib" if sys.platform.startswith("win") else "z")
+        
         if debug_flag:
             ext_list[i].extra_compile_args = ["-g", "-fno-strict-aliasing", "-ggdb"]
         else:
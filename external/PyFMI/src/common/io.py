@@ -21,7 +21,17 @@ from operator import itemgetter, attrgetter
 import array
 import codecs
 import re
+from collections import OrderedDict
 import sys
+import struct
+import logging
+import mmap
+import zlib
+import threading
+try:
+    import queue
+except ImportError: #Python 2
+    import Queue as queue
 
 import numpy as N
 import numpy as np
@@ -1098,13 +1108,17 @@ class ResultDymolaTextual(ResultDymola):
         self.data[1] = N.vstack((self.data[1],res.data[1]))
         self.data[1][n_points:,0] = self.data[1][n_points:,0] + time_shift 
 
+mat4_precision = {0: "f8", 1: "f4", 2: "i4", 3: "i2", 4: "u2", 5: "u1"}
+
 class ResultDymolaBinary(ResultDymola):
     """ 
     Class representing a simulation or optimization result loaded from a Dymola 
-    binary file.
+    binary file. The file is memory-mapped, only the header matrices
+    (name and dataInfo) are read when the file is opened and the
+    trajectories are read on demand.
     """
 
-    def __init__(self,fname):
+    def __init__(self, fname, max_cached_columns=256):
         """
         Load a result file written on Dymola binary format.
 
@@ -1112,22 +1126,106 @@ class ResultDymolaBinary(ResultDymola):
         
             fname --
                 Name of file.
+                
+            max_cached_columns --
+                The maximum number of trajectories kept in memory after
+                they have been read.
+                Default: 256
         """
         self._fname = fname
-        self.raw = scipy.io.loadmat(fname,chars_as_strings=False, variable_names=["name", "dataInfo", "data_1", "data_2"])
-        name = self.raw['name']
-        self.raw_name = name
-
-        self.name = fmi_util.convert_array_names_list_names_int(name.view(np.int32))
-        self.dataInfo = self.raw['dataInfo'].transpose()
+        self._max_cached_columns = max_cached_columns
+        self._columns = OrderedDict()
+        
+        with open(fname, "rb") as f:
+            self._mmap = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        self._matrices = self._read_matrix_headers()
+        
+        for required in ["name", "dataInfo", "data_1"]:
+            if required not in self._matrices:
+                raise JIOError("The result file %s does not contain the matrix %s."%(fname, required))
+        
+        #Dymola stores the matrices either transposed (binTrans) or not (binNormal)
+        self._transposed = True
+        if "Aclass" in self._matrices:
+            aclass = self._get_matrix("Aclass")
+            if aclass.shape[0] > 3 and aclass[3,:].tobytes().rstrip(b"\0 ").startswith(b"binNormal"):
+                self._transposed = False
+        
+        name = self._get_matrix("name", transposed=self._transposed)
+        self.name = fmi_util.convert_array_names_list_names_int(name.astype(np.int32))
         self.name_lookup = {key:ind for ind,key in enumerate(self.name)}
         
+        self._data_info = np.array(self._get_matrix("dataInfo", transposed=self._transposed), dtype=np.int32)
+        self.dataInfo = self._data_info.transpose()
+        self._data_1 = np.array(self._get_matrix("data_1", transposed=self._transposed), dtype=np.float64)
+        self._data_2 = self._get_matrix("data_2", transposed=self._transposed) if "data_2" in self._matrices else np.empty((0,0))
+        
         self._description = None
+    
+    def _read_matrix_headers(self):
+        """
+        Reads the headers of all the (MATLAB v4) matrices in the file 
+        without reading the data.
+        """
+        mm = self._mmap
+        size = len(mm)
+        header_size = struct.calcsize("<5i")
+        matrices = {}
+        pos = 0
+        
+        while pos + header_size <= size:
+            byte_order = "<"
+            mtype, mrows, ncols, imagf, namlen = struct.unpack_from(byte_order+"5i", mm, pos)
+            if mtype < 0 or mtype > 4052:
+                byte_order = ">"
+                mtype, mrows, ncols, imagf, namlen = struct.unpack_from(byte_order+"5i", mm, pos)
+            if mtype < 0 or mtype > 4052 or mrows < 0 or ncols < 0 or namlen < 1:
+                break #Not a valid header, the file is corrupt from here
+            
+            name = decode(mm[pos+header_size:pos+header_size+namlen-1]) if python3_flag else mm[pos+header_size:pos+header_size+namlen-1]
+            dtype = np.dtype(byte_order + mat4_precision[(mtype // 10) % 10])
+            offset = pos + header_size + namlen
+            nbytes = mrows*ncols*dtype.itemsize*(2 if imagf else 1)
+            
+            if offset + nbytes > size:
+                #Not finalized, use the number of columns that are available
+                ncols = (size - offset) // (mrows*dtype.itemsize) if mrows > 0 else 0
+                nbytes = mrows*ncols*dtype.itemsize
+            
+            matrices[name] = (offset, dtype, mrows, ncols)
+            pos = offset + nbytes
+        
+        return matrices
+    
+    def _get_matrix(self, name, transposed=True):
+        """
+        Returns a view (backed by the memory-mapped file) of a matrix.
+        """
+        offset, dtype, mrows, ncols = self._matrices[name]
+        matrix = np.ndarray(shape=(mrows, ncols), dtype=dtype, buffer=self._mmap, offset=offset, order="F")
+        
+        return matrix if transposed else matrix.transpose()
+    
+    def _get_trajectory(self, data_index):
+        """
+        Returns the trajectory in the given row of the data_2 matrix. The
+        trajectories are cached.
+        """
+        try:
+            column = self._columns.pop(data_index)
+        except KeyError:
+            column = np.array(self._data_2[data_index,:], dtype=np.float64)
+            if len(self._columns) >= self._max_cached_columns:
+                self._columns.popitem(last=False)
+        self._columns[data_index] = column
+        
+        return column
         
     def _get_description(self):
         if not self._description:
-            description = scipy.io.loadmat(self._fname,chars_as_strings=False, variable_names=["description"])["description"]
-            self._description = ["".join(description[:,i]).rstrip() for i in range(description[0,:].size)]
+            description = self._get_matrix("description", transposed=self._transposed)
+            self._description = [description[:,i].tobytes().rstrip(b"\0 ").decode("latin-1") if python3_flag else description[:,i].tobytes().rstrip("\0 ") 
+                                    for i in range(description.shape[1])]
         
         return self._description
 
@@ -1135,6 +1233,31 @@ class ResultDymolaBinary(ResultDymola):
     """
     Property for accessing the description vector.
     """)
+    
+    def _get_raw_name(self):
+        logging.warning("The attribute 'raw_name' is deprecated and will be removed. Please use 'name' instead.")
+        return self._name_char_matrix()
+    
+    raw_name = property(_get_raw_name, doc = 
+    """
+    Deprecated. The name matrix as a character array (as stored in the file).
+    """)
+    
+    def _get_raw(self):
+        logging.warning("The attribute 'raw' is deprecated and will be removed. Please use 'get_variable_data' or 'get_data_matrix' instead.")
+        return {"name": self._name_char_matrix(), "dataInfo": self._get_matrix("dataInfo", transposed=self._transposed), 
+                "data_1": self._get_matrix("data_1", transposed=self._transposed), "data_2": self._data_2}
+    
+    raw = property(_get_raw, doc = 
+    """
+    Deprecated. Dictionary with the matrices name, dataInfo, data_1 and 
+    data_2 (as stored in the file). Note that data_2 is backed by the
+    memory-mapped file.
+    """)
+    
+    def _name_char_matrix(self):
+        name = self._get_matrix("name", transposed=self._transposed)
+        return name.astype(np.uint32).view("U1") if python3_flag else name.astype(np.uint8).view("S1")
        
     def get_variable_data(self,name):
         """
@@ -1158,8 +1281,8 @@ class ResultDymolaBinary(ResultDymola):
         else:
             varInd  = self.get_variable_index(name)
             
-        dataInd = self.raw['dataInfo'][1][varInd]
-        dataMat = self.raw['dataInfo'][0][varInd]
+        dataInd = self._data_info[1][varInd]
+        dataMat = self._data_info[0][varInd]
         factor = 1
         if dataInd<0:
             factor = -1
@@ -1170,9 +1293,12 @@ class ResultDymolaBinary(ResultDymola):
         if dataMat == 0:
             # Take into account that the 'Time' variable has data matrix index 0
             # and that 'time' is called 'Time' in Dymola results
-            dataMat = 2 if len(self.raw['data_2'])> 0 else 1
-                
-        return Trajectory(self.raw['data_%d'%dataMat][0,:],factor*self.raw['data_%d'%dataMat][dataInd,:])
+            dataMat = 2 if len(self._data_2)> 0 else 1
+        
+        if dataMat == 1:
+            return Trajectory(self._data_1[0,:],factor*self._data_1[dataInd,:])
+        else:
+            return Trajectory(self._get_trajectory(0),factor*self._get_trajectory(dataInd))
 
     def is_variable(self, name):
         """
@@ -1190,7 +1316,7 @@ class ResultDymolaBinary(ResultDymola):
         if name == 'time' or name== 'Time':
             return True
         varInd  = self.get_variable_index(name)
-        dataMat = self.raw['dataInfo'][0][varInd]
+        dataMat = self._data_info[0][varInd]
         if dataMat<1:
             dataMat = 1
         
@@ -1213,7 +1339,7 @@ class ResultDymolaBinary(ResultDymola):
             True if the result should be negated
         """
         varInd  = self.get_variable_index(name)
-        dataInd = self.raw['dataInfo'][1][varInd]
+        dataInd = self._data_info[1][varInd]
         if dataInd<0:
             return True
         else:
@@ -1240,7 +1366,7 @@ class ResultDymolaBinary(ResultDymola):
             raise VariableNotTimeVarying("Variable " +
                                         name + " is not time-varying.")
         varInd  = self.get_variable_index(name)
-        dataInd = self.raw['dataInfo'][1][varInd]
+        dataInd = self._data_info[1][varInd]
         factor = 1
         if dataInd<0:
             factor = -1
@@ -1252,15 +1378,28 @@ class ResultDymolaBinary(ResultDymola):
     
     def get_data_matrix(self):
         """
-        Returns the result matrix.
+        Returns the result matrix. Note that the matrix is backed by the
+        memory-mapped file, i.e. it is not read into memory.
                 
         Returns::
         
             The result data matrix.
         """
-        return self.raw['data_%d'%2]
-        
-
+        return self._data_2
+    
+    def close(self):
+        """
+        Closes the memory-mapped file. Trajectories that have already
+        been returned are still valid.
+        """
+        if self._mmap is not None:
+            self._data_2 = None
+            self._columns.clear()
+            try:
+                self._mmap.close()
+            except BufferError:
+                return #There are still views of the file in use
+            self._mmap = None
 
 class ResultHandlerMemory(ResultHandler):
     def __init__(self, model):
@@ -2237,3 +2376,439 @@ class ResultHandlerBinaryFile(ResultHandler):
         method.
         """
         self.options = options
+
+# The chunked result format (.cres) is a column-oriented binary format
+# where the trajectories are written in chunks of a fixed number of 
+# points. Within a chunk each variable is stored (optionally compressed)
+# as a separate block so that a single trajectory can be read without 
+# loading the whole file.
+#
+#     header  -- magic, version, flags, number of trajectory variables,
+#                the name/description tables, dataInfo and data_1 (as
+#                in the Dymola binary format)
+#     chunks  -- number of points, the block sizes of all variables 
+#                followed by the blocks
+#     index   -- number of chunks followed by the chunk offsets
+#     footer  -- offset of the index and the end magic
+chunked_magic       = b"PYFMIRES"
+chunked_end_magic   = b"PYFMIEND"
+chunked_version     = 1
+chunked_header      = "<8sIIIIIII" #magic, version, compression, nvariables, nnames, name length, description length, nparameters
+chunked_chunk_npts  = "<Q"
+chunked_footer      = "<Q8s"
+
+class ResultDymolaChunked(ResultDymola):
+    """ 
+    Class representing a simulation result loaded from a chunked binary
+    result file (written by ResultHandlerChunkedFile). Only the header 
+    and the chunk index are read when the file is opened, trajectories 
+    are read (and decompressed) on demand.
+    """
+
+    def __init__(self, fname):
+        """
+        Load a result file written on the chunked binary format.
+
+        Parameters::
+        
+            fname --
+                Name of file.
+        """
+        self._fname = fname
+        self._file = open(fname, "rb")
+        
+        header = self._file.read(struct.calcsize(chunked_header))
+        magic, version, compression, nvariables, nnames, name_length, desc_length, nparameters = struct.unpack(chunked_header, header)
+        if magic != chunked_magic or version != chunked_version:
+            raise JIOError("The file %s is not a chunked result file."%fname)
+        
+        self._compression = compression
+        self._nvariables  = nvariables
+        
+        names = self._file.read(nnames*name_length)
+        descs = self._file.read(nnames*desc_length)
+        self.name = [decode(n.rstrip(b"\0")) for n in np.frombuffer(names, dtype="S%d"%name_length)] if python3_flag else \
+                    [n.rstrip("\0") for n in np.frombuffer(names, dtype="S%d"%name_length)]
+        self._raw_description = (descs, desc_length)
+        self._description = None
+        self.name_lookup = {key:ind for ind,key in enumerate(self.name)}
+        
+        self._data_info = np.frombuffer(self._file.read(4*nnames*4), dtype="<i4").reshape((4, nnames))
+        self.dataInfo = self._data_info.transpose()
+        self._data_1 = np.frombuffer(self._file.read(2*nparameters*8), dtype="<f8").reshape((nparameters, 2))
+        
+        self._data_start = self._file.tell()
+        self._read_chunk_index()
+        self._columns = {}
+    
+    def _read_chunk_index(self):
+        """
+        Reads the chunk index from the footer. If the file was not 
+        finalized (i.e. the simulation failed) the chunks are scanned
+        from the beginning instead.
+        """
+        f = self._file
+        footer_size = struct.calcsize(chunked_footer)
+        
+        f.seek(0, 2)
+        file_size = f.tell()
+        
+        offsets = None
+        if file_size - self._data_start >= footer_size:
+            f.seek(file_size - footer_size)
+            index_offset, magic = struct.unpack(chunked_footer, f.read(footer_size))
+            if magic == chunked_end_magic:
+                f.seek(index_offset)
+                nchunks = struct.unpack(chunked_chunk_npts, f.read(8))[0]
+                offsets = np.frombuffer(f.read(8*nchunks), dtype="<u8")
+                data_end = index_offset
+        if offsets is None:
+            offsets = []
+            data_end = file_size
+            pos = self._data_start
+            while pos + 8*(self._nvariables+1) <= data_end:
+                f.seek(pos)
+                f.read(8)
+                sizes = np.frombuffer(f.read(8*self._nvariables), dtype="<u8")
+                end = pos + 8*(self._nvariables+1) + int(sizes.sum())
+                if end > data_end:
+                    break #Truncated chunk
+                offsets.append(pos)
+                pos = end
+        
+        #Compute the position and size of each block
+        self._chunk_npoints = []
+        self._block_offsets = []
+        self._block_sizes = []
+        for offset in offsets:
+            f.seek(int(offset))
+            self._chunk_npoints.append(struct.unpack(chunked_chunk_npts, f.read(8))[0])
+            sizes = np.frombuffer(f.read(8*self._nvariables), dtype="<u8").astype(np.int64)
+            self._block_sizes.append(sizes)
+            self._block_offsets.append(int(offset) + 8*(self._nvariables+1) + np.append(0, np.cumsum(sizes)[:-1]))
+        self._npoints = int(sum(self._chunk_npoints))
+    
+    def _read_column(self, dataInd):
+        """
+        Reads the trajectory stored in the given column of the trajectory
+        data. The columns are cached.
+        """
+        if dataInd in self._columns:
+            return self._columns[dataInd]
+        
+        column = np.empty(self._npoints)
+        pos = 0
+        for i in range(len(self._chunk_npoints)):
+            self._file.seek(int(self._block_offsets[i][dataInd]))
+            block = self._file.read(int(self._block_sizes[i][dataInd]))
+            if self._compression:
+                block = zlib.decompress(block)
+            npoints = self._chunk_npoints[i]
+            column[pos:pos+npoints] = np.frombuffer(block, dtype="<f8")
+            pos += npoints
+        
+        self._columns[dataInd] = column
+        return column
+    
+    def _get_description(self):
+        if not self._description:
+            descs, desc_length = self._raw_description
+            self._description = [decode(d.rstrip(b"\0")) if python3_flag else d.rstrip("\0") for d in np.frombuffer(descs, dtype="S%d"%desc_length)]
+        
+        return self._description
+
+    description = property(_get_description, doc = 
+    """
+    Property for accessing the description vector.
+    """)
+    
+    def get_variable_data(self,name):
+        """
+        Retrieve the data sequence for a variable with a given name.
+        
+        Parameters::
+        
+            name --
+                Name of the variable.
+
+        Returns::
+        
+            A Trajectory object containing the time vector and the data vector 
+            of the variable.
+        """
+        if python3_flag and isinstance(name, bytes):
+            name = decode(name)
+            
+        if name == 'time' or name== 'Time':
+            varInd = 0;
+        else:
+            varInd  = self.get_variable_index(name)
+            
+        dataInd = self._data_info[1][varInd]
+        dataMat = self._data_info[0][varInd]
+        factor = 1
+        if dataInd<0:
+            factor = -1
+            dataInd = -dataInd -1
+        else:
+            dataInd = dataInd - 1
+            
+        if dataMat == 0:
+            dataMat = 2 if self._npoints > 0 else 1
+        
+        if dataMat == 1:
+            return Trajectory(self._data_1[0,:], factor*self._data_1[dataInd,:])
+        else:
+            return Trajectory(self._read_column(0), factor*self._read_column(dataInd))
+
+    def is_variable(self, name):
+        """
+        Returns True if the given name corresponds to a time-varying variable.
+        
+        Parameters::
+        
+            name -- 
+                Name of the variable/parameter/constant.
+                
+        Returns::
+        
+            True if the variable is time-varying.
+        """
+        if name == 'time' or name== 'Time':
+            return True
+        varInd  = self.get_variable_index(name)
+        dataMat = self._data_info[0][varInd]
+        
+        return dataMat > 1
+            
+    def is_negated(self, name):
+        """
+        Returns True if the given name corresponds to a negated result vector.
+        
+        Parameters::
+        
+            name -- 
+                Name of the variable/parameter/constant.
+                
+        Returns::
+        
+            True if the result should be negated
+        """
+        varInd  = self.get_variable_index(name)
+        
+        return self._data_info[1][varInd] < 0
+    
+    def get_column(self, name):
+        """
+        Returns the column number in the data matrix where the values of the 
+        variable are stored.
+        
+        Parameters::
+        
+            name -- 
+                Name of the variable/parameter/constant.
+            
+        Returns::
+        
+            The column number.
+        """
+        if name == 'time' or name== 'Time':
+            return 0
+        
+        if not self.is_variable(name):
+            raise VariableNotTimeVarying("Variable " +
+                                        name + " is not time-varying.")
+        dataInd = self._data_info[1][self.get_variable_index(name)]
+        
+        return -dataInd - 1 if dataInd < 0 else dataInd - 1
+    
+    def get_data_matrix(self):
+        """
+        Returns the result matrix. Note that this reads all the 
+        trajectories in the file.
+                
+        Returns::
+        
+            The result data matrix.
+        """
+        return np.array([self._read_column(i) for i in range(self._nvariables)])
+    
+    def close(self):
+        """
+        Closes the underlying file.
+        """
+        if self._file:
+            self._file.close()
+            self._file = None
+
+class ResultHandlerChunkedFile(ResultHandler):
+    """ 
+    Export a simulation result to file in the chunked binary result 
+    format. The result points are buffered and written in chunks of 
+    chunk_size points, column-wise and (optionally) zlib compressed. The
+    buffering, compression and writing is done in C (see 
+    fmi_util.ChunkedResultWriter) and can be performed in a background 
+    thread while the simulation continues.
+    """
+    def __init__(self, model, chunk_size=1024, compression=True, background=True):
+        self.model = model
+        self.chunk_size = chunk_size
+        self.compression = compression
+        self.background = background
+    
+    def initialize_complete(self):
+        pass 
+    
+    def simulation_start(self):
+        """
+        Opens the file and writes the header. This includes the information 
+        about the variables and a table determining the link between variables 
+        and data.
+        """
+        opts = self.options
+        
+        self.file_name = opts["result_file_name"]
+        try:
+            self.parameters = opts["sensitivities"]
+        except KeyError:
+            self.parameters = False
+            
+        if self.parameters:
+            raise fmi.FMUException("Storing sensitivity results are not supported using this format. Use the file format instead.")
+        
+        if self.file_name == "":
+            self.file_name=self.model.get_identifier() + '_result.cres'
+        
+        self._file = open(self.file_name,'wb')
+        
+        vars_real = self.model.get_model_variables(type=fmi.FMI_REAL,    filter=self.options["filter"], _as_list=True)
+        vars_int  = self.model.get_model_variables(type=fmi.FMI_INTEGER, filter=self.options["filter"], _as_list=True)
+        vars_bool = self.model.get_model_variables(type=fmi.FMI_BOOLEAN, filter=self.options["filter"], _as_list=True)
+        vars_enum = self.model.get_model_variables(type=fmi.FMI_ENUMERATION, filter=self.options["filter"], _as_list=True)
+        
+        sorted_vars = sorted(vars_real, key=attrgetter("value_reference")) + \
+                      sorted(vars_int,  key=attrgetter("value_reference")) + \
+                      sorted(vars_enum, key=attrgetter("value_reference")) + \
+                      sorted(vars_bool, key=attrgetter("value_reference"))
+        nnames = len(sorted_vars)+1
+        
+        len_name_data, name_data, len_desc_data, desc_data = fmi_util.convert_sorted_vars_name_desc(sorted_vars)
+        
+        data_info = np.zeros((4, nnames), dtype=np.int32)
+        [parameter_data, sorted_vars_real_vref, sorted_vars_int_vref, sorted_vars_bool_vref]  = fmi_util.prepare_data_info(data_info, sorted_vars, self.model)
+        
+        self.real_var_ref = np.array(sorted_vars_real_vref)
+        self.int_var_ref  = np.array(sorted_vars_int_vref)
+        self.bool_var_ref = np.array(sorted_vars_bool_vref)
+        self.nvariables = 1 + len(self.real_var_ref) + len(self.int_var_ref) + len(self.bool_var_ref)
+        
+        f = self._file
+        f.write(struct.pack(chunked_header, chunked_magic, chunked_version, 1 if self.compression else 0, 
+                            self.nvariables, nnames, len_name_data, len_desc_data, len(parameter_data)))
+        f.write(name_data)
+        f.write(desc_data)
+        f.write(data_info.astype("<i4").tobytes())
+        
+        #Parameters are stored for the start and final time, the final time is updated at the end
+        data_1 = np.array([parameter_data, parameter_data], dtype="<f8").transpose().copy()
+        self.data_1_end_time_position = f.tell() + 8
+        f.write(data_1.tobytes())
+        f.close()
+        self._file = None
+        
+        #The chunks, the index and the footer are written by the (C) writer
+        self._writer = fmi_util.ChunkedResultWriter(self.file_name, len(self.real_var_ref), len(self.int_var_ref), 
+                                                    len(self.bool_var_ref), self.chunk_size, self.compression)
+        self._writer_error = None
+        self._writer_thread = None
+        self.nbr_points = 0
+        
+        if self.background:
+            self._queue = queue.Queue()
+            self._free  = queue.Queue()
+            self._free.put(1) #Buffer 0 is filled first
+            self._writer_thread = threading.Thread(target=self._write_chunks)
+            self._writer_thread.daemon = True
+            self._writer_thread.start()
+    
+    def _write_chunks(self):
+        """
+        Background writer, compresses and writes the filled buffers. The 
+        writer releases the GIL while compressing and writing.
+        """
+        while True:
+            buffer = self._queue.get()
+            if buffer is None:
+                break
+            try:
+                if self._writer_error is None:
+                    self._writer.write(buffer)
+            except Exception as ex:
+                self._writer_error = ex
+            self._free.put(buffer)
+    
+    def _flush(self):
+        if self._writer_thread is not None:
+            #Wait until the previous chunk is written before switching buffer
+            free_buffer = self._free.get()
+            if self._writer_error is not None:
+                raise self._writer_error
+            self._queue.put(self._writer.swap(free_buffer))
+        else:
+            self._writer.write(self._writer.current)
+
+    def integration_point(self, solver = None):
+        """ 
+        Adds the current status of the model to the buffer. When the 
+        buffer is full, the chunk is written to file.
+        """
+        model = self.model
+        
+        r = model.get_real(self.real_var_ref)
+        i = model.get_integer(self.int_var_ref)
+        b = model.get_boolean(self.bool_var_ref)
+        
+        if self._writer.add_point(float(model.time), r, i, b):
+            self._flush()
+        
+        self.nbr_points += 1
+
+    def simulation_end(self):
+        """ 
+        Finalize the writing, i.e. write the remaining points, the chunk
+        index and the footer. Also updates the final time (in data set 1).
+        """
+        if self._writer is not None:
+            if self._writer_thread is not None:
+                self._queue.put(None)
+                self._writer_thread.join()
+                self._writer_thread = None
+            
+            try:
+                if self._writer_error is None:
+                    self._writer.finalize()
+            finally:
+                self._writer.close()
+                self._writer = None
+            
+            if self._writer_error is not None:
+                raise self._writer_error
+            
+            with open(self.file_name, "r+b") as f:
+                f.seek(self.data_1_end_time_position)
+                f.write(np.array([float(self.model.time)], dtype="<f8").tobytes())
+            
+    def get_result(self):
+        """
+        Method for retrieving the result. This method should return a 
+        result of an instance of ResultBase or of an instance of a 
+        subclass of ResultBase.
+        """
+        return ResultDymolaChunked(self.file_name)
+        
+    def set_options(self, options):
+        """
+        Options are the options dictionary provided to the simulation
+        method.
+        """
+        self.options = options
@@ -125,6 +125,7 @@ cdef class FMUModelBase(ModelBase):
     cdef public list _save_bool_variables_val
     cdef int _fmu_kind
     cdef char* _fmu_temp_dir
+    cdef int _keep_unzipped_dir
     
     cpdef _internal_set_fmu_null(self)
     cpdef get_variable_description(self, variablename)
@@ -178,6 +179,7 @@ cdef class FMUModelBase2(ModelBase):
     cdef object         __t
     cdef public object  _pyEventInfo
     cdef char* _fmu_temp_dir
+    cdef int _keep_unzipped_dir
     cdef object         _states_references
     cdef object         _inputs_references
     cdef object         _outputs_references
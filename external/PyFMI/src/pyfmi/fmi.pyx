@@ -1113,7 +1113,7 @@ cdef class FMUModelBase(ModelBase):
     """
     An FMI Model loaded from a DLL.
     """
-    def __init__(self, fmu, path='.', enable_logging=None, log_file_name="", log_level=FMI_DEFAULT_LOG_LEVEL, _unzipped_dir=None, _connect_dll=True):
+    def __init__(self, fmu, path='.', enable_logging=None, log_file_name="", log_level=FMI_DEFAULT_LOG_LEVEL, _unzipped_dir=None, _connect_dll=True, _keep_unzipped_dir=False):
         """
         Constructor.
         """
@@ -1134,6 +1134,7 @@ cdef class FMUModelBase(ModelBase):
         self._instantiated_fmu  = 0
         self._allocated_list = False
         self._fmu_temp_dir = NULL
+        self._keep_unzipped_dir = 1 if _keep_unzipped_dir else 0
         self._fmu_log_name = NULL
 
         #Specify the general callback functions
@@ -2548,9 +2549,9 @@ cdef class FMUModelCS1(FMUModelBase):
     #First step only support fmi1_fmu_kind_enu_cs_standalone
     #stepFinished not supported
 
-    def __init__(self, fmu, path='.', enable_logging=None, log_file_name="", log_level=FMI_DEFAULT_LOG_LEVEL, _unzipped_dir=None, _connect_dll=True):
+    def __init__(self, fmu, path='.', enable_logging=None, log_file_name="", log_level=FMI_DEFAULT_LOG_LEVEL, _unzipped_dir=None, _connect_dll=True, _keep_unzipped_dir=False):
         #Call super
-        FMUModelBase.__init__(self,fmu,path,enable_logging,log_file_name, log_level, _unzipped_dir, _connect_dll)
+        FMUModelBase.__init__(self,fmu,path,enable_logging,log_file_name, log_level, _unzipped_dir, _connect_dll, _keep_unzipped_dir)
 
         if self._fmu_kind != FMI_CS_STANDALONE and self._fmu_kind != FMI_CS_TOOL:
             raise FMUException("This class only supports FMI 1.0 for Co-simulation.")
@@ -2587,7 +2588,8 @@ cdef class FMUModelCS1(FMUModelBase):
             FMIL.fmi1_import_free(self._fmu)
 
         if self._fmu_temp_dir != NULL:
-            FMIL.fmi_import_rmdir(&self.callbacks, self._fmu_temp_dir)
+            if not self._keep_unzipped_dir:
+                FMIL.fmi_import_rmdir(&self.callbacks, self._fmu_temp_dir)
             FMIL.free(self._fmu_temp_dir)
             self._fmu_temp_dir = NULL
 
@@ -3040,9 +3042,9 @@ cdef class FMUModelME1(FMUModelBase):
     An FMI Model loaded from a DLL.
     """
 
-    def __init__(self, fmu, path='.', enable_logging=None, log_file_name="", log_level=FMI_DEFAULT_LOG_LEVEL, _unzipped_dir=None, _connect_dll=True):
+    def __init__(self, fmu, path='.', enable_logging=None, log_file_name="", log_level=FMI_DEFAULT_LOG_LEVEL, _unzipped_dir=None, _connect_dll=True, _keep_unzipped_dir=False):
         #Call super
-        FMUModelBase.__init__(self,fmu,path,enable_logging,log_file_name, log_level, _unzipped_dir, _connect_dll)
+        FMUModelBase.__init__(self,fmu,path,enable_logging,log_file_name, log_level, _unzipped_dir, _connect_dll, _keep_unzipped_dir)
 
         if self._fmu_kind != FMI_ME:
             raise FMUException("This class only supports FMI 1.0 for Model Exchange.")
@@ -3120,7 +3122,8 @@ cdef class FMUModelME1(FMUModelBase):
             FMIL.fmi1_import_free(self._fmu)
 
         if self._fmu_temp_dir != NULL:
-            FMIL.fmi_import_rmdir(&self.callbacks, self._fmu_temp_dir)
+            if not self._keep_unzipped_dir:
+                FMIL.fmi_import_rmdir(&self.callbacks, self._fmu_temp_dir)
             FMIL.free(self._fmu_temp_dir)
             self._fmu_temp_dir = NULL
 
@@ -3635,7 +3638,7 @@ cdef class FMUModelBase2(ModelBase):
     """
     FMI Model loaded from a dll.
     """
-    def __init__(self, fmu, path='.', enable_logging=None, log_file_name="", log_level=FMI_DEFAULT_LOG_LEVEL, _unzipped_dir=None, _connect_dll=True):
+    def __init__(self, fmu, path='.', enable_logging=None, log_file_name="", log_level=FMI_DEFAULT_LOG_LEVEL, _unzipped_dir=None, _connect_dll=True, _keep_unzipped_dir=False):
         """
         Constructor of the model.
 
@@ -3685,6 +3688,7 @@ cdef class FMUModelBase2(ModelBase):
         self._allocated_xml = 0
         self._allocated_fmu = 0
         self._fmu_temp_dir = NULL
+        self._keep_unzipped_dir = 1 if _keep_unzipped_dir else 0
         self._fmu_log_name = NULL
 
         #Default values
@@ -6448,7 +6452,7 @@ cdef class FMUModelCS2(FMUModelBase2):
     """
     Co-simulation model loaded from a dll
     """
-    def __init__(self, fmu, path = '.', enable_logging = None, log_file_name = "", log_level=FMI_DEFAULT_LOG_LEVEL, _unzipped_dir=None, _connect_dll=True):
+    def __init__(self, fmu, path = '.', enable_logging = None, log_file_name = "", log_level=FMI_DEFAULT_LOG_LEVEL, _unzipped_dir=None, _connect_dll=True, _keep_unzipped_dir=False):
         """
         Constructor of the model.
 
@@ -6480,7 +6484,7 @@ cdef class FMUModelCS2(FMUModelBase2):
         """
 
         #Call super
-        FMUModelBase2.__init__(self, fmu, path, enable_logging, log_file_name, log_level, _unzipped_dir, _connect_dll)
+        FMUModelBase2.__init__(self, fmu, path, enable_logging, log_file_name, log_level, _unzipped_dir, _connect_dll, _keep_unzipped_dir)
 
         if self._fmu_kind != FMIL.fmi2_fmu_kind_cs:
             if self._fmu_kind != FMIL.fmi2_fmu_kind_me_and_cs:
@@ -6509,7 +6513,8 @@ cdef class FMUModelCS2(FMUModelBase2):
             FMIL.fmi2_import_free(self._fmu)
 
         if self._fmu_temp_dir != NULL:
-            FMIL.fmi_import_rmdir(&self.callbacks, self._fmu_temp_dir)
+            if not self._keep_unzipped_dir:
+                FMIL.fmi_import_rmdir(&self.callbacks, self._fmu_temp_dir)
             FMIL.free(self._fmu_temp_dir)
             self._fmu_temp_dir = NULL
             
@@ -7049,7 +7054,7 @@ cdef class FMUModelME2(FMUModelBase2):
     Model-exchange model loaded from a dll
     """
 
-    def __init__(self, fmu, path = '.', enable_logging = None, log_file_name = "", log_level=FMI_DEFAULT_LOG_LEVEL, _unzipped_dir=None, _connect_dll=True):
+    def __init__(self, fmu, path = '.', enable_logging = None, log_file_name = "", log_level=FMI_DEFAULT_LOG_LEVEL, _unzipped_dir=None, _connect_dll=True, _keep_unzipped_dir=False):
         """
         Constructor of the model.
 
@@ -7080,7 +7085,7 @@ cdef class FMUModelME2(FMUModelBase2):
             A model as an object from the class FMUModelME2
         """
         #Call super
-        FMUModelBase2.__init__(self, fmu, path, enable_logging, log_file_name, log_level, _unzipped_dir, _connect_dll)
+        FMUModelBase2.__init__(self, fmu, path, enable_logging, log_file_name, log_level, _unzipped_dir, _connect_dll, _keep_unzipped_dir)
 
         if self._fmu_kind != FMIL.fmi2_fmu_kind_me:
             if self._fmu_kind != FMIL.fmi2_fmu_kind_me_and_cs:
@@ -7119,7 +7124,8 @@ cdef class FMUModelME2(FMUModelBase2):
             FMIL.fmi2_import_free(self._fmu)
 
         if self._fmu_temp_dir != NULL:
-            FMIL.fmi_import_rmdir(&self.callbacks, self._fmu_temp_dir)
+            if not self._keep_unzipped_dir:
+                FMIL.fmi_import_rmdir(&self.callbacks, self._fmu_temp_dir)
             FMIL.free(self._fmu_temp_dir)
             self._fmu_temp_dir = NULL
             
@@ -7743,7 +7749,7 @@ def _handle_load_fmu_exception(fmu, log_data):
     for log in log_data:
         print(log)
 
-def load_fmu(fmu, path = '.', enable_logging = None, log_file_name = "", kind = 'auto', log_level=FMI_DEFAULT_LOG_LEVEL):
+def load_fmu(fmu, path = '.', enable_logging = None, log_file_name = "", kind = 'auto', log_level=FMI_DEFAULT_LOG_LEVEL, unzip_cache = None):
     """
     Helper method for creating a model instance.
 
@@ -7777,7 +7783,17 @@ def load_fmu(fmu, path = '.', enable_logging = None, log_file_name = "", kind =
             Determines the logging output. Can be set between 0 
             (no logging) and 7 (everything).
             Default: 2 (log error messages)
-        
+
+        unzip_cache --
+            Path to an existing directory used as extraction cache. The
+            model description, the binaries for this platform and the
+            resources are unzipped into a sub directory named by the
+            SHA-256 of the FMU, which later loads of the same FMU reuse,
+            also from other processes. The sub directory is kept when
+            the model is deleted.
+            Default: None (unzip the complete FMU into a new temporary
+            directory that is removed with the model)
+
     Returns::
 
         A model instance corresponding to the loaded FMU.
@@ -7796,11 +7812,13 @@ def load_fmu(fmu, path = '.', enable_logging = None, log_file_name = "", kind =
     cdef FMIL.fmi2_import_t*            fmu_2 = NULL
     cdef FMIL.fmi1_fmu_kind_enu_t       fmu_1_kind
     cdef FMIL.fmi2_fmu_kind_enu_t       fmu_2_kind
+    cdef char*                          cached_dir = NULL
     cdef list                           log_data = []
 
     #Variables for deallocation
     fmu_temp_dir = None
     model        = None
+    keep_unzipped_dir = unzip_cache is not None
 
     # Check that the file referenced by fmu has the correct file-ending
     fmu_full_path = os.path.abspath(os.path.join(path,fmu))
@@ -7816,6 +7834,9 @@ def load_fmu(fmu, path = '.', enable_logging = None, log_file_name = "", kind =
         if (kind.upper() != 'ME' and kind.upper() != 'CS'):
             raise FMUException('Input-argument "kind" can only be "ME", "CS" or "auto" (default) and not: ' + kind)
 
+    if keep_unzipped_dir and not os.path.isdir(unzip_cache):
+        raise FMUException('The unzip cache directory %s does not exist.' % unzip_cache)
+
     #Specify FMI related callbacks
     callbacks.malloc    = FMIL.malloc
     callbacks.calloc    = FMIL.calloc
@@ -7843,16 +7864,23 @@ def load_fmu(fmu, path = '.', enable_logging = None, log_file_name = "", kind =
     context = FMIL.fmi_import_allocate_context(&callbacks)
 
     #Get the FMI version of the provided model
-    fmu_temp_dir = encode(create_temp_dir())
     fmu_full_path = encode(fmu_full_path)
-    version = FMIL.fmi_import_get_fmi_version(context, fmu_full_path, fmu_temp_dir)
+    if keep_unzipped_dir:
+        version = FMIL.fmi_import_get_fmi_version_cached(context, fmu_full_path, encode(os.path.abspath(unzip_cache)), &cached_dir)
+        if cached_dir != NULL:
+            fmu_temp_dir = <bytes>cached_dir
+            FMIL.free(cached_dir)
+    else:
+        fmu_temp_dir = encode(create_temp_dir())
+        version = FMIL.fmi_import_get_fmi_version(context, fmu_full_path, fmu_temp_dir)
 
     #Check the version
     if version == FMIL.fmi_version_unknown_enu:
         #Delete context
         last_error = FMIL.jm_get_last_error(&callbacks)
         FMIL.fmi_import_free_context(context)
-        FMIL.fmi_import_rmdir(&callbacks, fmu_temp_dir)
+        if not keep_unzipped_dir:
+            FMIL.fmi_import_rmdir(&callbacks, fmu_temp_dir)
         if callbacks.log_level >= FMIL.jm_log_level_error:
             _handle_load_fmu_exception(fmu, log_data)
             raise FMUException("The FMU version could not be determined. "+decode(last_error))
@@ -7864,7 +7892,8 @@ def load_fmu(fmu, path = '.', enable_logging = None, log_file_name = "", kind =
         #Delete the context
         last_error = FMIL.jm_get_last_error(&callbacks)
         FMIL.fmi_import_free_context(context)
-        FMIL.fmi_import_rmdir(&callbacks, fmu_temp_dir)
+        if not keep_unzipped_dir:
+            FMIL.fmi_import_rmdir(&callbacks, fmu_temp_dir)
         if callbacks.log_level >= FMIL.jm_log_level_error:
             _handle_load_fmu_exception(fmu, log_data)
             raise FMUException("The FMU version is unsupported. "+decode(last_error))
@@ -7881,7 +7910,8 @@ def load_fmu(fmu, path = '.', enable_logging = None, log_file_name = "", kind =
             #Delete the context
             last_error = FMIL.jm_get_last_error(&callbacks)
             FMIL.fmi_import_free_context(context)
-            FMIL.fmi_import_rmdir(&callbacks, fmu_temp_dir)
+            if not keep_unzipped_dir:
+                FMIL.fmi_import_rmdir(&callbacks, fmu_temp_dir)
             if callbacks.log_level >= FMIL.jm_log_level_error:
                 _handle_load_fmu_exception(fmu, log_data)
                 raise FMUException("The XML-could not be read. "+decode(last_error))
@@ -7893,13 +7923,14 @@ def load_fmu(fmu, path = '.', enable_logging = None, log_file_name = "", kind =
 
         #Compare fmu_kind with input-specified kind
         if fmu_1_kind == FMI_ME and kind.upper() != 'CS':
-            model=FMUModelME1(fmu, path, original_enable_logging, log_file_name,log_level, _unzipped_dir=fmu_temp_dir)
+            model=FMUModelME1(fmu, path, original_enable_logging, log_file_name,log_level, _unzipped_dir=fmu_temp_dir, _keep_unzipped_dir=keep_unzipped_dir)
         elif (fmu_1_kind == FMI_CS_STANDALONE or fmu_1_kind == FMI_CS_TOOL) and kind.upper() != 'ME':
-            model=FMUModelCS1(fmu, path, original_enable_logging, log_file_name,log_level, _unzipped_dir=fmu_temp_dir)
+            model=FMUModelCS1(fmu, path, original_enable_logging, log_file_name,log_level, _unzipped_dir=fmu_temp_dir, _keep_unzipped_dir=keep_unzipped_dir)
         else:
             FMIL.fmi1_import_free(fmu_1)
             FMIL.fmi_import_free_context(context)
-            FMIL.fmi_import_rmdir(&callbacks,fmu_temp_dir)
+            if not keep_unzipped_dir:
+                FMIL.fmi_import_rmdir(&callbacks, fmu_temp_dir)
             _handle_load_fmu_exception(fmu, log_data)
             raise FMUException('FMU is a ' + FMIL.fmi1_fmu_kind_to_string(fmu_1_kind) + ' and not a ' + kind.upper())
 
@@ -7911,7 +7942,8 @@ def load_fmu(fmu, path = '.', enable_logging = None, log_file_name = "", kind =
             #Delete the context
             last_error = FMIL.jm_get_last_error(&callbacks)
             FMIL.fmi_import_free_context(context)
-            FMIL.fmi_import_rmdir(&callbacks, fmu_temp_dir)
+            if not keep_unzipped_dir:
+                FMIL.fmi_import_rmdir(&callbacks, fmu_temp_dir)
             if callbacks.log_level >= FMIL.jm_log_level_error:
                 _handle_load_fmu_exception(fmu, log_data)
                 raise FMUException("The XML-could not be read. "+decode(last_error))
@@ -7926,7 +7958,8 @@ def load_fmu(fmu, path = '.', enable_logging = None, log_file_name = "", kind =
             last_error = FMIL.jm_get_last_error(&callbacks)
             FMIL.fmi2_import_free(fmu_2)
             FMIL.fmi_import_free_context(context)
-            FMIL.fmi_import_rmdir(&callbacks, fmu_temp_dir)
+            if not keep_unzipped_dir:
+                FMIL.fmi_import_rmdir(&callbacks, fmu_temp_dir)
             if callbacks.log_level >= FMIL.jm_log_level_error:
                 _handle_load_fmu_exception(fmu, log_data)
                 raise FMUException("The FMU kind could not be determined. "+decode(last_error))
@@ -7937,21 +7970,22 @@ def load_fmu(fmu, path = '.', enable_logging = None, log_file_name = "", kind =
         #FMU kind is known
         if kind.lower() == 'auto':
             if fmu_2_kind == FMIL.fmi2_fmu_kind_cs:
-                model = FMUModelCS2(fmu, path, original_enable_logging, log_file_name,log_level, _unzipped_dir=fmu_temp_dir)
+                model = FMUModelCS2(fmu, path, original_enable_logging, log_file_name,log_level, _unzipped_dir=fmu_temp_dir, _keep_unzipped_dir=keep_unzipped_dir)
             elif fmu_2_kind == FMIL.fmi2_fmu_kind_me or fmu_2_kind == FMIL.fmi2_fmu_kind_me_and_cs:
-                model = FMUModelME2(fmu, path, original_enable_logging, log_file_name,log_level, _unzipped_dir=fmu_temp_dir)
+                model = FMUModelME2(fmu, path, original_enable_logging, log_file_name,log_level, _unzipped_dir=fmu_temp_dir, _keep_unzipped_dir=keep_unzipped_dir)
         elif kind.upper() == 'CS':
             if fmu_2_kind == FMIL.fmi2_fmu_kind_cs or fmu_2_kind == FMIL.fmi2_fmu_kind_me_and_cs:
-                model = FMUModelCS2(fmu, path, original_enable_logging, log_file_name,log_level, _unzipped_dir=fmu_temp_dir)
+                model = FMUModelCS2(fmu, path, original_enable_logging, log_file_name,log_level, _unzipped_dir=fmu_temp_dir, _keep_unzipped_dir=keep_unzipped_dir)
         elif kind.upper() == 'ME':
             if fmu_2_kind == FMIL.fmi2_fmu_kind_me or fmu_2_kind == FMIL.fmi2_fmu_kind_me_and_cs:
-                model = FMUModelME2(fmu, path, original_enable_logging, log_file_name,log_level, _unzipped_dir=fmu_temp_dir)
+                model = FMUModelME2(fmu, path, original_enable_logging, log_file_name,log_level, _unzipped_dir=fmu_temp_dir, _keep_unzipped_dir=keep_unzipped_dir)
 
         #Could not match FMU kind with input-specified kind
         if model is None:
             FMIL.fmi2_import_free(fmu_2)
             FMIL.fmi_import_free_context(context)
-            FMIL.fmi_import_rmdir(&callbacks, fmu_temp_dir)
+            if not keep_unzipped_dir:
+                FMIL.fmi_import_rmdir(&callbacks, fmu_temp_dir)
             _handle_load_fmu_exception(fmu, log_data)
             raise FMUException('FMU is a ' + FMIL.fmi2_fmu_kind_to_string(fmu_2_kind) + ' and not a ' + kind.upper())
 
@@ -7961,7 +7995,8 @@ def load_fmu(fmu, path = '.', enable_logging = None, log_file_name = "", kind =
         #Delete the context
         last_error = FMIL.jm_get_last_error(&callbacks)
         FMIL.fmi_import_free_context(context)
-        FMIL.fmi_import_rmdir(&callbacks, fmu_temp_dir)
+        if not keep_unzipped_dir:
+            FMIL.fmi_import_rmdir(&callbacks, fmu_temp_dir)
         if callbacks.log_level >= FMIL.jm_log_level_error:
             _handle_load_fmu_exception(fmu, log_data)
             raise FMUException("The FMU version is not found. "+decode(last_error))
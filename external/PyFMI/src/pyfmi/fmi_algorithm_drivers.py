@@ -29,7 +29,7 @@ import pyfmi.fmi as fmi
 import pyfmi.fmi_coupled as fmi_coupled
 import pyfmi.fmi_extended as fmi_extended
 from pyfmi.common.algorithm_drivers import AlgorithmBase, AssimuloSimResult, OptionBase, InvalidAlgorithmOptionException, InvalidSolverArgumentException, JMResultBase
-from pyfmi.common.io import ResultDymolaTextual, ResultHandlerFile, ResultHandlerBinaryFile, ResultHandlerMemory, ResultHandler, ResultHandlerDummy, ResultHandlerCSV, ResultCSVTextual
+from pyfmi.common.io import ResultDymolaTextual, ResultHandlerFile, ResultHandlerBinaryFile, ResultHandlerMemory, ResultHandler, ResultHandlerDummy, ResultHandlerCSV, ResultCSVTextual, ResultHandlerChunkedFile
 from pyfmi.common.core import TrajectoryLinearInterpolation
 from pyfmi.common.core import TrajectoryUserFunction
 
@@ -98,9 +98,9 @@ class AssimuloFMIAlgOptions(OptionBase):
 
         result_handling --
             Specifies how the result should be handled. Either stored to
-            file (txt or binary) or stored in memory. One can also use a 
-            custom handler.
-            Available options: "file", "binary", "memory", "csv", "custom"
+            file (txt, binary or chunked binary) or stored in memory. One 
+            can also use a custom handler.
+            Available options: "file", "binary", "chunked", "memory", "csv", "custom"
             Default: "binary"
 
         result_handler --
@@ -281,6 +281,12 @@ class AssimuloFMIAlg(AlgorithmBase):
                 self.result_handler = ResultHandlerFile(self.model)
             else:
                 self.result_handler = ResultHandlerBinaryFile(self.model)
+        elif self.options["result_handling"] == "chunked":
+            if self.options["sensitivities"]:
+                logging.warning('The chunked result file do not currently support storing of sensitivity results. Switching to textual result format.')
+                self.result_handler = ResultHandlerFile(self.model)
+            else:
+                self.result_handler = ResultHandlerChunkedFile(self.model)
         elif self.options["result_handling"] == "memory":
             self.result_handler = ResultHandlerMemory(self.model)
         elif self.options["result_handling"] == "csv":
@@ -598,9 +604,9 @@ class FMICSAlgOptions(OptionBase):
 
         result_handling --
             Specifies how the result should be handled. Either stored to
-            file (txt or binary) or stored in memory. One can also use a 
-            custom handler.
-            Available options: "file", "binary", "memory", "csv", "custom"
+            file (txt, binary or chunked binary) or stored in memory. One 
+            can also use a custom handler.
+            Available options: "file", "binary", "chunked", "memory", "csv", "custom"
             Default: "binary"
 
         result_handler --
@@ -732,6 +738,8 @@ class FMICSAlg(AlgorithmBase):
             self.result_handler = ResultHandlerFile(self.model)
         elif self.options["result_handling"] == "binary":
             self.result_handler = ResultHandlerBinaryFile(self.model)
+        elif self.options["result_handling"] == "chunked":
+            self.result_handler = ResultHandlerChunkedFile(self.model)
         elif self.options["result_handling"] == "memory":
             self.result_handler = ResultHandlerMemory(self.model)
         elif self.options["result_handling"] == "csv":
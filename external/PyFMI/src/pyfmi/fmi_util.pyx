@@ -27,6 +27,7 @@ from numpy.compat import asbytes
 cimport numpy as np
 cimport fmil_import as FMIL
 from cpython cimport array
+from libc.stdio cimport FILE, fopen, fclose, fwrite, fflush, fseek, ftell, SEEK_END
 
 import functools
 import marshal
@@ -1015,3 +1016,244 @@ cdef class FastPointSave:
 """
 
 
+
+cdef extern from "zlib.h":
+    ctypedef unsigned char Bytef
+    ctypedef unsigned long uLong
+    ctypedef unsigned long uLongf
+    int Z_OK
+    uLong compressBound(uLong sourceLen) nogil
+    int compress2(Bytef *dest, uLongf *destLen, const Bytef *source, uLong sourceLen, int level) nogil
+
+cdef class ChunkedResultWriter:
+    """
+    Writer used by the chunked result handler. The result points are
+    stored column-wise in one of two buffers, i.e. each variable 
+    trajectory in a chunk is contiguous in memory, so that the chunk can 
+    be compressed and written one variable at the time. A full buffer is 
+    compressed (zlib) and written without holding the GIL, so that it 
+    can be done in a background thread while the other buffer is filled.
+    
+    The file is opened for appending after the header, i.e. the header 
+    has to be written (and the file closed) before creating the writer.
+    The chunk index and the footer are written by finalize.
+    """
+    cdef FILE* file
+    cdef double* buffers[2]
+    cdef int npoints[2]
+    cdef unsigned long long* offsets
+    cdef unsigned long long* block_sizes
+    cdef Bytef* cdata
+    cdef size_t cdata_size
+    cdef unsigned long long position
+    cdef int noffsets, max_offsets
+    cdef int nreal, nint, nbool
+    cdef readonly int nvariables, chunk_size, current
+    cdef readonly bint compression
+    
+    def __init__(self, fname, int nreal, int nint, int nbool, int chunk_size, bint compression):
+        cdef int k
+        
+        if chunk_size < 1:
+            raise ValueError("The chunk size must be positive.")
+        
+        self.nreal = nreal
+        self.nint  = nint
+        self.nbool = nbool
+        self.nvariables = 1 + nreal + nint + nbool
+        self.chunk_size = chunk_size
+        self.compression = compression
+        self.current = 0
+        
+        for k in range(2):
+            self.npoints[k] = 0
+            self.buffers[k] = <double*>FMIL.malloc(self.nvariables*chunk_size*sizeof(double))
+            if self.buffers[k] == NULL:
+                raise MemoryError()
+        self.block_sizes = <unsigned long long*>FMIL.malloc(self.nvariables*sizeof(unsigned long long))
+        self.max_offsets = 64
+        self.offsets = <unsigned long long*>FMIL.malloc(self.max_offsets*sizeof(unsigned long long))
+        if self.block_sizes == NULL or self.offsets == NULL:
+            raise MemoryError()
+        
+        if compression:
+            self.cdata_size = compressBound(chunk_size*sizeof(double))*self.nvariables
+            self.cdata = <Bytef*>FMIL.malloc(self.cdata_size)
+            if self.cdata == NULL:
+                raise MemoryError()
+        
+        fname = encode(fname)
+        self.file = fopen(fname, "ab")
+        if self.file == NULL:
+            raise IOError("Could not open the result file %s."%decode(fname))
+        fseek(self.file, 0, SEEK_END)
+        self.position = ftell(self.file)
+    
+    def __dealloc__(self):
+        if self.file != NULL:
+            fclose(self.file)
+        FMIL.free(self.buffers[0])
+        FMIL.free(self.buffers[1])
+        FMIL.free(self.block_sizes)
+        FMIL.free(self.offsets)
+        FMIL.free(self.cdata)
+    
+    cpdef int add_point(self, double t, np.ndarray r, np.ndarray i, np.ndarray b) except -1:
+        """
+        Adds a result point to the current buffer. Returns 1 if the buffer
+        is full, i.e. if the chunk should be written.
+        """
+        cdef int k, offset
+        cdef int p = self.npoints[self.current]
+        cdef int n = self.chunk_size
+        cdef np.ndarray[double, ndim=1, mode='c'] rvals = np.ascontiguousarray(r, dtype=np.float64)
+        cdef np.ndarray[double, ndim=1, mode='c'] ivals = np.ascontiguousarray(i, dtype=np.float64)
+        cdef np.ndarray[double, ndim=1, mode='c'] bvals = np.ascontiguousarray(b, dtype=np.float64)
+        cdef double* data = self.buffers[self.current]
+        
+        if p >= n:
+            raise IndexError("The result buffer is full, the chunk has to be written before adding more points.")
+        if rvals.shape[0] != self.nreal or ivals.shape[0] != self.nint or bvals.shape[0] != self.nbool:
+            raise ValueError("Expected %d real, %d integer and %d boolean values, got %d, %d and %d."%(
+                              self.nreal, self.nint, self.nbool, rvals.shape[0], ivals.shape[0], bvals.shape[0]))
+        
+        data[p] = t
+        offset = 1
+        for k in range(self.nreal):
+            data[(offset+k)*n+p] = rvals[k]
+        offset = offset + self.nreal
+        for k in range(self.nint):
+            data[(offset+k)*n+p] = ivals[k]
+        offset = offset + self.nint
+        for k in range(self.nbool):
+            data[(offset+k)*n+p] = bvals[k]
+        
+        self.npoints[self.current] = p + 1
+        
+        return 1 if p + 1 == n else 0
+    
+    def swap(self, int free_buffer):
+        """
+        Continues adding points to the given (written) buffer and returns
+        the index of the buffer that was filled.
+        """
+        cdef int full = self.current
+        
+        if free_buffer < 0 or free_buffer > 1 or (free_buffer != full and self.npoints[free_buffer] != 0):
+            raise ValueError("The buffer %d is not free."%free_buffer)
+        self.current = free_buffer
+        
+        return full
+    
+    def write(self, int buffer):
+        """
+        Compresses (optional) and writes the points in the given buffer 
+        as a chunk and resets the buffer. The GIL is released while 
+        writing.
+        """
+        cdef int res
+        cdef unsigned long long* offsets
+        
+        if buffer < 0 or buffer > 1:
+            raise ValueError("The buffer %d does not exist."%buffer)
+        if self.file == NULL:
+            raise IOError("The result file is closed.")
+        if self.npoints[buffer] == 0:
+            return
+        if self.noffsets == self.max_offsets:
+            offsets = <unsigned long long*>FMIL.realloc(self.offsets, 2*self.max_offsets*sizeof(unsigned long long))
+            if offsets == NULL:
+                raise MemoryError()
+            self.offsets = offsets
+            self.max_offsets = 2*self.max_offsets
+        
+        with nogil:
+            res = self._write_chunk(buffer)
+        
+        if res < 0:
+            raise IOError("Failed to compress the result chunk.")
+        elif res > 0:
+            raise IOError("Failed to write the result chunk to file.")
+    
+    cdef int _write_chunk(self, int buffer) nogil:
+        """
+        Writes a chunk: the number of points, the block sizes of all 
+        variables followed by the blocks. Returns 0 on success, -1 if the
+        compression failed and 1 if the writing failed.
+        """
+        cdef unsigned long long npts = self.npoints[buffer]
+        cdef size_t nbytes = npts*sizeof(double)
+        cdef size_t used = 0, total = 0
+        cdef uLongf block_size
+        cdef int k
+        cdef double* data = self.buffers[buffer]
+        
+        if self.compression:
+            for k in range(self.nvariables):
+                block_size = self.cdata_size - used
+                if compress2(self.cdata+used, &block_size, <Bytef*>(data+k*self.chunk_size), nbytes, 1) != Z_OK:
+                    return -1
+                self.block_sizes[k] = block_size
+                used = used + block_size
+        else:
+            for k in range(self.nvariables):
+                self.block_sizes[k] = nbytes
+        
+        if fwrite(&npts, sizeof(unsigned long long), 1, self.file) != 1:
+            return 1
+        if fwrite(self.block_sizes, sizeof(unsigned long long), self.nvariables, self.file) != <size_t>self.nvariables:
+            return 1
+        if self.compression:
+            if fwrite(self.cdata, 1, used, self.file) != used:
+                return 1
+            total = used
+        else:
+            for k in range(self.nvariables):
+                if fwrite(data+k*self.chunk_size, 1, nbytes, self.file) != nbytes:
+                    return 1
+            total = self.nvariables*nbytes
+        #Flush so that the complete chunks are readable if the simulation is aborted
+        if fflush(self.file) != 0:
+            return 1
+        
+        self.offsets[self.noffsets] = self.position
+        self.noffsets = self.noffsets + 1
+        self.position = self.position + (1 + self.nvariables)*sizeof(unsigned long long) + total
+        self.npoints[buffer] = 0
+        
+        return 0
+    
+    def finalize(self):
+        """
+        Writes the remaining points, the chunk index and the footer and 
+        closes the file.
+        """
+        cdef unsigned long long nchunks, index_offset
+        cdef const char* end_magic = b"PYFMIEND"
+        cdef int ok
+        
+        if self.file == NULL:
+            return
+        
+        self.write(self.current)
+        
+        nchunks = self.noffsets
+        index_offset = self.position
+        ok = fwrite(&nchunks, sizeof(unsigned long long), 1, self.file) == 1
+        ok = ok and fwrite(self.offsets, sizeof(unsigned long long), self.noffsets, self.file) == <size_t>self.noffsets
+        ok = ok and fwrite(&index_offset, sizeof(unsigned long long), 1, self.file) == 1
+        ok = ok and fwrite(end_magic, 1, 8, self.file) == 8
+        ok = (fclose(self.file) == 0) and ok
+        self.file = NULL
+        
+        if not ok:
+            raise IOError("Failed to write the chunk index to the result file.")
+    
+    def close(self):
+        """
+        Closes the file without writing the chunk index, only the complete
+        chunks written so far are readable.
+        """
+        if self.file != NULL:
+            fclose(self.file)
+            self.file = NULL
@@ -465,7 +465,7 @@ cdef extern from 'fmilib.h':
     int fmi2_import_get_derivatives(fmi2_import_t *, fmi2_real_t *, size_t)
     int fmi2_import_reset(fmi2_import_t* fmu)
     int fmi2_import_serialize_fmu_state(fmi2_import_t *, fmi2_FMU_state_t, fmi2_byte_t *, size_t)
-    int fmi2_import_set_real(fmi2_import_t *, fmi2_value_reference_t *, size_t, fmi2_real_t *)
+    int fmi2_import_set_real(fmi2_import_t *, fmi2_value_reference_t *, size_t, fmi2_real_t *) nogil
     int fmi2_import_get_boolean(fmi2_import_t *, fmi2_value_reference_t *, size_t, fmi2_boolean_t *)
     int fmi2_import_get_state_value_references(fmi2_import_t *, fmi2_value_reference_t *, size_t)
     int fmi2_import_set_debug_logging(fmi2_import_t *, fmi2_boolean_t, size_t, fmi2_string_t*)
@@ -481,7 +481,7 @@ cdef extern from 'fmilib.h':
     int fmi2_import_get_real_status(fmi2_import_t *, int, fmi2_real_t *)
     int fmi2_import_serialized_fmu_state_size(fmi2_import_t *, fmi2_FMU_state_t, size_t *)
     int fmi2_import_get_nominals_of_continuous_states(fmi2_import_t* fmu, fmi2_real_t *, size_t nx)
-    int fmi2_import_get_real(fmi2_import_t *, fmi2_value_reference_t *, size_t, fmi2_real_t *)
+    int fmi2_import_get_real(fmi2_import_t *, fmi2_value_reference_t *, size_t, fmi2_real_t *) nogil
     int fmi2_import_get_continuous_states(fmi2_import_t *, fmi2_real_t *, size_t)
     int fmi2_import_free_fmu_state(fmi2_import_t *, fmi2_FMU_state_t *)
     #void fmi2_import_get_dependencies_outputs_on_inputs(fmi2_import_t *, size_t **, size_t **, char **)
@@ -576,6 +576,7 @@ cdef extern from 'fmilib.h':
     char * fmi1_get_platform()
     char * fmi1_status_to_string(int)
     fmi_version_enu_t fmi_import_get_fmi_version(fmi_import_context_t*, char*, char*)
+    fmi_version_enu_t fmi_import_get_fmi_version_cached(fmi_import_context_t*, char*, char*, char**)
     int fmi_import_rmdir(jm_callbacks*, char *)
 
 
@@ -835,7 +836,7 @@ cdef extern from 'fmilib.h':
 
     fmi2_value_reference_t * fmi2_import_get_value_referece_list(fmi2_import_variable_list_t *)
 
-    int fmi2_import_set_real_input_derivatives(fmi2_import_t *, fmi2_value_reference_t *, size_t, fmi2_integer_t *, fmi2_real_t *)
+    int fmi2_import_set_real_input_derivatives(fmi2_import_t *, fmi2_value_reference_t *, size_t, fmi2_integer_t *, fmi2_real_t *) nogil
 
     int fmi2_import_clear_last_error(fmi2_import_t *)
 
@@ -914,7 +915,7 @@ cdef extern from 'fmilib.h':
     double fmi2_import_convert_from_SI_base_unit(double, fmi2_import_unit_t *)
     int fmi2_import_set_fmu_state(fmi2_import_t *, fmi2_FMU_state_t)
     int * fmi2_import_get_SI_unit_exponents(fmi2_import_unit_t *)
-    int fmi2_import_get_real_output_derivatives(fmi2_import_t *, fmi2_value_reference_t *, size_t, fmi2_integer_t *, fmi2_real_t *)
+    int fmi2_import_get_real_output_derivatives(fmi2_import_t *, fmi2_value_reference_t *, size_t, fmi2_integer_t *, fmi2_real_t *) nogil
     char * fmi2_import_get_enum_type_value_name(fmi2_import_enumeration_typedef_t *, int)
     fmi2_value_reference_t fmi2_import_get_variable_vr(fmi2_import_variable_t *)
     fmi2_import_display_unit_t * fmi2_import_get_unit_display_unit(fmi2_import_unit_t *, size_t)
@@ -105,6 +105,86 @@ cdef perform_do_step_parallel(list models, FMIL.fmi2_import_t** model_addresses,
     for model in models:
         model.time = cur_time + step_size
 
+cdef int exchange_connection_data_nogil(FMIL.fmi2_import_t** fmus, int nmodels,
+                                        int* output_offsets, FMIL.fmi2_value_reference_t* output_vrefs,
+                                        int* input_offsets, FMIL.fmi2_value_reference_t* input_vrefs,
+                                        int* input_source, FMIL.fmi2_integer_t* input_orders,
+                                        FMIL.fmi2_real_t* y, FMIL.fmi2_real_t* yd, FMIL.fmi2_real_t* y_last,
+                                        FMIL.fmi2_real_t* u, FMIL.fmi2_real_t* ud,
+                                        FMIL.fmi2_real_t* u_last, FMIL.fmi2_real_t* ud_last,
+                                        int extrapolation_order, int output_derivatives, int smooth_coupling,
+                                        int has_last_y, int has_last_ud, double h, int setting, int* has_ud_out) nogil:
+    """
+    Gathers all the connected outputs, applies the coupling u = Ly
+    (including the extrapolation corrections) and scatters the inputs.
+    The connection matrix L is given as input_source, i.e. input i is
+    connected to output input_source[i]. On return has_ud_out is set if
+    input derivatives were computed (and set) in this exchange.
+    """
+    cdef int i, j, n, status = 0
+    cdef int n_inputs = input_offsets[nmodels]
+    cdef int n_outputs = output_offsets[nmodels]
+    cdef int has_ud = 0
+    cdef double uhat
+
+    #Gather the outputs (and output derivatives)
+    if setting == PARALLEL:
+        for i in prange(nmodels, schedule="dynamic", chunksize=1):
+            status |= FMIL.fmi2_import_get_real(fmus[i], &output_vrefs[output_offsets[i]], output_offsets[i+1]-output_offsets[i], &y[output_offsets[i]])
+    else:
+        for i in range(nmodels):
+            status |= FMIL.fmi2_import_get_real(fmus[i], &output_vrefs[output_offsets[i]], output_offsets[i+1]-output_offsets[i], &y[output_offsets[i]])
+    if status != 0: return status
+
+    if extrapolation_order > 0:
+        if output_derivatives:
+            for i in range(nmodels):
+                n = output_offsets[i+1]-output_offsets[i]
+                status |= FMIL.fmi2_import_get_real_output_derivatives(fmus[i], &output_vrefs[output_offsets[i]], n, input_orders, &yd[output_offsets[i]])
+            if status != 0: return status
+            has_ud = 1
+        elif has_last_y:
+            for j in range(n_outputs):
+                yd[j] = (y[j] - y_last[j])/h
+            has_ud = 1
+
+    #Apply the coupling
+    for i in range(n_inputs):
+        j = input_source[i]
+        u[i] = y[j]
+        if has_ud:
+            ud[i] = yd[j]
+
+    if extrapolation_order > 0 and smooth_coupling:
+        for i in range(n_inputs):
+            uhat = u_last[i] + (h*ud_last[i] if has_last_ud else 0.0)
+            if has_ud:
+                ud[i] = (u[i] - uhat)/h + ud[i]
+            u[i] = uhat
+
+    #Scatter the inputs
+    if setting == PARALLEL:
+        for i in prange(nmodels, schedule="dynamic", chunksize=1):
+            status |= FMIL.fmi2_import_set_real(fmus[i], &input_vrefs[input_offsets[i]], input_offsets[i+1]-input_offsets[i], &u[input_offsets[i]])
+            if has_ud:
+                status |= FMIL.fmi2_import_set_real_input_derivatives(fmus[i], &input_vrefs[input_offsets[i]], input_offsets[i+1]-input_offsets[i], input_orders, &ud[input_offsets[i]])
+    else:
+        for i in range(nmodels):
+            status |= FMIL.fmi2_import_set_real(fmus[i], &input_vrefs[input_offsets[i]], input_offsets[i+1]-input_offsets[i], &u[input_offsets[i]])
+            if has_ud:
+                status |= FMIL.fmi2_import_set_real_input_derivatives(fmus[i], &input_vrefs[input_offsets[i]], input_offsets[i+1]-input_offsets[i], input_orders, &ud[input_offsets[i]])
+    if status != 0: return status
+
+    #Store the history used by the extrapolation
+    for j in range(n_outputs):
+        y_last[j] = y[j]
+    for i in range(n_inputs):
+        u_last[i] = u[i]
+        ud_last[i] = ud[i] if has_ud else 0.0
+    has_ud_out[0] = has_ud
+
+    return 0
+
 cdef enter_initialization_mode(list models, double start_time, double final_time, object opts, dict time_spent):
     cdef int status
     for model in models:
@@ -270,6 +350,15 @@ class MasterAlgOptions(OptionBase):
             Defines the number of threads used when the execution is set
             to parallel.
             Default: Number of cores / OpenMP environment variable
+        
+        fast_connection_exchange --
+            Defines if the connection data should be exchanged using the
+            compiled connection matrix, i.e. all outputs are gathered, 
+            coupled and scattered to the inputs in a single call without
+            the GIL. Only used in fixed-step simulations without algebraic
+            loops and with extrapolation order of at most one, otherwise
+            the general exchange is used.
+            Default: True
             
         error_controlled --
             Defines if the algorithm should adapt the step-size during
@@ -348,6 +437,7 @@ class MasterAlgOptions(OptionBase):
         "experimental_finite_difference_D": False,
         "experimental_output_solve":False,
         "force_finite_difference_outputs": False,
+        "fast_connection_exchange": True,
         "num_threads":None}
         super(MasterAlgOptions,self).__init__(_defaults)
         self._update_keep_dict_defaults(*args, **kw)
@@ -377,6 +467,15 @@ cdef class Master:
     cdef public int _display_counter
     cdef public object _display_progress
     cdef public double _time_integration_start
+    cdef int* _conn_output_offsets
+    cdef int* _conn_input_offsets
+    cdef int* _conn_input_source
+    cdef FMIL.fmi2_value_reference_t* _conn_output_vrefs
+    cdef FMIL.fmi2_value_reference_t* _conn_input_vrefs
+    cdef FMIL.fmi2_integer_t* _conn_orders
+    cdef public int _fast_exchange, _fast_exchange_output_derivatives
+    cdef public int _fast_exchange_has_last_y, _fast_exchange_has_last_ud
+    cdef public np.ndarray _conn_y, _conn_yd, _conn_y_last, _conn_u, _conn_ud, _conn_u_last, _conn_ud_last
     
     def __init__(self, models, connections):
         """
@@ -435,6 +534,7 @@ cdef class Master:
         
         self.error_controlled = 0
         self.linear_correction = 1
+        self._fast_exchange = 0
         
         self.check_support_storing_fmu_state()
         
@@ -452,6 +552,7 @@ cdef class Master:
     
     def __del__(self):
         FMIL.free(self.fmu_adresses)
+        self.free_connection_exchange()
     
     cdef set_last_y(self, np.ndarray y):
         self.y_m1 = y.copy()
@@ -496,6 +597,131 @@ cdef class Master:
         for model in self.models_dict.keys():
             self.fmu_adresses[self.models_dict[model]["order"]] = (<FMUModelCS2>model)._fmu
             
+    def free_connection_exchange(self):
+        FMIL.free(self._conn_output_offsets); self._conn_output_offsets = NULL
+        FMIL.free(self._conn_input_offsets);  self._conn_input_offsets  = NULL
+        FMIL.free(self._conn_input_source);   self._conn_input_source   = NULL
+        FMIL.free(self._conn_output_vrefs);   self._conn_output_vrefs   = NULL
+        FMIL.free(self._conn_input_vrefs);    self._conn_input_vrefs    = NULL
+        FMIL.free(self._conn_orders);         self._conn_orders         = NULL
+    
+    def check_support_connection_exchange(self, opts):
+        """
+        Checks if the compiled connection exchange can be used, i.e. if
+        the exchange is a pure u = Ly (with extrapolation of at most
+        order one) that does not need the linear correction or any of
+        the experimental output computations.
+        """
+        if not opts["fast_connection_exchange"]:
+            return 0
+        if self.error_controlled or self.algebraic_loops:
+            return 0
+        if opts["extrapolation_order"] > 1 or opts["experimental_output_derivative"]:
+            return 0
+        for model in self.models:
+            #Subclasses may override get_real / set_real, require the plain FMU
+            if type(model) is not fmi.FMUModelCS2:
+                return 0
+        return 1
+    
+    def setup_connection_exchange(self, opts):
+        """
+        Compiles the connection matrix into flat value reference and
+        offset arrays used by the compiled (nogil) connection exchange.
+        """
+        cdef int i, j, n_models = len(self.models)
+        cdef int n_orders = max(self._len_inputs, self._len_outputs, 1)
+        cdef np.ndarray indices = self.L.indices
+        cdef np.ndarray indptr  = self.L.indptr
+        
+        self.free_connection_exchange()
+        
+        self._conn_output_offsets = <int*>FMIL.malloc((n_models+1)*sizeof(int))
+        self._conn_input_offsets  = <int*>FMIL.malloc((n_models+1)*sizeof(int))
+        self._conn_input_source   = <int*>FMIL.malloc(max(self._len_inputs,1)*sizeof(int))
+        self._conn_output_vrefs   = <FMIL.fmi2_value_reference_t*>FMIL.malloc(max(self._len_outputs,1)*sizeof(FMIL.fmi2_value_reference_t))
+        self._conn_input_vrefs    = <FMIL.fmi2_value_reference_t*>FMIL.malloc(max(self._len_inputs,1)*sizeof(FMIL.fmi2_value_reference_t))
+        self._conn_orders         = <FMIL.fmi2_integer_t*>FMIL.malloc(n_orders*sizeof(FMIL.fmi2_integer_t))
+        
+        for model in self.models:
+            i = self.models_dict[model]["order"]
+            self._conn_output_offsets[i] = self.models_dict[model]["global_index_outputs"]
+            self._conn_input_offsets[i]  = self.models_dict[model]["global_index_inputs"]
+            for j, vref in enumerate(self.models_dict[model]["local_output_vref"]):
+                self._conn_output_vrefs[self._conn_output_offsets[i]+j] = vref
+            for j, vref in enumerate(self.models_dict[model]["local_input_vref"]):
+                self._conn_input_vrefs[self._conn_input_offsets[i]+j] = vref
+        self._conn_output_offsets[n_models] = self._len_outputs
+        self._conn_input_offsets[n_models]  = self._len_inputs
+        
+        #Each input is connected to exactly one output
+        for i in range(self._len_inputs):
+            self._conn_input_source[i] = indices[indptr[i]]
+        for i in range(n_orders):
+            self._conn_orders[i] = 1
+        
+        self._conn_y       = np.zeros(self._len_outputs)
+        self._conn_yd      = np.zeros(self._len_outputs)
+        self._conn_y_last  = np.zeros(self._len_outputs)
+        self._conn_u       = np.zeros(self._len_inputs)
+        self._conn_ud      = np.zeros(self._len_inputs)
+        self._conn_u_last  = np.zeros(self._len_inputs)
+        self._conn_ud_last = np.zeros(self._len_inputs)
+        
+        y_last = self.get_last_y()
+        self._fast_exchange_has_last_y = 0 if y_last is None else 1
+        if y_last is not None:
+            self._conn_y_last[:] = y_last.ravel()
+        u_last, ud_last, udd_last = self.get_last_us()
+        self._conn_u_last[:] = u_last.ravel()
+        self._fast_exchange_has_last_ud = 0 if ud_last is None else 1
+        if ud_last is not None:
+            self._conn_ud_last[:] = ud_last.ravel()
+        
+        self._fast_exchange_output_derivatives = 1 if (self.max_output_derivative_order > 0 and not opts["force_finite_difference_outputs"]) else 0
+    
+    cdef exchange_connection_data_compiled(self, int setting):
+        cdef int status, has_ud = 0
+        cdef int n_models = len(self.models)
+        cdef int extrapolation_order = self.opts["extrapolation_order"]
+        cdef int smooth_coupling = self.opts["smooth_coupling"]
+        cdef double h = self.get_current_step_size()
+        cdef FMIL.fmi2_real_t* y       = <FMIL.fmi2_real_t*>self._conn_y.data
+        cdef FMIL.fmi2_real_t* yd      = <FMIL.fmi2_real_t*>self._conn_yd.data
+        cdef FMIL.fmi2_real_t* y_last  = <FMIL.fmi2_real_t*>self._conn_y_last.data
+        cdef FMIL.fmi2_real_t* u       = <FMIL.fmi2_real_t*>self._conn_u.data
+        cdef FMIL.fmi2_real_t* ud      = <FMIL.fmi2_real_t*>self._conn_ud.data
+        cdef FMIL.fmi2_real_t* u_last  = <FMIL.fmi2_real_t*>self._conn_u_last.data
+        cdef FMIL.fmi2_real_t* ud_last = <FMIL.fmi2_real_t*>self._conn_ud_last.data
+        
+        #Release the GIL as in perform_do_step_parallel, the FMU logger
+        #callback acquires it from the worker threads
+        with nogil:
+            status = exchange_connection_data_nogil(self.fmu_adresses, n_models,
+                        self._conn_output_offsets, self._conn_output_vrefs,
+                        self._conn_input_offsets, self._conn_input_vrefs,
+                        self._conn_input_source, self._conn_orders,
+                        y, yd, y_last, u, ud, u_last, ud_last,
+                        extrapolation_order, self._fast_exchange_output_derivatives, smooth_coupling,
+                        self._fast_exchange_has_last_y, self._fast_exchange_has_last_ud, h, setting, &has_ud)
+        
+        if status != 0: 
+            raise fmi.FMUException("Failed to exchange the connection data. Return flag %d."%status)
+        
+        self._fast_exchange_has_last_y  = 1
+        self._fast_exchange_has_last_ud = has_ud
+    
+    def finalize_connection_exchange(self):
+        """
+        Stores the state of the compiled connection exchange in the
+        corresponding Python attributes.
+        """
+        self.y_prev = self._conn_y_last.reshape(-1,1).copy()
+        self.yd_prev = self._conn_yd.reshape(-1,1).copy() if self._fast_exchange_has_last_ud else None
+        self.set_last_y(self.y_prev)
+        self.set_last_yd(self.yd_prev)
+        self.set_last_us(self._conn_u_last.reshape(-1,1), self._conn_ud_last.reshape(-1,1) if self._fast_exchange_has_last_ud else None)
+    
     def define_connection_matrix(self):
         cdef list data = []
         cdef list row = []
@@ -1188,9 +1414,12 @@ cdef class Master:
                     
                 #Set external input
                 self.set_input(tcur + step_size)
-                ycur, ydcur, ucur = self.exchange_connection_data()
-                self.set_last_y(ycur)
-                self.set_last_yd(ydcur)
+                if self._fast_exchange:
+                    self.exchange_connection_data_compiled(calling_setting)
+                else:
+                    ycur, ydcur, ucur = self.exchange_connection_data()
+                    self.set_last_y(ycur)
+                    self.set_last_yd(ydcur)
                 
                 time_start = timer()
                 #store_communication_point(self.models_dict)
@@ -1224,6 +1453,9 @@ cdef class Master:
                         G   = np.vstack((R1,R2))
                         G1  = K2.dot(K1)
                         print("           , rho(G)=%s"%(str(numpy.linalg.eig(G1)[0])))
+            
+            if self._fast_exchange:
+                self.finalize_connection_exchange()
                     
     
     def specify_external_input(self, input):
@@ -1356,6 +1588,11 @@ cdef class Master:
         #Copy FMU address (used when evaluating in parallel)
         self.copy_fmu_addresses()
         
+        #Compile the connections (used by the compiled connection exchange)
+        self._fast_exchange = self.check_support_connection_exchange(options)
+        if self._fast_exchange:
+            self.setup_connection_exchange(options)
+        
         self.initialize_result_objects(options)
         store_communication_point(self.models_dict)
         #self.report_solution(tcur)
@@ -17,6 +17,8 @@
 
 import nose
 import os
+import shutil
+import tempfile
 import numpy as np
 
 from pyfmi import testattr
@@ -465,6 +467,22 @@ class Test_FMUModelME2:
     @testattr(stddist = True)
     def test_malformed_xml(self):
         nose.tools.assert_raises(FMUException, load_fmu, os.path.join(file_path, "files", "FMUs", "XML", "ME2.0", "MalFormed.fmu"))
+
+    @testattr(stddist = True)
+    def test_malformed_xml_unzip_cache(self):
+        unzip_cache = tempfile.mkdtemp()
+        try:
+            for i in range(2):
+                nose.tools.assert_raises(FMUException, load_fmu, os.path.join(file_path, "files", "FMUs", "XML", "ME2.0", "MalFormed.fmu"), unzip_cache=unzip_cache)
+            #The shared extraction is kept when loading fails and reused by the second load
+            nose.tools.assert_equal(len(os.listdir(unzip_cache)), 1)
+        finally:
+            shutil.rmtree(unzip_cache)
+
+    @testattr(stddist = True)
+    def test_missing_unzip_cache(self):
+        unzip_cache = os.path.join(tempfile.gettempdir(), "pyfmi_missing_unzip_cache")
+        nose.tools.assert_raises(FMUException, load_fmu, os.path.join(file_path, "files", "FMUs", "XML", "ME2.0", "MalFormed.fmu"), unzip_cache=unzip_cache)
         
     @testattr(stddist = True)
     def test_log_file_name(self):
@@ -100,6 +100,49 @@ class Test_Master:
         sim = Master(models, connections)
         assert not sim.algebraic_loops
     
+    @testattr(stddist = True)
+    def test_support_connection_exchange(self):
+        model_sub1 = FMUModelCS2("LinearStability_LinearSubSystemNoFeed1.fmu", cs2_xml_path, _connect_dll=False)
+        model_sub2 = FMUModelCS2("LinearStability_LinearSubSystemNoFeed2.fmu", cs2_xml_path, _connect_dll=False)
+
+        models = [model_sub1, model_sub2]
+        connections = [(model_sub1,"y1",model_sub2,"u2"),
+                   (model_sub2,"y2",model_sub1,"u1")]
+
+        master = Master(models, connections)
+        opts = master.simulate_options()
+
+        assert master.check_support_connection_exchange(opts)
+
+        opts["extrapolation_order"] = 2
+        assert not master.check_support_connection_exchange(opts)
+
+        opts["extrapolation_order"] = 0
+        opts["fast_connection_exchange"] = False
+        assert not master.check_support_connection_exchange(opts)
+
+        #Algebraic loop, requires the general exchange
+        model_sub1 = FMUModelCS2("LinearStability.SubSystem1.fmu", cs2_xml_path, _connect_dll=False)
+        model_sub2 = FMUModelCS2("LinearStability.SubSystem2.fmu", cs2_xml_path, _connect_dll=False)
+
+        models = [model_sub1, model_sub2]
+        connections = [(model_sub1,"y1",model_sub2,"u2"),
+                   (model_sub2,"y2",model_sub1,"u1")]
+
+        master = Master(models, connections)
+        assert not master.check_support_connection_exchange(master.simulate_options())
+
+        #Overridden get_real / set_real, requires the general exchange
+        model_sub1 = Dummy_FMUModelCS2([], "LinearCoSimulation_LinearSubSystem1.fmu", cs2_xml_path, _connect_dll=False)
+        model_sub2 = Dummy_FMUModelCS2([], "LinearCoSimulation_LinearSubSystem2.fmu", cs2_xml_path, _connect_dll=False)
+
+        models = [model_sub1, model_sub2]
+        connections = [(model_sub1,"y1",model_sub2,"u2"),
+                   (model_sub2,"y2",model_sub1,"u1")]
+
+        master = Master(models, connections)
+        assert not master.check_support_connection_exchange(master.simulate_options())
+
     @testattr(stddist = True)
     def test_basic_simulation(self):
         model_sub1 = Dummy_FMUModelCS2([], "LinearCoSimulation_LinearSubSystem1.fmu", cs2_xml_path, _connect_dll=False)
@@ -17,12 +17,14 @@
 
 import nose
 import os
+import struct
 import numpy as np
+import scipy.io
 
 
 from pyfmi import testattr
 from pyfmi.fmi import FMUModel, FMUException, FMUModelME1, FMUModelCS1, load_fmu, FMUModelCS2, FMUModelME2
-from pyfmi.common.io import ResultDymolaTextual, ResultDymolaBinary, ResultWriterDymola, JIOError, ResultHandlerCSV, ResultCSVTextual, ResultHandlerBinaryFile, ResultHandlerFile
+from pyfmi.common.io import ResultDymolaTextual, ResultDymolaBinary, ResultWriterDymola, JIOError, ResultHandlerCSV, ResultCSVTextual, ResultHandlerBinaryFile, ResultHandlerFile, ResultHandlerChunkedFile, ResultDymolaChunked
 import pyfmi.fmi_util as fmi_util
 import pyfmi.fmi as fmi
 from pyfmi.tests.test_util import Dummy_FMUModelCS1, Dummy_FMUModelME1, Dummy_FMUModelME2, Dummy_FMUModelCS2
@@ -433,6 +435,31 @@ class TestResultFileBinary:
         for var in res.name:
             res.get_variable_data(var)
     
+    @testattr(stddist = True)
+    def test_read_all_variables_limited_cache(self):
+        res_full = ResultDymolaBinary(os.path.join(file_path, "files", "Results", "DoublePendulum.mat"))
+        res = ResultDymolaBinary(os.path.join(file_path, "files", "Results", "DoublePendulum.mat"), max_cached_columns=2)
+        
+        for var in res.name:
+            np.testing.assert_array_equal(res.get_variable_data(var).x, res_full.get_variable_data(var).x)
+        
+        assert len(res._columns) <= 2
+        nose.tools.assert_equal(res.get_data_matrix().shape, res_full.get_data_matrix().shape)
+        
+        res.close()
+    
+    @testattr(stddist = True)
+    def test_deprecated_raw_attributes(self):
+        file_name = os.path.join(file_path, "files", "Results", "DoublePendulum.mat")
+        res = ResultDymolaBinary(file_name)
+        raw = scipy.io.loadmat(file_name, chars_as_strings=False, variable_names=["name", "dataInfo", "data_1", "data_2"])
+        
+        for matrix in ["name", "dataInfo", "data_1", "data_2"]:
+            np.testing.assert_array_equal(res.raw[matrix], raw[matrix])
+        np.testing.assert_array_equal(res.raw_name, raw["name"])
+        
+        res.close()
+    
     
     
     @testattr(stddist = True)
@@ -485,6 +512,190 @@ class TestResultFileBinary:
         simple_alias = Dummy_FMUModelCS2([("x", "y")], "NegatedAlias.fmu", os.path.join(file_path, "files", "FMUs", "XML", "CS2.0"), _connect_dll=False)
         _run_negated_alias(simple_alias, "binary")
 
+if assimulo_installed:
+    class TestResultFileChunked_Simulation:
+        @testattr(stddist = True)
+        def test_correct_file_after_simulation_failure(self):
+            simple_alias = Dummy_FMUModelME2([("x", "y")], "NegatedAlias.fmu", os.path.join(file_path, "files", "FMUs", "XML", "ME2.0"), _connect_dll=False)
+
+            def f(*args, **kwargs):
+                if simple_alias.time > 0.5:
+                    raise Exception
+                return -simple_alias.continuous_states
+
+            simple_alias.get_derivatives = f
+
+            opts = simple_alias.simulate_options()
+            opts["result_handling"] = "custom"
+            opts["result_handler"] = ResultHandlerChunkedFile(simple_alias, chunk_size=4, background=False)
+            opts["solver"] = "ExplicitEuler"
+
+            successful_simulation = False
+            try:
+                res = simple_alias.simulate(options=opts)
+                successful_simulation = True #The above simulation should fail...
+            except:
+                pass
+
+            if successful_simulation:
+                raise Exception
+
+            #The driver finalizes the file also when the simulation fails (the
+            #recovery of unfinalized files is tested in TestResultFileChunked)
+            result = ResultDymolaChunked("NegatedAlias_result.cres")
+
+            x = result.get_variable_data("x").x
+            y = result.get_variable_data("y").x
+
+            assert len(x) > 2
+
+            for i in range(len(x)):
+                nose.tools.assert_equal(x[i], -y[i])
+            result.close()
+
+        @testattr(stddist = True)
+        def test_chunked_options_me2(self):
+            simple_alias = Dummy_FMUModelME2([("x", "y")], "NegatedAlias.fmu", os.path.join(file_path, "files", "FMUs", "XML", "ME2.0"), _connect_dll=False)
+            _run_negated_alias(simple_alias, "chunked")
+
+        @testattr(stddist = True)
+        def test_chunked_compare_binary(self):
+            model = Dummy_FMUModelME2([], "bouncingBall.fmu", os.path.join(file_path, "files", "FMUs", "XML", "ME2.0"), _connect_dll=False)
+
+            opts = model.simulate_options()
+            opts["ncp"] = 500
+            opts["result_handling"] = "binary"
+            res_binary = model.simulate(options=opts)
+
+            model.reset()
+            opts["result_handling"] = "custom"
+            opts["result_handler"] = ResultHandlerChunkedFile(model, chunk_size=64)
+            res_chunked = model.simulate(options=opts)
+
+            for var in ["time", "h", "der(h)", "g"]:
+                np.testing.assert_array_equal(res_binary[var], res_chunked[var])
+
+class TestResultFileChunked:
+    @testattr(stddist = True)
+    def test_get_description(self):
+        model = Dummy_FMUModelME1([], "CoupledClutches.fmu", os.path.join(file_path, "files", "FMUs", "XML", "ME1.0"), _connect_dll=False)
+        model.initialize()
+
+        result_writer = ResultHandlerChunkedFile(model)
+        result_writer.set_options(model.simulate_options())
+        result_writer.simulation_start()
+        result_writer.initialize_complete()
+        result_writer.integration_point()
+        result_writer.simulation_end()
+
+        res = ResultDymolaChunked('CoupledClutches_result.cres')
+
+        assert res.description[res.get_variable_index("J1.phi")] == "Absolute rotation angle of component"
+
+    @testattr(stddist = True)
+    def test_work_flow_me2(self):
+        model = Dummy_FMUModelME2([], "bouncingBall.fmu", os.path.join(file_path, "files", "FMUs", "XML", "ME2.0"), _connect_dll=False)
+        model.setup_experiment()
+        model.initialize()
+
+        for compression in [True, False]:
+            bouncingBall = ResultHandlerChunkedFile(model, chunk_size=2, compression=compression)
+
+            bouncingBall.set_options(model.simulate_options())
+            bouncingBall.simulation_start()
+            bouncingBall.initialize_complete()
+            for i in range(5):
+                bouncingBall.integration_point()
+            bouncingBall.simulation_end()
+
+            res = ResultDymolaChunked('bouncingBall_result.cres')
+
+            h = res.get_variable_data('h')
+            derh = res.get_variable_data('der(h)')
+
+            nose.tools.assert_equal(len(h.x), 5)
+            nose.tools.assert_almost_equal(h.x[-1], 1.000000, 5)
+            nose.tools.assert_almost_equal(derh.x[-1], 0.000000, 5)
+            nose.tools.assert_equal(res.get_data_matrix().shape[1], 5)
+            res.close()
+
+    def _write_bouncing_ball(self, npoints, finalize=True):
+        model = Dummy_FMUModelME2([], "bouncingBall.fmu", os.path.join(file_path, "files", "FMUs", "XML", "ME2.0"), _connect_dll=False)
+        model.setup_experiment()
+        model.initialize()
+
+        result_handler = ResultHandlerChunkedFile(model, chunk_size=2, background=False)
+        result_handler.set_options(model.simulate_options())
+        result_handler.simulation_start()
+        result_handler.initialize_complete()
+        for i in range(npoints):
+            result_handler.integration_point()
+        if finalize:
+            result_handler.simulation_end()
+
+        return result_handler
+
+    @testattr(stddist = True)
+    def test_unfinalized_file(self):
+        result_handler = self._write_bouncing_ball(5, finalize=False)
+
+        #No index or footer, only the complete chunks (2x2 points) are readable
+        res = ResultDymolaChunked('bouncingBall_result.cres')
+        nose.tools.assert_equal(len(res.get_variable_data('h').x), 4)
+        nose.tools.assert_equal(res.get_data_matrix().shape[1], 4)
+        res.close()
+
+        result_handler.simulation_end()
+
+        res = ResultDymolaChunked('bouncingBall_result.cres')
+        nose.tools.assert_equal(len(res.get_variable_data('h').x), 5)
+        res.close()
+
+    @testattr(stddist = True)
+    def test_truncated_file(self):
+        self._write_bouncing_ball(5)
+
+        with open('bouncingBall_result.cres', 'rb') as f:
+            data = f.read()
+        res = ResultDymolaChunked('bouncingBall_result.cres')
+        h = res.get_variable_data('h').x
+        res.close()
+        index_offset = struct.unpack("<Q", data[-16:-8])[0]
+
+        #Missing footer, all chunks are recovered by scanning the file
+        with open('bouncingBall_result.cres', 'wb') as f:
+            f.write(data[:-16])
+        res = ResultDymolaChunked('bouncingBall_result.cres')
+        np.testing.assert_array_equal(res.get_variable_data('h').x, h)
+        res.close()
+
+        #Truncated last chunk, only the first two chunks are recovered
+        with open('bouncingBall_result.cres', 'wb') as f:
+            f.write(data[:index_offset-1])
+        res = ResultDymolaChunked('bouncingBall_result.cres')
+        np.testing.assert_array_equal(res.get_variable_data('h').x, h[:4])
+        res.close()
+
+    @testattr(stddist = True)
+    def test_writer_bounds(self):
+        with open('chunked_writer.cres', 'wb') as f:
+            pass
+        writer = fmi_util.ChunkedResultWriter('chunked_writer.cres', 1, 1, 0, 2, True)
+
+        writer.add_point(0.0, np.array([1.0]), np.array([1]), np.array([]))
+        nose.tools.assert_raises(ValueError, writer.add_point, 0.0, np.array([1.0, 2.0]), np.array([1]), np.array([]))
+        nose.tools.assert_equal(writer.add_point(1.0, np.array([1.0]), np.array([1]), np.array([])), 1)
+        nose.tools.assert_raises(IndexError, writer.add_point, 2.0, np.array([1.0]), np.array([1]), np.array([]))
+
+        writer.write(writer.current)
+        nose.tools.assert_equal(writer.add_point(2.0, np.array([1.0]), np.array([1]), np.array([])), 0)
+        writer.close()
+
+    @testattr(stddist = True)
+    def test_chunked_options_cs2(self):
+        simple_alias = Dummy_FMUModelCS2([("x", "y")], "NegatedAlias.fmu", os.path.join(file_path, "files", "FMUs", "XML", "CS2.0"), _connect_dll=False)
+        _run_negated_alias(simple_alias, "chunked")
+
 if assimulo_installed:
     class TestResultCSVTextual_Simulation:
         @testattr(stddist = True)